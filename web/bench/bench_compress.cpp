@@ -0,0 +1,336 @@
+// 压缩基准测试：gzip压缩器各级别的吞吐与压缩率，以及各种内容协商路径下每个响应的网络字节数与服务器CPU时间
+//
+// 第一部分直接压缩一段源代码文本(本仓库的src/与include/，找不到时用生成的文本)；
+// 第二部分启动进程内的WebServer(1个I/O线程、1个计算线程)，客户端线程在keep-alive连接上串行请求同一个JS文件：
+//   identity     不带Accept-Encoding，从缓存发送原始内容
+//   gzip-cached  服务器压缩一次后缓存，之后的请求直接命中
+//   precompressed 目录中有预先生成的.gz文件
+//   gzip-stream  缓存关闭，每个请求都在计算线程上流式压缩(chunked)
+// 服务器CPU时间 = 进程CPU时间 - 客户端线程的CPU时间
+#include "gzip.hpp"
+#include "web_server.hpp"
+#include "bench_json.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// 测试参数
+struct CompressOptions {
+    int port = 18095;
+    double seconds = 2;      // 每个场景的测量时长
+    int clients = 2;         // 客户端线程数(各一个连接)
+    size_t fileSize = 128 * 1024;  // 请求的JS文件大小
+    std::string engine;
+};
+
+// 一个场景的结果
+struct ScenarioResult {
+    uint64_t requests = 0;
+    uint64_t errors = 0;
+    uint64_t bytes = 0;         // 收到的字节数(响应头+响应体)
+    double serverCpu = 0;       // 服务器的CPU时间(秒)
+};
+
+// 线程/进程的CPU时间(秒)
+double CpuSeconds(clockid_t clock) {
+    timespec ts{};
+    clock_gettime(clock, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) / 1e9;
+}
+
+// 源代码文本：本仓库的源文件，找不到时生成
+std::string LoadCorpus(size_t size) {
+    std::string corpus;
+    for (const char* dir : {"src", "include"}) {
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator(dir, ec)) {
+            std::ifstream in(entry.path(), std::ios::binary);
+            std::ostringstream content;
+            content << in.rdbuf();
+            corpus += content.str();
+        }
+    }
+    if (corpus.empty()) {
+        for (uint32_t i = 0; corpus.size() < size; ++i) {
+            corpus += "static int handler_" + std::to_string(i * 2654435761u % 997) + "(const Request& request) {\n"
+                      "    return request.size() > " + std::to_string(i % 64) + " ? Send(request) : 0;\n}\n";
+        }
+    }
+    while (corpus.size() < size) corpus += corpus;
+    corpus.resize(size);
+    return corpus;
+}
+
+// 阻塞的keep-alive客户端：一次一个请求，读完整个响应(Content-Length或chunked)
+class BlockingClient {
+public:
+    explicit BlockingClient(int port) {
+        fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (connect(fd_, (sockaddr*)&addr, sizeof(addr)) < 0) {
+            close(fd_);
+            fd_ = -1;
+            return;
+        }
+        int one = 1;
+        setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    ~BlockingClient() {
+        if (fd_ >= 0) close(fd_);
+    }
+
+    // 发送请求并读完响应，返回状态码(连接错误时为0)，bytes为响应的总字节数
+    int Request(const std::string& request, size_t& bytes) {
+        if (fd_ < 0) return 0;
+        for (size_t sent = 0; sent < request.size();) {
+            ssize_t n = send(fd_, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) return 0;
+            sent += static_cast<size_t>(n);
+        }
+        size_t end;
+        while ((end = buffer_.find("\r\n\r\n")) == std::string::npos) {
+            if (!Fill()) return 0;
+        }
+        int status = buffer_.size() > 12 ? std::atoi(buffer_.c_str() + 9) : 0;
+        size_t body = end + 4;
+        size_t length = 0;
+        size_t field = buffer_.find("Content-Length:");
+        if (field != std::string::npos && field < end) {
+            length = std::strtoull(buffer_.c_str() + field + 15, nullptr, 10);
+        } else if (buffer_.find("Transfer-Encoding: chunked") < end) {
+            // 逐块跳过，直到大小为0的最后一块
+            size_t pos = body;
+            while (true) {
+                size_t lineEnd;
+                while ((lineEnd = buffer_.find("\r\n", pos)) == std::string::npos) {
+                    if (!Fill()) return 0;
+                }
+                size_t chunk = std::strtoull(buffer_.c_str() + pos, nullptr, 16);
+                pos = lineEnd + 2 + chunk + 2;
+                if (chunk == 0) break;
+                while (buffer_.size() < pos) {
+                    if (!Fill()) return 0;
+                }
+            }
+            length = pos - body;
+        }
+        while (buffer_.size() < body + length) {
+            if (!Fill()) return 0;
+        }
+        bytes = body + length;
+        buffer_.erase(0, body + length);
+        return status;
+    }
+
+private:
+    bool Fill() {
+        char chunk[65536];
+        ssize_t n = recv(fd_, chunk, sizeof(chunk), 0);
+        if (n <= 0) return false;
+        buffer_.append(chunk, static_cast<size_t>(n));
+        return true;
+    }
+
+    int fd_ = -1;
+    std::string buffer_;  // 已收到但尚未消费的响应数据
+};
+
+// 运行一个场景：cacheSize为0时关闭缓存
+bool RunScenario(const CompressOptions& options, const fs::path& root, const std::string& request,
+                 size_t cacheSize, ScenarioResult& result) {
+    WebServer webServer;
+    ServerConfig config;
+    config.port = options.port;
+    config.engine = options.engine;
+    config.threads = 1;
+    config.computeThreads = 1;
+    config.cacheCapacity = cacheSize;
+    config.cacheMaxFileSize = std::max(MAX_CACHED_FILE_SIZE, options.fileSize);
+    config.documentRoot = root.string();
+    std::streambuf* out = std::cout.rdbuf(nullptr);  // 屏蔽服务器的日志
+    bool ok = webServer.Initialize(config);
+    std::cout.rdbuf(out);
+    if (!ok) return false;
+
+    // 预热：缓存场景的第一次请求完成加载与压缩，不计入测量
+    {
+        BlockingClient client(options.port);
+        size_t bytes = 0;
+        if (client.Request(request, bytes) != 200) return false;
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> requests{0};
+    std::atomic<uint64_t> errors{0};
+    std::atomic<uint64_t> received{0};
+    std::vector<double> clientCpu(static_cast<size_t>(options.clients));
+    std::vector<std::thread> threads;
+    double processStart = CpuSeconds(CLOCK_PROCESS_CPUTIME_ID);
+    for (int i = 0; i < options.clients; ++i) {
+        threads.emplace_back([&, i]() {
+            double start = CpuSeconds(CLOCK_THREAD_CPUTIME_ID);
+            BlockingClient client(options.port);
+            uint64_t count = 0, bytes = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                size_t size = 0;
+                if (client.Request(request, size) != 200) {
+                    errors.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                }
+                ++count;
+                bytes += size;
+            }
+            requests.fetch_add(count, std::memory_order_relaxed);
+            received.fetch_add(bytes, std::memory_order_relaxed);
+            clientCpu[static_cast<size_t>(i)] = CpuSeconds(CLOCK_THREAD_CPUTIME_ID) - start;
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.seconds));
+    stop = true;
+    for (auto& thread : threads) thread.join();
+    double processCpu = CpuSeconds(CLOCK_PROCESS_CPUTIME_ID) - processStart;
+
+    out = std::cout.rdbuf(nullptr);
+    webServer.Stop();
+    std::cout.rdbuf(out);
+
+    result.requests = requests.load();
+    result.errors = errors.load();
+    result.bytes = received.load();
+    double clients = 0;
+    for (double cpu : clientCpu) clients += cpu;
+    result.serverCpu = std::max(0.0, processCpu - clients);
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    CompressOptions options;
+    std::string jsonPath;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--port=", 7) == 0) {
+            options.port = std::atoi(argv[i] + 7);
+        } else if (strncmp(argv[i], "--seconds=", 10) == 0) {
+            options.seconds = std::atof(argv[i] + 10);
+        } else if (strncmp(argv[i], "--clients=", 10) == 0) {
+            options.clients = std::max(1, std::atoi(argv[i] + 10));
+        } else if (strncmp(argv[i], "--file-size=", 12) == 0) {
+            options.fileSize = std::max<size_t>(MIN_COMPRESS_SIZE, std::strtoull(argv[i] + 12, nullptr, 10));
+        } else if (strncmp(argv[i], "--engine=", 9) == 0) {
+            options.engine = argv[i] + 9;
+        } else if (!ParseJsonFlag(argv[i], jsonPath)) {
+            std::cout << "Usage: " << argv[0]
+                      << " [--port=P] [--seconds=S] [--clients=N] [--file-size=BYTES] [--engine=NAME] [--json=FILE]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    JsonReport report("compress");
+    report.Param("seconds", options.seconds);
+    report.Param("clients", options.clients);
+    report.Param("file_size", static_cast<double>(options.fileSize));
+    report.Param("engine", options.engine.empty() ? "default" : options.engine);
+
+    // 第一部分：压缩器
+    std::string corpus = LoadCorpus(1 << 20);
+    std::cout << "=== gzip encoder (" << corpus.size() / 1024 << "KB of source text) ===" << std::endl;
+    std::cout << std::left << std::setw(8) << "level" << std::right << std::setw(10) << "MB/s"
+              << std::setw(12) << "bytes" << std::setw(10) << "ratio" << std::endl;
+    for (int level : {1, 6, 9}) {
+        size_t size = 0;
+        int rounds = 0;
+        auto start = clock_type::now();
+        do {
+            size = GzipEncoder::Compress(corpus, level).size();
+            ++rounds;
+        } while (clock_type::now() - start < std::chrono::milliseconds(500));
+        double seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+        double mbps = static_cast<double>(corpus.size()) * rounds / seconds / 1e6;
+        double ratio = static_cast<double>(size) / static_cast<double>(corpus.size());
+        std::cout << std::left << std::setw(8) << level << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << mbps << std::setw(12) << size << std::setprecision(3) << std::setw(10)
+                  << ratio << std::endl;
+        report.Row();
+        report.Set("scenario", "encoder");
+        report.Set("level", level);
+        report.Set("mb_per_second", mbps);
+        report.Set("compressed_bytes", static_cast<double>(size));
+        report.Set("ratio", ratio);
+    }
+
+    // 第二部分：进程内的服务器
+    fs::path root = fs::temp_directory_path() / "bench_compress_www";
+    fs::create_directories(root);
+    std::string script = corpus.substr(0, options.fileSize);
+    std::ofstream(root / "app.js", std::ios::binary) << script;
+    std::ofstream(root / "pre.js", std::ios::binary) << script;
+    std::ofstream(root / "pre.js.gz", std::ios::binary) << GzipEncoder::Compress(script, 9);
+    fs::last_write_time(root / "pre.js.gz", fs::last_write_time(root / "pre.js"));
+
+    const std::string identity = "GET /app.js HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    const std::string gzip = "GET /app.js HTTP/1.1\r\nHost: localhost\r\nAccept-Encoding: gzip, deflate, br\r\n\r\n";
+    const std::string precompressed =
+        "GET /pre.js HTTP/1.1\r\nHost: localhost\r\nAccept-Encoding: gzip, deflate, br\r\n\r\n";
+    struct Scenario {
+        const char* name;
+        const std::string& request;
+        size_t cacheSize;
+    };
+    const Scenario scenarios[] = {
+        {"identity", identity, DEFAULT_CACHE_CAPACITY},
+        {"gzip-cached", gzip, DEFAULT_CACHE_CAPACITY},
+        {"precompressed", precompressed, DEFAULT_CACHE_CAPACITY},
+        {"gzip-stream", gzip, 0},
+    };
+
+    std::cout << "\n=== Responses (" << options.fileSize / 1024 << "KB script, 1 I/O thread, " << options.clients
+              << " clients, " << options.seconds << "s per scenario) ===" << std::endl;
+    std::cout << std::left << std::setw(15) << "scenario" << std::right << std::setw(10) << "req/s"
+              << std::setw(14) << "bytes/resp" << std::setw(14) << "cpu us/req" << std::setw(8) << "errors"
+              << std::endl;
+    bool ok = true;
+    for (const auto& scenario : scenarios) {
+        ScenarioResult result;
+        if (!RunScenario(options, root, scenario.request, scenario.cacheSize, result)) {
+            std::cerr << "Failed to run scenario " << scenario.name << std::endl;
+            ok = false;
+            break;
+        }
+        double rate = static_cast<double>(result.requests) / options.seconds;
+        double bytes = result.requests ? static_cast<double>(result.bytes) / static_cast<double>(result.requests) : 0;
+        double cpu = result.requests ? result.serverCpu * 1e6 / static_cast<double>(result.requests) : 0;
+        std::cout << std::left << std::setw(15) << scenario.name << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(10) << rate << std::setw(14) << bytes << std::setprecision(1) << std::setw(14) << cpu
+                  << std::setw(8) << result.errors << std::endl;
+        ok = ok && result.errors == 0 && result.requests > 0;
+
+        report.Row();
+        report.Set("scenario", scenario.name);
+        report.Set("requests_per_second", rate);
+        report.Set("bytes_per_response", bytes);
+        report.Set("server_cpu_us_per_request", cpu);
+        report.Set("errors", static_cast<double>(result.errors));
+    }
+    bool written = report.Write(jsonPath);
+
+    fs::remove_all(root);
+    return ok && written ? 0 : 1;
+}
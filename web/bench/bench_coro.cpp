@@ -0,0 +1,273 @@
+// 协程处理器基准测试：co_await的开销，以及协程服务器与直接实现IoHandler回调的吞吐对比
+//
+// 1. 微基准：co_await一个立即返回的子任务(每次创建并销毁一个协程帧)、帧池与堆的分配+释放
+// 2. 服务器：同一引擎、1个I/O线程，分别运行回调实现(与WebServer一样在引擎缓冲区上原地解析)与协程实现
+//    (while (co_await ReadRequest()) co_await Send(...))，都回应同一个预先构建的1KB响应；
+//    阻塞的客户端线程各持一个连接，每轮发送pipeline个请求再读完全部响应。两种实现交替运行rounds轮，取各自最好的一轮
+#include "coro_server.hpp"
+#include "bench_json.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// 测试参数
+struct CoroOptions {
+    int port = 18095;
+    std::string engine;
+    int connections = 8;  // 客户端连接数(各一个线程)
+    int pipeline = 8;     // 每轮发送的请求数
+    double seconds = 2;   // 每轮的测量时长
+    int rounds = 3;       // 交替运行的轮数
+};
+
+const char REQUEST[] = "GET /index.html HTTP/1.1\r\nHost: localhost\r\n\r\n";
+
+// 预先构建的1KB响应
+SharedBuffer MakeResponse() {
+    return std::make_shared<const std::string>(
+        "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nContent-Length: 1024\r\n\r\n" + std::string(1024, 'x'));
+}
+
+Task<int> Identity(int value) { co_return value; }
+
+Task<> AwaitLoop(int iterations, int64_t& sum) {
+    for (int i = 0; i < iterations; ++i) sum += co_await Identity(i);
+}
+
+// 微基准：每次co_await的纳秒数(sum为子任务返回值之和，避免被优化掉)
+double MeasureAwait(int iterations, int64_t& sum) {
+    sum = 0;
+    auto start = clock_type::now();
+    Task<> task = AwaitLoop(iterations, sum);
+    task.Start();
+    return std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / iterations;
+}
+
+// 微基准：分配+释放一个size字节帧的纳秒数
+template <typename Allocate, typename Release>
+double MeasureAllocation(int iterations, size_t size, Allocate allocate, Release release) {
+    std::vector<void*> frames(16);
+    auto start = clock_type::now();
+    for (int i = 0; i < iterations; i += 16) {
+        for (auto& frame : frames) frame = allocate(size);
+        for (auto& frame : frames) release(frame, size);
+    }
+    return std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / iterations;
+}
+
+// 回调实现：与WebServer::ConsumeInput相同的原地解析，只回应固定的响应
+class CallbackServer : public IoHandler {
+public:
+    explicit CallbackServer(SharedBuffer response) : response_(std::move(response)) {}
+
+    bool Initialize(const CoroOptions& options) {
+        engine_ = CreateIoEngine(options.engine.empty() ? DefaultIoEngineName() : options.engine);
+        IoEngineOptions engineOptions;
+        engineOptions.port = options.port;
+        engineOptions.threadCount = 1;
+        if (!engine_ || !engine_->Initialize(engineOptions, this)) return false;
+        engine_->Start();
+        return true;
+    }
+    void Stop() { engine_->Stop(); }
+
+    void OnAccept(size_t, SOCKET socket) override { partial_.Insert(socket); }
+    void OnRecv(size_t, SOCKET socket, const char* data, size_t length) override {
+        std::string* partial = partial_.Find(socket);
+        if (!partial) return;
+        bool inPlace = partial->empty();
+        if (!inPlace) partial->append(data, length);
+        const char* buffer = inPlace ? data : partial->data();
+        size_t size = inPlace ? length : partial->size();
+        size_t consumed = 0;
+        while (consumed < size) {
+            ParseStatus status = parser_.parse(buffer + consumed, size - consumed);
+            if (status == ParseStatus::INCOMPLETE) break;
+            if (status == ParseStatus::FAILED || status == ParseStatus::UNSUPPORTED) {
+                engine_->Close(socket);
+                consumed = size;
+                break;
+            }
+            engine_->Send(socket, response_);
+            consumed += parser_.consumed();
+            parser_.reset();
+        }
+        parser_.reset();
+        if (inPlace) {
+            partial->assign(data + consumed, size - consumed);
+        } else {
+            partial->erase(0, consumed);
+        }
+    }
+    void OnSend(size_t, SOCKET, size_t) override {}
+    void OnClose(size_t, SOCKET socket) override { partial_.Erase(socket); }
+
+private:
+    std::unique_ptr<IoEngine> engine_;
+    SharedBuffer response_;
+    HttpParser parser_;  // 只有一个I/O线程，每次回调从头解析
+    ConnectionTable<std::string> partial_;  // 各连接未完成的请求
+};
+
+// 协程实现
+Task<> Serve(CoConnection& conn, SharedBuffer response) {
+    for (;;) {
+        const HttpRequest* request = co_await conn.ReadRequest();
+        if (!request) break;
+        bool open = co_await conn.Send(response);
+        if (!open) break;
+    }
+}
+
+// 运行客户端：各线程每轮发送pipeline个请求并读完全部响应，返回每秒完成的请求数
+double RunClients(const CoroOptions& options, size_t responseSize) {
+    std::string batch;
+    for (int i = 0; i < options.pipeline; ++i) batch += REQUEST;
+    size_t expected = responseSize * static_cast<size_t>(options.pipeline);
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> completed{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < options.connections; ++t) {
+        threads.emplace_back([&]() {
+            int fd = socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(static_cast<uint16_t>(options.port));
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+                close(fd);
+                return;
+            }
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            std::vector<char> buffer(65536);
+            uint64_t done = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (send(fd, batch.data(), batch.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(batch.size())) break;
+                size_t received = 0;
+                while (received < expected) {
+                    ssize_t n = recv(fd, buffer.data(), buffer.size(), 0);
+                    if (n <= 0) break;
+                    received += static_cast<size_t>(n);
+                }
+                if (received < expected) break;
+                done += static_cast<uint64_t>(options.pipeline);
+            }
+            completed.fetch_add(done);
+            close(fd);
+        });
+    }
+    auto start = clock_type::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.seconds));
+    stop = true;
+    for (auto& thread : threads) thread.join();
+    return completed.load() / std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    CoroOptions options;
+    std::string jsonPath;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--port=", 7) == 0) {
+            options.port = std::atoi(argv[i] + 7);
+        } else if (strncmp(argv[i], "--engine=", 9) == 0) {
+            options.engine = argv[i] + 9;
+        } else if (strncmp(argv[i], "--connections=", 14) == 0) {
+            options.connections = std::max(1, std::atoi(argv[i] + 14));
+        } else if (strncmp(argv[i], "--pipeline=", 11) == 0) {
+            options.pipeline = std::max(1, std::atoi(argv[i] + 11));
+        } else if (strncmp(argv[i], "--seconds=", 10) == 0) {
+            options.seconds = std::atof(argv[i] + 10);
+        } else if (strncmp(argv[i], "--rounds=", 9) == 0) {
+            options.rounds = std::max(1, std::atoi(argv[i] + 9));
+        } else if (!ParseJsonFlag(argv[i], jsonPath)) {
+            std::cout << "Usage: " << argv[0] << " [--port=P] [--engine=NAME] [--connections=N] [--pipeline=N]"
+                      << " [--seconds=S] [--rounds=N] [--json=FILE]" << std::endl;
+            return 1;
+        }
+    }
+    std::string engine = options.engine.empty() ? DefaultIoEngineName() : options.engine;
+
+    JsonReport report("coro");
+    report.Param("engine", engine);
+    report.Param("connections", options.connections);
+    report.Param("pipeline", options.pipeline);
+    report.Param("seconds", options.seconds);
+    report.Param("rounds", options.rounds);
+
+    // 1. 微基准
+    const int ITERATIONS = 10000000;
+    int64_t checksum = 0;
+    MeasureAwait(ITERATIONS / 10, checksum);  // 预热，填充帧池
+    uint64_t heapBefore = FramePool::HeapAllocations();
+    double awaitNs = MeasureAwait(ITERATIONS, checksum);
+    uint64_t heapFrames = FramePool::HeapAllocations() - heapBefore;
+    double poolNs = MeasureAllocation(ITERATIONS, 192, FramePool::Allocate, FramePool::Release);
+    double heapNs = MeasureAllocation(ITERATIONS, 192, [](size_t size) { return ::operator new(size); },
+                                      [](void* frame, size_t) { ::operator delete(frame); });
+    std::cout << "=== Coroutine overhead ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(1)
+              << "co_await child task:     " << awaitNs << " ns (heap frames in " << ITERATIONS << " awaits: "
+              << heapFrames << ", checksum " << checksum << ")" << std::endl
+              << "frame alloc+free (pool): " << poolNs << " ns" << std::endl
+              << "frame alloc+free (heap): " << heapNs << " ns" << std::endl;
+    report.Row();
+    report.Set("name", "micro");
+    report.Set("await_ns", awaitNs);
+    report.Set("await_heap_frames", static_cast<double>(heapFrames));
+    report.Set("pool_alloc_ns", poolNs);
+    report.Set("heap_alloc_ns", heapNs);
+
+    // 2. 服务器吞吐
+    SharedBuffer response = MakeResponse();
+    std::cout << "\n=== Callback vs coroutine server (" << engine << ", 1 I/O thread, " << options.connections
+              << " connections, pipeline " << options.pipeline << ", best of " << options.rounds << " x "
+              << options.seconds << "s) ===" << std::endl;
+    double best[2] = {0, 0};
+    for (int round = 0; round < options.rounds; ++round) {
+        {
+            CallbackServer server(response);
+            if (!server.Initialize(options)) {
+                std::cerr << "Failed to start the callback server" << std::endl;
+                return 1;
+            }
+            best[0] = std::max(best[0], RunClients(options, response->size()));
+            server.Stop();
+        }
+        {
+            CoServer server;
+            CoServerConfig config;
+            config.port = options.port;
+            config.engine = options.engine;
+            config.threads = 1;
+            if (!server.Initialize(config, [&response](CoConnection& conn) { return Serve(conn, response); })) {
+                std::cerr << "Failed to start the coroutine server" << std::endl;
+                return 1;
+            }
+            best[1] = std::max(best[1], RunClients(options, response->size()));
+            server.Stop();
+        }
+    }
+    std::cout << std::left << std::setw(12) << "handler" << std::right << std::setw(12) << "req/s"
+              << std::setw(10) << "ratio" << std::endl;
+    const char* names[] = {"callback", "coroutine"};
+    for (int i = 0; i < 2; ++i) {
+        std::cout << std::left << std::setw(12) << names[i] << std::right << std::setprecision(0) << std::setw(12)
+                  << best[i] << std::setprecision(3) << std::setw(10) << best[i] / best[0] << std::endl;
+        report.Row();
+        report.Set("name", names[i]);
+        report.Set("requests_per_second", best[i]);
+        report.Set("ratio", best[i] / best[0]);
+    }
+    return report.Write(jsonPath) && best[0] > 0 && best[1] > 0 ? 0 : 1;
+}
@@ -0,0 +1,283 @@
+// I/O引擎基准测试：在回环地址上比较各引擎的吞吐、每请求系统调用数与每请求堆分配次数
+//
+// 服务端默认使用最小的固定响应处理器，只衡量引擎本身的开销；
+// --server时运行完整的WebServer(请求解析、超时、静态资源缓存命中)；
+// 客户端为单线程epoll闭环压测，每个连接保持pipeline个未完成请求(keep-alive)，
+// 预热后才开始计数，客户端本身不分配内存，因此分配次数反映服务端的稳态堆流量
+#include "io_engine.hpp"
+#include "web_server.hpp"
+#include "bench_json.hpp"
+#include <sys/epoll.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <new>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::atomic<uint64_t> allocations{0};  // 堆分配次数(全进程)
+
+const char REQUEST[] = "GET /ok.txt HTTP/1.1\r\nHost: localhost\r\n\r\n";
+const size_t REQUEST_SIZE = sizeof(REQUEST) - 1;
+const char RESPONSE[] =
+    "HTTP/1.1 200 OK\r\nDate: Thu, 01 Jan 1970 00:00:00 GMT\r\nContent-Type: text/plain\r\n"
+    "Content-Length: 2\r\nConnection: keep-alive\r\n\r\nok";
+const size_t RESPONSE_SIZE = sizeof(RESPONSE) - 1;
+// --server模式下请求的文件，其响应与固定响应长度相同(只有Date头的值不同)
+const char FILE_NAME[] = "ok.txt";
+const char FILE_CONTENT[] = "ok";
+
+// 固定响应处理器：每收满一个请求大小就回复一次(与WebServer一样每个请求单独Send)
+class FixedResponseHandler : public IoHandler {
+public:
+    IoEngine* engine = nullptr;
+    SharedBuffer response = std::make_shared<const std::string>(RESPONSE, RESPONSE_SIZE);
+
+    void OnAccept(size_t, SOCKET socket) override { received_[socket] = 0; }
+    void OnRecv(size_t, SOCKET socket, const char* data, size_t length) override {
+        (void)data;
+        size_t& pending = received_[socket];
+        pending += length;
+        while (pending >= REQUEST_SIZE) {
+            pending -= REQUEST_SIZE;
+            engine->Send(socket, response);
+        }
+    }
+    void OnSend(size_t, SOCKET, size_t) override {}
+    void OnClose(size_t, SOCKET socket) override { received_.erase(socket); }
+
+private:
+    std::unordered_map<SOCKET, size_t> received_;  // 单I/O线程，无需加锁
+};
+
+// 连接到本地端口
+int Connect(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+// 发送一批流水线请求
+void SendRequests(int fd, const std::string& batch) {
+    if (send(fd, batch.data(), batch.size(), MSG_NOSIGNAL) < 0) {
+        std::cerr << "send failed: " << strerror(errno) << std::endl;
+    }
+}
+
+// 测量结果(预热之后)
+struct Result {
+    uint64_t completed = 0;    // 完成的请求数
+    double seconds = 0;        // 测量时长
+    uint64_t syscalls = 0;     // 服务端系统调用数
+    uint64_t allocations = 0;  // 堆分配次数
+};
+
+// 闭环客户端：预热warmup后测量duration内完成的请求
+Result RunClient(IoEngine& engine, int port, int connections, int pipeline,
+                 std::chrono::milliseconds warmup, std::chrono::milliseconds duration) {
+    std::string batch;
+    for (int i = 0; i < pipeline; ++i) batch.append(REQUEST, REQUEST_SIZE);
+
+    int ep = epoll_create1(0);
+    std::unordered_map<int, size_t> received;
+    received.reserve(connections);
+    for (int i = 0; i < connections; ++i) {
+        int fd = Connect(port);
+        if (fd < 0) continue;
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev);
+        received[fd] = 0;
+        SendRequests(fd, batch);
+    }
+
+    Result result;
+    uint64_t completed = 0;
+    char buffer[16384];
+    epoll_event events[256];
+    auto start = std::chrono::steady_clock::now();
+    auto measureAt = start + warmup;
+    auto deadline = measureAt + duration;
+    bool measuring = false;
+    while (true) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) break;
+        if (!measuring && now >= measureAt) {
+            // 预热结束：连接已建立，各级缓冲区与池已达到稳态
+            measuring = true;
+            start = now;
+            completed = 0;
+            result.syscalls = engine.SyscallCount();
+            result.allocations = allocations.load(std::memory_order_relaxed);
+        }
+        int n = epoll_wait(ep, events, 256, 100);
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            ssize_t r;
+            while ((r = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+                size_t& got = received[fd];
+                got += static_cast<size_t>(r);
+                // 整批响应到齐后再发送下一批
+                size_t responses = RESPONSE_SIZE * pipeline;
+                while (got >= responses) {
+                    got -= responses;
+                    completed += pipeline;
+                    SendRequests(fd, batch);
+                }
+            }
+        }
+    }
+
+    result.completed = completed;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.syscalls = engine.SyscallCount() - result.syscalls;
+    result.allocations = allocations.load(std::memory_order_relaxed) - result.allocations;
+
+    for (auto& entry : received) close(entry.first);
+    close(ep);
+    return result;
+}
+
+// 打印一行结果并记入JSON报告
+void Report(JsonReport& report, const std::string& name, const Result& result) {
+    double completed = static_cast<double>(std::max<uint64_t>(result.completed, 1));
+    report.Row();
+    report.Set("engine", name);
+    report.Set("requests", static_cast<double>(result.completed));
+    report.Set("requests_per_second", result.completed / result.seconds);
+    report.Set("syscalls_per_request", result.syscalls / completed);
+    report.Set("allocations_per_request", result.allocations / completed);
+    std::cout << std::left << std::setw(8) << name
+              << std::right << std::setw(12) << result.completed
+              << std::setw(14) << std::fixed << std::setprecision(0) << result.completed / result.seconds
+              << std::setw(16) << std::setprecision(3) << result.syscalls / completed
+              << std::setw(14) << std::setprecision(4) << result.allocations / completed << std::endl;
+}
+
+}
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+int main(int argc, char* argv[]) {
+    int connections = 32;
+    int seconds = 3;
+    int pipeline = 1;
+    int port = 18080;
+    bool server = false;
+    std::vector<std::string> engines = {"epoll", "uring"};
+    std::string jsonPath;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--connections=", 14) == 0) {
+            connections = std::atoi(argv[i] + 14);
+        } else if (strncmp(argv[i], "--seconds=", 10) == 0) {
+            seconds = std::atoi(argv[i] + 10);
+        } else if (strncmp(argv[i], "--pipeline=", 11) == 0) {
+            pipeline = std::max(1, std::atoi(argv[i] + 11));
+        } else if (strncmp(argv[i], "--port=", 7) == 0) {
+            port = std::atoi(argv[i] + 7);
+        } else if (strcmp(argv[i], "--server") == 0) {
+            server = true;
+        } else if (strncmp(argv[i], "--engines=", 10) == 0) {
+            engines.clear();
+            std::stringstream ss(argv[i] + 10);
+            std::string name;
+            while (std::getline(ss, name, ',')) engines.push_back(name);
+        } else if (!ParseJsonFlag(argv[i], jsonPath)) {
+            std::cout << "Usage: " << argv[0]
+                      << " [--connections=N] [--pipeline=N] [--seconds=S] [--port=P] [--engines=epoll,uring] [--server]"
+                      << " [--json=FILE]" << std::endl;
+            return 1;
+        }
+    }
+
+    // --server模式的文档根目录(首个请求之后全部是缓存命中)
+    fs::path root = fs::temp_directory_path() / "bench_engine_www";
+    if (server) {
+        fs::create_directories(root);
+        std::ofstream(root / FILE_NAME, std::ios::binary) << FILE_CONTENT;
+    }
+
+    std::cout << "=== I/O engine benchmark (" << connections << " keep-alive connections, pipeline "
+              << pipeline << ", " << seconds << "s, 1 I/O thread, "
+              << (server ? "WebServer cache hits" : "fixed response") << ") ===" << std::endl;
+    std::cout << std::left << std::setw(8) << "engine"
+              << std::right << std::setw(12) << "requests"
+              << std::setw(14) << "req/s"
+              << std::setw(16) << "syscalls/req"
+              << std::setw(14) << "allocs/req" << std::endl;
+
+    JsonReport report("engine");
+    report.Param("connections", connections);
+    report.Param("pipeline", pipeline);
+    report.Param("seconds", seconds);
+    report.Param("server", server ? "WebServer" : "fixed");
+
+    auto warmup = std::chrono::milliseconds(500);
+    for (const auto& name : engines) {
+        if (server) {
+            ServerConfig config;
+            config.port = port;
+            config.engine = name;
+            config.threads = 1;
+            config.documentRoot = root.string();
+            WebServer webServer;
+            std::streambuf* out = std::cout.rdbuf(nullptr);  // 屏蔽服务器的启动日志
+            bool ok = webServer.Initialize(config);
+            std::cout.rdbuf(out);
+            if (!ok) {
+                std::cout << std::left << std::setw(8) << name << "  unavailable" << std::endl;
+                continue;
+            }
+            Result result = RunClient(*webServer.Engine(), port, connections, pipeline,
+                                      warmup, std::chrono::seconds(seconds));
+            std::cout.rdbuf(nullptr);
+            webServer.Stop();
+            std::cout.rdbuf(out);
+            Report(report, name, result);
+            continue;
+        }
+
+        auto engine = CreateIoEngine(name);
+        FixedResponseHandler handler;
+        handler.engine = engine.get();
+        IoEngineOptions options;
+        options.port = port;
+        options.threadCount = 1;
+        if (!engine || !engine->Initialize(options, &handler)) {
+            std::cout << std::left << std::setw(8) << name << "  unavailable" << std::endl;
+            continue;
+        }
+        engine->Start();
+        Result result = RunClient(*engine, port, connections, pipeline, warmup, std::chrono::seconds(seconds));
+        engine->Stop();
+        Report(report, name, result);
+    }
+
+    if (server) fs::remove_all(root);
+    return report.Write(jsonPath) ? 0 : 1;
+}
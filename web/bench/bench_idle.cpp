@@ -0,0 +1,220 @@
+// 空闲连接内存基准测试：每个空闲keep-alive连接占用的服务端常驻内存
+//
+// 每个引擎在独立的子进程中运行WebServer(RSS互不影响)，客户端在另一个子进程中建立N个连接，
+// 每个连接发送一个分两次到达的请求(使服务端缓冲未完成的请求)并读完响应，之后保持空闲；
+// 服务端进程在连接建立前后读取/proc/self/statm，差值除以N即每个空闲连接的内存
+#include "web_server.hpp"
+#include <sys/wait.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// 典型浏览器请求(约400字节)，分两半发送
+const char REQUEST[] =
+    "GET /ok.txt HTTP/1.1\r\n"
+    "Host: localhost\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/124.0 Safari/537.36\r\n"
+    "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+    "Accept-Encoding: gzip, deflate, br\r\n"
+    "Accept-Language: en-GB,en;q=0.9\r\n"
+    "Cookie: session=eyJ1c2VyIjoiYWxpY2UiLCJleHAiOjE3MDAwMDAwMDB9\r\n"
+    "Connection: keep-alive\r\n"
+    "\r\n";
+const size_t REQUEST_SIZE = sizeof(REQUEST) - 1;
+
+// 当前进程的常驻内存(字节)
+size_t ResidentBytes() {
+    std::ifstream statm("/proc/self/statm");
+    size_t pages = 0, resident = 0;
+    statm >> pages >> resident;
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+// 连接到本地端口(阻塞模式)
+int Connect(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+// 进程间的同步管道
+struct Pipes {
+    int go[2];     // 服务端 -> 客户端：基线已测量，开始连接
+    int ready[2];  // 客户端 -> 服务端：连接已建立并完成请求(写入连接数)
+    int done[2];   // 服务端 -> 客户端：测量完毕(关闭写端)
+};
+
+// 客户端进程：建立连接并各完成一个请求，然后保持空闲直到服务端测量完毕
+void RunClient(int port, int connections, const Pipes& pipes) {
+    char unused;
+    if (read(pipes.go[0], &unused, 1) != 1) _exit(1);
+
+    std::vector<int> fds;
+    fds.reserve(connections);
+    for (int i = 0; i < connections; ++i) {
+        int fd = Connect(port);
+        if (fd < 0) break;
+        fds.push_back(fd);
+    }
+
+    // 先发前半部分，稍后再发后半部分，服务端须缓冲未完成的请求
+    size_t half = REQUEST_SIZE / 2;
+    for (int fd : fds) send(fd, REQUEST, half, MSG_NOSIGNAL);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    for (int fd : fds) send(fd, REQUEST + half, REQUEST_SIZE - half, MSG_NOSIGNAL);
+
+    // 读完每个连接的响应(以响应体"ok"结尾)
+    char buffer[4096];
+    for (int fd : fds) {
+        std::string response;
+        while (response.size() < 2 || response.compare(response.size() - 2, 2, "ok") != 0) {
+            ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+            if (n <= 0) break;
+            response.append(buffer, static_cast<size_t>(n));
+        }
+    }
+
+    int count = static_cast<int>(fds.size());
+    if (write(pipes.ready[1], &count, sizeof(count)) < 0) _exit(1);
+    while (read(pipes.done[0], &unused, 1) > 0) {}  // 等待服务端测量完毕
+    for (int fd : fds) close(fd);
+    _exit(0);
+}
+
+// 服务端进程：运行WebServer并测量，返回是否成功
+bool Measure(const std::string& engine, int port, int connections, bool lazyRecv, const fs::path& root,
+             const Pipes& pipes) {
+    ServerConfig config;
+    config.port = port;
+    config.engine = engine;
+    config.threads = 1;
+    config.lazyRecv = lazyRecv;
+    config.documentRoot = root.string();
+    WebServer server;
+    std::streambuf* out = std::cout.rdbuf(nullptr);  // 屏蔽服务器日志
+    bool ok = server.Initialize(config);
+    std::cout.rdbuf(out);
+    if (!ok) {
+        std::cout << std::left << std::setw(8) << engine << "  unavailable" << std::endl;
+        return false;  // 退出后客户端读到EOF随之退出
+    }
+
+    // 先完成一个请求，使缓存、池等一次性开销计入基线
+    int warm = Connect(port);
+    send(warm, REQUEST, REQUEST_SIZE, MSG_NOSIGNAL);
+    char buffer[1024];
+    if (recv(warm, buffer, sizeof(buffer), 0) <= 0) std::cerr << "warm-up request failed" << std::endl;
+    close(warm);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    size_t before = ResidentBytes();
+
+    char go = 1;
+    int established = 0;
+    if (write(pipes.go[1], &go, 1) != 1 ||
+        read(pipes.ready[0], &established, sizeof(established)) != sizeof(established)) {
+        established = 0;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    size_t after = ResidentBytes();
+    close(pipes.done[1]);  // 通知客户端退出
+
+    std::cout.rdbuf(nullptr);
+    server.Stop();
+    std::cout.rdbuf(out);
+
+    double perConnection = established > 0 && after > before
+        ? static_cast<double>(after - before) / established : 0.0;
+    std::cout << std::left << std::setw(8) << engine
+              << std::right << std::setw(14) << established
+              << std::setw(14) << std::fixed << std::setprecision(1) << (after - before) / 1048576.0
+              << std::setw(16) << std::setprecision(0) << perConnection << std::endl;
+    return established == connections;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    int connections = 8000;
+    int port = 18090;
+    bool lazyRecv = false;
+    std::vector<std::string> engines = {"epoll", "uring"};
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--connections=", 14) == 0) {
+            connections = std::max(1, std::atoi(argv[i] + 14));
+        } else if (strncmp(argv[i], "--port=", 7) == 0) {
+            port = std::atoi(argv[i] + 7);
+        } else if (strcmp(argv[i], "--lazy-recv") == 0) {
+            lazyRecv = true;
+        } else if (strncmp(argv[i], "--engines=", 10) == 0) {
+            engines.clear();
+            std::stringstream ss(argv[i] + 10);
+            std::string name;
+            while (std::getline(ss, name, ',')) engines.push_back(name);
+        } else {
+            std::cout << "Usage: " << argv[0]
+                      << " [--connections=N] [--port=P] [--engines=epoll,uring] [--lazy-recv]" << std::endl;
+            return 1;
+        }
+    }
+
+    fs::path root = fs::temp_directory_path() / "bench_idle_www";
+    fs::create_directories(root);
+    std::ofstream(root / "ok.txt", std::ios::binary) << "ok";
+
+    std::cout << "=== Idle connection memory (" << connections << " keep-alive connections, 1 I/O thread) ===" << std::endl;
+    std::cout << std::left << std::setw(8) << "engine"
+              << std::right << std::setw(14) << "connections"
+              << std::setw(14) << "RSS (MB)"
+              << std::setw(16) << "bytes/conn" << std::endl;
+
+    int status = 0;
+    for (const auto& engine : engines) {
+        // 服务端与客户端各一个进程(都从单线程的主进程fork)，每个引擎的RSS互不影响
+        Pipes pipes;
+        if (pipe(pipes.go) < 0 || pipe(pipes.ready) < 0 || pipe(pipes.done) < 0) return 1;
+        std::cout.flush();
+        pid_t server = fork();
+        if (server == 0) {
+            close(pipes.go[0]);
+            close(pipes.ready[1]);
+            close(pipes.done[0]);
+            _exit(Measure(engine, port, connections, lazyRecv, root, pipes) ? 0 : 1);
+        }
+        pid_t client = fork();
+        if (client == 0) {
+            close(pipes.go[1]);
+            close(pipes.ready[0]);
+            close(pipes.done[1]);
+            RunClient(port, connections, pipes);
+        }
+        for (int* fds : {pipes.go, pipes.ready, pipes.done}) {
+            close(fds[0]);
+            close(fds[1]);
+        }
+
+        int result = 0;
+        waitpid(server, &result, 0);
+        waitpid(client, nullptr, 0);
+        if (!WIFEXITED(result) || WEXITSTATUS(result) != 0) status = 1;
+    }
+
+    fs::remove_all(root);
+    return status;
+}
@@ -0,0 +1,84 @@
+#ifndef BENCH_JSON_HPP
+#define BENCH_JSON_HPP
+
+// 基准测试结果的JSON输出(用于回归跟踪)：各基准测试加--json=FILE时把结果写入FILE，表格照常打印
+// 格式：{"benchmark": 名称, "params": {参数}, "results": [{每行结果}, ...]}
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+class JsonReport {
+public:
+    explicit JsonReport(const std::string& benchmark) : benchmark_(benchmark) {}
+
+    // 顶层参数
+    void Param(const std::string& key, double value) { AppendField(params_, key, Number(value)); }
+    void Param(const std::string& key, const std::string& value) { AppendField(params_, key, Quote(value)); }
+
+    // 开始新的一行结果，之后的Set写入这一行
+    void Row() {
+        if (!rows_.empty()) rows_ += ",";
+        rows_ += "\n    {}";
+    }
+    void Set(const std::string& key, double value) { AppendToRow(key, Number(value)); }
+    void Set(const std::string& key, const std::string& value) { AppendToRow(key, Quote(value)); }
+    void Set(const std::string& key, const char* value) { AppendToRow(key, Quote(value)); }
+
+    // 写入文件(path为空时不输出)，失败时返回false
+    bool Write(const std::string& path) const {
+        if (path.empty()) return true;
+        std::ofstream out(path, std::ios::binary);
+        out << "{\n  \"benchmark\": " << Quote(benchmark_)
+            << ",\n  \"params\": {" << params_ << "}"
+            << ",\n  \"results\": [" << rows_ << "\n  ]\n}\n";
+        if (!out) {
+            std::cerr << "Failed to write " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    static std::string Number(double value) {
+        if (!std::isfinite(value)) return "null";
+        char text[32];
+        snprintf(text, sizeof(text), "%.10g", value);
+        return text;
+    }
+
+    static std::string Quote(const std::string& value) {
+        std::string out = "\"";
+        for (char c : value) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        return out + "\"";
+    }
+
+    static void AppendField(std::string& object, const std::string& key, const std::string& value) {
+        if (!object.empty()) object += ", ";
+        object += Quote(key) + ": " + value;
+    }
+
+    // 把字段插入当前行的右花括号之前
+    void AppendToRow(const std::string& key, const std::string& value) {
+        rows_.pop_back();
+        if (rows_.back() != '{') rows_ += ", ";
+        rows_ += Quote(key) + ": " + value + "}";
+    }
+
+    std::string benchmark_;  // 基准测试名称
+    std::string params_;     // 参数对象的内容
+    std::string rows_;       // 结果数组的内容
+};
+
+// 解析--json=FILE，匹配时返回true
+inline bool ParseJsonFlag(const char* arg, std::string& path) {
+    if (std::string(arg).compare(0, 7, "--json=") != 0) return false;
+    path = arg + 7;
+    return true;
+}
+
+#endif
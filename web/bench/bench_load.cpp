@@ -0,0 +1,523 @@
+// HTTP负载生成器：多线程、keep-alive、可配置流水线深度/连接数/请求组合，报告吞吐与p50/p99/p99.9延迟
+//
+// 闭环(默认)：每个连接始终保持pipeline个未完成请求，一个响应到齐就补发一个；
+// 开环(--rate=R)：按固定速率R(各线程均分)安排请求的预定发送时间，延迟从预定时间算起，
+// 服务端变慢时排队等待的时间也计入延迟(避免协调遗漏)；
+// 每个压测线程独占一个epoll实例与一部分连接，延迟记入各自的LatencyHistogram，结束后合并；
+// --server时在进程内启动WebServer(临时文档根目录)，否则压测--host:--port上已运行的服务器
+#include "metrics.hpp"
+#include "web_server.hpp"
+#include "bench_json.hpp"
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+const size_t MAX_RESPONSE_HEADER = 64 * 1024;  // 响应头的最大长度
+const uint32_t TIMER_EVENT = UINT32_MAX;        // epoll事件中代表定时器的标识(其余为连接下标)
+
+// 压测参数
+struct LoadOptions {
+    std::string host = "127.0.0.1";
+    int port = 18080;
+    int threads = 2;          // 压测线程数
+    int connections = 64;     // 连接总数(各线程均分)
+    int pipeline = 1;         // 每个连接的最大未完成请求数
+    double seconds = 5;       // 测量时长
+    double warmup = 1;        // 预热时长(不计入结果)
+    double rate = 0;          // 开环的目标速率(请求/秒，0表示闭环)
+    std::string mix = "/index.html";  // 请求组合：path[:weight],...
+    std::string headers;      // 附加到每个请求的头(每行以CRLF结尾，如条件请求或Range)
+};
+
+// 请求组合中的一项
+struct MixEntry {
+    std::string request;  // 完整的请求报文
+    uint32_t weight;      // 权重
+};
+
+// 一个连接的状态
+struct Connection {
+    int fd = -1;
+    std::string output;        // 未发送完的请求
+    size_t outputOffset = 0;   // output中已发送的字节数
+    std::deque<clock_type::time_point> sentAt;  // 未完成请求的计时起点(按发送顺序)
+    std::string header;        // 未完整的响应头
+    uint64_t bodyRemaining = 0;  // 当前响应未收到的响应体字节数
+    int status = 0;            // 当前响应的状态码
+};
+
+// 一个压测线程的结果
+struct WorkerResult {
+    uint64_t completed = 0;  // 测量期间完成的请求数
+    uint64_t bytes = 0;      // 测量期间收到的字节数
+    uint64_t errors = 0;     // 非2xx/3xx响应、格式错误的响应与断开时未完成的请求
+    uint64_t reconnects = 0; // 被服务端断开后重连的次数
+    LatencyHistogram latency;  // 请求延迟(纳秒)
+};
+
+// 解析请求组合
+bool ParseMix(const std::string& text, const std::string& host, const std::string& headers,
+              std::vector<MixEntry>& mix) {
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty() || item[0] != '/') return false;
+        uint32_t weight = 1;
+        size_t colon = item.rfind(':');
+        if (colon != std::string::npos) {
+            weight = static_cast<uint32_t>(std::strtoul(item.c_str() + colon + 1, nullptr, 10));
+            item.resize(colon);
+        }
+        if (weight == 0) continue;
+        mix.push_back({"GET " + item + " HTTP/1.1\r\nHost: " + host + "\r\n" + headers + "\r\n", weight});
+    }
+    return !mix.empty();
+}
+
+// 连接到服务器
+int Connect(const LoadOptions& options) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(options.port);
+    if (inet_pton(AF_INET, options.host.c_str(), &addr.sin_addr) != 1 ||
+        connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+// 从响应头中取Content-Length(不存在时为0)
+uint64_t ContentLength(const std::string& header) {
+    static const char NAME[] = "content-length:";
+    const size_t nameSize = sizeof(NAME) - 1;
+    for (size_t line = header.find("\r\n"); line != std::string::npos; line = header.find("\r\n", line + 2)) {
+        size_t start = line + 2;
+        if (header.size() - start < nameSize) break;
+        bool match = true;
+        for (size_t i = 0; i < nameSize && match; ++i) {
+            match = std::tolower(static_cast<unsigned char>(header[start + i])) == NAME[i];
+        }
+        if (match) return std::strtoull(header.c_str() + start + nameSize, nullptr, 10);
+    }
+    return 0;
+}
+
+// 一个压测线程：独占epoll实例与connections个连接
+class Worker {
+public:
+    Worker(const LoadOptions& options, const std::vector<MixEntry>& mix, int connections, double rate,
+           uint64_t seed)
+        : options_(options), mix_(mix), rate_(rate), rng_(seed), connections_(connections) {
+        for (const auto& entry : mix_) totalWeight_ += entry.weight;
+    }
+
+    // 运行到deadline，measureAt之后完成的请求计入结果
+    void Run(clock_type::time_point measureAt, clock_type::time_point deadline) {
+        ep_ = epoll_create1(0);
+        for (auto& conn : connections_) Open(conn);
+        if (rate_ > 0) {
+            timer_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.u32 = TIMER_EVENT;
+            epoll_ctl(ep_, EPOLL_CTL_ADD, timer_, &ev);
+        }
+
+        auto start = clock_type::now();
+        uint64_t scheduled = 0;  // 开环：已到预定时间的请求数
+        uint64_t issued = 0;     // 开环：已发送的请求数
+        size_t next = 0;         // 开环：轮询分配请求的起始连接
+        if (rate_ <= 0) {
+            for (auto& conn : connections_) {
+                for (int i = 0; i < options_.pipeline && conn.fd >= 0; ++i) Issue(conn, clock_type::now());
+            }
+        }
+
+        std::vector<epoll_event> events(256);
+        while (true) {
+            auto now = clock_type::now();
+            if (now >= deadline) break;
+            measuring_ = now >= measureAt;
+
+            if (rate_ > 0) {
+                // 把到期的请求分配给有空闲流水线槽位的连接；分配不出去的继续排队(计时从预定时间开始)
+                auto elapsed = std::chrono::duration<double>(now - start).count();
+                scheduled = static_cast<uint64_t>(elapsed * rate_) + 1;
+                while (issued < scheduled) {
+                    Connection* target = nullptr;
+                    for (size_t i = 0; i < connections_.size() && !target; ++i) {
+                        Connection& conn = connections_[(next + i) % connections_.size()];
+                        if (conn.fd >= 0 && conn.sentAt.size() < static_cast<size_t>(options_.pipeline)) {
+                            target = &conn;
+                            next = (next + i + 1) % connections_.size();
+                        }
+                    }
+                    if (!target) break;
+                    Issue(*target, start + std::chrono::duration_cast<clock_type::duration>(
+                                               std::chrono::duration<double>(issued / rate_)));
+                    ++issued;
+                }
+                // 用timerfd在下一个请求的预定时间唤醒(纳秒精度，不忙等，压测线程不与服务端争抢CPU)
+                auto due = start + std::chrono::duration_cast<clock_type::duration>(
+                                       std::chrono::duration<double>(scheduled / rate_));
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(due.time_since_epoch()).count();
+                itimerspec spec{};
+                spec.it_value.tv_sec = static_cast<time_t>(ns / 1000000000);
+                spec.it_value.tv_nsec = static_cast<long>(ns % 1000000000);
+                timerfd_settime(timer_, TFD_TIMER_ABSTIME, &spec, nullptr);
+            }
+
+            int n = epoll_wait(ep_, events.data(), static_cast<int>(events.size()), 100);
+            for (int i = 0; i < n; ++i) {
+                if (events[i].data.u32 == TIMER_EVENT) {
+                    uint64_t expirations;
+                    (void)!read(timer_, &expirations, sizeof(expirations));
+                    continue;
+                }
+                Connection& conn = connections_[events[i].data.u32];
+                if (conn.fd < 0) continue;
+                if (events[i].events & EPOLLOUT) Flush(conn);
+                if (conn.fd >= 0 && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))) Receive(conn);
+            }
+        }
+
+        for (auto& conn : connections_) {
+            if (conn.fd >= 0) close(conn.fd);
+        }
+        if (timer_ >= 0) close(timer_);
+        close(ep_);
+    }
+
+    WorkerResult& Result() { return result_; }
+
+private:
+    // 建立连接并加入epoll
+    void Open(Connection& conn) {
+        conn.fd = Connect(options_);
+        if (conn.fd < 0) return;
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u32 = static_cast<uint32_t>(&conn - connections_.data());
+        epoll_ctl(ep_, EPOLL_CTL_ADD, conn.fd, &ev);
+    }
+
+    // 连接被断开：未完成的请求计为错误，然后重连(闭环时重新填满流水线)
+    void Reconnect(Connection& conn) {
+        if (measuring_) result_.errors += conn.sentAt.size();
+        close(conn.fd);
+        conn = Connection();
+        ++result_.reconnects;
+        Open(conn);
+        if (rate_ <= 0) {
+            for (int i = 0; i < options_.pipeline && conn.fd >= 0; ++i) Issue(conn, clock_type::now());
+        }
+    }
+
+    // 按权重随机选择一个请求并发送，计时起点为issuedAt
+    void Issue(Connection& conn, clock_type::time_point issuedAt) {
+        uint32_t pick = std::uniform_int_distribution<uint32_t>(0, totalWeight_ - 1)(rng_);
+        const MixEntry* entry = &mix_[0];
+        for (const auto& candidate : mix_) {
+            entry = &candidate;
+            if (pick < candidate.weight) break;
+            pick -= candidate.weight;
+        }
+        conn.sentAt.push_back(issuedAt);
+        bool idle = conn.outputOffset == conn.output.size();
+        conn.output.append(entry->request);
+        if (idle) Flush(conn);
+    }
+
+    // 尽量发送output中的数据，发不完时等待可写
+    void Flush(Connection& conn) {
+        while (conn.outputOffset < conn.output.size()) {
+            ssize_t n = send(conn.fd, conn.output.data() + conn.outputOffset,
+                             conn.output.size() - conn.outputOffset, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                shutdown(conn.fd, SHUT_RDWR);  // 由随后的可读事件完成重连(此时可能正在解析响应)
+                return;
+            }
+            conn.outputOffset += static_cast<size_t>(n);
+        }
+        bool pending = conn.outputOffset < conn.output.size();
+        if (!pending) {
+            conn.output.clear();
+            conn.outputOffset = 0;
+        }
+        epoll_event ev{};
+        ev.events = pending ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+        ev.data.u32 = static_cast<uint32_t>(&conn - connections_.data());
+        epoll_ctl(ep_, EPOLL_CTL_MOD, conn.fd, &ev);
+    }
+
+    // 读取并解析响应
+    void Receive(Connection& conn) {
+        char buffer[65536];
+        while (true) {
+            ssize_t n = recv(conn.fd, buffer, sizeof(buffer), 0);
+            if (n > 0) {
+                if (measuring_) result_.bytes += static_cast<uint64_t>(n);
+                if (!Consume(conn, buffer, static_cast<size_t>(n))) {
+                    Reconnect(conn);
+                    return;
+                }
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+            Reconnect(conn);
+            return;
+        }
+    }
+
+    // 增量解析响应：响应头攒齐后按Content-Length跳过响应体(不保存)，格式错误时返回false
+    bool Consume(Connection& conn, const char* data, size_t length) {
+        while (length > 0) {
+            if (conn.bodyRemaining > 0) {
+                size_t take = static_cast<size_t>(std::min<uint64_t>(conn.bodyRemaining, length));
+                conn.bodyRemaining -= take;
+                data += take;
+                length -= take;
+                if (conn.bodyRemaining == 0) Complete(conn);
+                continue;
+            }
+
+            size_t before = conn.header.size();
+            conn.header.append(data, length);
+            size_t end = conn.header.find("\r\n\r\n", before >= 3 ? before - 3 : 0);
+            if (end == std::string::npos) {
+                return conn.header.size() <= MAX_RESPONSE_HEADER;
+            }
+            size_t used = end + 4 - before;  // 本次数据中属于响应头的部分
+            data += used;
+            length -= used;
+            conn.header.resize(end + 4);
+            if (conn.header.compare(0, 5, "HTTP/") != 0 || conn.header.size() < 12) return false;
+            conn.status = std::atoi(conn.header.c_str() + 9);
+            conn.bodyRemaining = ContentLength(conn.header);
+            conn.header.clear();
+            if (conn.bodyRemaining == 0) Complete(conn);
+        }
+        return true;
+    }
+
+    // 一个响应接收完毕
+    void Complete(Connection& conn) {
+        if (conn.sentAt.empty()) return;  // 没有对应请求的响应(服务器行为异常)
+        auto now = clock_type::now();
+        if (measuring_) {
+            ++result_.completed;
+            if (conn.status < 200 || conn.status >= 400) ++result_.errors;
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - conn.sentAt.front()).count();
+            result_.latency.Record(ns > 0 ? static_cast<uint64_t>(ns) : 0);
+        }
+        conn.sentAt.pop_front();
+        if (rate_ <= 0) Issue(conn, now);
+    }
+
+    const LoadOptions& options_;
+    const std::vector<MixEntry>& mix_;
+    double rate_;                 // 本线程的开环速率(0表示闭环)
+    std::mt19937 rng_;
+    uint32_t totalWeight_ = 0;
+    std::vector<Connection> connections_;
+    int ep_ = -1;
+    int timer_ = -1;              // 开环：下一个请求预定时间的定时器(steady_clock即CLOCK_MONOTONIC)
+    bool measuring_ = false;      // 是否已过预热期
+    WorkerResult result_;
+};
+
+// 在临时目录中准备--server模式的文档根目录：1KB的index.html与64KB的asset.bin
+fs::path PrepareDocumentRoot() {
+    fs::path root = fs::temp_directory_path() / "bench_load_www";
+    fs::create_directories(root);
+    std::ofstream(root / "index.html", std::ios::binary) << std::string(1024, 'x');
+    std::ofstream(root / "asset.bin", std::ios::binary) << std::string(64 * 1024, 'y');
+    return root;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    LoadOptions options;
+    bool server = false;
+    std::string engine;
+    int serverThreads = 1;
+    std::string jsonPath;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--host=", 7) == 0) {
+            options.host = argv[i] + 7;
+        } else if (strncmp(argv[i], "--port=", 7) == 0) {
+            options.port = std::atoi(argv[i] + 7);
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            options.threads = std::max(1, std::atoi(argv[i] + 10));
+        } else if (strncmp(argv[i], "--connections=", 14) == 0) {
+            options.connections = std::max(1, std::atoi(argv[i] + 14));
+        } else if (strncmp(argv[i], "--pipeline=", 11) == 0) {
+            options.pipeline = std::max(1, std::atoi(argv[i] + 11));
+        } else if (strncmp(argv[i], "--seconds=", 10) == 0) {
+            options.seconds = std::atof(argv[i] + 10);
+        } else if (strncmp(argv[i], "--warmup=", 9) == 0) {
+            options.warmup = std::atof(argv[i] + 9);
+        } else if (strncmp(argv[i], "--rate=", 7) == 0) {
+            options.rate = std::atof(argv[i] + 7);
+        } else if (strncmp(argv[i], "--mix=", 6) == 0) {
+            options.mix = argv[i] + 6;
+        } else if (strncmp(argv[i], "--header=", 9) == 0) {
+            if (argv[i][9]) options.headers.append(argv[i] + 9).append("\r\n");
+        } else if (strcmp(argv[i], "--server") == 0) {
+            server = true;
+        } else if (strncmp(argv[i], "--engine=", 9) == 0) {
+            engine = argv[i] + 9;
+        } else if (strncmp(argv[i], "--server-threads=", 17) == 0) {
+            serverThreads = std::max(1, std::atoi(argv[i] + 17));
+        } else if (!ParseJsonFlag(argv[i], jsonPath)) {
+            std::cout << "Usage: " << argv[0]
+                      << " [--host=IP] [--port=P] [--threads=N] [--connections=N] [--pipeline=N]"
+                      << " [--seconds=S] [--warmup=S] [--rate=REQ_PER_SEC] [--mix=/path[:weight],...]"
+                      << " [--header='Name: value']..."
+                      << " [--server [--engine=NAME] [--server-threads=N]] [--json=FILE]" << std::endl;
+            return 1;
+        }
+    }
+    options.threads = std::min(options.threads, options.connections);
+
+    std::vector<MixEntry> mix;
+    if (!ParseMix(options.mix, options.host, options.headers, mix)) {
+        std::cerr << "Invalid --mix: " << options.mix << std::endl;
+        return 1;
+    }
+
+    // 进程内的服务器
+    fs::path root;
+    WebServer webServer;
+    if (server) {
+        root = PrepareDocumentRoot();
+        ServerConfig config;
+        config.port = options.port;
+        config.engine = engine;
+        config.threads = serverThreads;
+        config.documentRoot = root.string();
+        std::streambuf* out = std::cout.rdbuf(nullptr);  // 屏蔽服务器的启动日志
+        bool ok = webServer.Initialize(config);
+        std::cout.rdbuf(out);
+        if (!ok) {
+            std::cerr << "Failed to start the in-process server" << std::endl;
+            fs::remove_all(root);
+            return 1;
+        }
+    }
+
+    std::cout << "=== HTTP load (" << options.host << ":" << options.port << ", "
+              << options.threads << " threads, " << options.connections << " connections, pipeline "
+              << options.pipeline << ", ";
+    if (options.rate > 0) {
+        std::cout << "open loop " << options.rate << " req/s";
+    } else {
+        std::cout << "closed loop";
+    }
+    std::cout << ", " << options.seconds << "s after " << options.warmup << "s warmup, mix " << options.mix;
+    if (server) std::cout << ", in-process " << (engine.empty() ? "default" : engine) << " server";
+    std::cout << ") ===" << std::endl;
+
+    // 各线程均分连接与速率，共享同一个测量窗口
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int t = 0; t < options.threads; ++t) {
+        int connections = options.connections / options.threads + (t < options.connections % options.threads ? 1 : 0);
+        workers.push_back(std::make_unique<Worker>(options, mix, connections, options.rate / options.threads,
+                                                   static_cast<uint64_t>(t) + 1));
+    }
+    auto start = clock_type::now();
+    auto measureAt = start + std::chrono::duration_cast<clock_type::duration>(
+                                 std::chrono::duration<double>(options.warmup));
+    auto deadline = measureAt + std::chrono::duration_cast<clock_type::duration>(
+                                    std::chrono::duration<double>(options.seconds));
+    std::vector<std::thread> threads;
+    for (auto& worker : workers) {
+        threads.emplace_back([&worker, measureAt, deadline]() { worker->Run(measureAt, deadline); });
+    }
+    for (auto& thread : threads) thread.join();
+    double seconds = std::chrono::duration<double>(clock_type::now() - measureAt).count();
+
+    if (server) {
+        std::streambuf* out = std::cout.rdbuf(nullptr);
+        webServer.Stop();
+        std::cout.rdbuf(out);
+    }
+
+    // 合并各线程的结果
+    WorkerResult total;
+    HistogramSnapshot latency;
+    for (auto& worker : workers) {
+        total.completed += worker->Result().completed;
+        total.bytes += worker->Result().bytes;
+        total.errors += worker->Result().errors;
+        total.reconnects += worker->Result().reconnects;
+        latency.Add(worker->Result().latency);
+    }
+
+    auto us = [](uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+    double rps = total.completed / seconds;
+    double mbps = total.bytes / seconds / 1e6;
+    std::cout << std::right << std::setw(12) << "requests" << std::setw(12) << "req/s"
+              << std::setw(10) << "MB/s" << std::setw(8) << "errors"
+              << std::setw(10) << "p50(us)" << std::setw(10) << "p90(us)" << std::setw(10) << "p99(us)"
+              << std::setw(11) << "p99.9(us)" << std::setw(10) << "max(us)" << std::endl;
+    std::cout << std::setw(12) << total.completed << std::fixed << std::setprecision(0) << std::setw(12) << rps
+              << std::setprecision(1) << std::setw(10) << mbps << std::setw(8) << total.errors
+              << std::setw(10) << us(latency.Percentile(0.5)) << std::setw(10) << us(latency.Percentile(0.9))
+              << std::setw(10) << us(latency.Percentile(0.99)) << std::setw(11) << us(latency.Percentile(0.999))
+              << std::setw(10) << us(latency.Max()) << std::endl;
+    double bytesPerRequest = total.completed ? static_cast<double>(total.bytes) / total.completed : 0.0;
+    std::cout << "bytes/request: " << std::setprecision(0) << bytesPerRequest << std::endl;
+    if (total.reconnects > 0) std::cout << "reconnects: " << total.reconnects << std::endl;
+
+    JsonReport report("load");
+    report.Param("host", options.host);
+    report.Param("port", options.port);
+    report.Param("threads", options.threads);
+    report.Param("connections", options.connections);
+    report.Param("pipeline", options.pipeline);
+    report.Param("seconds", options.seconds);
+    report.Param("warmup", options.warmup);
+    report.Param("rate", options.rate);
+    report.Param("mix", options.mix);
+    report.Param("server", server ? (engine.empty() ? "default" : engine) : "external");
+    report.Row();
+    report.Set("requests", static_cast<double>(total.completed));
+    report.Set("requests_per_second", rps);
+    report.Set("megabytes_per_second", mbps);
+    report.Set("bytes_per_request", bytesPerRequest);
+    report.Set("errors", static_cast<double>(total.errors));
+    report.Set("reconnects", static_cast<double>(total.reconnects));
+    report.Set("p50_us", us(latency.Percentile(0.5)));
+    report.Set("p90_us", us(latency.Percentile(0.9)));
+    report.Set("p99_us", us(latency.Percentile(0.99)));
+    report.Set("p999_us", us(latency.Percentile(0.999)));
+    report.Set("max_us", us(latency.Max()));
+    report.Set("mean_us", latency.count ? us(latency.sum / latency.count) : 0.0);
+    bool written = report.Write(jsonPath);
+
+    if (server) fs::remove_all(root);
+    return written && total.completed > 0 ? 0 : 1;
+}
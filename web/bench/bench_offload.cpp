@@ -0,0 +1,257 @@
+// 计算线程池基准测试：慢速的图片上传与快速的GET混合时，GET的尾延迟
+//
+// 进程内的WebServer只用1个I/O线程，分别以内联(上传在I/O线程上处理)与线程池两种模式运行；
+// 若干上传线程持续POST大图片(服务端计算校验和)，若干GET线程在keep-alive连接上串行请求1KB的小文件，
+// 报告GET的p50/p99/p99.9与上传吞吐。内联模式下GET要排在正在处理的上传之后，尾延迟约等于一次上传的处理时间
+#include "metrics.hpp"
+#include "web_server.hpp"
+#include "bench_json.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// 测试参数
+struct OffloadOptions {
+    int port = 18090;
+    double seconds = 3;          // 每种模式的测量时长
+    int uploaders = 2;           // 上传线程数(各一个连接)
+    size_t uploadSize = 4 << 20; // 每次上传的字节数
+    int getters = 4;             // GET线程数(各一个连接)
+    int computeThreads = 2;      // 线程池模式的计算线程数
+    std::string engine;
+};
+
+// 一种模式的结果
+struct ModeResult {
+    uint64_t gets = 0;       // 完成的GET数
+    uint64_t uploads = 0;    // 完成的上传数
+    uint64_t errors = 0;     // 非200响应与连接错误
+    HistogramSnapshot latency;  // GET延迟(纳秒)
+};
+
+// 阻塞的keep-alive客户端：一次一个请求，读完整个响应
+class BlockingClient {
+public:
+    explicit BlockingClient(int port) {
+        fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (connect(fd_, (sockaddr*)&addr, sizeof(addr)) < 0) {
+            close(fd_);
+            fd_ = -1;
+            return;
+        }
+        int one = 1;
+        setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    ~BlockingClient() {
+        if (fd_ >= 0) close(fd_);
+    }
+
+    // 发送请求并读完响应，返回状态码(连接错误时为0)
+    int Request(const std::string& request) {
+        if (fd_ < 0) return 0;
+        for (size_t sent = 0; sent < request.size();) {
+            ssize_t n = send(fd_, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) return 0;
+            sent += static_cast<size_t>(n);
+        }
+        size_t end;
+        while ((end = buffer_.find("\r\n\r\n")) == std::string::npos) {
+            if (!Fill()) return 0;
+        }
+        int status = buffer_.size() > 12 ? std::atoi(buffer_.c_str() + 9) : 0;
+        size_t length = 0;
+        size_t field = buffer_.find("Content-Length:");
+        if (field != std::string::npos && field < end) length = std::strtoull(buffer_.c_str() + field + 15, nullptr, 10);
+        while (buffer_.size() < end + 4 + length) {
+            if (!Fill()) return 0;
+        }
+        buffer_.erase(0, end + 4 + length);
+        return status;
+    }
+
+private:
+    bool Fill() {
+        char chunk[16384];
+        ssize_t n = recv(fd_, chunk, sizeof(chunk), 0);
+        if (n <= 0) return false;
+        buffer_.append(chunk, static_cast<size_t>(n));
+        return true;
+    }
+
+    int fd_ = -1;
+    std::string buffer_;  // 已收到但尚未消费的响应数据
+};
+
+// 以给定的计算线程数(-1表示内联)运行一种模式
+bool RunMode(const OffloadOptions& options, const fs::path& root, int computeThreads, ModeResult& result) {
+    WebServer webServer;
+    ServerConfig config;
+    config.port = options.port;
+    config.engine = options.engine;
+    config.threads = 1;
+    config.computeThreads = computeThreads;
+    config.documentRoot = root.string();
+    std::streambuf* out = std::cout.rdbuf(nullptr);  // 屏蔽服务器的日志
+    bool ok = webServer.Initialize(config);
+    std::cout.rdbuf(out);
+    if (!ok) return false;
+
+    // 伪造的PNG：文件头之后填充随机字节
+    std::string image(options.uploadSize, '\0');
+    const char PNG[] = "\x89PNG\r\n\x1a\n";
+    std::copy(PNG, PNG + 8, image.begin());
+    for (size_t i = 8; i < image.size(); ++i) image[i] = static_cast<char>(i * 2654435761u >> 24);
+    const std::string upload = "POST /upload HTTP/1.1\r\nHost: localhost\r\nContent-Type: image/png\r\nContent-Length: " +
+                               std::to_string(image.size()) + "\r\n\r\n" + image;
+    const std::string get = "GET /index.html HTTP/1.1\r\nHost: localhost\r\n\r\n";
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> uploads{0};
+    std::atomic<uint64_t> errors{0};
+    std::vector<std::unique_ptr<LatencyHistogram>> histograms;
+    std::vector<uint64_t> gets(static_cast<size_t>(options.getters));
+    std::vector<std::thread> threads;
+    for (int i = 0; i < options.uploaders; ++i) {
+        threads.emplace_back([&]() {
+            BlockingClient client(options.port);
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (client.Request(upload) == 200) {
+                    uploads.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    errors.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                }
+            }
+        });
+    }
+    for (int i = 0; i < options.getters; ++i) {
+        histograms.push_back(std::make_unique<LatencyHistogram>());
+        threads.emplace_back([&, i]() {
+            BlockingClient client(options.port);
+            LatencyHistogram& histogram = *histograms[static_cast<size_t>(i)];
+            while (!stop.load(std::memory_order_relaxed)) {
+                auto start = clock_type::now();
+                if (client.Request(get) != 200) {
+                    errors.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                }
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - start).count();
+                histogram.Record(static_cast<uint64_t>(ns));
+                ++gets[static_cast<size_t>(i)];
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.seconds));
+    stop = true;
+    for (auto& thread : threads) thread.join();
+
+    out = std::cout.rdbuf(nullptr);
+    webServer.Stop();
+    std::cout.rdbuf(out);
+
+    result.uploads = uploads.load();
+    result.errors = errors.load();
+    for (int i = 0; i < options.getters; ++i) {
+        result.gets += gets[static_cast<size_t>(i)];
+        result.latency.Add(*histograms[static_cast<size_t>(i)]);
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    OffloadOptions options;
+    std::string jsonPath;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--port=", 7) == 0) {
+            options.port = std::atoi(argv[i] + 7);
+        } else if (strncmp(argv[i], "--seconds=", 10) == 0) {
+            options.seconds = std::atof(argv[i] + 10);
+        } else if (strncmp(argv[i], "--uploaders=", 12) == 0) {
+            options.uploaders = std::max(0, std::atoi(argv[i] + 12));
+        } else if (strncmp(argv[i], "--upload-size=", 14) == 0) {
+            options.uploadSize = std::max<size_t>(16, std::strtoull(argv[i] + 14, nullptr, 10));
+        } else if (strncmp(argv[i], "--getters=", 10) == 0) {
+            options.getters = std::max(1, std::atoi(argv[i] + 10));
+        } else if (strncmp(argv[i], "--compute-threads=", 18) == 0) {
+            options.computeThreads = std::max(1, std::atoi(argv[i] + 18));
+        } else if (strncmp(argv[i], "--engine=", 9) == 0) {
+            options.engine = argv[i] + 9;
+        } else if (!ParseJsonFlag(argv[i], jsonPath)) {
+            std::cout << "Usage: " << argv[0]
+                      << " [--port=P] [--seconds=S] [--uploaders=N] [--upload-size=BYTES] [--getters=N]"
+                      << " [--compute-threads=N] [--engine=NAME] [--json=FILE]" << std::endl;
+            return 1;
+        }
+    }
+
+    fs::path root = fs::temp_directory_path() / "bench_offload_www";
+    fs::create_directories(root);
+    std::ofstream(root / "index.html", std::ios::binary) << std::string(1024, 'x');
+
+    std::cout << "=== Upload offload (1 I/O thread, " << options.uploaders << " uploaders x "
+              << options.uploadSize / 1024 << "KB, " << options.getters << " GET connections, "
+              << options.seconds << "s per mode) ===" << std::endl;
+    std::cout << std::left << std::setw(12) << "mode" << std::right << std::setw(10) << "uploads/s"
+              << std::setw(10) << "GET/s" << std::setw(10) << "p50(us)" << std::setw(10) << "p99(us)"
+              << std::setw(11) << "p99.9(us)" << std::setw(10) << "max(us)" << std::setw(8) << "errors" << std::endl;
+
+    JsonReport report("offload");
+    report.Param("seconds", options.seconds);
+    report.Param("uploaders", options.uploaders);
+    report.Param("upload_size", static_cast<double>(options.uploadSize));
+    report.Param("getters", options.getters);
+    report.Param("engine", options.engine.empty() ? "default" : options.engine);
+
+    auto us = [](uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+    bool ok = true;
+    const std::pair<const char*, int> modes[] = {{"inline", -1}, {"pool", options.computeThreads}};
+    for (const auto& [name, computeThreads] : modes) {
+        ModeResult result;
+        if (!RunMode(options, root, computeThreads, result)) {
+            std::cerr << "Failed to start the in-process server" << std::endl;
+            ok = false;
+            break;
+        }
+        std::string mode = computeThreads < 0 ? name : std::string(name) + "(" + std::to_string(computeThreads) + ")";
+        std::cout << std::left << std::setw(12) << mode << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << result.uploads / options.seconds << std::setprecision(0)
+                  << std::setw(10) << result.gets / options.seconds
+                  << std::setw(10) << us(result.latency.Percentile(0.5))
+                  << std::setw(10) << us(result.latency.Percentile(0.99))
+                  << std::setw(11) << us(result.latency.Percentile(0.999))
+                  << std::setw(10) << us(result.latency.Max()) << std::setw(8) << result.errors << std::endl;
+        ok = ok && result.errors == 0 && result.gets > 0;
+
+        report.Row();
+        report.Set("mode", name);
+        report.Set("compute_threads", computeThreads);
+        report.Set("uploads_per_second", result.uploads / options.seconds);
+        report.Set("gets_per_second", result.gets / options.seconds);
+        report.Set("get_p50_us", us(result.latency.Percentile(0.5)));
+        report.Set("get_p99_us", us(result.latency.Percentile(0.99)));
+        report.Set("get_p999_us", us(result.latency.Percentile(0.999)));
+        report.Set("get_max_us", us(result.latency.Max()));
+        report.Set("errors", static_cast<double>(result.errors));
+    }
+    bool written = report.Write(jsonPath);
+
+    fs::remove_all(root);
+    return ok && written ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+// 响应头序列化基准测试：原来的BuildHttpHeader/BuildHttpResponse与ResponseWriter的ns/响应与堆分配次数
+//
+// 原实现(哈希表查状态文本、std::to_string、逐段拼接std::string)原样复制在下面作为基线；
+// ResponseWriter把状态行与响应头写入栈上的缓冲区，另外包含每秒格式化一次的Date头
+#include "response_writer.hpp"
+#include "bench_json.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <unordered_map>
+
+namespace {
+
+std::atomic<uint64_t> allocations{0};  // 堆分配次数
+
+using clock_type = std::chrono::steady_clock;
+
+// 原来的实现
+std::string LegacyBuildHttpHeader(uint64_t contentLength, const std::string& contentType, int statusCode = 200) {
+    static const std::unordered_map<int, std::string> statusTexts = {
+        {200, "OK"},
+        {400, "Bad Request"},
+        {404, "Not Found"},
+        {500, "Internal Server Error"}
+    };
+
+    std::string header;
+    header.reserve(128);
+    header += "HTTP/1.1 ";
+    header += std::to_string(statusCode);
+    header += ' ';
+    header += statusTexts.at(statusCode);
+    header += "\r\nContent-Type: ";
+    header += contentType;
+    header += "\r\nContent-Length: ";
+    header += std::to_string(contentLength);
+    header += "\r\nConnection: keep-alive\r\n\r\n";
+    return header;
+}
+
+std::string LegacyBuildHttpResponse(const std::string& content, const std::string& contentType, int statusCode = 200) {
+    std::string response = LegacyBuildHttpHeader(content.size(), contentType, statusCode);
+    response += content;
+    return response;
+}
+
+// ResponseWriter写入与WebServer相同的响应头
+void WriteHeader(ResponseWriter& writer, uint64_t contentLength, std::string_view contentType, int statusCode) {
+    writer.StatusLine(statusCode);
+    writer.Date();
+    writer.ContentType(contentType);
+    writer.ContentLength(contentLength);
+    writer.KeepAlive();
+    writer.End();
+}
+
+JsonReport report("response");  // JSON报告
+
+// 打印一行结果并记入JSON报告
+void Report(const char* name, size_t iterations, clock_type::duration elapsed, uint64_t allocs, size_t checksum) {
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    report.Row();
+    report.Set("case", name);
+    report.Set("ns_per_response", ns / iterations);
+    report.Set("allocations_per_response", static_cast<double>(allocs) / iterations);
+    report.Set("bytes", static_cast<double>(checksum / iterations));
+    std::cout << std::left << std::setw(30) << name
+              << std::right << std::setw(12) << std::fixed << std::setprecision(1) << ns / iterations
+              << std::setw(14) << std::setprecision(2) << static_cast<double>(allocs) / iterations
+              << std::setw(14) << checksum / iterations << std::endl;
+}
+
+// 计时运行body(返回每次生成的字节数)iterations次
+template <typename Body>
+void Run(const char* name, size_t iterations, Body body) {
+    size_t checksum = 0;
+    for (size_t i = 0; i < iterations / 10; ++i) checksum += body(i);  // 预热
+    checksum = 0;
+    uint64_t allocsBefore = allocations.load(std::memory_order_relaxed);
+    auto start = clock_type::now();
+    for (size_t i = 0; i < iterations; ++i) checksum += body(i);
+    auto elapsed = clock_type::now() - start;
+    Report(name, iterations, elapsed, allocations.load(std::memory_order_relaxed) - allocsBefore, checksum);
+}
+
+}
+
+// 统计全进程的堆分配
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+int main(int argc, char* argv[]) {
+    size_t iterations = 5000000;
+    std::string jsonPath;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--iterations=", 13) == 0) {
+            iterations = static_cast<size_t>(std::max(1LL, std::atoll(argv[i] + 13)));
+        } else if (!ParseJsonFlag(argv[i], jsonPath)) {
+            std::cout << "Usage: " << argv[0] << " [--iterations=N] [--json=FILE]" << std::endl;
+            return 1;
+        }
+    }
+
+    report.Param("iterations", static_cast<double>(iterations));
+    const std::string contentType = "application/javascript";
+    const std::string body = "File not found";
+
+    std::cout << "=== Response header serialization (" << iterations << " iterations) ===" << std::endl;
+    std::cout << std::left << std::setw(30) << "case"
+              << std::right << std::setw(12) << "ns/resp"
+              << std::setw(14) << "allocs/resp"
+              << std::setw(14) << "bytes" << std::endl;
+
+    // 响应头(文件零拷贝发送前的头部)
+    Run("legacy BuildHttpHeader", iterations, [&](size_t i) {
+        return LegacyBuildHttpHeader(100000 + i, contentType).size();
+    });
+    Run("writer header (stack)", iterations, [&](size_t i) {
+        char buffer[RESPONSE_HEADER_BUFFER];
+        ResponseWriter writer(buffer, sizeof(buffer));
+        WriteHeader(writer, 100000 + i, contentType, 200);
+        return writer.Size();
+    });
+
+    // 带内容的完整响应(错误页等)
+    Run("legacy BuildHttpResponse", iterations, [&](size_t) {
+        return LegacyBuildHttpResponse(body, "text/plain", 404).size();
+    });
+    Run("writer response (string)", iterations, [&](size_t) {
+        char buffer[RESPONSE_HEADER_BUFFER];
+        ResponseWriter writer(buffer, sizeof(buffer));
+        WriteHeader(writer, body.size(), "text/plain", 404);
+        std::string response;
+        response.reserve(writer.Size() + body.size());
+        response.append(writer.Data(), writer.Size());
+        response.append(body);
+        return response.size();
+    });
+
+    // Date头：缓存命中与每次格式化
+    Run("Date line (cached)", iterations, [](size_t) { return DateHeaderLine()->size(); });
+    Run("FormatHttpDate (uncached)", iterations, [](size_t i) {
+        char date[HTTP_DATE_SIZE];
+        FormatHttpDate(static_cast<std::time_t>(1700000000 + i), date);
+        return static_cast<size_t>(date[0] != 0) * HTTP_DATE_SIZE;
+    });
+    return report.Write(jsonPath) ? 0 : 1;
+}
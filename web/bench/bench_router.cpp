@@ -0,0 +1,173 @@
+// 路由分派与MIME查找基准测试
+//
+// mime：编译期完美哈希表(MimeType) 对比 原来的fs::path::extension()比较链
+// dispatch：WebServer的分派方式(内置端点查完美哈希表，其余走基数树) 对比 逐个比较路径的if链；
+// 路由表为WebServer的内置端点加一组典型的REST风格路由，请求路径按比例混合静态文件与各端点；
+// scale：64条运行时注册的精确路由，基数树对比逐条比较的线性表(路由数增长时线性表随之变慢)
+#include "router.hpp"
+#include "static_map.hpp"
+#include "mime.hpp"
+#include "bench_json.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// 原来的做法：每次比较都构造扩展名的fs::path
+std::string_view LegacyMimeType(std::string_view path) {
+    std::filesystem::path filePath(path);
+    if (filePath.extension() == ".html") return "text/html";
+    if (filePath.extension() == ".css") return "text/css";
+    if (filePath.extension() == ".js") return "application/javascript";
+    if (filePath.extension() == ".jpg" || filePath.extension() == ".jpeg") return "image/jpeg";
+    if (filePath.extension() == ".png") return "image/png";
+    return "text/plain";
+}
+
+// 内置端点(与WebServer相同的构建方式)
+struct Builtin {
+    HttpMethod method = HttpMethod::UNKNOWN;
+    int handler = 0;
+};
+constexpr auto BUILTIN = MakeStaticMap<Builtin>({
+    {"/upload", {HttpMethod::POST, 1}},
+    {"/metrics", {HttpMethod::UNKNOWN, 2}},
+    {"/healthz", {HttpMethod::GET, 3}},
+    {"/api/login", {HttpMethod::POST, 4}},
+    {"/api/logout", {HttpMethod::POST, 5}},
+    {"/api/users", {HttpMethod::GET, 6}},
+    {"/api/orders", {HttpMethod::GET, 7}},
+    {"/api/search", {HttpMethod::GET, 8}},
+});
+
+int Dispatch(const Router<int>& router, HttpMethod method, std::string_view path) {
+    const Builtin* builtin = BUILTIN.Find(path);
+    if (builtin && (builtin->method == HttpMethod::UNKNOWN || builtin->method == method)) return builtin->handler;
+    const int* handler = router.Match(method, path);
+    return handler ? *handler : 0;
+}
+
+// 对比：逐个比较的if链(新增端点时的直观写法)
+int LinearDispatch(HttpMethod method, std::string_view path) {
+    if (method == HttpMethod::POST && path == "/upload") return 1;
+    if (path == "/metrics") return 2;
+    if (method == HttpMethod::GET && path == "/healthz") return 3;
+    if (method == HttpMethod::POST && path == "/api/login") return 4;
+    if (method == HttpMethod::POST && path == "/api/logout") return 5;
+    if (method == HttpMethod::GET && path == "/api/users") return 6;
+    if (method == HttpMethod::GET && path == "/api/orders") return 7;
+    if (method == HttpMethod::GET && path == "/api/search") return 8;
+    if (method == HttpMethod::GET && path.compare(0, 11, "/api/users/") == 0) return 9;
+    if (method == HttpMethod::GET && path.compare(0, 12, "/api/orders/") == 0) return 10;
+    if (method == HttpMethod::GET && path.compare(0, 8, "/static/") == 0) return 11;
+    return 12;
+}
+
+template <typename F>
+double Measure(const std::vector<std::string>& paths, size_t rounds, uint64_t& checksum, F f) {
+    auto start = clock_type::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        for (const auto& path : paths) checksum += f(path);
+    }
+    return std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / (rounds * paths.size());
+}
+
+void Report(JsonReport& report, const char* name, double ns) {
+    report.Row();
+    report.Set("operation", name);
+    report.Set("ns_per_op", ns);
+    std::cout << std::left << std::setw(22) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(1) << ns << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t rounds = 200000;
+    std::string jsonPath;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--rounds=", 9) == 0) {
+            rounds = static_cast<size_t>(std::atoll(argv[i] + 9));
+        } else if (!ParseJsonFlag(argv[i], jsonPath)) {
+            std::cout << "Usage: " << argv[0] << " [--rounds=N] [--json=FILE]" << std::endl;
+            return 1;
+        }
+    }
+
+    const std::vector<std::string> paths = {
+        "/index.html", "/static/app.js", "/static/style.css", "/static/img/logo.png",
+        "/photos/cat.jpeg", "/favicon.ico", "/fonts/inter.woff2", "/README",
+        "/metrics", "/upload", "/api/users", "/api/users/42", "/api/orders/17", "/api/search",
+        "/healthz", "/docs/guide.html",
+    };
+
+    Router<int> router;
+    router.AddPrefix(HttpMethod::UNKNOWN, "/", 12);
+    router.AddPrefix(HttpMethod::GET, "/api/users/", 9);
+    router.AddPrefix(HttpMethod::GET, "/api/orders/", 10);
+    router.AddPrefix(HttpMethod::GET, "/static/", 11);
+
+    // 两种分派方式结果一致
+    for (const auto& path : paths) {
+        for (HttpMethod method : {HttpMethod::GET, HttpMethod::POST}) {
+            if (Dispatch(router, method, path) != LinearDispatch(method, path)) {
+                std::cout << "dispatch mismatch for " << path << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    std::cout << "=== Router benchmark (" << paths.size() << " paths x " << rounds << " rounds) ===" << std::endl;
+    std::cout << std::left << std::setw(22) << "operation" << std::right << std::setw(10) << "ns/op" << std::endl;
+    JsonReport report("router");
+    report.Param("paths", static_cast<double>(paths.size()));
+    report.Param("rounds", static_cast<double>(rounds));
+
+    uint64_t checksum = 0;
+    Report(report, "mime_legacy", Measure(paths, rounds / 10, checksum,
+                                          [](const std::string& p) { return LegacyMimeType(p).size(); }));
+    Report(report, "mime_static_map", Measure(paths, rounds, checksum,
+                                              [](const std::string& p) { return MimeType(p).size(); }));
+    Report(report, "dispatch_if_chain", Measure(paths, rounds, checksum, [](const std::string& p) {
+        return static_cast<size_t>(LinearDispatch(HttpMethod::GET, p));
+    }));
+    Report(report, "dispatch_router", Measure(paths, rounds, checksum, [&router](const std::string& p) {
+        return static_cast<size_t>(Dispatch(router, HttpMethod::GET, p));
+    }));
+
+    // 64条路由：基数树对比线性表，请求均匀命中各路由
+    const char* resources[] = {"users", "orders", "items", "carts", "invoices", "reports", "sessions", "tokens"};
+    const char* actions[] = {"list", "get", "create", "update", "delete", "search", "export", "stats"};
+    std::vector<std::pair<std::string, int>> table;
+    Router<int> scaled;
+    std::vector<std::string> scaledPaths;
+    for (const char* resource : resources) {
+        for (const char* action : actions) {
+            std::string path = std::string("/api/v1/") + resource + "/" + action;
+            int id = static_cast<int>(table.size()) + 1;
+            table.emplace_back(path, id);
+            scaled.Add(HttpMethod::GET, path, id);
+            scaledPaths.push_back(path);
+        }
+    }
+    Report(report, "scale64_linear", Measure(scaledPaths, rounds / 4, checksum, [&table](const std::string& p) {
+        for (const auto& [path, id] : table) {
+            if (path == p) return static_cast<size_t>(id);
+        }
+        return size_t(0);
+    }));
+    Report(report, "scale64_router", Measure(scaledPaths, rounds / 4, checksum, [&scaled](const std::string& p) {
+        const int* handler = scaled.Match(HttpMethod::GET, p);
+        return static_cast<size_t>(handler ? *handler : 0);
+    }));
+    std::cout << "checksum " << checksum << std::endl;
+    return report.Write(jsonPath) ? 0 : 1;
+}
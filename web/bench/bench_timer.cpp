@@ -0,0 +1,91 @@
+// 定时器轮基准测试：一百万个并发定时器的添加、重新调度、取消与到期
+//
+// 使用侵入式节点(与WebServer的连接超时相同)，不启动工作线程，手动推进tick；
+// 超时均匀分布在1秒到2小时之间，覆盖分层轮的各层
+#include "timer.hpp"
+#include "bench_json.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// 打印一行结果并记入JSON报告
+void Report(JsonReport& report, const char* name, size_t operations, clock_type::duration elapsed) {
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    report.Row();
+    report.Set("operation", name);
+    report.Set("count", static_cast<double>(operations));
+    report.Set("ns_per_op", ns / operations);
+    std::cout << std::left << std::setw(14) << name
+              << std::right << std::setw(12) << operations
+              << std::setw(12) << std::fixed << std::setprecision(1) << ns / operations
+              << std::setw(14) << std::setprecision(2) << operations / ns * 1000.0 << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = 1000000;
+    std::string jsonPath;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--timers=", 9) == 0) {
+            count = static_cast<size_t>(std::atoll(argv[i] + 9));
+        } else if (!ParseJsonFlag(argv[i], jsonPath)) {
+            std::cout << "Usage: " << argv[0] << " [--timers=N] [--json=FILE]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int64_t> dist(1000, 2 * 3600 * 1000);
+    std::vector<std::chrono::milliseconds> timeouts(count);
+    for (auto& timeout : timeouts) timeout = std::chrono::milliseconds(dist(rng));
+
+    TimerWheel timer(10ms);
+    std::vector<TimerNode> nodes(count);
+    size_t fired = 0;
+    for (auto& node : nodes) node.callback = [&fired]() { ++fired; };
+
+    std::cout << "=== Timer wheel benchmark (" << count << " concurrent timers, 1s-2h timeouts) ===" << std::endl;
+    std::cout << std::left << std::setw(14) << "operation"
+              << std::right << std::setw(12) << "count"
+              << std::setw(12) << "ns/op"
+              << std::setw(14) << "Mops/s" << std::endl;
+
+    JsonReport report("timer");
+    report.Param("timers", static_cast<double>(count));
+
+    // 添加
+    auto start = clock_type::now();
+    for (size_t i = 0; i < count; ++i) timer.Schedule(nodes[i], timeouts[i]);
+    Report(report, "schedule", count, clock_type::now() - start);
+
+    // 重新调度(连接活动时刷新超时)
+    start = clock_type::now();
+    for (size_t i = 0; i < count; ++i) timer.Schedule(nodes[i], timeouts[count - 1 - i]);
+    Report(report, "reschedule", count, clock_type::now() - start);
+
+    // 取消一半
+    start = clock_type::now();
+    for (size_t i = 0; i < count; i += 2) timer.Cancel(nodes[i]);
+    Report(report, "cancel", (count + 1) / 2, clock_type::now() - start);
+
+    // 推进到所有定时器到期
+    size_t remaining = timer.CountTasks();
+    uint64_t ticks = 2 * 3600 * 100 + 1;
+    start = clock_type::now();
+    timer.Advance(ticks);
+    auto elapsed = clock_type::now() - start;
+    Report(report, "expire", remaining, elapsed);
+    std::cout << "advanced " << ticks << " ticks in "
+              << std::chrono::duration<double, std::milli>(elapsed).count() << " ms, fired "
+              << fired << "/" << remaining << std::endl;
+    return report.Write(jsonPath) && fired == remaining && timer.CountTasks() == 0 ? 0 : 1;
+}
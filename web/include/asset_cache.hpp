@@ -0,0 +1,116 @@
+#ifndef ASSET_CACHE_HPP
+#define ASSET_CACHE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+// 静态资源缓存：以请求路径为键保存预先序列化的完整响应(状态行+头+内容)
+// 总内存受预算限制，超出时按CLOCK算法淘汰；
+// 索引是不可变的快照，插入与淘汰在互斥锁下复制索引、修改后发布新版本(只在未命中时发生)；
+// 每个事件循环通过自己的Reader持有一份快照，命中时只读取一次共享的版本号再做一次哈希查找，
+// 不加锁也不写共享的缓存行(键为string_view，查找不分配内存)，版本变化后才在锁下取新快照；
+// 距上次校验超过revalidateInterval时在锁外检查文件的mtime与大小(由源文件生成的项如预压缩文件还检查源文件的mtime)，
+// 文件被修改或删除后该项失效，下一次请求重新加载
+class AssetCache {
+private:
+    struct Entry;
+    using Index = std::unordered_map<std::string_view, std::shared_ptr<Entry>>;  // 键 -> 缓存项(发布后不再修改)
+
+public:
+    using Response = std::shared_ptr<const std::string>;  // 不可变的完整响应
+
+    // 读者：持有索引的快照，只由所属线程使用(每个事件循环一个)；
+    // 快照使被淘汰的项在读者下一次查找之前保持存活
+    class Reader {
+        friend class AssetCache;
+        std::shared_ptr<const Index> snapshot_;
+        uint64_t version_ = UINT64_MAX;  // 快照的版本(初始值保证第一次查找时获取)
+    };
+
+    // capacity: 内存预算(字节)，maxFileSize: 可缓存的最大文件
+    AssetCache(size_t capacity, size_t maxFileSize,
+               std::chrono::milliseconds revalidateInterval = 1s);
+
+    // 缓存项的文件元数据(用于生成ETag/Last-Modified；未编码时响应的最后size字节是文件内容)
+    struct FileInfo {
+        uint64_t size = 0;
+        std::filesystem::file_time_type mtime;
+        uint32_t coding = 0;  // 响应内容的编码(CODING_GZIP等，0表示原始内容)
+    };
+
+    // 查找，未命中或已失效时返回空(info非空时填入元数据)；命中与未命中由调用者计入各自线程的指标
+    Response Find(Reader& reader, std::string_view key, FileInfo* info = nullptr);
+    // 源文件：filePath由它生成(如预压缩的.gz/.br)时一并校验，源文件被修改或删除后该项同样失效
+    struct Source {
+        std::string path;  // 为空表示没有源文件
+        std::filesystem::file_time_type mtime;
+    };
+
+    Response Insert(std::string_view key,  // 插入(替换同名项)，必要时淘汰旧项
+                    const std::string& filePath,
+                    std::string response,
+                    uint64_t fileSize,
+                    std::filesystem::file_time_type mtime,
+                    uint32_t coding = 0,
+                    const Source& source = {});
+    Response Insert(std::string_view key,  // 插入已有的共享响应(同一响应可以挂在多个键上，各自计入内存)
+                    const std::string& filePath,
+                    Response response,
+                    uint64_t fileSize,
+                    std::filesystem::file_time_type mtime,
+                    uint32_t coding = 0,
+                    const Source& source = {});
+    void Invalidate(std::string_view key);  // 移除指定项
+    bool Cacheable(uint64_t fileSize) const;  // 文件是否适合缓存
+
+    // 统计信息
+    size_t Size() const;         // 缓存项数
+    size_t MemoryUsage() const;  // 已用内存(字节)
+    size_t Capacity() const { return capacity_; }
+    uint64_t Evictions() const { return evictions_.load(std::memory_order_relaxed); }
+
+private:
+    // 缓存项(发布后只有引用位与校验时间会被修改)
+    struct Entry {
+        std::string key;         // 请求路径(索引中的键指向它)
+        std::filesystem::path filePath;  // 文件路径(用于校验)
+        Response response;       // 完整响应
+        uint64_t fileSize;       // 缓存时的文件大小
+        std::filesystem::file_time_type mtime;  // 缓存时的修改时间
+        uint32_t coding;         // 响应内容的编码
+        std::filesystem::path sourcePath;  // 源文件路径(为空表示没有)
+        std::filesystem::file_time_type sourceMtime;  // 缓存时源文件的修改时间
+        size_t cost;             // 占用内存
+        size_t slot;             // 在CLOCK环中的位置(只在锁内访问)
+        std::atomic<bool> referenced;  // CLOCK引用位(命中时置位)
+        std::atomic<int64_t> checkedAt;  // 上次校验时间(毫秒)
+    };
+
+    void RemoveAt(Index& index, size_t slot);  // 删除环中指定位置的项(调用者持有锁)
+    void EvictFor(Index& index, size_t cost);  // 淘汰直到能容纳cost字节(调用者持有锁)
+    void Publish(std::shared_ptr<const Index> index);  // 发布新的索引(调用者持有锁)
+    static int64_t NowMs();       // 单调时钟(毫秒)
+
+    size_t capacity_;             // 内存预算
+    size_t maxFileSize_;          // 可缓存的最大文件
+    int64_t revalidateMs_;        // 校验间隔(毫秒)
+    std::vector<std::shared_ptr<Entry>> ring_;  // CLOCK环
+    std::shared_ptr<const Index> current_;  // 当前发布的索引
+    std::atomic<uint64_t> version_;  // 当前索引的版本(每次发布递增，读者据此判断快照是否过期)
+    size_t hand_;                 // CLOCK指针
+    size_t used_;                 // 已用内存
+    mutable std::mutex mutex_;    // 保护环、当前索引与内存统计(读者只在取新快照时获取)
+    std::atomic<uint64_t> evictions_;  // 淘汰次数
+};
+
+#endif
@@ -1,13 +1,28 @@
 #ifndef COMMON_HPP
 #define COMMON_HPP
 
+#ifdef _WIN32
 // 包含必要的Windows网络和系统头文件
 #include <winsock2.h>
 #include <windows.h>
 #include <ws2tcpip.h>
 #include <mswsock.h>
+#else
+// 包含必要的POSIX网络和系统头文件
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstring>
+#endif
 
 // 包含C++标准库头文件
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <string>
 #include <thread>
@@ -20,6 +35,7 @@
 #include <filesystem>
 #include <functional>
 
+#ifdef _WIN32
 // 针对MinGW和MSVC的不同链接设置
 #ifdef __MINGW32__
 #define LINK_WINSOCK
@@ -27,10 +43,116 @@
 #pragma comment(lib, "ws2_32.lib")  // 链接Winsock库
 #pragma comment(lib, "mswsock.lib")  // 链接微软扩展库
 #endif
+#else
+// 在POSIX平台上模拟Winsock的套接字类型和常量
+using SOCKET = int;
+const SOCKET INVALID_SOCKET = -1;
+const int SOCKET_ERROR = -1;
+
+// 关闭套接字
+inline int closesocket(SOCKET s) {
+    return ::close(s);
+}
+#endif
+
+// 只读文件句柄(用于零拷贝发送文件)
+#ifdef _WIN32
+using FileHandle = HANDLE;
+const FileHandle INVALID_FILE = INVALID_HANDLE_VALUE;
+
+// 打开文件并获取大小，失败返回INVALID_FILE
+inline FileHandle OpenFileForRead(const std::string& path, uint64_t& size) {
+    FileHandle file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                                  OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    LARGE_INTEGER fileSize;
+    if (file != INVALID_FILE && !GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        return INVALID_FILE;
+    }
+    if (file != INVALID_FILE) size = static_cast<uint64_t>(fileSize.QuadPart);
+    return file;
+}
+
+// 从文件的offset处读取size字节追加到out，失败返回false
+inline bool ReadFileContent(FileHandle file, uint64_t size, std::string& out, uint64_t offset = 0) {
+    size_t start = out.size();
+    out.resize(start + size);
+    uint64_t done = 0;
+    while (done < size) {
+        OVERLAPPED overlapped{};
+        overlapped.Offset = static_cast<DWORD>((offset + done) & 0xffffffffu);
+        overlapped.OffsetHigh = static_cast<DWORD>((offset + done) >> 32);
+        DWORD chunk = static_cast<DWORD>(std::min<uint64_t>(size - done, 1u << 30));
+        DWORD bytesRead = 0;
+        if (!ReadFile(file, &out[start + done], chunk, &bytesRead, &overlapped) || bytesRead == 0) {
+            out.resize(start);
+            return false;
+        }
+        done += bytesRead;
+    }
+    return true;
+}
+
+// 复制文件句柄(共享同一个打开的文件，各自关闭)，失败返回INVALID_FILE
+inline FileHandle DuplicateFile(FileHandle file) {
+    HANDLE copy = INVALID_FILE;
+    if (!DuplicateHandle(GetCurrentProcess(), file, GetCurrentProcess(), &copy, 0, FALSE, DUPLICATE_SAME_ACCESS)) {
+        return INVALID_FILE;
+    }
+    return copy;
+}
+
+// 关闭文件
+inline void CloseFile(FileHandle file) {
+    CloseHandle(file);
+}
+#else
+using FileHandle = int;
+const FileHandle INVALID_FILE = -1;
+
+// 打开文件并获取大小，失败返回INVALID_FILE
+inline FileHandle OpenFileForRead(const std::string& path, uint64_t& size) {
+    FileHandle file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (file != INVALID_FILE && (fstat(file, &st) < 0 || !S_ISREG(st.st_mode))) {
+        ::close(file);
+        return INVALID_FILE;
+    }
+    if (file != INVALID_FILE) size = static_cast<uint64_t>(st.st_size);
+    return file;
+}
+
+// 从文件的offset处读取size字节追加到out，失败返回false
+inline bool ReadFileContent(FileHandle file, uint64_t size, std::string& out, uint64_t offset = 0) {
+    size_t start = out.size();
+    out.resize(start + size);
+    uint64_t done = 0;
+    while (done < size) {
+        ssize_t n = ::pread(file, &out[start + done], size - done, static_cast<off_t>(offset + done));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            out.resize(start);
+            return false;
+        }
+        done += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+// 复制文件句柄(共享同一个打开的文件，各自关闭)，失败返回INVALID_FILE
+inline FileHandle DuplicateFile(FileHandle file) {
+    return ::fcntl(file, F_DUPFD_CLOEXEC, 0);
+}
+
+// 关闭文件
+inline void CloseFile(FileHandle file) {
+    ::close(file);
+}
+#endif
 
 // 获取默认线程数(CPU核心数*2，最小为4)
 inline int GetDefaultThreadCount() {
-    static const int count = std::thread::hardware_concurrency() > 0 ? 
+    static const int count = std::thread::hardware_concurrency() > 0 ?
                            std::thread::hardware_concurrency() * 2 : 4;
     return count;
 }
@@ -39,41 +161,33 @@ inline int GetDefaultThreadCount() {
 const int DEFAULT_PORT = 8080;
 // 缓冲区大小
 const int BUFFER_SIZE = 8192;
-// 最大并发连接数
+// 最大并发连接数(默认的连接上限，达到后暂停接受新连接)
 const int MAX_CONCURRENT = 2000;
+// 静态资源缓存的默认内存预算
+const size_t DEFAULT_CACHE_CAPACITY = 64 * 1024 * 1024;
+// 可缓存的最大文件(更大的文件零拷贝发送)
+const size_t MAX_CACHED_FILE_SIZE = 256 * 1024;
+// 小于此大小的文件不压缩(gzip头尾与块的开销抵消了收益)
+const size_t MIN_COMPRESS_SIZE = 256;
+// 不能缓存的可压缩文件在计算线程池上流式压缩的上限(更大的文件按原样零拷贝发送)
+const size_t MAX_STREAM_COMPRESS_SIZE = 16 * 1024 * 1024;
+// 流式压缩每次读取的输入大小
+const size_t COMPRESS_CHUNK_SIZE = 64 * 1024;
+// 连接发送队列的高低水位：超过高水位时暂停读取与处理流水线请求，回落到低水位以下时恢复
+const size_t OUTPUT_HIGH_WATER = 1024 * 1024;
+const size_t OUTPUT_LOW_WATER = 256 * 1024;
+// 接受的最大请求头(超过时以431拒绝)与默认的最大请求体(超过时以413拒绝)
+const size_t MAX_REQUEST_HEADER = 64 * 1024;
+const size_t DEFAULT_MAX_REQUEST_BODY = 32 * 1024 * 1024;
+// 默认连接超时：空闲、读取请求头、读取请求体
+const std::chrono::milliseconds DEFAULT_IDLE_TIMEOUT = std::chrono::seconds(60);
+const std::chrono::milliseconds DEFAULT_HEADER_TIMEOUT = std::chrono::seconds(10);
+const std::chrono::milliseconds DEFAULT_BODY_TIMEOUT = std::chrono::seconds(30);
+// 过载保护：事件循环延迟(请求的排队时间)或请求处理时间的滑动平均超过阈值时，以503拒绝新请求
+const std::chrono::milliseconds DEFAULT_SHED_QUEUE_DELAY = std::chrono::milliseconds(100);
+const std::chrono::milliseconds DEFAULT_SHED_SERVICE_TIME = std::chrono::milliseconds(50);
 
-// I/O操作类型枚举
-enum class IoOperation { ACCEPT, RECV, SEND };
-
-// 每个I/O操作的数据结构
-struct PerIoData {
-    OVERLAPPED overlapped;  // Windows重叠I/O结构
-    WSABUF wsaBuf;          // Winsock缓冲区结构
-    IoOperation operation;  // 操作类型
-    SOCKET socket;          // 关联的套接字
-    char buffer[BUFFER_SIZE]; // 数据缓冲区
-    
-    // 默认构造函数
-    PerIoData() {
-        ZeroMemory(&overlapped, sizeof(OVERLAPPED));  // 清空重叠结构
-        wsaBuf.len = sizeof(buffer);  // 设置缓冲区长度
-        wsaBuf.buf = buffer;          // 设置缓冲区指针
-    }
-    
-    // 带参数的构造函数
-    PerIoData(SOCKET s, IoOperation op) : PerIoData() {
-        socket = s;      // 设置套接字
-        operation = op;  // 设置操作类型
-    }
-    
-    // 带数据初始化的构造函数
-    PerIoData(SOCKET s, IoOperation op, const std::string& data) : PerIoData(s, op) {
-        size_t copySize = std::min(data.size(), sizeof(buffer));  // 计算可拷贝大小
-        memcpy(buffer, data.data(), copySize);  // 拷贝数据
-        wsaBuf.len = static_cast<ULONG>(copySize);  // 设置实际数据长度
-    }
-};
-
+#ifdef _WIN32
 // 打印Windows错误信息
 inline void PrintWindowsError(DWORD errorCode) {
     LPSTR messageBuffer = nullptr;
@@ -86,7 +200,7 @@ inline void PrintWindowsError(DWORD errorCode) {
         (LPSTR)&messageBuffer,
         0,
         nullptr);
-    
+
     if (messageBuffer) {
         std::cerr << messageBuffer;  // 输出错误信息
         LocalFree(messageBuffer);    // 释放缓冲区
@@ -95,5 +209,6 @@ inline void PrintWindowsError(DWORD errorCode) {
     }
     std::cerr << std::endl;
 }
+#endif
 
-#endif
\ No newline at end of file
+#endif
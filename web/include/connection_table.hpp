@@ -0,0 +1,130 @@
+#ifndef CONNECTION_TABLE_HPP
+#define CONNECTION_TABLE_HPP
+
+#include "common.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// 连接句柄：套接字加上槽位的代数；fd关闭后被新连接复用时代数不同，旧句柄随之失效
+struct ConnectionHandle {
+    SOCKET socket = INVALID_SOCKET;
+    uint32_t generation = 0;
+
+    // 打包为64位(低32位为fd，其上24位为代数，最高8位留给调用者，如io_uring的操作类型)
+    uint64_t Pack() const { return (static_cast<uint64_t>(generation) << 32) | static_cast<uint32_t>(socket); }
+    static ConnectionHandle Unpack(uint64_t packed) {
+        return {static_cast<SOCKET>(packed & 0xffffffffu), static_cast<uint32_t>(packed >> 32) & GENERATION_MASK};
+    }
+
+    static constexpr uint32_t GENERATION_MASK = 0xffffff;  // 代数只保留24位
+};
+
+// 按fd下标的连接表：取代以套接字为键的哈希表，查找只是一次下标计算加一次访问，没有哈希与链表跳转，
+// 相邻fd的连接状态在内存中也相邻；每个槽位带代数，Insert时加一，
+// 持有旧句柄的完成事件、待处理列表等可以识别出fd已被复用并丢弃；
+// 槽位按页分配(每页PAGE_SLOTS个)，扩容时已有槽位不移动，回调期间持有的引用保持有效；
+// 不加锁，由所属线程访问(跨线程使用时由调用者加锁)
+template <typename T>
+class ConnectionTable {
+public:
+    static constexpr size_t PAGE_BITS = 10;
+    static constexpr size_t PAGE_SLOTS = size_t(1) << PAGE_BITS;  // 每页的槽位数
+
+    ConnectionTable() = default;
+    ConnectionTable(const ConnectionTable&) = delete;
+    ConnectionTable& operator=(const ConnectionTable&) = delete;
+
+    // 占用套接字的槽位，值重置为T()，代数加一
+    T& Insert(SOCKET socket) {
+        Slot& slot = SlotAt(IndexOf(socket));
+        if (!slot.used) ++size_;
+        slot.used = true;
+        slot.generation = slot.generation % ConnectionHandle::GENERATION_MASK + 1;  // 1 ~ GENERATION_MASK，0表示无连接
+        slot.value = T();
+        return slot.value;
+    }
+
+    // 查找套接字当前的连接，不存在时返回nullptr
+    T* Find(SOCKET socket) {
+        Slot* slot = Lookup(socket);
+        return slot && slot->used ? &slot->value : nullptr;
+    }
+
+    // 按句柄查找：fd已关闭或已被新连接复用时返回nullptr
+    T* Find(ConnectionHandle handle) {
+        Slot* slot = Lookup(handle.socket);
+        return slot && slot->used && slot->generation == handle.generation ? &slot->value : nullptr;
+    }
+
+    // 套接字当前连接的句柄(套接字不在表中时代数为0，不匹配任何连接)
+    ConnectionHandle Handle(SOCKET socket) {
+        Slot* slot = Lookup(socket);
+        return {socket, slot && slot->used ? slot->generation : 0};
+    }
+
+    // 移除连接：值重置为T()(释放其资源)，槽位保留代数供下次复用；不存在时返回false
+    bool Erase(SOCKET socket) {
+        Slot* slot = Lookup(socket);
+        if (!slot || !slot->used) return false;
+        slot->used = false;
+        slot->value = T();
+        --size_;
+        return true;
+    }
+
+    size_t Size() const { return size_; }
+    bool Empty() const { return size_ == 0; }
+
+    // 按fd顺序访问所有连接，f(SOCKET, T&)中可以移除当前连接
+    template <typename F>
+    void ForEach(F f) {
+        for (size_t page = 0; page < pages_.size() && size_ > 0; ++page) {
+            if (!pages_[page]) continue;
+            for (size_t i = 0; i < PAGE_SLOTS; ++i) {
+                Slot& slot = pages_[page][i];
+                if (slot.used) f(SocketOf((page << PAGE_BITS) | i), slot.value);
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        T value{};
+        uint32_t generation = 0;  // 每次Insert加一(跳过0)
+        bool used = false;        // 是否有连接
+    };
+
+    // 套接字对应的下标：Linux上就是fd(内核总是分配最小的空闲fd，天然稠密)；
+    // Windows的SOCKET是内核句柄，值为4的倍数，同样从句柄表中复用较小的值
+#ifdef _WIN32
+    static size_t IndexOf(SOCKET socket) { return static_cast<size_t>(socket) >> 2; }
+    static SOCKET SocketOf(size_t index) { return static_cast<SOCKET>(index << 2); }
+#else
+    static size_t IndexOf(SOCKET socket) { return static_cast<size_t>(socket); }
+    static SOCKET SocketOf(size_t index) { return static_cast<SOCKET>(index); }
+#endif
+
+    // 下标对应的槽位(按需分配所在的页)
+    Slot& SlotAt(size_t index) {
+        size_t page = index >> PAGE_BITS;
+        if (page >= pages_.size()) pages_.resize(page + 1);
+        if (!pages_[page]) pages_[page].reset(new Slot[PAGE_SLOTS]);
+        return pages_[page][index & (PAGE_SLOTS - 1)];
+    }
+
+    // 已分配的槽位(所在页尚未分配时返回nullptr)
+    Slot* Lookup(SOCKET socket) {
+        if (socket == INVALID_SOCKET) return nullptr;
+        size_t index = IndexOf(socket);
+        size_t page = index >> PAGE_BITS;
+        if (page >= pages_.size() || !pages_[page]) return nullptr;
+        return &pages_[page][index & (PAGE_SLOTS - 1)];
+    }
+
+    std::vector<std::unique_ptr<Slot[]>> pages_;  // 槽位页(按需分配)
+    size_t size_ = 0;                              // 连接数
+};
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef CONTENT_CODING_HPP
+#define CONTENT_CODING_HPP
+
+#include <cstdint>
+#include <string_view>
+
+// 内容编码(位掩码，可组合表示客户端接受的集合)
+const uint32_t CODING_GZIP = 1;
+const uint32_t CODING_BR = 2;
+
+// 解析Accept-Encoding，返回客户端接受的编码集合：q=0表示拒绝，"*"匹配未单独列出的编码，
+// "x-gzip"等同于gzip；不按q值排序(接受多种时由服务器选择更小的表示)
+uint32_t AcceptedCodings(std::string_view header);
+
+// Content-Encoding的值("gzip"/"br")，也用作ETag的后缀；identity(0)为空
+std::string_view CodingName(uint32_t coding);
+// 预压缩文件的扩展名(".gz"/".br")
+std::string_view CodingExtension(uint32_t coding);
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef CORO_HPP
+#define CORO_HPP
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <utility>
+
+// 协程帧池：协程帧按64字节分级，释放的帧挂在当前线程的空闲表上供下次复用(帧的第一个字存放链表指针)，
+// 稳态下创建协程不访问堆；超过MAX_POOLED_FRAME的帧直接从堆分配
+// 每个线程一组空闲表，不加锁：连接的协程只在所属事件循环线程上创建与销毁；
+// 在其他线程上释放的帧进入那个线程的空闲表，线程退出时归还给堆
+class FramePool {
+public:
+    static constexpr size_t GRANULARITY = 64;        // 分级粒度
+    static constexpr size_t MAX_POOLED_FRAME = 4096;  // 池化的最大帧
+
+    static void* Allocate(size_t size);                   // 分配协程帧
+    static void Release(void* frame, size_t size) noexcept;  // 释放协程帧(size与分配时相同)
+
+    static uint64_t Allocations();      // 当前线程累计分配的帧数
+    static uint64_t HeapAllocations();  // 其中从堆分配的帧数(空闲表为空或帧过大)
+};
+
+template <typename T = void>
+class Task;
+
+// Task的promise公共部分：帧从FramePool分配；创建后挂起，由co_await或Start开始执行；
+// 结束时对称转移到等待者(没有等待者时挂起，由持有者销毁)，嵌套调用不增长调用栈
+struct TaskPromiseBase {
+    std::coroutine_handle<> continuation;  // co_await本任务的协程
+    std::exception_ptr exception;          // 未捕获的异常(在co_await处重新抛出)
+
+    static void* operator new(size_t size) { return FramePool::Allocate(size); }
+    static void operator delete(void* frame, size_t size) noexcept { FramePool::Release(frame, size); }
+
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> self) noexcept {
+            std::coroutine_handle<> next = self.promise().continuation;
+            return next ? next : std::noop_coroutine();
+        }
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() { exception = std::current_exception(); }
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase {
+    std::optional<T> value;  // 返回值
+
+    Task<T> get_return_object();
+    template <typename U>
+    void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+    T Result() {
+        if (exception) std::rethrow_exception(exception);
+        return std::move(*value);
+    }
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object();
+    void return_void() const noexcept {}
+    void Result() const {
+        if (exception) std::rethrow_exception(exception);
+    }
+};
+
+// 惰性协程任务：co_await时才开始执行，完成后返回结果(或重新抛出异常)；
+// 独占协程帧，析构时销毁(连同它正在等待的子任务)
+template <typename T>
+class [[nodiscard]] Task {
+public:
+    using promise_type = TaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() = default;
+    explicit Task(Handle handle) : handle_(handle) {}
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() {
+        if (handle_) handle_.destroy();
+    }
+
+    explicit operator bool() const { return static_cast<bool>(handle_); }
+    bool Done() const { return !handle_ || handle_.done(); }
+    // 作为顶层任务开始执行(运行到第一个挂起点返回)
+    void Start() { handle_.resume(); }
+    // 顶层任务结束后的异常(没有时为空)
+    std::exception_ptr Exception() const { return handle_ ? handle_.promise().exception : nullptr; }
+
+    // co_await：记录等待者后直接转移到本任务
+    bool await_ready() const noexcept { return !handle_ || handle_.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+        handle_.promise().continuation = caller;
+        return handle_;
+    }
+    T await_resume() { return handle_.promise().Result(); }
+
+private:
+    Handle handle_;
+};
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef CORO_SERVER_HPP
+#define CORO_SERVER_HPP
+
+#include "common.hpp"
+#include "io_engine.hpp"
+#include "http_parser.hpp"
+#include "object_pool.hpp"
+#include "connection_table.hpp"
+#include "coro.hpp"
+
+class CoConnection;
+
+// 连接处理器：每个新连接调用一次，返回的协程在连接所属的事件循环上运行，
+// 通常循环co_await ReadRequest()直到返回nullptr；协程结束时连接被关闭
+using CoHandler = std::function<Task<>(CoConnection&)>;
+
+// 协程服务器配置
+struct CoServerConfig {
+    int port = DEFAULT_PORT;  // 监听端口
+    std::string engine;       // I/O引擎名称(为空时使用平台默认引擎)
+    int threads = 0;          // I/O线程数(0表示默认值)
+    std::chrono::milliseconds idleTimeout = DEFAULT_IDLE_TIMEOUT;  // 没有收发进展的期限
+    size_t maxConnections = MAX_CONCURRENT;  // 并发连接上限(0表示不限制)
+};
+
+// 协程连接：把引擎的回调转换为可co_await的操作，每个连接同一时刻最多有一个操作在等待
+// - co_await ReadRequest()：下一个请求(const HttpRequest*，请求头中的string_view在下一次ReadRequest前有效)；
+//   连接关闭或请求格式错误时为nullptr(格式错误时连接随之关闭)；上一个请求未读完的请求体被跳过
+// - co_await ReadBody()：当前请求体的下一段(string_view，只在下一次co_await前有效)，读完或连接关闭时为空；
+//   数据到达时若协程正在等待，直接交出引擎接收缓冲区中的数据，不复制
+// - co_await Send(...)/SendFile(...)：数据立即交给引擎，发送队列超过高水位时挂起到回落以后，
+//   返回连接是否仍然打开；没有背压时不挂起
+// 等待体都是栈上的小对象，co_await不分配内存；对象由服务器的池管理，协程结束前保持有效
+// 注意：GCC 12会错误编译以co_await表达式直接作为if/while条件的协程(整个协程体不执行)，
+// 先把结果存入变量(或在while条件中声明变量)再判断
+class CoConnection {
+public:
+    struct [[nodiscard]] RequestAwaiter {
+        CoConnection& conn;
+        bool await_ready() { return conn.TryReadRequest(); }
+        void await_suspend(std::coroutine_handle<> handle) { conn.Suspend(Wait::REQUEST, handle); }
+        const HttpRequest* await_resume() const { return conn.request_; }
+    };
+
+    struct [[nodiscard]] BodyAwaiter {
+        CoConnection& conn;
+        bool await_ready() { return conn.TryReadBody(); }
+        void await_suspend(std::coroutine_handle<> handle) { conn.Suspend(Wait::BODY, handle); }
+        std::string_view await_resume() const { return conn.chunk_; }
+    };
+
+    struct [[nodiscard]] SendAwaiter {
+        CoConnection& conn;
+        bool await_ready() const { return !conn.open_ || !conn.engine_->Backpressured(conn.socket_); }
+        void await_suspend(std::coroutine_handle<> handle) { conn.Suspend(Wait::SEND, handle); }
+        bool await_resume() const { return conn.open_; }
+    };
+
+    RequestAwaiter ReadRequest() { return {*this}; }
+    BodyAwaiter ReadBody() { return {*this}; }
+    SendAwaiter Send(std::string data);
+    SendAwaiter Send(SharedBuffer data);
+    SendAwaiter SendFile(FileHandle file, uint64_t offset, uint64_t length);  // 接管file的所有权
+    void Close();  // 关闭连接(等待中的操作随后以连接关闭的结果返回)
+
+    bool Open() const { return open_; }
+    SOCKET Socket() const { return socket_; }
+    size_t Loop() const { return loop_; }
+    uint64_t BodyRemaining() const { return bodyRemaining_; }  // 当前请求体尚未读取的字节数
+
+private:
+    friend class CoServer;
+
+    // 协程正在等待的操作
+    enum class Wait : uint8_t { NONE, REQUEST, BODY, SEND };
+
+    void Reset(IoEngine* engine, SOCKET socket, size_t loop);  // 从池中取出后初始化
+    void Suspend(Wait wait, std::coroutine_handle<> handle) {
+        wait_ = wait;
+        waiter_ = handle;
+    }
+    bool TryReadRequest();   // 尝试解析下一个请求头，可以返回时为true
+    bool TryReadBody();      // 尝试取出下一段请求体，可以返回时为true
+    void FinishRequest();    // 跳过当前请求未读的请求体，把后续数据并回input_
+    bool Receive(const char* data, size_t length);  // 收到数据，返回是否应恢复协程
+    std::string_view TakeBuffered(uint64_t limit);  // 从已缓冲的未读数据中取出最多limit字节
+
+    IoEngine* engine_ = nullptr;
+    SOCKET socket_ = INVALID_SOCKET;
+    size_t loop_ = 0;
+    Task<> task_;                       // 处理器协程
+    std::coroutine_handle<> waiter_;    // 等待中的协程(可能是task_调用的子任务)
+    Wait wait_ = Wait::NONE;
+    bool open_ = false;                 // 未请求关闭
+    bool closed_ = false;               // 引擎已关闭连接(OnClose)
+    HttpParser parser_;                 // 请求头解析器
+    const HttpRequest* request_ = nullptr;  // 当前请求(nullptr表示正在等待下一个请求头)
+    std::string input_;                 // 接收缓冲区：[head_, inputOffset_)为当前请求头与已读的请求体
+    size_t head_ = 0;                   // 当前请求在input_中的起始偏移
+    size_t inputOffset_ = 0;            // input_中第一个未读字节(当前请求期间)
+    std::string pending_;               // 当前请求期间收到的数据(不追加到input_，请求头的视图保持有效)
+    size_t pendingOffset_ = 0;          // pending_中第一个未读字节
+    uint64_t bodyRemaining_ = 0;        // 当前请求体尚未交给处理器的字节数
+    uint64_t discard_ = 0;              // 尚未到达、需要丢弃的请求体字节数(处理器没有读完请求体)
+    std::string_view chunk_;            // ReadBody的结果
+    TimerNode timeout_;                 // 空闲超时
+};
+
+// 协程服务器：实现IoHandler，把每个连接交给一个处理器协程；
+// 回调、定时器与协程都在连接所属的事件循环线程上执行，按循环分片的状态无需加锁
+class CoServer : public IoHandler {
+public:
+    CoServer() = default;
+    ~CoServer();
+
+    bool Initialize(const CoServerConfig& config, CoHandler handler);  // 创建引擎并开始接受连接
+    void Stop();  // 停止引擎并关闭所有连接
+    IoEngine* Engine() const { return engine_.get(); }
+
+    // IoHandler回调
+    void OnAccept(size_t loop, SOCKET socket) override;
+    void OnRecv(size_t loop, SOCKET socket, const char* data, size_t length) override;
+    void OnSend(size_t loop, SOCKET socket, size_t bytesSent) override;
+    void OnClose(size_t loop, SOCKET socket) override;
+
+private:
+    // 分片：每个事件循环一份连接表与连接对象池
+    struct Shard {
+        ConnectionTable<CoConnection*> connections;
+        ObjectPool<CoConnection, 16> pool;
+    };
+
+    void Resume(size_t loop, CoConnection& conn);  // 恢复等待中的协程
+    void Settle(size_t loop, CoConnection& conn);  // 协程运行后：已结束则关闭连接或归还对象
+
+    std::unique_ptr<IoEngine> engine_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    CoHandler handler_;
+    std::chrono::milliseconds idleTimeout_{DEFAULT_IDLE_TIMEOUT};
+};
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef EPOLL_ENGINE_HPP
+#define EPOLL_ENGINE_HPP
+
+#include "io_engine.hpp"
+#include "connection_table.hpp"
+#include <memory>
+
+// 基于边缘触发epoll的I/O引擎(Linux)
+// 每个I/O线程拥有独立的epoll实例，连接归属于接受它的线程；
+// Send只把数据放入连接的发送队列，每轮事件处理完后用一次sendmsg聚合写出(支持流水线)，
+// 文件段用sendfile直接从页缓存发送，EAGAIN后在下一次可写事件时从断点继续；
+// 发送队列超过高水位时停止读取该连接，回落到低水位以下后在本轮末尾主动恢复读取；
+// 每个循环拥有自己的定时器轮，epoll_wait的超时取自最近的到期时间，空闲时无限期休眠；
+// Post把任务放入循环的投递队列并写eventfd唤醒它，循环在处理唤醒事件时执行；
+// 连接数达到本循环的上限时停止accept(边缘触发下不再收到通知)，有连接关闭后在本轮末尾主动恢复；
+// 连接按fd下标存放在ConnectionTable中，epoll事件与待处理列表带连接的代数，fd被复用后的陈旧事件直接丢弃；
+// reusePort模式下每个线程还拥有独立的SO_REUSEPORT监听套接字并绑定到CPU核心
+class EpollEngine : public IoEngine {
+public:
+    EpollEngine();
+    ~EpollEngine() override;
+
+    const char* Name() const override { return "epoll"; }
+    bool Initialize(const IoEngineOptions& options, IoHandler* handler) override;
+    void Start() override;
+    void Stop() override;
+    size_t ThreadCount() const override { return loops_.size(); }
+    size_t LoopCount() const override { return loops_.size(); }
+    uint64_t SyscallCount() const override;
+    uint64_t AcceptPauseCount() const override;
+
+    void Send(SOCKET socket, std::string data) override;
+    void Send(SOCKET socket, SharedBuffer data) override;
+    void Send(SOCKET socket, SharedBuffer data, size_t offset, size_t length) override;
+    void SendFile(SOCKET socket, FileHandle file, uint64_t offset, uint64_t length) override;
+    void Close(SOCKET socket) override;
+    void CloseAfterSend(SOCKET socket) override;
+    bool Backpressured(SOCKET socket) override;
+    void Post(size_t loop, std::function<void()> task) override;
+    TimerWheel& Timers(size_t loop) override;
+
+private:
+    // 连接状态
+    struct Connection {
+        OutputQueue output;              // 待发送数据队列
+        size_t offset = 0;               // 队首内存数据已发送的字节数
+        size_t pending = 0;              // 本轮发送完成前已写出的字节数
+        uint64_t queued = 0;             // 队列中待发送的字节数(含文件段)
+        bool writable = true;            // 上次写出未遇到EAGAIN(否则等待EPOLLOUT)
+        bool flushQueued = false;        // 是否已加入本轮的待刷新列表
+        bool paused = false;             // 发送队列超过高水位，暂停读取
+        bool closeAfterSend = false;     // 发送队列写完后关闭
+    };
+
+    // 事件循环(每个I/O线程一个)
+    struct Loop {
+        size_t index = 0;   // 事件循环编号
+        SOCKET listenSocket = INVALID_SOCKET;  // 监听套接字(共享或独立)
+        int epollFd = -1;   // epoll实例
+        int wakeFd = -1;    // 用于唤醒的eventfd
+        std::thread thread; // I/O线程
+        ConnectionTable<Connection> connections;  // 本线程拥有的连接(按fd下标)
+        std::vector<ConnectionHandle> flushList;   // 本轮有新数据待写出的连接
+        std::vector<ConnectionHandle> resumeList;  // 本轮解除背压、需要恢复读取的连接
+        std::vector<ConnectionHandle> resuming;    // 正在恢复读取的连接(与resumeList交换，避免分配)
+        TimerWheel timers;  // 本循环的定时器(决定epoll_wait的超时)
+        std::mutex postMutex;  // 保护posted(其他线程投递任务)
+        std::vector<std::function<void()>> posted;   // 其他线程投递的任务
+        std::vector<std::function<void()>> running;  // 正在执行的任务(与posted交换，避免分配)
+        bool acceptPaused = false;  // 连接数达到上限，暂停accept
+        bool resumeAccept = false;  // 暂停后有连接关闭，本轮末尾恢复accept
+        std::atomic<uint64_t> syscalls{0};      // 系统调用计数(仅本线程写入)
+        std::atomic<uint64_t> acceptPauses{0};  // 暂停accept的次数(仅本线程写入)
+        char buffer[BUFFER_SIZE];  // 读缓冲区(所有连接共享)
+
+        void CountSyscall() { syscalls.store(syscalls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+    };
+
+    bool SetupLoop(Loop& loop);         // 创建epoll实例并注册监听套接字
+    void DestroyLoop(Loop& loop);       // 关闭epoll实例及独立的监听套接字
+    void RunLoop(Loop& loop);           // 事件循环
+    void HandleAccept(Loop& loop);      // 接受所有待处理连接
+    void HandleRead(Loop& loop, SOCKET socket);   // 读取直到EAGAIN
+    void HandleWrite(Loop& loop, SOCKET socket);  // 继续发送队列中的数据
+    bool FlushOutput(Loop& loop, SOCKET socket, Connection& conn);  // 尽量写出队列，出错返回false
+    void FlushPending(Loop& loop);      // 每轮事件处理完后聚合写出各连接的响应
+    void RunPosted(Loop& loop);         // 执行其他线程投递的任务
+    void ResumeReads(Loop& loop);       // 读取解除背压的连接(边缘触发不会再次通知已到达的数据)
+    void CheckLowWater(Loop& loop, SOCKET socket, Connection& conn);  // 发送队列回落到低水位时解除背压
+    void QueueOutput(Loop& loop, SOCKET socket, OutputSegment segment);  // 放入发送队列并登记待刷新
+    void CloseConnection(Loop& loop, SOCKET socket);    // 关闭并移除连接
+
+    std::atomic<bool> running_;        // 运行标志
+    IoEngineOptions options_;          // 引擎配置
+    size_t connectionLimit_;           // 每个事件循环的连接上限
+    SOCKET listenSocket_;              // 共享监听套接字(reusePort模式下不使用)
+    IoHandler* handler_;               // 事件处理器
+    std::vector<std::unique_ptr<Loop>> loops_;  // 事件循环
+};
+
+#endif
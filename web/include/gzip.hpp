@@ -0,0 +1,91 @@
+#ifndef GZIP_HPP
+#define GZIP_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// CRC-32(与PNG、gzip使用的相同多项式)；crc为之前各段的结果，可以分段计算
+uint32_t Crc32(std::string_view data, uint32_t crc = 0);
+
+// 默认压缩级别(与gzip命令相同)
+const int DEFAULT_GZIP_LEVEL = 6;
+
+// 流式gzip压缩器(DEFLATE，RFC 1951/1952)：32KB滑动窗口，哈希链查找匹配，按级别做惰性匹配；
+// 每块按实际的符号频率构建动态哈夫曼编码，并与固定编码、不压缩的存储块比较后取最小者
+// 输入可以分段写入，内存占用固定(约400KB)，与数据总量无关：
+// Write压缩一段输入，Flush把目前为止的数据全部输出并按字节对齐(接收方可以立即解压，用于分块发送)，
+// Finish输出最后一块与gzip尾部
+class GzipEncoder {
+public:
+    explicit GzipEncoder(int level = DEFAULT_GZIP_LEVEL);  // 级别1(最快)到9(压缩率最高)
+
+    void Write(std::string_view data, std::string& out);  // 压缩一段输入，已完成的输出追加到out
+    void Flush(std::string& out);   // 同步刷新：结束当前块，输出全部待输出的数据
+    void Finish(std::string& out);  // 结束压缩流，之后不能再写入
+
+    uint64_t BytesIn() const { return bytesIn_; }  // 已写入的原始字节数
+
+    static std::string Compress(std::string_view data, int level = DEFAULT_GZIP_LEVEL);  // 一次压缩整段数据
+
+private:
+    static constexpr int WINDOW_SIZE = 32768;
+    static constexpr int HASH_SIZE = 1 << 15;
+    static constexpr int MIN_MATCH = 3;
+    static constexpr int MAX_MATCH = 258;
+    static constexpr int MIN_LOOKAHEAD = MAX_MATCH + MIN_MATCH + 1;
+    static constexpr int MAX_DISTANCE = WINDOW_SIZE - MIN_LOOKAHEAD;
+    static constexpr size_t MAX_SYMBOLS = 16384;  // 每块最多的符号数
+    static constexpr int NIL = -1;
+
+    // 一个符号：字面字节(distance为0)或匹配(长度+距离)
+    struct Symbol {
+        uint16_t value;     // 字面字节或匹配长度
+        uint16_t distance;  // 匹配距离(0表示字面字节)
+    };
+
+    void Begin(std::string& out);       // 开始一次调用(首次时写入gzip头)
+    void FillWindow();                  // 从input_补充窗口(必要时先滑动窗口)
+    void Deflate(bool flush);           // 压缩窗口中的数据(flush为false时保留至少MIN_LOOKAHEAD字节)
+    int InsertString(int position);     // 把position起的3字节加入哈希链，返回链上之前的位置
+    int LongestMatch(int chain);        // 从chain开始沿哈希链查找最长匹配(结果在matchStart_)
+    bool TallyLiteral(uint8_t byte);    // 记录符号，缓冲区满时返回true
+    bool TallyMatch(int distance, int length);
+    void FlushBlock(int end, bool last);  // 输出[blockStart_, end)对应的块
+    void PutBits(uint32_t value, int count);
+    void AlignToByte();
+
+    // 压缩参数(按级别)
+    int goodLength_;   // 已有匹配达到此长度时缩短查找
+    int maxLazy_;      // 已有匹配达到此长度时不再惰性查找
+    int niceLength_;   // 找到此长度的匹配即停止
+    int maxChain_;     // 哈希链的最大查找次数
+
+    std::vector<uint8_t> window_;  // 2*WINDOW_SIZE：前半为历史数据，后半为待压缩的数据
+    std::vector<int> head_;        // 哈希值 -> 最近的位置
+    std::vector<int> prev_;        // 位置 -> 同一哈希值的前一个位置
+    std::vector<Symbol> symbols_;  // 当前块的符号
+    uint32_t literalFreq_[286] = {};  // 当前块的字面/长度符号频率
+    uint32_t distanceFreq_[30] = {};  // 当前块的距离符号频率
+
+    int strStart_ = 0;       // 当前位置
+    int lookahead_ = 0;      // 当前位置之后的有效字节数
+    int blockStart_ = 0;     // 当前块的起始位置(存储块需要原始数据)
+    int matchStart_ = 0;     // 最近一次找到的匹配的起始位置
+    int matchLength_ = MIN_MATCH - 1;
+    int prevLength_ = MIN_MATCH - 1;
+    int prevMatch_ = 0;
+    bool matchAvailable_ = false;  // 上一个位置的字节尚未输出(惰性匹配)
+
+    std::string_view input_;   // 本次调用尚未放入窗口的输入
+    std::string* out_ = nullptr;  // 本次调用的输出
+    uint64_t bitBuffer_ = 0;
+    int bitCount_ = 0;
+    uint32_t crc_ = 0;
+    uint64_t bytesIn_ = 0;
+    bool started_ = false;   // 已写入gzip头
+    bool finished_ = false;
+};
+
+#endif
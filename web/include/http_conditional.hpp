@@ -0,0 +1,66 @@
+#ifndef HTTP_CONDITIONAL_HPP
+#define HTTP_CONDITIONAL_HPP
+
+#include "http_parser.hpp"
+#include "response_writer.hpp"
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+// ETag的最大长度(引号+16位十六进制大小+'-'+16位十六进制修改时间+'-'+编码名称+引号)
+const size_t ETAG_MAX = 48;
+// 一个Range请求最多接受的范围数，超过时忽略Range头发送整个文件
+const size_t MAX_RANGES = 16;
+// 间隔不超过该字节数的范围合并为一个(与multipart中每部分的分隔行和头部大小相当，合并不会多发送数据)
+const uint64_t RANGE_COALESCE_GAP = 80;
+
+// 资源的校验信息：由文件大小与修改时间生成，不读取文件内容
+// ETag为强校验("大小-修改时间"，十六进制)，Last-Modified精确到秒
+struct Validators {
+    char etag[ETAG_MAX];                  // ETag(含引号)
+    size_t etagSize = 0;
+    char lastModified[HTTP_DATE_SIZE];    // Last-Modified(IMF-fixdate)
+    std::time_t modified = 0;             // 修改时间(秒)
+
+    std::string_view ETag() const { return std::string_view(etag, etagSize); }
+    std::string_view LastModified() const { return std::string_view(lastModified, HTTP_DATE_SIZE); }
+};
+
+// coding非空时ETag附加"-编码名称"，同一文件的压缩表示与原始内容的ETag不同(304按表示区分)
+Validators MakeValidators(uint64_t size, std::filesystem::file_time_type mtime,
+                          std::string_view coding = std::string_view());
+
+// 解析IMF-fixdate("Sun, 06 Nov 1994 08:49:37 GMT")，其他格式返回空
+std::optional<std::time_t> ParseHttpDate(std::string_view text);
+
+// 客户端的副本是否仍然有效(应回复304)：有If-None-Match时按ETag弱比较，否则按If-Modified-Since
+bool NotModified(const HttpRequest& request, const Validators& validators);
+
+// If-Range是否允许按范围回复：没有该头，或ETag强匹配，或日期与Last-Modified相同
+bool IfRangeMatches(const HttpRequest& request, const Validators& validators);
+
+// 文件中的一段字节
+struct ByteRange {
+    uint64_t offset = 0;
+    uint64_t length = 0;
+};
+
+// Range头的解析结果
+enum class RangeStatus {
+    NONE,           // 没有Range头、格式错误或范围过多，忽略并发送整个文件
+    PARTIAL,        // 至少一个范围可以满足(超出文件末尾的部分已截断；重叠或相近的范围已合并，
+                    // 需要合并时按起点排序，否则按请求顺序保存)
+    UNSATISFIABLE   // 格式正确但没有可以满足的范围(416)
+};
+
+struct RangeSet {
+    ByteRange ranges[MAX_RANGES];
+    size_t count = 0;
+};
+
+// 解析"bytes=a-b, c-, -n"形式的Range头(size为文件大小)
+RangeStatus ParseRange(std::string_view header, uint64_t size, RangeSet& ranges);
+
+#endif
@@ -2,7 +2,7 @@
 #define HTTP_PARSER_HPP
 
 #include <string>
-#include <unordered_map>
+#include <string_view>
 
 // HTTP方法枚举
 enum class HttpMethod { 
@@ -15,24 +15,67 @@ enum class HttpMethod {
 enum class ParseStatus { 
     SUCCESS,    // 解析成功
     INCOMPLETE, // 数据不完整
-    FAILED      // 解析失败
+    FAILED,     // 解析失败
+    UNSUPPORTED // 格式正确但使用了不支持的Transfer-Encoding(应回复501，请求边界未知)
 };
 
+// 常用请求头，解析时直接按枚举建立索引
+enum class KnownHeader {
+    HOST,
+    CONTENT_LENGTH,
+    CONTENT_TYPE,
+    CONNECTION,
+    ACCEPT_ENCODING,
+    RANGE,
+    IF_NONE_MATCH,
+    IF_MODIFIED_SINCE,
+    IF_RANGE,
+    TRANSFER_ENCODING,
+    COUNT  // 枚举数量
+};
+
+// 请求头字段
+struct HttpHeader {
+    std::string_view name;   // 头名称
+    std::string_view value;  // 头值(已去除首尾空白)
+};
+
+// 每个请求最多保存的头字段数
+const size_t MAX_HEADERS = 32;
+
 // HTTP请求结构体
+// 所有string_view都指向连接的接收缓冲区，只在该请求被消费前有效
 struct HttpRequest {
     HttpMethod method = HttpMethod::UNKNOWN;  // 请求方法
-    std::string uri;                         // 请求URI
-    std::string version;                     // HTTP版本
-    std::unordered_map<std::string, std::string> headers;  // 请求头
-    std::string body;                        // 请求体
+    std::string_view uri;                    // 请求URI
+    std::string_view version;                // HTTP版本
+    HttpHeader headers[MAX_HEADERS];         // 请求头(按出现顺序)
+    size_t headerCount = 0;                  // 请求头数量
+    std::string_view known[static_cast<size_t>(KnownHeader::COUNT)];  // 常用头的值
+    std::string_view body;                   // 请求体
+
+    std::string_view header(KnownHeader id) const {  // 按枚举获取头值
+        return known[static_cast<size_t>(id)];
+    }
+    std::string_view header(std::string_view name) const;  // 按名称获取头值(不区分大小写)
 };
 
-// HTTP解析器类
+// HTTP解析器类(可恢复：每个连接持有一个实例，跨多次recv增量解析)
+// data为连接累积的接收缓冲区，解析从上次停止的偏移继续，已扫描的字节不会重新解析；
+// 返回SUCCESS时consumed()为该请求占用的字节数，之后的字节属于下一个请求。
+// 解析过程不分配内存：中间状态只记录偏移，完成时才生成指向data的string_view；
+// 各状态通过ScanSpan(http_scan.hpp)成块跳过普通字符，只在停止字节处做状态转换
 class HttpParser {
 public:
     HttpParser();
-    void reset();  // 重置解析器状态
+    void reset();  // 重置解析器状态(开始解析下一个请求)
     ParseStatus parse(const char* data, size_t length);  // 解析HTTP数据
+    // 只解析到请求头结束：返回SUCCESS时consumed()为请求体的起始偏移，请求体由调用者按contentLength()自行读取
+    // (request().body为空)，读完后调用reset()开始下一个请求
+    ParseStatus parseHeader(const char* data, size_t length);
+    size_t contentLength() const { return content_length_; }  // 请求体长度(请求头完整后有效)
+    size_t consumed() const { return offset_; }  // 已消费的字节数
+    bool InBody() const { return state_ == State::BODY; }  // 请求头已完整，正在等待请求体
     const HttpRequest& request() const;  // 获取解析后的请求
     
 private:
@@ -46,12 +89,32 @@ private:
         BODY,         // 解析体
         COMPLETE      // 完成解析
     };
+
+    // 缓冲区中的一段(偏移+长度)，缓冲区扩容后仍然有效
+    struct Span {
+        size_t offset = 0;
+        size_t length = 0;
+    };
+
+    static int LineEnding(const char* data, size_t i, size_t length);  // 检查行结束符
+    bool AddHeader(const char* data, size_t lineEnd);  // 保存一个头字段
+    void Finish(const char* data);  // 根据偏移生成请求中的string_view
     
     State state_;            // 当前解析状态
+    size_t offset_;          // 下一个待解析字节在缓冲区中的偏移
+    size_t token_start_;     // 当前词法单元的起始偏移
+    size_t value_start_;     // 当前头值的起始偏移
+    Span uri_;               // 请求URI
+    Span version_;           // HTTP版本
+    Span body_;              // 请求体
+    Span header_names_[MAX_HEADERS];   // 头名称
+    Span header_values_[MAX_HEADERS];  // 头值
     HttpRequest request_;    // 解析结果
-    std::string current_header_;  // 当前正在解析的头字段
     size_t content_length_;  // 内容长度
+    bool has_content_length_ = false;  // 已出现过Content-Length头
+    bool has_transfer_encoding_ = false;  // 出现过Transfer-Encoding头(不支持分块的请求体)
     size_t bytes_remaining_; // 剩余待解析字节数
+    bool header_only_ = false;  // 请求头结束时即返回(parseHeader)
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,27 @@
+#ifndef HTTP_SCAN_HPP
+#define HTTP_SCAN_HPP
+
+#include <cstddef>
+
+// HTTP字符类别：扫描在第一个不属于该类别的字节(停止字节)处结束
+enum class ScanClass {
+    TOKEN,         // tchar(方法、头名称)，冒号、空白、控制字符等会停止扫描
+    URI,           // URI与版本，空格与控制字符会停止扫描
+    HEADER_VALUE   // 头值，除制表符外的控制字符(含CR/LF)会停止扫描
+};
+
+// 扫描实现级别
+enum class ScanLevel {
+    SCALAR,  // 逐字节查表
+    SSE42,   // SSE4.2 PCMPESTRI，每次16字节
+    AVX2     // AVX2范围比较，每次32字节
+};
+
+// 返回data中第一个停止字节的下标，没有则返回length
+size_t ScanSpan(const char* data, size_t length, ScanClass cls);
+
+ScanLevel GetScanLevel();  // 当前使用的实现(启动时按CPU特性选择最快的)
+bool SetScanLevel(ScanLevel level);  // 切换实现(仅用于测试与基准测试，CPU不支持时返回false)
+const char* ScanLevelName(ScanLevel level);  // 实现名称
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef IO_ENGINE_HPP
+#define IO_ENGINE_HPP
+
+#include "common.hpp"
+#include "timer.hpp"
+#include <memory>
+#include <string>
+
+// I/O引擎配置
+struct IoEngineOptions {
+    int port = DEFAULT_PORT;  // 监听端口
+    int threadCount = 1;      // I/O线程数
+    bool reusePort = false;   // 每个事件循环使用独立的SO_REUSEPORT监听套接字并绑定到CPU核心
+    bool lazyRecv = false;    // 只在套接字可读时才借用接收缓冲区，空闲连接不占用缓冲区
+                              // (IOCP改用零字节接收；epoll与uring本来就在数据到达时才使用共享缓冲区)
+    size_t outputHighWater = OUTPUT_HIGH_WATER;  // 连接发送队列超过此字节数时暂停读取(背压)
+    size_t outputLowWater = OUTPUT_LOW_WATER;    // 发送队列回落到此字节数以下时恢复读取
+    size_t maxConnections = MAX_CONCURRENT;      // 并发连接上限(0表示不限制)，由各事件循环均分；
+                                                 // 达到上限时暂停接受，新连接留在内核的监听队列中
+};
+
+// 每个事件循环分得的连接上限(向上取整，不限制时为SIZE_MAX)
+size_t LoopConnectionLimit(const IoEngineOptions& options, size_t loops);
+
+// 共享的不可变缓冲区(如缓存的完整响应)，发送时只增加引用计数，不复制
+using SharedBuffer = std::shared_ptr<const std::string>;
+
+// 待发送的数据段：内存数据(独占，或共享缓冲区中的一段)，或文件中的一段(由引擎以零拷贝方式发送)
+struct OutputSegment {
+    std::string data;                // 独占的内存数据
+    SharedBuffer shared;             // 共享的内存数据(非空时代替data)
+    FileHandle file = INVALID_FILE;  // 文件(由数据段持有，析构时关闭)
+    uint64_t offset = 0;             // 文件中下一个待发送字节的偏移(共享缓冲区中的起始偏移)
+    uint64_t remaining = 0;          // 文件中剩余待发送的字节数(共享缓冲区中发送的长度)
+
+    OutputSegment() = default;
+    explicit OutputSegment(std::string d) : data(std::move(d)) {}
+    explicit OutputSegment(SharedBuffer s) : shared(std::move(s)), remaining(shared->size()) {}
+    OutputSegment(SharedBuffer s, size_t off, size_t length) : shared(std::move(s)), offset(off), remaining(length) {}
+    OutputSegment(FileHandle f, uint64_t off, uint64_t length) : file(f), offset(off), remaining(length) {}
+    OutputSegment(OutputSegment&& other) noexcept;
+    OutputSegment& operator=(OutputSegment&& other) noexcept;
+    OutputSegment(const OutputSegment&) = delete;
+    OutputSegment& operator=(const OutputSegment&) = delete;
+    ~OutputSegment();
+
+    bool IsFile() const { return file != INVALID_FILE; }
+    const char* Data() const { return shared ? shared->data() + offset : data.data(); }  // 内存数据起始地址
+    size_t Size() const { return shared ? static_cast<size_t>(remaining) : data.size(); }  // 内存数据长度
+    uint64_t Bytes() const { return IsFile() ? remaining : Size(); }            // 待发送的字节数
+};
+
+// 发送队列：OutputSegment的环形缓冲区，容量只增不减，
+// 稳态下入队出队不分配内存(std::deque会随队首推进反复释放和申请块)
+class OutputQueue {
+public:
+    OutputQueue() = default;
+    OutputQueue(const OutputQueue&) = delete;
+    OutputQueue& operator=(const OutputQueue&) = delete;
+    OutputQueue(OutputQueue&& other) noexcept;
+    OutputQueue& operator=(OutputQueue&& other) noexcept;
+
+    bool empty() const { return count_ == 0; }
+    size_t size() const { return count_; }
+    OutputSegment& front() { return slots_[head_]; }
+    OutputSegment& operator[](size_t i) { return slots_[(head_ + i) & (capacity_ - 1)]; }  // 第i个(0为队首)
+
+    void push_back(OutputSegment segment);   // 追加到队尾
+    void push_front(OutputSegment segment);  // 放回队首(部分发送的剩余数据)
+    void pop_front();                        // 移除队首并释放其资源
+    void clear();                            // 移除全部(保留容量)
+
+private:
+    void Grow();  // 容量翻倍
+
+    std::unique_ptr<OutputSegment[]> slots_;  // 槽位(容量为2的幂)
+    size_t capacity_ = 0;  // 槽位数
+    size_t head_ = 0;      // 队首位置
+    size_t count_ = 0;     // 元素数
+};
+
+// I/O事件处理器接口(由上层协议逻辑实现)
+// loop为连接所属事件循环的编号(0 ~ LoopCount()-1)，连接在其生命周期内不会迁移，
+// 同一事件循环的回调总是串行执行，因此按loop分片的状态无需加锁
+class IoHandler {
+public:
+    virtual ~IoHandler() = default;
+    virtual void OnAccept(size_t loop, SOCKET socket) = 0;  // 接受新连接
+    virtual void OnRecv(size_t loop, SOCKET socket, const char* data, size_t length) = 0;  // 收到数据
+    virtual void OnSend(size_t loop, SOCKET socket, size_t bytesSent) = 0;  // 发送有进展(bytesSent为自上次回调以来写出的字节数)
+    virtual void OnClose(size_t loop, SOCKET socket) = 0;   // 连接已关闭
+};
+
+// I/O引擎接口(IOCP、epoll等后端的统一抽象)
+class IoEngine {
+public:
+    virtual ~IoEngine() = default;
+
+    virtual const char* Name() const = 0;  // 引擎名称
+    virtual bool Initialize(const IoEngineOptions& options, IoHandler* handler) = 0;  // 创建监听套接字等资源
+    virtual void Start() = 0;  // 启动I/O线程并开始接受连接
+    virtual void Stop() = 0;   // 停止I/O线程并关闭所有连接
+    virtual size_t ThreadCount() const = 0;  // I/O线程数
+    virtual size_t LoopCount() const = 0;    // 相互独立的事件循环数
+    virtual uint64_t SyscallCount() const = 0;  // I/O线程累计执行的系统调用次数
+    virtual uint64_t AcceptPauseCount() const = 0;  // 因连接数达到上限而暂停接受连接的累计次数
+
+    // 异步发送数据(epoll后端要求在连接所属的I/O线程上调用)
+    virtual void Send(SOCKET socket, std::string data) = 0;
+    // 异步发送共享缓冲区，发送完成前引擎持有一个引用(调用线程要求同上)
+    virtual void Send(SOCKET socket, SharedBuffer data) = 0;
+    // 异步发送共享缓冲区的[offset, offset+length)部分(调用线程要求同上)
+    virtual void Send(SOCKET socket, SharedBuffer data, size_t offset, size_t length) = 0;
+    // 异步发送文件的[offset, offset+length)区间，数据直接从页缓存发往套接字；
+    // 引擎接管file的所有权，发送完成或连接关闭后关闭它(调用线程要求同Send)
+    virtual void SendFile(SOCKET socket, FileHandle file, uint64_t offset, uint64_t length) = 0;
+    // 关闭连接(可在任意线程调用，完成后回调OnClose)
+    virtual void Close(SOCKET socket) = 0;
+    // 发送队列全部写出后关闭连接(如错误响应之后)：先只关闭写端，继续读取直到对端关闭，
+    // 避免未读的数据使内核发送RST、冲掉尚未送达的响应；期间收到的数据照常交给处理器(调用线程要求同Send)
+    virtual void CloseAfterSend(SOCKET socket) = 0;
+    // 连接是否处于背压状态：发送队列超过高水位后为真，直到回落到低水位以下(此时引擎暂停读取，
+    // 回落后在OnSend之前恢复)；处理器应暂停处理已收到的流水线请求，在OnSend中继续(调用线程要求同Send)
+    virtual bool Backpressured(SOCKET socket) = 0;
+    // 在指定事件循环的线程上执行task(可在任意线程调用，如计算线程池交回处理结果)：
+    // 任务在该循环的回调之间串行执行，其中可以像回调中一样调用Send等；引擎停止后未执行的任务被丢弃
+    virtual void Post(size_t loop, std::function<void()> task) = 0;
+    // 指定事件循环的定时器：由该循环根据最近的到期时间决定等待时长，回调在该循环线程上执行；
+    // 只能在该循环的回调中使用(Start之前也可以)
+    virtual TimerWheel& Timers(size_t loop) = 0;
+};
+
+// 当前平台的默认引擎名称
+const char* DefaultIoEngineName();
+
+// 根据名称创建I/O引擎，不支持时返回nullptr
+std::unique_ptr<IoEngine> CreateIoEngine(const std::string& name);
+
+#endif
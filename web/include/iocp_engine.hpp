@@ -0,0 +1,123 @@
+#ifndef IOCP_ENGINE_HPP
+#define IOCP_ENGINE_HPP
+
+#include "io_engine.hpp"
+#include "object_pool.hpp"
+#include "connection_table.hpp"
+
+// I/O操作类型枚举
+enum class IoOperation { ACCEPT, RECV, SEND };
+
+// AcceptEx为本地与远端地址各保留的空间
+const DWORD ACCEPT_ADDRESS_SIZE = sizeof(sockaddr_in) + 16;
+
+// 接收缓冲区(与PerIoData分离，从池中借用，复用时不清零)
+struct RecvBuffer {
+    char data[BUFFER_SIZE];
+};
+
+// 每个I/O操作的数据结构(从池中获取，复用时保留各vector的容量)
+struct PerIoData {
+    OVERLAPPED overlapped;  // Windows重叠I/O结构
+    WSABUF wsaBuf;          // Winsock缓冲区结构
+    IoOperation operation;  // 操作类型
+    SOCKET socket;          // 关联的套接字
+    uint32_t generation = 0;  // 投递时连接的代数(套接字关闭后句柄值被新连接复用时，识别陈旧的完成事件)
+    RecvBuffer* recvBuffer = nullptr;         // 接收缓冲区(RECV操作，连接关闭时归还；零字节接收时为空)
+    char addresses[2 * ACCEPT_ADDRESS_SIZE];  // AcceptEx写入的地址(ACCEPT操作)
+    std::vector<OutputSegment> sendData;  // 聚合发送的数据段(SEND操作，完成前保持有效)
+    std::vector<WSABUF> sendBufs;         // 聚合发送的缓冲区描述
+    size_t sendOffset = 0;                // 第一个数据段此前已发送的字节数(部分发送后继续)
+    OutputSegment fileSegment;            // TransmitFile发送的文件段(SEND操作)
+};
+
+// 基于IOCP的I/O引擎(Windows)
+// 同一套接字的完成事件可能在任意工作线程上到达，因此所有线程共享一个事件循环编号(0)，
+// 处理器回调由handlerMutex_串行化；
+// 接收回调中产生的响应先放入连接的发送队列，回调返回后用一次多缓冲区WSASend聚合发送，
+// 文件段用TransmitFile从系统缓存直接发送，部分发送时未发送的数据段(共享缓冲区只增加引用)放回队首；
+// 发送队列超过高水位时暂不投递下一次接收，回落到低水位以下后再投递；
+// 同一连接的完成事件会在不同工作线程间迁移，因此I/O操作对象与接收缓冲区的池由整个引擎共享并加锁；
+// lazyRecv模式下投递零字节WSARecv只等待可读，完成后才借用缓冲区非阻塞地读空套接字并立即归还；
+// Post把任务放入投递队列并向完成端口投递一个不带OVERLAPPED的通知，由任一工作线程在处理器回调锁下执行；
+// 连接数达到上限时不再投递下一个AcceptEx，有连接关闭后恢复；
+// I/O操作记录投递时连接的代数，套接字关闭后句柄值被新连接复用时，旧连接的完成事件不会影响新连接
+class IocpEngine : public IoEngine {
+public:
+    IocpEngine();
+    ~IocpEngine() override;
+
+    const char* Name() const override { return "iocp"; }
+    bool Initialize(const IoEngineOptions& options, IoHandler* handler) override;
+    void Start() override;
+    void Stop() override;
+    size_t ThreadCount() const override { return threadCount_; }
+    size_t LoopCount() const override { return 1; }
+    uint64_t SyscallCount() const override { return syscalls_.load(std::memory_order_relaxed); }
+    uint64_t AcceptPauseCount() const override { return acceptPauses_.load(std::memory_order_relaxed); }
+
+    void Send(SOCKET socket, std::string data) override;
+    void Send(SOCKET socket, SharedBuffer data) override;
+    void Send(SOCKET socket, SharedBuffer data, size_t offset, size_t length) override;
+    void SendFile(SOCKET socket, FileHandle file, uint64_t offset, uint64_t length) override;
+    void Close(SOCKET socket) override;
+    void CloseAfterSend(SOCKET socket) override;
+    bool Backpressured(SOCKET socket) override;
+    void Post(size_t loop, std::function<void()> task) override;
+    TimerWheel& Timers(size_t loop) override;
+
+private:
+    bool CreateListenSocket(int port);  // 创建监听套接字
+    bool SetupCompletionPort();         // 设置完成端口
+    void CreateWorkerThreads();         // 创建工作线程
+    void StartAccept();                 // 开始接受连接
+    void HandleIoCompletion(DWORD bytesTransferred, PerIoData* perIoData);  // 处理I/O完成
+    void HandleAccept(PerIoData* acceptData);    // 处理接受连接
+    void HandleRecv(PerIoData* recvData, DWORD bytesTransferred);  // 处理接收数据
+    bool DrainSocket(SOCKET socket);  // 零字节接收完成后借用缓冲区读空套接字，对端关闭或出错时返回false
+    void DeliverRecv(SOCKET socket, const char* data, size_t length);  // 把收到的数据交给处理器
+    void HandleSend(PerIoData* sendData, DWORD bytesTransferred);  // 处理发送数据
+    void PostRecv(PerIoData* perIoData);  // 投递接收操作
+    void FlushSend(SOCKET socket);        // 聚合发送队列中的数据
+    void QueueOutput(SOCKET socket, OutputSegment segment);  // 放入发送队列
+    void CloseClientSocket(SOCKET socket);  // 关闭客户端套接字
+    void RunPosted();                       // 执行其他线程投递的任务
+    PerIoData* AcquireIo(SOCKET socket, IoOperation operation, uint32_t generation = 0);  // 从池中取出I/O操作对象
+    bool IsCurrent(const PerIoData* perIoData);  // 操作是否属于套接字当前的连接(而非已关闭的旧连接)
+    void ReleaseIo(PerIoData* perIoData);  // 归还I/O操作对象及其接收缓冲区
+
+    std::atomic<bool> running_;       // 运行标志
+    HANDLE iocpHandle_;               // IOCP句柄
+    SOCKET listenSocket_;             // 监听套接字
+    IoHandler* handler_;              // 事件处理器
+    size_t threadCount_;              // 工作线程数
+    bool lazyRecv_;                   // 零字节接收模式
+    size_t outputHighWater_;          // 发送队列高水位
+    size_t outputLowWater_;           // 发送队列低水位
+    size_t maxConnections_;           // 连接上限
+    std::vector<std::thread> workerThreads_;  // 工作线程
+    // 客户端连接的发送状态
+    struct Connection {
+        OutputQueue output;              // 待发送数据队列
+        size_t offset = 0;               // 队首内存数据已发送的字节数
+        uint64_t queued = 0;             // 队列中及在途的待发送字节数(含文件段)
+        bool sendInFlight = false;       // 是否有未完成的WSASend
+        bool paused = false;             // 发送队列超过高水位，暂停接收
+        bool closeAfterSend = false;     // 发送队列写完后关闭
+        PerIoData* parkedRecv = nullptr;  // 背压期间暂缓投递的接收操作
+    };
+    ConnectionTable<Connection> sockets_;  // 已打开的客户端套接字(按句柄值下标)
+    std::mutex socketsMutex_;         // 套接字表互斥锁
+    bool acceptPaused_;               // 连接数达到上限，暂停AcceptEx(由socketsMutex_保护)
+    std::atomic<uint64_t> acceptPauses_;  // 暂停accept的次数
+    std::atomic<uint64_t> syscalls_;  // 系统调用计数
+    std::recursive_mutex handlerMutex_;  // 串行化处理器回调(发送失败时会在回调内重入)
+    TimerWheel timers_;               // 定时器(在handlerMutex_下使用，决定完成端口的等待时长)
+    std::mutex postMutex_;            // 保护posted_
+    std::vector<std::function<void()>> posted_;  // 其他线程投递的任务
+    ObjectPool<PerIoData> ioPool_;    // I/O操作对象池
+    ObjectPool<RecvBuffer> bufferPool_;  // 接收缓冲区池
+    std::mutex poolMutex_;            // 保护两个池(完成事件在任意工作线程上到达)
+};
+
+#endif
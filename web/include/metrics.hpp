@@ -0,0 +1,107 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 单写者计数器：只由所属线程递增(relaxed读写，不使用加锁的原子读改写指令)，其他线程随时读取
+class Counter {
+public:
+    void Add(uint64_t n = 1) { value_.store(value_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+    uint64_t Get() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+// 对数线性(HDR风格)延迟直方图：小于16的值各占一个桶，之后每个2的幂区间分为16个线性子桶，
+// 相对误差不超过1/16，覆盖整个uint64_t范围；与Counter一样只由所属线程写入
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BITS = 4;
+    static constexpr size_t SUB_COUNT = size_t(1) << SUB_BITS;    // 每个2的幂区间的子桶数
+    static constexpr size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_COUNT;  // 桶数
+
+    void Record(uint64_t value);  // 记录一个值(纳秒)
+    uint64_t Count(size_t bucket) const { return counts_[bucket].load(std::memory_order_relaxed); }
+    uint64_t Total() const { return total_.Get(); }  // 记录的值的个数
+    uint64_t Sum() const { return sum_.Get(); }      // 记录的值之和
+
+    static size_t BucketOf(uint64_t value);         // 值所在的桶
+    static uint64_t BucketUpperBound(size_t bucket);  // 桶内的最大值
+
+private:
+    std::atomic<uint64_t> counts_[BUCKETS] = {};  // 各桶的计数
+    Counter total_;
+    Counter sum_;
+};
+
+// 直方图的快照：可合并多个线程(或多个压测线程)的直方图并计算分位数
+struct HistogramSnapshot {
+    std::vector<uint64_t> counts = std::vector<uint64_t>(LatencyHistogram::BUCKETS);  // 合并后的各桶计数
+    uint64_t count = 0;  // 值的个数
+    uint64_t sum = 0;    // 值之和
+
+    void Add(const LatencyHistogram& histogram);  // 累加一个直方图
+    uint64_t Percentile(double quantile) const;   // 分位数(取所在桶的上界)
+    uint64_t Max() const;                         // 最大值所在桶的上界
+};
+
+// 单独统计的HTTP状态码(其他状态码计入最后一个槽位)
+const int TRACKED_STATUS[] = {200, 206, 304, 400, 404, 413, 416, 431, 500, 501, 503};
+const size_t STATUS_SLOTS = sizeof(TRACKED_STATUS) / sizeof(TRACKED_STATUS[0]) + 1;
+
+// 每个工作线程(事件循环)的指标：按缓存行对齐，不同线程的计数器不会共享缓存行；
+// 请求路径上只有所属线程的普通读写，没有锁也没有跨核的缓存行争用
+struct alignas(64) ThreadMetrics {
+    Counter accepts;         // 接受的连接数
+    Counter closes;          // 关闭的连接数(活动连接数 = accepts - closes)
+    Counter bytesIn;         // 接收的字节数
+    Counter bytesOut;        // 发送的字节数
+    Counter parseFailures;   // 格式错误的请求数
+    Counter timeouts;        // 超时关闭的连接数(定时器到期)
+    Counter shed;            // 过载时以503拒绝的请求数
+    Counter overloads;       // 进入过载状态的次数
+    Counter recoveries;      // 退出过载状态的次数(当前过载 = overloads - recoveries)
+    Counter offloaded;       // 交给计算线程池处理的请求数
+    Counter encoded;         // 以压缩编码(gzip/br)发送的响应数
+    Counter cacheHits;       // 静态资源缓存命中次数
+    Counter cacheMisses;     // 静态资源缓存未命中次数
+    Counter requests[STATUS_SLOTS];  // 按状态码统计的请求数
+    LatencyHistogram latency;        // 请求处理时间(纳秒)
+
+    void RecordRequest(int statusCode, std::chrono::steady_clock::duration elapsed);  // 记录一个请求
+};
+
+// 汇总各线程指标的快照(抓取/metrics时按需生成)
+struct MetricsSnapshot {
+    uint64_t accepts = 0;
+    uint64_t closes = 0;
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+    uint64_t parseFailures = 0;
+    uint64_t timeouts = 0;
+    uint64_t shed = 0;
+    uint64_t overloads = 0;
+    uint64_t recoveries = 0;
+    uint64_t offloaded = 0;
+    uint64_t encoded = 0;
+    uint64_t cacheHits = 0;
+    uint64_t cacheMisses = 0;
+    uint64_t requests[STATUS_SLOTS] = {};
+    HistogramSnapshot latency;  // 请求处理时间(纳秒)
+
+    void Add(const ThreadMetrics& metrics);  // 累加一个线程的指标
+    void WritePrometheus(std::string& out) const;  // 以Prometheus文本格式输出
+};
+
+// 以Prometheus文本格式输出一个不带标签的指标(type为counter或gauge)
+void WriteMetric(std::string& out, std::string_view name, std::string_view type,
+                 std::string_view help, uint64_t value);
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef MIME_HPP
+#define MIME_HPP
+
+#include <string_view>
+
+// 按文件扩展名(最后一个'/'之后的最后一个'.'之后，不区分大小写)确定Content-Type，
+// 查找编译期构建的完美哈希表；没有扩展名或扩展名未知时为text/plain
+std::string_view MimeType(std::string_view path);
+
+// 该类型的内容是否值得压缩(文本、脚本、JSON/XML、SVG与WebAssembly；图片、音视频、字体与压缩包已经压缩过)
+bool CompressibleType(std::string_view contentType);
+
+#endif
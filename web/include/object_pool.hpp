@@ -0,0 +1,55 @@
+#ifndef OBJECT_POOL_HPP
+#define OBJECT_POOL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// 对象池：按slab(一次SlabSize个)批量分配对象，释放的对象放回空闲表供下次复用，
+// 稳态下获取与释放都不访问堆
+// 对象只在池析构时销毁：复用时保留其内部缓冲区的容量，状态由调用者重置；
+// 对象以默认初始化方式创建，字符数组等缓冲区不会被清零
+// 不加锁：每个事件循环拥有自己的池(跨线程使用时由调用者加锁)
+template <typename T, size_t SlabSize = 64>
+class ObjectPool {
+public:
+    ObjectPool() = default;
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // 获取一个对象(空闲表为空时分配一个新slab)
+    T* Acquire() {
+        if (free_.empty()) Grow();
+        T* object = free_.back();
+        free_.pop_back();
+        ++inUse_;
+        return object;
+    }
+
+    // 归还对象
+    void Release(T* object) {
+        free_.push_back(object);  // 容量已预留，不会重新分配
+        --inUse_;
+    }
+
+    size_t Capacity() const { return slabs_.size() * SlabSize; }  // 已创建的对象数
+    size_t InUse() const { return inUse_; }                         // 正在使用的对象数
+    size_t SlabCount() const { return slabs_.size(); }              // 已分配的slab数
+
+private:
+    // 分配一个slab并把其中的对象放入空闲表(低地址的对象先被取出)
+    void Grow() {
+        T* slab = new T[SlabSize];  // 默认初始化，不清零
+        slabs_.emplace_back(slab);
+        free_.reserve(Capacity());
+        for (size_t i = SlabSize; i-- > 0;) {
+            free_.push_back(&slab[i]);
+        }
+    }
+
+    std::vector<std::unique_ptr<T[]>> slabs_;  // 已分配的slab
+    std::vector<T*> free_;                      // 空闲对象
+    size_t inUse_ = 0;                          // 正在使用的对象数
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef OVERLOAD_HPP
+#define OVERLOAD_HPP
+
+#include <chrono>
+#include <cstdint>
+
+// 过载检测(每个事件循环一个，只由所属线程使用)：两个信号任一超过阈值即进入过载状态，
+// 两者都回落到阈值的一半以下才退出(滞回，避免在阈值附近反复切换)
+// - 排队时间：事件循环延迟，即定时器实际执行比预定时间晚多少。事件循环忙于处理一批事件时，
+//   已到达套接字的请求都在内核缓冲区中排队，它们等待的时间就是这个延迟
+// - 处理时间：请求处理时间的指数滑动平均(权重1/8)，反映磁盘变慢等使每个请求变贵的情况；
+//   过载期间以503快速拒绝的请求同样计入，平均值随之回落，部分请求得以重新进入(逐步恢复)
+// 阈值为0的信号不参与判断
+class OverloadDetector {
+public:
+    using Duration = std::chrono::steady_clock::duration;
+
+    OverloadDetector(Duration queueDelayLimit, Duration serviceTimeLimit);
+
+    void RecordQueueDelay(Duration delay);      // 记录一次事件循环延迟采样
+    void RecordServiceTime(Duration elapsed);   // 记录一个请求的处理时间
+    bool Overloaded() const { return overloaded_; }  // 是否应当拒绝新请求
+
+    Duration QueueDelay() const { return Duration(queueDelay_); }    // 最近一次的事件循环延迟
+    Duration ServiceTime() const { return Duration(serviceTime_); }  // 处理时间的滑动平均
+
+private:
+    void Update();  // 根据两个信号更新过载状态
+
+    int64_t queueDelayLimit_;   // 排队时间阈值(steady_clock的计数单位，下同)
+    int64_t serviceTimeLimit_;  // 处理时间阈值
+    int64_t queueDelay_ = 0;    // 最近一次的事件循环延迟
+    int64_t serviceTime_ = 0;   // 处理时间的滑动平均
+    bool overloaded_ = false;   // 当前是否过载
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef RESPONSE_WRITER_HPP
+#define RESPONSE_WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// IMF-fixdate的长度("Sun, 06 Nov 1994 08:49:37 GMT")
+const size_t HTTP_DATE_SIZE = 29;
+// Date头整行的长度("Date: " + 日期 + "\r\n")
+const size_t DATE_LINE_SIZE = 6 + HTTP_DATE_SIZE + 2;
+// 响应头缓冲区的建议大小(状态行与常用响应头)
+const size_t RESPONSE_HEADER_BUFFER = 512;
+
+// 把时刻格式化为IMF-fixdate(写入HTTP_DATE_SIZE个字符，不含结尾的'\0')
+void FormatHttpDate(std::time_t time, char* out);
+
+// 当前时刻的Date头整行，每个线程每秒只格式化一次；
+// 返回的缓冲区不可变，可以直接作为共享数据段发送(下一秒换成新的缓冲区)
+const std::shared_ptr<const std::string>& DateHeaderLine();
+
+// 响应头写入器：把状态行与响应头写入调用者提供的缓冲区，不分配内存
+// 状态行与固定的头部是预先生成的常量片段，数字用std::to_chars格式化；
+// 缓冲区不足时停止写入并标记溢出(Ok()返回false)
+class ResponseWriter {
+public:
+    ResponseWriter(char* buffer, size_t capacity) : begin_(buffer), pos_(buffer), end_(buffer + capacity) {}
+
+    void StatusLine(int statusCode);          // "HTTP/1.1 200 OK\r\n"
+    void Date();                              // 当前时刻的Date头
+    void ContentType(std::string_view type);  // Content-Type头
+    void ContentLength(uint64_t length);      // Content-Length头
+    void KeepAlive();                         // "Connection: keep-alive\r\n"
+    void Connection(bool keepAlive);          // 保持连接时同KeepAlive()，否则"Connection: close\r\n"
+    void Header(std::string_view name, std::string_view value);  // 任意响应头
+    void End();                               // 头部结束的空行
+
+    bool Ok() const { return !overflow_; }    // 缓冲区是否足够
+    const char* Data() const { return begin_; }
+    size_t Size() const { return static_cast<size_t>(pos_ - begin_); }
+    std::string_view View() const { return std::string_view(begin_, Size()); }
+
+    static std::string_view StatusLineFor(int statusCode);  // 常用状态码的状态行(其他状态码返回空)
+
+private:
+    void Append(std::string_view text);  // 追加文本(空间不足时标记溢出)
+
+    char* begin_;            // 缓冲区起始
+    char* pos_;              // 写入位置
+    char* end_;              // 缓冲区末尾
+    bool overflow_ = false;  // 是否溢出
+};
+
+#endif
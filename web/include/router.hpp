@@ -0,0 +1,124 @@
+#ifndef ROUTER_HPP
+#define ROUTER_HPP
+
+#include "http_parser.hpp"
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 路由表：精确路径与路径前缀挂在同一棵基数树(压缩前缀树)上，每条边是一段字符串，
+// 匹配时沿路径逐段比较，经过的前缀路由中最长的一个作为后备，走到路径末尾的节点上有精确路由则优先；
+// 每个节点按方法保存处理器，HttpMethod::UNKNOWN表示任意方法(指定方法的处理器优先)
+// 构建(Add/AddPrefix)在启动时完成，之后只读，可由多个事件循环并发匹配
+template <typename Handler>
+class Router {
+public:
+    Router() : root_(std::make_unique<Node>()) {}
+
+    void Add(HttpMethod method, std::string_view path, Handler handler) {       // 注册精确路径
+        Insert(path)->exact[Slot(method)] = std::move(handler);
+    }
+    void AddPrefix(HttpMethod method, std::string_view prefix, Handler handler) {  // 注册路径前缀
+        Insert(prefix)->prefix[Slot(method)] = std::move(handler);
+    }
+
+    // 匹配请求：精确路由优先，其次是最长的前缀路由，都没有时返回nullptr
+    const Handler* Match(HttpMethod method, std::string_view path) const {
+        const Handler* best = nullptr;
+        const Node* node = root_.get();
+        size_t offset = 0;
+        while (true) {
+            if (const Handler* handler = Pick(node->prefix, method)) best = handler;
+            if (offset == path.size()) {
+                const Handler* handler = Pick(node->exact, method);
+                return handler ? handler : best;
+            }
+            const Node* next = node->Child(path[offset]);
+            if (!next) return best;
+            const std::string& label = next->label;
+            if (path.size() - offset < label.size() ||
+                std::memcmp(path.data() + offset, label.data(), label.size()) != 0) {
+                return best;
+            }
+            offset += label.size();
+            node = next;
+        }
+    }
+
+    size_t NodeCount() const { return Count(*root_); }  // 树中的节点数(含根)
+
+private:
+    static constexpr size_t METHOD_SLOTS = 3;  // UNKNOWN(任意)、GET、POST
+
+    struct Node {
+        std::string label;      // 从父节点到本节点的边
+        std::string firsts;     // 各子节点边的首字节(与children一一对应，查找子节点只扫描这几个字节)
+        std::vector<std::unique_ptr<Node>> children;
+        std::optional<Handler> exact[METHOD_SLOTS];   // 精确路由
+        std::optional<Handler> prefix[METHOD_SLOTS];  // 前缀路由
+
+        const Node* Child(char first) const {  // 边以first开头的子节点(没有时返回nullptr)
+            for (size_t i = 0; i < firsts.size(); ++i) {
+                if (firsts[i] == first) return children[i].get();
+            }
+            return nullptr;
+        }
+    };
+
+    static size_t Slot(HttpMethod method) { return static_cast<size_t>(method); }
+
+    // 取方法对应的处理器，没有时取任意方法的处理器
+    static const Handler* Pick(const std::optional<Handler> (&handlers)[METHOD_SLOTS], HttpMethod method) {
+        const std::optional<Handler>& specific = handlers[Slot(method)];
+        if (specific) return &*specific;
+        const std::optional<Handler>& any = handlers[Slot(HttpMethod::UNKNOWN)];
+        return any ? &*any : nullptr;
+    }
+
+    // 找到或创建path对应的节点，边只有部分相同时拆分
+    Node* Insert(std::string_view path) {
+        Node* node = root_.get();
+        size_t offset = 0;
+        while (offset < path.size()) {
+            std::string_view rest = path.substr(offset);
+            size_t index = node->firsts.find(rest[0]);
+            if (index == std::string::npos) {
+                auto leaf = std::make_unique<Node>();
+                leaf->label = std::string(rest);
+                node->firsts.push_back(rest[0]);
+                node->children.push_back(std::move(leaf));
+                return node->children.back().get();
+            }
+            std::unique_ptr<Node>& child = node->children[index];
+            size_t common = 0;
+            while (common < child->label.size() && common < rest.size() && child->label[common] == rest[common]) {
+                ++common;
+            }
+            if (common < child->label.size()) {
+                // 拆分：公共部分成为新的中间节点，原节点挂在它下面
+                auto middle = std::make_unique<Node>();
+                middle->label = child->label.substr(0, common);
+                child->label.erase(0, common);
+                middle->firsts.push_back(child->label[0]);
+                middle->children.push_back(std::move(child));
+                child = std::move(middle);
+            }
+            node = child.get();
+            offset += common;
+        }
+        return node;
+    }
+
+    static size_t Count(const Node& node) {
+        size_t count = 1;
+        for (const auto& child : node.children) count += Count(*child);
+        return count;
+    }
+
+    std::unique_ptr<Node> root_;
+};
+
+#endif
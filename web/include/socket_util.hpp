@@ -0,0 +1,13 @@
+#ifndef SOCKET_UTIL_HPP
+#define SOCKET_UTIL_HPP
+
+#include "common.hpp"
+
+// 创建已绑定并处于监听状态的TCP套接字(POSIX)，失败返回INVALID_SOCKET
+// reusePort为true时设置SO_REUSEPORT，多个套接字可绑定同一端口由内核分发连接
+SOCKET CreateListenSocket(int port, bool nonBlocking, bool reusePort = false);
+
+// 将当前线程绑定到指定CPU核心(按核心数取模)
+void PinCurrentThread(size_t index);
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef STATIC_MAP_HPP
+#define STATIC_MAP_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// 编译期构建的完美哈希表(键为字符串，键集合在编译期已知，如MIME扩展名、内置路由)：
+// 构造时从1开始逐个尝试种子，直到所有键的哈希值在2的幂大小(不小于键数的四倍)的槽位中互不冲突；
+// 查找只需一次哈希、一次取槽位和一次字符串比较，没有探测也没有分支链
+// 用constexpr/constinit变量保存，构造在编译期完成，运行时不执行任何初始化
+template <typename Value, size_t N>
+class StaticMap {
+public:
+    static_assert(N > 0 && N < 255, "StaticMap holds 1 to 254 entries");
+
+    using Entry = std::pair<std::string_view, Value>;
+
+    constexpr explicit StaticMap(const Entry (&entries)[N]) {
+        for (size_t i = 0; i < N; ++i) entries_[i] = entries[i];
+        while (!TryBuild()) ++seed_;
+    }
+
+    // 查找键，不存在时返回nullptr
+    constexpr const Value* Find(std::string_view key) const {
+        uint8_t index = slots_[Hash(key, seed_) & (SLOTS - 1)];
+        if (index == EMPTY || entries_[index].first != key) return nullptr;
+        return &entries_[index].second;
+    }
+
+    constexpr uint32_t Seed() const { return seed_; }  // 找到的种子
+    static constexpr size_t Slots() { return SLOTS; }  // 槽位数
+
+    // 带种子的哈希：每次混入8字节(末尾不足8字节的部分补零)，最后混合高低位(只取低位作为槽位)
+    static constexpr uint32_t Hash(std::string_view key, uint32_t seed) {
+        uint64_t hash = (seed * 0x9e3779b97f4a7c15ull) ^ key.size();
+        for (size_t offset = 0; offset < key.size(); offset += 8) {
+            hash = (hash ^ Load(key, offset)) * 0xbf58476d1ce4e5b9ull;
+            hash ^= hash >> 29;
+        }
+        hash *= 0x94d049bb133111ebull;
+        return static_cast<uint32_t>(hash >> 32);
+    }
+
+private:
+    static constexpr uint8_t EMPTY = 0xff;
+
+    // 从offset起按小端序读取至多8字节(不足8字节时高位补零)；
+    // 编译期逐字节拼接，运行时在小端机器上用整字加载，不足8字节的尾部用重叠读取拼出，不逐字节循环
+    static constexpr uint64_t Load(std::string_view key, size_t offset) {
+        size_t count = key.size() - offset < 8 ? key.size() - offset : 8;
+        if (!std::is_constant_evaluated() && std::endian::native == std::endian::little) {
+            const char* data = key.data();
+            uint64_t word = 0;
+            if (count == 8) {
+                std::memcpy(&word, data + offset, 8);
+                return word;
+            }
+            if (key.size() >= 8) {  // 读取最后8字节，移掉已经混入的部分
+                std::memcpy(&word, data + key.size() - 8, 8);
+                return word >> (8 * (8 - count));
+            }
+            if (count >= 4) {  // 4到7字节：前4字节与后4字节重叠拼接
+                uint32_t low = 0, high = 0;
+                std::memcpy(&low, data, 4);
+                std::memcpy(&high, data + count - 4, 4);
+                return low | (static_cast<uint64_t>(high) << (8 * (count - 4)));
+            }
+            // 1到3字节：首、中、尾三个字节(可能重合)
+            return static_cast<uint64_t>(static_cast<uint8_t>(data[0])) |
+                   (static_cast<uint64_t>(static_cast<uint8_t>(data[count / 2])) << (8 * (count / 2))) |
+                   (static_cast<uint64_t>(static_cast<uint8_t>(data[count - 1])) << (8 * (count - 1)));
+        }
+        uint64_t word = 0;
+        for (size_t i = 0; i < count; ++i) {
+            word |= static_cast<uint64_t>(static_cast<uint8_t>(key[offset + i])) << (8 * i);
+        }
+        return word;
+    }
+
+    // 槽位数：不小于4N的2的幂(负载不超过四分之一，几十个键时几十次尝试内就能找到无冲突的种子；
+    // 槽位只存一字节下标，空间代价很小)
+    static constexpr size_t SlotCount() {
+        size_t slots = 4;
+        while (slots < 4 * N) slots *= 2;
+        return slots;
+    }
+    static constexpr size_t SLOTS = SlotCount();
+
+    // 用当前种子放置所有键，有冲突时返回false
+    constexpr bool TryBuild() {
+        for (auto& slot : slots_) slot = EMPTY;
+        for (size_t i = 0; i < N; ++i) {
+            uint8_t& slot = slots_[Hash(entries_[i].first, seed_) & (SLOTS - 1)];
+            if (slot != EMPTY) return false;
+            slot = static_cast<uint8_t>(i);
+        }
+        return true;
+    }
+
+    Entry entries_[N] = {};
+    uint8_t slots_[SLOTS] = {};  // 槽位 -> entries_下标(EMPTY表示空)
+    uint32_t seed_ = 1;
+};
+
+// 从{键, 值}列表构建(推导条目数)：constexpr auto MAP = MakeStaticMap<Value>({{"a", x}, {"b", y}});
+template <typename Value, size_t N>
+constexpr StaticMap<Value, N> MakeStaticMap(const std::pair<std::string_view, Value> (&entries)[N]) {
+    return StaticMap<Value, N>(entries);
+}
+
+#endif
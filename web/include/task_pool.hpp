@@ -0,0 +1,60 @@
+#ifndef TASK_POOL_HPP
+#define TASK_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 工作窃取的计算线程池：CPU密集的处理(图片处理、压缩等)放在这里执行，不阻塞I/O线程上的其他连接，
+// 完成后由任务自己用IoEngine::Post把结果交回连接所属的事件循环
+// 每个工作线程一个双端队列(各自加锁，互不争用)：
+// - 外部线程提交的任务轮流放入各队列的队尾，工作线程提交的子任务放入自己的队尾(数据还在本核的缓存中)
+// - 工作线程从自己的队首按提交顺序取任务(先到的请求先处理)，自己的队列空时从其他队列的队尾窃取
+//   (与队列的主人各取一端，窃取的是主人最晚才会处理的任务)
+// - 所有队列都空时在条件变量上休眠，提交任务时唤醒一个
+class TaskPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit TaskPool(size_t threads);  // 创建并启动工作线程(至少一个)
+    ~TaskPool();
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    void Submit(Task task);  // 提交任务(可在任意线程调用，Stop之后提交的任务被丢弃)
+    void Stop();             // 等待正在执行的任务完成后停止工作线程，丢弃尚未执行的任务
+
+    size_t ThreadCount() const { return workers_.size(); }
+    size_t Pending() const { return pending_.load(std::memory_order_relaxed); }  // 排队中的任务数
+    uint64_t Executed() const;  // 累计执行的任务数
+    uint64_t Stolen() const;    // 其中从其他线程的队列窃取的任务数
+
+private:
+    // 工作线程及其队列
+    struct Worker {
+        std::mutex mutex;          // 保护tasks
+        std::deque<Task> tasks;    // 本线程的任务队列
+        std::thread thread;
+        std::atomic<uint64_t> executed{0};  // 执行的任务数(仅本线程写入)
+        std::atomic<uint64_t> stolen{0};    // 窃取的任务数(仅本线程写入)
+    };
+
+    void Run(size_t index);                   // 工作线程主循环
+    bool TryPop(size_t index, Task& task);    // 从自己的队首取任务
+    bool TrySteal(size_t index, Task& task);  // 从其他队列的队尾窃取任务
+
+    std::vector<std::unique_ptr<Worker>> workers_;  // 工作线程
+    std::mutex sleepMutex_;              // 与wake_配合，避免丢失唤醒
+    std::condition_variable wake_;       // 有新任务或停止时唤醒休眠的工作线程
+    std::atomic<size_t> pending_{0};     // 已提交但尚未取出的任务数
+    std::atomic<size_t> next_{0};        // 外部提交时轮流选择的队列
+    std::atomic<bool> stopping_{false};  // 停止标志
+};
+
+#endif
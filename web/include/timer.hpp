@@ -3,54 +3,86 @@
 
 #include <functional>
 #include <chrono>
-#include <atomic>
-#include <mutex>
+#include <memory>
 #include <vector>
 #include <unordered_map>
-#include <thread>
 #include <iostream>
 
 using namespace std::chrono_literals;
 
-// 定时器轮类
+// 侵入式双向链表节点(槽位链表头也使用此结构)
+struct TimerLink {
+    TimerLink* prev = nullptr;
+    TimerLink* next = nullptr;
+};
+
+// 定时器节点：嵌入到使用者的对象中，添加、取消与重新调度都是O(1)
+// 节点在销毁前必须先取消(或已经到期)
+struct TimerNode : TimerLink {
+    std::function<void()> callback;  // 到期回调
+    uint64_t expires = 0;            // 所在槽位对应的到期tick
+    uint64_t deadline = 0;           // 真实期限(Touch延后期限时只更新它，到期时再重新放置)
+    uint64_t id = 0;                 // AddTimeout分配的ID(侵入式节点为0)
+
+    TimerNode() = default;
+    TimerNode(const TimerNode&) = delete;
+    TimerNode& operator=(const TimerNode&) = delete;
+    bool Linked() const { return next != nullptr; }  // 是否在轮中等待到期
+};
+
+// 分层定时器轮：第0层256个槽位(每槽1个tick)，第1~3层各64个槽位(每槽覆盖下一层一整圈)，
+// 第3层转一圈约为2^26个tick(10ms间隔时约7.7天)，更长的超时放在最远的槽位，级联时重新放置
+// 定时器轮没有线程也不加锁：由所属事件循环用NextTimeout计算等待时长，醒来后调用Expire，
+// 回调在事件循环线程上执行
 class TimerWheel {
 public:
     using TimeoutCallback = std::function<void()>;  // 超时回调类型
-    
-    // 构造函数
-    explicit TimerWheel(size_t slots = 60, 
-                      std::chrono::milliseconds interval = 10ms);
-    ~TimerWheel();
-    
-    void Start();  // 启动定时器
-    void Stop();   // 停止定时器
+    using Clock = std::chrono::steady_clock;
+
+    // 构造函数(第0个tick对应构造时刻)
+    explicit TimerWheel(std::chrono::milliseconds interval = 10ms);
+
+    // 侵入式接口(节点由调用者持有)
+    void Schedule(TimerNode& node, std::chrono::milliseconds timeout);  // 添加或重新调度
+    void Touch(TimerNode& node, std::chrono::milliseconds timeout);  // 刷新期限：延后时只记录，不移动节点
+    void Cancel(TimerNode& node);  // 取消(未调度时无操作)
+
+    // 基于ID的接口(节点由定时器轮持有)
     uint64_t AddTimeout(std::chrono::milliseconds timeout, TimeoutCallback cb);  // 添加超时任务
     void CancelTimeout(uint64_t id);  // 取消超时任务
-    
+
+    size_t Expire(Clock::time_point now = Clock::now());  // 处理now之前到期的tick，返回执行的回调数
+    int NextTimeout(Clock::time_point now = Clock::now()) const;  // 距下一次需要处理的毫秒数，无定时器时返回-1
+    size_t Advance(uint64_t ticks);  // 推进指定数量的tick并执行到期回调，返回执行的回调数
+
     // 获取信息方法
-    size_t GetCurrentSlot() const;  // 获取当前槽位
-    size_t GetWheelSize() const;    // 获取轮大小
-    bool IsRunning() const;         // 是否运行中
+    size_t GetCurrentSlot() const;  // 获取第0层当前槽位
+    size_t GetWheelSize() const;    // 获取第0层槽位数
+    uint64_t GetCurrentTick() const;  // 获取当前tick
     size_t CountTasks() const;      // 任务计数
     void PrintDebugInfo() const;    // 打印调试信息
 
 private:
-    // 定时任务结构
-    struct TimerTask {
-        uint64_t id;            // 任务ID
-        TimeoutCallback callback;  // 回调函数
-    };
-    
-    void RunLoop();  // 运行循环
-    
-    std::vector<std::unordered_map<uint64_t, TimerTask>> wheel_;  // 定时器轮
-    size_t slots_;               // 槽位数
-    std::chrono::milliseconds interval_;  // 间隔时间
-    size_t current_slot_;        // 当前槽位
-    mutable std::mutex mutex_;   // 互斥锁
-    std::atomic<uint64_t> next_id_;  // 下一个ID
-    std::atomic<bool> running_;  // 运行标志
-    std::thread worker_thread_;  // 工作线程
+    static constexpr int LEVELS = 4;        // 层数
+    static constexpr int ROOT_BITS = 8;     // 第0层槽位数的位数
+    static constexpr int LEVEL_BITS = 6;    // 第1~3层槽位数的位数
+    static constexpr uint64_t ROOT_SIZE = 1ull << ROOT_BITS;
+    static constexpr uint64_t LEVEL_SIZE = 1ull << LEVEL_BITS;
+    static constexpr uint64_t MAX_SPAN = 1ull << (ROOT_BITS + (LEVELS - 1) * LEVEL_BITS);  // 轮能表示的最大间隔
+
+    uint64_t ToTicks(std::chrono::milliseconds timeout) const;  // 超时换算为tick数(向上取整)
+    void Link(TimerNode& node);  // 按到期tick放入对应层的槽位
+    static void Unlink(TimerLink& node);  // 从所在槽位摘除
+    void Cascade(int level, size_t index);  // 把高层槽位中的节点重新放置到低层
+    size_t RunTick();  // 处理当前tick
+
+    std::vector<TimerLink> slots_;  // 所有层的槽位链表头(第0层在前)
+    std::unordered_map<uint64_t, std::unique_ptr<TimerNode>> owned_;  // AddTimeout创建的节点
+    std::chrono::milliseconds interval_;  // tick间隔
+    Clock::time_point start_;    // 第0个tick的时刻
+    uint64_t now_;               // 下一个待处理的tick
+    size_t count_;               // 等待中的定时器数
+    uint64_t next_id_;           // 下一个ID
 };
 
-#endif
\ No newline at end of file
+#endif
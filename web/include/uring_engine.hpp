@@ -0,0 +1,77 @@
+#ifndef URING_ENGINE_HPP
+#define URING_ENGINE_HPP
+
+#include "io_engine.hpp"
+#include <memory>
+
+// 基于io_uring的完成式I/O引擎(Linux 6.0+)
+// 多次触发(multishot)accept与recv，接收缓冲区由内核从提供的缓冲区环中挑选
+// (缓冲区环不可用时退化为IORING_OP_PROVIDE_BUFFERS)，
+// 每轮事件循环只调用一次io_uring_enter批量提交SQE并等待完成；
+// Send只把数据放入连接的发送队列，每轮处理完完成事件后用一个SENDMSG聚合发送(支持流水线)，
+// 文件段经连接私有的管道用两次IORING_OP_SPLICE(文件->管道->套接字)发送，不经过用户态；
+// 发送队列超过高水位时取消该连接的multishot recv，回落到低水位以下后重新投递；
+// Post把任务放入循环的投递队列并写eventfd，由在途的eventfd读操作完成时执行；
+// 连接数达到本环的上限时取消multishot accept，有连接关闭后重新投递；
+// 每个环拥有自己的定时器轮，io_uring_enter的等待时长取自最近的到期时间；
+// 连接按fd下标存放在ConnectionTable中，user_data带连接的代数，不属于当前连接的完成事件直接丢弃；
+// reusePort模式下每个环拥有独立的SO_REUSEPORT监听套接字并绑定到CPU核心
+class UringEngine : public IoEngine {
+public:
+    UringEngine();
+    ~UringEngine() override;
+
+    const char* Name() const override { return "uring"; }
+    bool Initialize(const IoEngineOptions& options, IoHandler* handler) override;
+    void Start() override;
+    void Stop() override;
+    size_t ThreadCount() const override { return loops_.size(); }
+    size_t LoopCount() const override { return loops_.size(); }
+    uint64_t SyscallCount() const override;
+    uint64_t AcceptPauseCount() const override;
+
+    void Send(SOCKET socket, std::string data) override;
+    void Send(SOCKET socket, SharedBuffer data) override;
+    void Send(SOCKET socket, SharedBuffer data, size_t offset, size_t length) override;
+    void SendFile(SOCKET socket, FileHandle file, uint64_t offset, uint64_t length) override;
+    void Close(SOCKET socket) override;
+    void CloseAfterSend(SOCKET socket) override;
+    bool Backpressured(SOCKET socket) override;
+    void Post(size_t loop, std::function<void()> task) override;
+    TimerWheel& Timers(size_t loop) override;
+
+private:
+    struct Connection;  // 连接状态
+    struct Loop;        // 事件循环(每个I/O线程一个环)
+
+    bool SetupLoop(Loop& loop);      // 创建环并注册缓冲区环
+    bool ProbeBufferRing(Loop& loop);  // 检测缓冲区环是否可用
+    void DestroyLoop(Loop& loop);    // 释放环相关资源
+    void RunLoop(Loop& loop);        // 事件循环
+    void HandleCompletion(Loop& loop, uint64_t userData, int res, uint32_t flags);  // 分发完成事件
+    void HandleAccept(Loop& loop, int res, uint32_t flags);  // 处理accept完成
+    void HandleRecv(Loop& loop, SOCKET socket, int res, uint32_t flags);  // 处理recv完成
+    void HandleSend(Loop& loop, SOCKET socket, int res);  // 处理send完成
+    void HandleSplice(Loop& loop, SOCKET socket, bool toSocket, int res);  // 处理splice完成
+    void ArmAccept(Loop& loop);      // 投递multishot accept
+    void CancelAccept(Loop& loop);   // 取消multishot accept(达到连接上限)
+    void ArmRecv(Loop& loop, SOCKET socket, Connection& conn);  // 投递multishot recv
+    void ArmWake(Loop& loop);        // 投递eventfd读操作用于唤醒
+    void RunPosted(Loop& loop);      // 执行其他线程投递的任务
+    void CancelRecv(Loop& loop, SOCKET socket);  // 取消multishot recv(背压)
+    void CheckLowWater(Loop& loop, SOCKET socket, Connection& conn);  // 发送队列回落到低水位时恢复接收
+    void SubmitSend(Loop& loop, SOCKET socket, Connection& conn);  // 为队首数据投递sendmsg或splice
+    void QueueOutput(Loop& loop, SOCKET socket, OutputSegment segment);  // 放入发送队列并登记待刷新
+    void FlushPending(Loop& loop);   // 为本轮有新数据的连接投递发送
+    void MaybeClose(Loop& loop, SOCKET socket);  // 无未完成操作时关闭连接
+    void ShutdownDrained(Loop& loop, SOCKET socket, Connection& conn);  // 要求写完后关闭的连接已写完，关闭写端
+
+    std::atomic<bool> running_;     // 运行标志
+    IoEngineOptions options_;       // 引擎配置
+    size_t connectionLimit_;        // 每个环的连接上限
+    SOCKET listenSocket_;           // 共享监听套接字(reusePort模式下不使用)
+    IoHandler* handler_;            // 事件处理器
+    std::vector<std::unique_ptr<Loop>> loops_;  // 事件循环
+};
+
+#endif
@@ -0,0 +1,221 @@
+#ifndef WEB_SERVER_HPP
+#define WEB_SERVER_HPP
+
+#include "common.hpp"
+#include "io_engine.hpp"
+#include "http_parser.hpp"
+#include "asset_cache.hpp"
+#include "object_pool.hpp"
+#include "response_writer.hpp"
+#include "metrics.hpp"
+#include "connection_table.hpp"
+#include "overload.hpp"
+#include "task_pool.hpp"
+#include "router.hpp"
+#include "static_map.hpp"
+#include "http_conditional.hpp"
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <unordered_map>
+
+// 服务器配置
+struct ServerConfig {
+    int port = DEFAULT_PORT;      // 监听端口
+    std::string engine;           // I/O引擎名称(为空时使用平台默认引擎)
+    int threads = 0;              // I/O线程数(0表示默认值)
+    bool reusePort = false;       // 每核一个反应器，各自拥有SO_REUSEPORT监听套接字
+    bool lazyRecv = false;        // 只在套接字可读时借用接收缓冲区(IOCP使用零字节接收)
+    std::string documentRoot = "./www";  // 文档根目录
+    size_t cacheCapacity = DEFAULT_CACHE_CAPACITY;  // 静态资源缓存预算(0表示不缓存)
+    size_t cacheMaxFileSize = MAX_CACHED_FILE_SIZE;  // 可缓存的最大文件
+    std::chrono::milliseconds idleTimeout = DEFAULT_IDLE_TIMEOUT;      // 两个请求之间(以及发送响应期间)的空闲期限
+    std::chrono::milliseconds headerTimeout = DEFAULT_HEADER_TIMEOUT;  // 从请求第一个字节起读完请求头的期限
+    std::chrono::milliseconds bodyTimeout = DEFAULT_BODY_TIMEOUT;      // 读取请求体时两次接收之间的期限
+    size_t maxConnections = MAX_CONCURRENT;  // 并发连接上限(0表示不限制)，达到后暂停接受新连接
+    std::chrono::milliseconds shedQueueDelay = DEFAULT_SHED_QUEUE_DELAY;    // 事件循环延迟超过此值时以503拒绝请求(0表示不检测)
+    std::chrono::milliseconds shedServiceTime = DEFAULT_SHED_SERVICE_TIME;  // 平均处理时间超过此值时以503拒绝请求(0表示不检测)
+    int computeThreads = 0;       // 计算线程池的线程数(0表示CPU核心数，负数表示不使用线程池，在I/O线程上直接处理)
+    size_t maxRequestBody = DEFAULT_MAX_REQUEST_BODY;  // 请求体上限(请求体整个缓存在内存中)
+};
+
+// Web服务器类(HTTP与定时器逻辑，I/O由IoEngine后端完成)
+class WebServer : public IoHandler {
+public:
+    WebServer();
+    ~WebServer();
+
+    bool Initialize(const ServerConfig& config = ServerConfig());  // 初始化服务器
+    void Run();      // 运行服务器
+    void Stop();     // 停止服务器
+    IoEngine* Engine() const { return engine_.get(); }  // 当前使用的I/O引擎
+
+    // IoHandler回调
+    void OnAccept(size_t loop, SOCKET socket) override;  // 处理接受连接
+    void OnRecv(size_t loop, SOCKET socket, const char* data, size_t length) override;  // 处理接收数据
+    void OnSend(size_t loop, SOCKET socket, size_t bytesSent) override;  // 处理发送完成
+    void OnClose(size_t loop, SOCKET socket) override;  // 处理连接关闭
+
+private:
+    // 私有方法
+    // 处理HTTP请求，返回响应状态码(0表示已交给计算线程池，完成时再记录)；overloaded时除/metrics外以503拒绝
+    int ProcessHttpRequest(size_t loop, SOCKET clientSocket, const HttpRequest& request, bool overloaded);
+    // 路由处理器(path为改写后的请求路径)，返回值同ProcessHttpRequest
+    using RouteHandler = int (WebServer::*)(size_t loop, SOCKET clientSocket, const HttpRequest& request,
+                                            std::string_view path);
+    struct BuiltinRoute {
+        HttpMethod method = HttpMethod::UNKNOWN;  // UNKNOWN表示任意方法
+        RouteHandler handler = nullptr;
+    };
+    static const StaticMap<BuiltinRoute, 2> BUILTIN_ROUTES;  // 内置端点(编译期构建的完美哈希表)
+    int HandleUpload(size_t loop, SOCKET clientSocket, const HttpRequest& request, std::string_view path);
+    int HandleMetrics(size_t loop, SOCKET clientSocket, const HttpRequest& request, std::string_view path);
+    int HandleStatic(size_t loop, SOCKET clientSocket, const HttpRequest& request, std::string_view path);
+    bool ResolveFile(std::string_view path, std::filesystem::path& filePath) const;  // 文档根目录下的文件路径
+    std::string RenderMetrics() const;  // 汇总各分片的指标，生成/metrics的内容
+    std::string ProcessImageUpload(std::string_view imageData,  // 处理图片上传，返回完整响应(可在计算线程上执行)
+                                   bool keepAlive);
+    void OffloadUpload(size_t loop, SOCKET clientSocket, std::string_view imageData,  // 把图片上传交给计算线程池
+                       bool keepAlive);
+    ConnectionHandle BeginOffload(size_t loop, SOCKET clientSocket);  // 标记连接忙碌，返回完成时找回连接的句柄
+    void CompleteOffload(size_t loop, ConnectionHandle handle,  // 在所属事件循环上发送结果(send返回记录的状态码)并继续处理
+                         std::chrono::steady_clock::time_point start, const std::function<int(SOCKET)>& send);
+    // 压缩的表示(返回值同ProcessHttpRequest；返回-1时按原始内容回复，file未被使用)
+    int SendPrecompressed(size_t loop, SOCKET clientSocket, const HttpRequest& request, std::string_view key,
+                          const std::filesystem::path& filePath, std::filesystem::file_time_type mtime,
+                          uint32_t coding, std::string_view contentType);
+    int SendCompressed(size_t loop, SOCKET clientSocket, const HttpRequest& request, std::string_view key,
+                       const std::filesystem::path& filePath, FileHandle file, uint64_t fileSize,
+                       std::filesystem::file_time_type mtime, std::string_view contentType);
+    // 压缩一次并放入缓存(可在计算线程上执行)，压缩后不更小时缓存原始内容(coding为0)
+    AssetCache::Response CompressOnce(const std::string& key, const std::string& filePath, std::string content,
+                                      std::filesystem::file_time_type mtime, std::string_view contentType,
+                                      uint32_t& coding);
+    // 等待同一键压缩完成的请求(已交给计算线程池，完成时在所属事件循环上回复)
+    struct CompressWaiter {
+        ConnectionHandle handle;
+        std::chrono::steady_clock::time_point start;
+        bool keepAlive;  // 请求是否保持连接(决定响应的Connection头)
+    };
+    void FinishCompressing(size_t loop, const std::string& key,  // 压缩完成：把结果交给等待该键的请求
+                           const AssetCache::Response& cached, uint32_t coding);
+    struct CompressStream;  // 流式压缩的状态
+    void StreamCompressed(size_t loop, SOCKET clientSocket, FileHandle file, uint64_t fileSize,  // 分块流式压缩
+                          const Validators& validators, std::string_view contentType, bool keepAlive);
+    void CompressNext(std::shared_ptr<CompressStream> stream);  // 压缩下一段(计算线程)，交回事件循环发送
+    void SendStreamChunk(std::shared_ptr<CompressStream> stream,  // 发送一段(事件循环)，按发送队列决定是否继续
+                         std::string chunk, bool ok, bool last);
+    void CountCompression(uint64_t bytesIn, uint64_t bytesOut);  // 统计服务器自己完成的压缩
+    // 构建HTTP响应头/完整响应(date为false时不含Date头，用于缓存的响应；keepAlive为false时带Connection: close)
+    std::string BuildHttpHeader(uint64_t contentLength, std::string_view contentType,
+                                int statusCode = 200, bool date = true, bool keepAlive = true);
+    std::string BuildHttpResponse(std::string_view content, std::string_view contentType,
+                                  int statusCode = 200, bool date = true, bool keepAlive = true);
+    static void WriteHttpHeader(ResponseWriter& writer, uint64_t contentLength,  // 写入状态行与响应头
+                                std::string_view contentType, int statusCode, bool date, bool keepAlive);
+    // 静态文件的响应头(另含ETag、Last-Modified与Accept-Ranges，contentRange非空时为206的Content-Range，
+    // contentEncoding非空时为Content-Encoding；文件的类型可压缩时带Vary: Accept-Encoding，
+    // multipart/byteranges响应由fileType给出文件本身的类型)
+    static std::string BuildFileHeader(uint64_t contentLength, std::string_view contentType,
+                                       const Validators& validators, int statusCode = 200, bool date = true,
+                                       std::string_view contentRange = std::string_view(),
+                                       std::string_view contentEncoding = std::string_view(),
+                                       bool keepAlive = true, std::string_view fileType = std::string_view());
+    // 静态文件内容的来源：缓存的完整响应(文件内容是最后size字节)或已打开的文件
+    struct FileBody {
+        SharedBuffer cached;             // 缓存的完整响应(为空时使用file)
+        FileHandle file = INVALID_FILE;  // 已打开的文件(发送时由引擎接管)
+        uint64_t size = 0;               // 文件大小
+    };
+    // 处理条件请求与范围请求：已回复304/206/416时返回状态码(file已被接管或关闭)，
+    // 返回0时应发送完整的200响应(body未被使用)
+    int SendConditional(SOCKET clientSocket, const HttpRequest& request, const Validators& validators,
+                        std::string_view contentType, FileBody& body);
+    int SendRanges(SOCKET clientSocket, const RangeSet& ranges, const Validators& validators,  // 206(单段或multipart)
+                   std::string_view contentType, FileBody& body, bool keepAlive);
+    // 发送缓存的响应(插入Date头；keepAlive为false时把其中的Connection头换成close)
+    void SendCachedResponse(SOCKET clientSocket, const SharedBuffer& response, bool keepAlive = true);
+    void ScheduleLagProbe(size_t loop);  // 安排下一次事件循环延迟采样
+
+    // 连接所处阶段(决定使用哪个超时)
+    enum class ClientPhase {
+        IDLE,    // 等待下一个请求或正在发送响应
+        HEADER,  // 正在读取请求头
+        BODY     // 正在读取请求体
+    };
+
+    // 客户端上下文结构(从分片的对象池获取，连接关闭后复用)
+    // 空闲连接只保留这一百多字节：解析器与未完成请求的缓冲区只在请求进行中持有
+    struct ClientContext {
+        std::string partial_request;  // 未完成请求的已接收部分(请求完成后释放)
+        HttpParser* parser = nullptr;  // 请求解析器(只在回调期间或读取请求体时从分片的池中借用)
+        TimerNode timeout;            // 超时定时器(侵入式节点，挂在所属事件循环的定时器轮上)
+        SOCKET socket = INVALID_SOCKET;  // 所属连接
+        uint32_t loop = 0;            // 所属事件循环
+        ClientPhase phase = ClientPhase::IDLE;  // 当前阶段
+        bool backlogged = false;      // 发送背压期间暂停处理，partial_request中有待处理的完整请求
+        bool busy = false;            // 请求正在计算线程池中处理，完成前暂停处理后续的流水线请求(响应须按序发送)
+        bool closing = false;         // 已回复错误响应或客户端要求关闭，发送完后关闭，不再处理收到的数据
+        bool closeAfterResponse = false;  // 计算线程池中的请求要求关闭连接(Connection: close或HTTP/1.0)，回复后关闭
+        uint32_t headerScanned = 0;   // 未读完的请求头中已查找过空行的字节数(解析器归还后据此只查找新数据)
+        std::shared_ptr<CompressStream> stream;  // 因发送背压暂停的流式压缩(发送队列回落后由OnSend继续)
+    };
+
+    void ConsumeInput(size_t loop, SOCKET clientSocket, ClientContext& client,  // 解析并处理收到的请求
+                      const char* data, size_t length);
+    void RefreshTimeout(size_t loop, ClientContext& client);  // 按阶段刷新超时
+    void RejectRequest(size_t loop, SOCKET clientSocket, ClientContext& client, int statusCode);  // 回复错误后关闭连接
+
+    // 字符串键的透明哈希(std::string与std::string_view哈希相同，查找时不构造std::string)
+    struct KeyHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view key) const { return std::hash<std::string_view>{}(key); }
+    };
+
+    // 分片：每个事件循环独占一份连接状态，回调与定时器都只在所属循环线程上执行，无需加锁
+    struct Shard {
+        ConnectionTable<ClientContext*> clients;  // 客户端(按fd下标)
+        ObjectPool<ClientContext> contexts;  // 客户端上下文池
+        ObjectPool<HttpParser, 16> parsers;  // 解析器池(只有正在接收请求体的连接长期持有解析器)
+        ThreadMetrics metrics;               // 本事件循环的指标(只由本循环线程写入，/metrics按需汇总)
+        AssetCache::Reader cacheReader;      // 静态资源缓存索引的快照(命中时不加锁)
+        // 本事件循环上正在压缩的键 -> 等待的请求(只由本循环线程访问；透明哈希，以string_view查找)
+        std::unordered_map<std::string, std::vector<CompressWaiter>, KeyHash, std::equal_to<>> compressing;
+        OverloadDetector overload;           // 过载检测(事件循环延迟与请求处理时间)
+        TimerNode lagProbe;                  // 事件循环延迟的采样定时器(只在有流量或过载时运行)
+        std::chrono::steady_clock::time_point lagProbeDue;  // 采样定时器的预定到期时刻
+        bool active = false;                 // 上次采样以来收到过数据
+
+        Shard(std::chrono::milliseconds queueDelayLimit, std::chrono::milliseconds serviceTimeLimit) :
+            overload(queueDelayLimit, serviceTimeLimit) {}
+        void ReleaseParser(ClientContext& client);  // 把解析器归还到池
+        void CountOverload(bool wasOverloaded);     // 统计进入与退出过载状态的次数
+        ClientContext* FindClient(SOCKET socket) {  // 查找客户端(不存在时返回nullptr)
+            ClientContext** client = clients.Find(socket);
+            return client ? *client : nullptr;
+        }
+    };
+
+    // 成员变量
+    std::atomic<bool> running_;        // 服务器运行标志
+    int port_;                        // 监听端口
+    std::unique_ptr<IoEngine> engine_;  // I/O引擎
+    std::vector<std::unique_ptr<Shard>> shards_;  // 每个事件循环一个分片
+    std::string documentRoot_ = "./www";  // 文档根目录
+    std::filesystem::path rootPath_;      // 规范化的文档根目录(静态文件必须在它之下)
+    std::chrono::milliseconds idleTimeout_;    // 空闲超时
+    std::chrono::milliseconds headerTimeout_;  // 请求头超时
+    std::chrono::milliseconds bodyTimeout_;    // 请求体超时
+    size_t maxRequestBody_ = DEFAULT_MAX_REQUEST_BODY;  // 请求体上限
+    std::unique_ptr<AssetCache> cache_;  // 静态资源缓存(各事件循环共享，各自通过分片中的Reader查找)
+    Router<RouteHandler> router_;        // 运行时注册的路由(静态文件挂在"/"前缀上)
+    std::unique_ptr<TaskPool> pool_;     // 计算线程池(CPU密集的处理器在这里执行，为空时在I/O线程上处理)
+    SharedBuffer overloadResponse_;      // 过载时的503响应(预先构建，不含Date头)
+    std::chrono::milliseconds shedQueueDelay_;   // 事件循环延迟阈值
+    std::chrono::milliseconds shedServiceTime_;  // 平均处理时间阈值
+    std::atomic<uint64_t> compressions_{0};      // 服务器完成的压缩次数(I/O线程与计算线程都会写入)
+    std::atomic<uint64_t> compressedIn_{0};      // 压缩前的字节数
+    std::atomic<uint64_t> compressedOut_{0};     // 压缩后的字节数
+};
+
+#endif
@@ -0,0 +1,192 @@
+#include "asset_cache.hpp"
+#include <mutex>
+
+namespace fs = std::filesystem;
+
+namespace {
+// 每个缓存项除内容外的估计开销(键、路径与管理结构)
+const size_t ENTRY_OVERHEAD = 128;
+}
+
+// 构造函数
+AssetCache::AssetCache(size_t capacity, size_t maxFileSize, std::chrono::milliseconds revalidateInterval) :
+    capacity_(capacity),
+    maxFileSize_(maxFileSize),
+    revalidateMs_(revalidateInterval.count()),
+    current_(std::make_shared<const Index>()),
+    version_(0),
+    hand_(0),
+    used_(0),
+    evictions_(0) {}
+
+// 单调时钟(毫秒)
+int64_t AssetCache::NowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 文件是否适合缓存
+bool AssetCache::Cacheable(uint64_t fileSize) const {
+    return fileSize <= maxFileSize_ && fileSize + ENTRY_OVERHEAD <= capacity_;
+}
+
+// 查找缓存项
+AssetCache::Response AssetCache::Find(Reader& reader, std::string_view key, FileInfo* info) {
+    // 索引发布了新版本时取新快照(只在插入或淘汰之后发生)
+    uint64_t version = version_.load(std::memory_order_acquire);
+    if (reader.version_ != version) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reader.snapshot_ = current_;
+        reader.version_ = version_.load(std::memory_order_relaxed);
+    }
+    auto it = reader.snapshot_->find(key);
+    if (it == reader.snapshot_->end()) return nullptr;
+
+    // 快照持有缓存项，下面的访问都不需要锁
+    Entry& entry = *it->second;
+    if (!entry.referenced.load(std::memory_order_relaxed)) {
+        entry.referenced.store(true, std::memory_order_relaxed);  // 已置位时不再写，避免各核争用同一缓存行
+    }
+    Response response = entry.response;
+    if (info) {
+        info->size = entry.fileSize;
+        info->mtime = entry.mtime;
+        info->coding = entry.coding;
+    }
+
+    // 未到校验时间，或其他线程正在校验时直接返回
+    int64_t now = NowMs();
+    int64_t checkedAt = entry.checkedAt.load(std::memory_order_relaxed);
+    if (now - checkedAt < revalidateMs_ ||
+        !entry.checkedAt.compare_exchange_strong(checkedAt, now, std::memory_order_relaxed)) {
+        return response;
+    }
+
+    // 检查文件是否被修改或删除(在锁外，不阻塞插入与淘汰)
+    std::error_code ec;
+    auto currentTime = fs::last_write_time(entry.filePath, ec);
+    uint64_t currentSize = ec ? 0 : fs::file_size(entry.filePath, ec);
+    bool valid = !ec && currentTime == entry.mtime && currentSize == entry.fileSize;
+    if (valid && !entry.sourcePath.empty()) {
+        valid = fs::last_write_time(entry.sourcePath, ec) == entry.sourceMtime && !ec;
+    }
+    if (valid) return response;
+
+    // 期间可能已被重新加载，只移除本次校验的那一份
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto current = current_->find(key);
+    if (current != current_->end() && current->second == it->second) {
+        auto next = std::make_shared<Index>(*current_);
+        RemoveAt(*next, entry.slot);
+        Publish(std::move(next));
+    }
+    return nullptr;
+}
+
+// 插入缓存项
+AssetCache::Response AssetCache::Insert(
+    std::string_view key,
+    const std::string& filePath,
+    std::string response,
+    uint64_t fileSize,
+    fs::file_time_type mtime,
+    uint32_t coding,
+    const Source& source)
+{
+    return Insert(key, filePath, std::make_shared<const std::string>(std::move(response)), fileSize, mtime, coding,
+                  source);
+}
+
+// 插入已有的共享响应
+AssetCache::Response AssetCache::Insert(
+    std::string_view key,
+    const std::string& filePath,
+    Response shared,
+    uint64_t fileSize,
+    fs::file_time_type mtime,
+    uint32_t coding,
+    const Source& source)
+{
+    size_t cost = shared->size() + key.size() + filePath.size() + source.path.size() + ENTRY_OVERHEAD;
+    if (cost > capacity_) return shared;  // 超出预算，只返回不缓存
+
+    auto entry = std::make_shared<Entry>();
+    entry->key = key;
+    entry->filePath = filePath;
+    entry->response = shared;
+    entry->fileSize = fileSize;
+    entry->mtime = mtime;
+    entry->coding = coding;
+    entry->sourcePath = source.path;
+    entry->sourceMtime = source.mtime;
+    entry->cost = cost;
+    entry->referenced.store(false, std::memory_order_relaxed);
+    entry->checkedAt.store(NowMs(), std::memory_order_relaxed);
+
+    // 复制索引后修改(复制只复制键与指针，只在未命中时发生)
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto next = std::make_shared<Index>(*current_);
+    auto it = next->find(key);
+    if (it != next->end()) RemoveAt(*next, it->second->slot);
+    EvictFor(*next, cost);
+
+    entry->slot = ring_.size();
+    (*next)[entry->key] = entry;  // 键指向缓存项自己持有的字符串
+    ring_.push_back(std::move(entry));
+    used_ += cost;
+    Publish(std::move(next));
+    return shared;
+}
+
+// 移除指定项
+void AssetCache::Invalidate(std::string_view key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = current_->find(key);
+    if (it == current_->end()) return;
+    auto next = std::make_shared<Index>(*current_);
+    RemoveAt(*next, it->second->slot);
+    Publish(std::move(next));
+}
+
+// 发布新的索引：读者下一次查找时看到新版本
+void AssetCache::Publish(std::shared_ptr<const Index> index) {
+    current_ = std::move(index);
+    version_.fetch_add(1, std::memory_order_release);
+}
+
+// 删除环中指定位置的项：用环尾的项填补空位
+void AssetCache::RemoveAt(Index& index, size_t slot) {
+    used_ -= ring_[slot]->cost;
+    index.erase(ring_[slot]->key);
+    if (slot != ring_.size() - 1) {
+        ring_[slot] = std::move(ring_.back());
+        ring_[slot]->slot = slot;
+    }
+    ring_.pop_back();
+    if (hand_ >= ring_.size()) hand_ = 0;
+}
+
+// CLOCK淘汰：指针扫过的项若被引用过则清除引用位给第二次机会，否则淘汰
+void AssetCache::EvictFor(Index& index, size_t cost) {
+    while (!ring_.empty() && used_ + cost > capacity_) {
+        Entry& entry = *ring_[hand_];
+        if (entry.referenced.exchange(false, std::memory_order_relaxed)) {
+            hand_ = (hand_ + 1) % ring_.size();
+        } else {
+            RemoveAt(index, hand_);
+            evictions_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+// 缓存项数
+size_t AssetCache::Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ring_.size();
+}
+
+// 已用内存
+size_t AssetCache::MemoryUsage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return used_;
+}
@@ -0,0 +1,99 @@
+#include "content_coding.hpp"
+
+namespace {
+
+// 去除首尾的空格与制表符
+std::string_view Trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+    return text;
+}
+
+// 不区分大小写的比较(b为小写)
+bool EqualsLower(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        char c = a[i];
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        if (c != b[i]) return false;
+    }
+    return true;
+}
+
+// q值是否为0("0"、"0."、"0.000"；格式错误时按1处理)
+bool ZeroQuality(std::string_view parameters) {
+    while (!parameters.empty()) {
+        size_t semicolon = parameters.find(';');
+        std::string_view parameter = Trim(parameters.substr(0, semicolon));
+        parameters = semicolon == std::string_view::npos ? std::string_view() : parameters.substr(semicolon + 1);
+        if (parameter.size() < 2 || (parameter[0] != 'q' && parameter[0] != 'Q') || parameter[1] != '=') continue;
+        std::string_view value = Trim(parameter.substr(2));
+        if (value.empty() || value[0] != '0') return false;
+        for (size_t i = 1; i < value.size(); ++i) {
+            if (i == 1 ? value[i] != '.' : value[i] != '0') return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+}
+
+// 解析Accept-Encoding
+uint32_t AcceptedCodings(std::string_view header) {
+    uint32_t accepted = 0;
+    uint32_t listed = 0;  // 单独列出的编码(不受"*"影响)
+    bool wildcard = false;
+    while (!header.empty()) {
+        size_t comma = header.find(',');
+        std::string_view item = header.substr(0, comma);
+        header = comma == std::string_view::npos ? std::string_view() : header.substr(comma + 1);
+
+        size_t semicolon = item.find(';');
+        std::string_view name = Trim(item.substr(0, semicolon));
+        bool rejected = semicolon != std::string_view::npos && ZeroQuality(item.substr(semicolon + 1));
+        uint32_t coding = 0;
+        if (EqualsLower(name, "gzip") || EqualsLower(name, "x-gzip")) {
+            coding = CODING_GZIP;
+        } else if (EqualsLower(name, "br")) {
+            coding = CODING_BR;
+        } else if (name == "*") {
+            wildcard = !rejected;
+            continue;
+        } else {
+            continue;
+        }
+        listed |= coding;
+        if (rejected) {
+            accepted &= ~coding;
+        } else {
+            accepted |= coding;
+        }
+    }
+    if (wildcard) accepted |= (CODING_GZIP | CODING_BR) & ~listed;
+    return accepted;
+}
+
+// 编码的名称
+std::string_view CodingName(uint32_t coding) {
+    switch (coding) {
+        case CODING_GZIP:
+            return "gzip";
+        case CODING_BR:
+            return "br";
+        default:
+            return std::string_view();
+    }
+}
+
+// 预压缩文件的扩展名
+std::string_view CodingExtension(uint32_t coding) {
+    switch (coding) {
+        case CODING_GZIP:
+            return ".gz";
+        case CODING_BR:
+            return ".br";
+        default:
+            return std::string_view();
+    }
+}
@@ -0,0 +1,73 @@
+#include "coro.hpp"
+#include <new>
+
+namespace {
+
+const size_t FRAME_CLASSES = FramePool::MAX_POOLED_FRAME / FramePool::GRANULARITY;  // 分级数
+
+// 空闲帧(复用帧的第一个字作为链表指针)
+struct FreeFrame {
+    FreeFrame* next;
+};
+
+// 当前线程的空闲表
+struct FrameCache {
+    FreeFrame* free[FRAME_CLASSES] = {};  // 每级一个空闲链表
+    uint64_t allocations = 0;             // 累计分配的帧数
+    uint64_t heapAllocations = 0;         // 其中从堆分配的帧数
+
+    // 线程退出时把空闲帧归还给堆
+    ~FrameCache() {
+        for (FreeFrame*& head : free) {
+            while (head) {
+                FreeFrame* frame = head;
+                head = frame->next;
+                ::operator delete(frame);
+            }
+        }
+    }
+};
+
+thread_local FrameCache frameCache;
+
+// 帧大小所在的级别
+size_t ClassOf(size_t size) {
+    return (size + FramePool::GRANULARITY - 1) / FramePool::GRANULARITY - 1;
+}
+
+}
+
+// 分配协程帧：优先从当前线程的空闲表取，按级别的上限分配以便复用
+void* FramePool::Allocate(size_t size) {
+    FrameCache& cache = frameCache;
+    ++cache.allocations;
+    if (size > MAX_POOLED_FRAME) {
+        ++cache.heapAllocations;
+        return ::operator new(size);
+    }
+    size_t index = ClassOf(size);
+    if (FreeFrame* frame = cache.free[index]) {
+        cache.free[index] = frame->next;
+        return frame;
+    }
+    ++cache.heapAllocations;
+    return ::operator new((index + 1) * GRANULARITY);
+}
+
+// 释放协程帧：放回当前线程的空闲表
+void FramePool::Release(void* frame, size_t size) noexcept {
+    if (size > MAX_POOLED_FRAME) {
+        ::operator delete(frame);
+        return;
+    }
+    size_t index = ClassOf(size);
+    FreeFrame* node = static_cast<FreeFrame*>(frame);
+    node->next = frameCache.free[index];
+    frameCache.free[index] = node;
+}
+
+// 当前线程累计分配的帧数
+uint64_t FramePool::Allocations() { return frameCache.allocations; }
+
+// 当前线程从堆分配的帧数
+uint64_t FramePool::HeapAllocations() { return frameCache.heapAllocations; }
@@ -0,0 +1,272 @@
+#include "coro_server.hpp"
+
+// 从池中取出后初始化(缓冲区保留上次使用时的容量)
+void CoConnection::Reset(IoEngine* engine, SOCKET socket, size_t loop) {
+    engine_ = engine;
+    socket_ = socket;
+    loop_ = loop;
+    waiter_ = nullptr;
+    wait_ = Wait::NONE;
+    open_ = true;
+    closed_ = false;
+    parser_.reset();
+    request_ = nullptr;
+    input_.clear();
+    head_ = 0;
+    inputOffset_ = 0;
+    pending_.clear();
+    pendingOffset_ = 0;
+    bodyRemaining_ = 0;
+    discard_ = 0;
+    chunk_ = std::string_view();
+}
+
+// 发送数据
+CoConnection::SendAwaiter CoConnection::Send(std::string data) {
+    if (open_) engine_->Send(socket_, std::move(data));
+    return {*this};
+}
+
+// 发送共享缓冲区
+CoConnection::SendAwaiter CoConnection::Send(SharedBuffer data) {
+    if (open_) engine_->Send(socket_, std::move(data));
+    return {*this};
+}
+
+// 零拷贝发送文件的一段
+CoConnection::SendAwaiter CoConnection::SendFile(FileHandle file, uint64_t offset, uint64_t length) {
+    if (open_) {
+        engine_->SendFile(socket_, file, offset, length);
+    } else {
+        CloseFile(file);
+    }
+    return {*this};
+}
+
+// 关闭连接(引擎随后回调OnClose)
+void CoConnection::Close() {
+    if (!open_) return;
+    open_ = false;
+    engine_->Close(socket_);
+}
+
+// 尝试解析下一个请求头：成功、格式错误或连接已关闭时可以返回
+bool CoConnection::TryReadRequest() {
+    if (request_) FinishRequest();
+    if (!open_) return true;
+
+    ParseStatus status = parser_.parseHeader(input_.data() + head_, input_.size() - head_);
+    if (status == ParseStatus::SUCCESS) {
+        request_ = &parser_.request();
+        inputOffset_ = head_ + parser_.consumed();
+        bodyRemaining_ = parser_.contentLength();
+        return true;
+    }
+    if (status == ParseStatus::FAILED || status == ParseStatus::UNSUPPORTED ||
+        input_.size() - head_ > MAX_REQUEST_HEADER) {
+        Close();
+        return true;
+    }
+    // 请求头不完整：把它移到缓冲区开头，解析器下次从头扫描(请求头很短)
+    if (head_ > 0) {
+        input_.erase(0, head_);
+        head_ = 0;
+        parser_.reset();
+    }
+    return false;
+}
+
+// 尝试取出下一段请求体：有缓冲的数据、请求体已读完或连接已关闭时可以返回
+bool CoConnection::TryReadBody() {
+    chunk_ = std::string_view();
+    if (!open_ || bodyRemaining_ == 0) return true;
+    chunk_ = TakeBuffered(bodyRemaining_);
+    bodyRemaining_ -= chunk_.size();
+    return !chunk_.empty();
+}
+
+// 结束当前请求：跳过未读的请求体(尚未到达的部分记入discard_)，未读数据并入input_供下一个请求解析
+void CoConnection::FinishRequest() {
+    while (bodyRemaining_ > 0) {
+        std::string_view skipped = TakeBuffered(bodyRemaining_);
+        if (skipped.empty()) break;
+        bodyRemaining_ -= skipped.size();
+    }
+    discard_ = bodyRemaining_;
+    bodyRemaining_ = 0;
+    request_ = nullptr;
+    chunk_ = std::string_view();
+    parser_.reset();
+
+    if (pendingOffset_ < pending_.size()) {
+        input_.erase(0, inputOffset_);
+        input_.append(pending_, pendingOffset_, std::string::npos);
+        head_ = 0;
+    } else if (inputOffset_ == input_.size()) {
+        input_.clear();
+        head_ = 0;
+    } else {
+        head_ = inputOffset_;  // 流水线中的下一个请求已在input_中，不移动数据
+    }
+    pending_.clear();
+    pendingOffset_ = 0;
+    inputOffset_ = 0;
+}
+
+// 从已缓冲的未读数据中取出最多limit字节(先input_后pending_)
+std::string_view CoConnection::TakeBuffered(uint64_t limit) {
+    if (inputOffset_ < input_.size()) {
+        size_t n = static_cast<size_t>(std::min<uint64_t>(limit, input_.size() - inputOffset_));
+        std::string_view chunk(input_.data() + inputOffset_, n);
+        inputOffset_ += n;
+        return chunk;
+    }
+    if (pendingOffset_ < pending_.size()) {
+        size_t n = static_cast<size_t>(std::min<uint64_t>(limit, pending_.size() - pendingOffset_));
+        std::string_view chunk(pending_.data() + pendingOffset_, n);
+        pendingOffset_ += n;
+        return chunk;
+    }
+    return std::string_view();
+}
+
+// 收到数据：保存到缓冲区，返回等待中的操作是否可以完成
+bool CoConnection::Receive(const char* data, size_t length) {
+    if (!request_) {
+        // 等待请求头：先丢弃上一个请求未读完的请求体
+        size_t skip = static_cast<size_t>(std::min<uint64_t>(discard_, length));
+        discard_ -= skip;
+        if (skip == length) return false;
+        input_.append(data + skip, length - skip);
+        return wait_ == Wait::REQUEST && TryReadRequest();
+    }
+    if (wait_ == Wait::BODY && inputOffset_ == input_.size() && pendingOffset_ == pending_.size()) {
+        // 正在等待请求体且没有缓冲的数据：直接交出引擎缓冲区中的数据(协程在本回调中恢复)
+        size_t n = static_cast<size_t>(std::min<uint64_t>(bodyRemaining_, length));
+        chunk_ = std::string_view(data, n);
+        bodyRemaining_ -= n;
+        pending_.append(data + n, length - n);
+        return true;
+    }
+    pending_.append(data, length);
+    return wait_ == Wait::BODY && TryReadBody();
+}
+
+// 析构函数
+CoServer::~CoServer() { Stop(); }
+
+// 创建引擎并开始接受连接
+bool CoServer::Initialize(const CoServerConfig& config, CoHandler handler) {
+    handler_ = std::move(handler);
+    idleTimeout_ = config.idleTimeout;
+
+    std::string name = config.engine.empty() ? DefaultIoEngineName() : config.engine;
+    engine_ = CreateIoEngine(name);
+    if (!engine_) {
+        std::cerr << "Unsupported I/O engine: " << name << std::endl;
+        return false;
+    }
+    IoEngineOptions options;
+    options.port = config.port;
+    options.threadCount = config.threads > 0 ? config.threads : GetDefaultThreadCount();
+    options.maxConnections = config.maxConnections;
+    if (!engine_->Initialize(options, this)) {
+        engine_.reset();
+        return false;
+    }
+    for (size_t i = 0; i < engine_->LoopCount(); ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+    engine_->Start();
+    return true;
+}
+
+// 停止引擎：关闭连接时恢复等待中的协程，使它们看到连接关闭后结束
+void CoServer::Stop() {
+    if (!engine_) return;
+    engine_->Stop();
+    engine_.reset();
+    shards_.clear();
+}
+
+// 接受新连接：创建处理器协程并运行到第一个挂起点
+void CoServer::OnAccept(size_t loop, SOCKET socket) {
+    Shard& shard = *shards_[loop];
+    CoConnection& conn = *shard.pool.Acquire();
+    shard.connections.Insert(socket) = &conn;
+    conn.Reset(engine_.get(), socket, loop);
+    conn.timeout_.callback = [&conn]() { conn.Close(); };
+    engine_->Timers(loop).Schedule(conn.timeout_, idleTimeout_);
+
+    conn.task_ = handler_(conn);
+    conn.task_.Start();
+    Settle(loop, conn);
+}
+
+// 收到数据：等待中的读取可以完成时恢复协程
+void CoServer::OnRecv(size_t loop, SOCKET socket, const char* data, size_t length) {
+    CoConnection** found = shards_[loop]->connections.Find(socket);
+    if (!found) return;
+    CoConnection& conn = **found;
+    engine_->Timers(loop).Touch(conn.timeout_, idleTimeout_);
+    if (conn.Receive(data, length)) {
+        Resume(loop, conn);
+        Settle(loop, conn);
+    }
+}
+
+// 发送有进展：背压解除时恢复等待发送的协程
+void CoServer::OnSend(size_t loop, SOCKET socket, size_t) {
+    CoConnection** found = shards_[loop]->connections.Find(socket);
+    if (!found) return;
+    CoConnection& conn = **found;
+    engine_->Timers(loop).Touch(conn.timeout_, idleTimeout_);
+    if (conn.wait_ == CoConnection::Wait::SEND && !engine_->Backpressured(socket)) {
+        Resume(loop, conn);
+        Settle(loop, conn);
+    }
+}
+
+// 连接已关闭：等待中的操作以连接关闭的结果返回，处理器随之结束
+void CoServer::OnClose(size_t loop, SOCKET socket) {
+    Shard& shard = *shards_[loop];
+    CoConnection** found = shard.connections.Find(socket);
+    if (!found) return;
+    CoConnection& conn = **found;
+    engine_->Timers(loop).Cancel(conn.timeout_);
+    shard.connections.Erase(socket);
+    conn.open_ = false;
+    conn.closed_ = true;
+    if (conn.wait_ != CoConnection::Wait::NONE) Resume(loop, conn);
+    // 处理器在等待连接以外的事件：直接销毁协程帧(连同其中的子任务)
+    if (!conn.task_.Done()) conn.task_ = Task<>();
+    Settle(loop, conn);
+}
+
+// 恢复等待中的协程(运行到下一个挂起点或结束)
+void CoServer::Resume(size_t, CoConnection& conn) {
+    std::coroutine_handle<> waiter = conn.waiter_;
+    conn.waiter_ = nullptr;
+    conn.wait_ = CoConnection::Wait::NONE;
+    waiter.resume();
+}
+
+// 处理器结束后关闭连接，连接关闭后销毁协程帧并归还连接对象
+void CoServer::Settle(size_t loop, CoConnection& conn) {
+    if (!conn.task_.Done()) return;
+    if (!conn.closed_) {
+        conn.Close();
+        return;
+    }
+    if (std::exception_ptr exception = conn.task_.Exception()) {
+        try {
+            std::rethrow_exception(exception);
+        } catch (const std::exception& e) {
+            std::cerr << "Connection handler failed: " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "Connection handler failed" << std::endl;
+        }
+    }
+    conn.task_ = Task<>();
+    shards_[loop]->pool.Release(&conn);
+}
@@ -0,0 +1,578 @@
+#include "epoll_engine.hpp"
+#include "socket_util.hpp"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/sendfile.h>
+#include <sys/uio.h>
+#include <algorithm>
+#include <csignal>
+
+namespace {
+// 单次epoll_wait最多收割的事件数
+const int MAX_EVENTS = 256;
+// 单次sendmsg最多聚合的缓冲区数
+const int MAX_IOVECS = 64;
+// 单次sendfile最多发送的字节数(Linux上限)
+const uint64_t MAX_SENDFILE_CHUNK = 0x7ffff000;
+
+// 当前I/O线程所属的事件循环
+thread_local void* currentLoop = nullptr;
+}
+
+// 构造函数
+EpollEngine::EpollEngine() :
+    running_(false),
+    connectionLimit_(SIZE_MAX),
+    listenSocket_(INVALID_SOCKET),
+    handler_(nullptr) {}
+
+// 析构函数
+EpollEngine::~EpollEngine() { Stop(); }
+
+// 初始化引擎
+bool EpollEngine::Initialize(const IoEngineOptions& options, IoHandler* handler) {
+    options_ = options;
+    handler_ = handler;
+
+    // sendfile无法指定MSG_NOSIGNAL，对端关闭时改为返回EPIPE
+    signal(SIGPIPE, SIG_IGN);
+
+    // 共享模式下所有线程使用同一个非阻塞监听套接字
+    if (!options_.reusePort) {
+        listenSocket_ = CreateListenSocket(options_.port, true);
+        if (listenSocket_ == INVALID_SOCKET) {
+            return false;
+        }
+    }
+
+    // 为每个I/O线程创建事件循环
+    for (int i = 0; i < std::max(options_.threadCount, 1); ++i) {
+        auto loop = std::make_unique<Loop>();
+        loop->index = static_cast<size_t>(i);
+        if (!SetupLoop(*loop)) {
+            DestroyLoop(*loop);
+            for (auto& l : loops_) DestroyLoop(*l);
+            loops_.clear();
+            if (listenSocket_ != INVALID_SOCKET) {
+                closesocket(listenSocket_);
+                listenSocket_ = INVALID_SOCKET;
+            }
+            return false;
+        }
+        loops_.push_back(std::move(loop));
+    }
+    connectionLimit_ = LoopConnectionLimit(options_, loops_.size());
+
+    return true;
+}
+
+// 创建epoll实例并注册监听套接字与唤醒fd
+bool EpollEngine::SetupLoop(Loop& loop) {
+    loop.epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (loop.epollFd < 0) {
+        std::cerr << "epoll_create1 failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    loop.wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (loop.wakeFd < 0) {
+        std::cerr << "eventfd failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = static_cast<uint64_t>(loop.wakeFd);  // 代数为0，与连接的句柄区分
+    if (epoll_ctl(loop.epollFd, EPOLL_CTL_ADD, loop.wakeFd, &ev) < 0) {
+        std::cerr << "epoll_ctl(wake) failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (options_.reusePort) {
+        // 每个线程独立的监听套接字，由内核按四元组哈希分发连接
+        loop.listenSocket = CreateListenSocket(options_.port, true, true);
+        if (loop.listenSocket == INVALID_SOCKET) {
+            return false;
+        }
+        ev.events = EPOLLIN | EPOLLET;
+    } else {
+        // 所有线程共享监听套接字，EPOLLEXCLUSIVE避免惊群
+        loop.listenSocket = listenSocket_;
+        ev.events = EPOLLIN | EPOLLET | EPOLLEXCLUSIVE;
+    }
+    ev.data.u64 = static_cast<uint64_t>(loop.listenSocket);
+    if (epoll_ctl(loop.epollFd, EPOLL_CTL_ADD, loop.listenSocket, &ev) < 0) {
+        std::cerr << "epoll_ctl(listen) failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// 关闭epoll实例及独立的监听套接字
+void EpollEngine::DestroyLoop(Loop& loop) {
+    if (loop.wakeFd >= 0) {
+        close(loop.wakeFd);
+        loop.wakeFd = -1;
+    }
+    if (loop.epollFd >= 0) {
+        close(loop.epollFd);
+        loop.epollFd = -1;
+    }
+    if (options_.reusePort && loop.listenSocket != INVALID_SOCKET) {
+        closesocket(loop.listenSocket);
+    }
+    loop.listenSocket = INVALID_SOCKET;
+}
+
+// 启动I/O线程
+void EpollEngine::Start() {
+    if (running_.exchange(true)) return;
+    for (auto& loop : loops_) {
+        Loop* l = loop.get();
+        loop->thread = std::thread([this, l]() { RunLoop(*l); });
+    }
+}
+
+// 事件循环
+void EpollEngine::RunLoop(Loop& loop) {
+    currentLoop = &loop;
+    if (options_.reusePort) {
+        PinCurrentThread(loop.index);
+    }
+    epoll_event events[MAX_EVENTS];
+
+    while (running_) {
+        // 批量收割就绪事件，最多等到下一个定时器到期(没有定时器时无限期休眠)
+        int n = epoll_wait(loop.epollFd, events, MAX_EVENTS, loop.timers.NextTimeout());
+        loop.CountSyscall();
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "epoll_wait failed: " << strerror(errno) << std::endl;
+            break;
+        }
+
+        // 先处理到期定时器，使本轮新加入的定时器以当前时刻为起点
+        loop.timers.Expire();
+
+        for (int i = 0; i < n; ++i) {
+            uint64_t data = events[i].data.u64;
+            uint32_t flags = events[i].events;
+
+            if (data == static_cast<uint64_t>(loop.wakeFd)) {
+                uint64_t value;
+                while (read(loop.wakeFd, &value, sizeof(value)) > 0) {}
+                loop.CountSyscall();
+                RunPosted(loop);
+                continue;
+            }
+            if (data == static_cast<uint64_t>(loop.listenSocket)) {
+                HandleAccept(loop);
+                continue;
+            }
+
+            // 同一批事件中fd可能已被关闭并由新连接复用：代数不符的陈旧事件直接丢弃
+            ConnectionHandle handle = ConnectionHandle::Unpack(data);
+            if (!loop.connections.Find(handle)) continue;
+            SOCKET fd = handle.socket;
+
+            // 先处理可写，再处理可读(读到EOF时会关闭连接)
+            if (flags & EPOLLOUT) {
+                HandleWrite(loop, fd);
+            }
+            if (flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                HandleRead(loop, fd);
+            }
+        }
+
+        // 本轮产生的响应统一写出，再读取解除了背压的连接(可能产生新的响应)
+        FlushPending(loop);
+        while (!loop.resumeList.empty()) {
+            ResumeReads(loop);
+            FlushPending(loop);
+        }
+
+        // 暂停期间监听队列中积压的连接不会再触发边缘事件，腾出名额后主动取出
+        if (loop.resumeAccept) {
+            loop.resumeAccept = false;
+            HandleAccept(loop);
+            FlushPending(loop);
+        }
+    }
+
+    currentLoop = nullptr;
+}
+
+// 接受所有待处理连接(边缘触发需一次取尽)；达到连接上限时暂停，其余连接留在监听队列中
+void EpollEngine::HandleAccept(Loop& loop) {
+    while (running_) {
+        if (loop.connections.Size() >= connectionLimit_) {
+            if (!loop.acceptPaused) {
+                loop.acceptPaused = true;
+                loop.acceptPauses.store(loop.acceptPauses.load(std::memory_order_relaxed) + 1,
+                                        std::memory_order_relaxed);
+            }
+            return;
+        }
+        SOCKET clientSocket = accept4(loop.listenSocket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        loop.CountSyscall();
+        if (clientSocket == INVALID_SOCKET) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::cerr << "accept4 failed: " << strerror(errno) << std::endl;
+            }
+            return;
+        }
+
+        // TCP_NODELAY已从监听套接字继承，无需再次设置
+
+        // 同时监听读写事件，边缘触发下无需反复修改注册；事件中带连接的句柄(fd与代数)
+        loop.connections.Insert(clientSocket);
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.u64 = loop.connections.Handle(clientSocket).Pack();
+        loop.CountSyscall();
+        if (epoll_ctl(loop.epollFd, EPOLL_CTL_ADD, clientSocket, &ev) < 0) {
+            std::cerr << "Failed to register client socket: " << strerror(errno) << std::endl;
+            loop.connections.Erase(clientSocket);
+            closesocket(clientSocket);
+            continue;
+        }
+
+        handler_->OnAccept(loop.index, clientSocket);
+    }
+}
+
+// 读取数据直到EAGAIN(处于背压状态时不读取，对端关闭由随后的写出失败发现)
+void EpollEngine::HandleRead(Loop& loop, SOCKET socket) {
+    while (true) {
+        Connection* conn = loop.connections.Find(socket);
+        if (!conn || conn->paused) return;
+        ssize_t n = recv(socket, loop.buffer, sizeof(loop.buffer), 0);
+        loop.CountSyscall();
+        if (n > 0) {
+            handler_->OnRecv(loop.index, socket, loop.buffer, static_cast<size_t>(n));
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+
+        // 对端关闭或出错
+        CloseConnection(loop, socket);
+        return;
+    }
+}
+
+// 套接字可写时继续发送
+void EpollEngine::HandleWrite(Loop& loop, SOCKET socket) {
+    Connection* conn = loop.connections.Find(socket);
+    if (!conn) return;
+    conn->writable = true;
+    if (conn->output.empty()) return;
+
+    if (!FlushOutput(loop, socket, *conn)) {
+        CloseConnection(loop, socket);
+    }
+}
+
+// 尽量写出发送队列，遇到EAGAIN时等待下一次可写事件
+bool EpollEngine::FlushOutput(Loop& loop, SOCKET socket, Connection& conn) {
+    iovec iov[MAX_IOVECS];
+    while (!conn.output.empty()) {
+        OutputSegment& front = conn.output.front();
+        ssize_t n;
+        if (front.IsFile()) {
+            // 文件段：sendfile从页缓存直接发送，内核推进偏移
+            off_t offset = static_cast<off_t>(front.offset);
+            n = sendfile(socket, front.file, &offset, std::min(front.remaining, MAX_SENDFILE_CHUNK));
+        } else {
+            // 把队列中连续的内存数据聚合到一次sendmsg，后面紧跟文件时用MSG_MORE合并成满包
+            int count = 0;
+            bool more = false;
+            for (size_t i = 0; i < conn.output.size() && count < MAX_IOVECS; ++i) {
+                const OutputSegment& segment = conn.output[i];
+                if (segment.IsFile()) {
+                    more = true;
+                    break;
+                }
+                size_t skip = (count == 0) ? conn.offset : 0;
+                iov[count].iov_base = const_cast<char*>(segment.Data()) + skip;
+                iov[count].iov_len = segment.Size() - skip;
+                ++count;
+            }
+            msghdr msg{};
+            msg.msg_iov = iov;
+            msg.msg_iovlen = count;
+            n = sendmsg(socket, &msg, MSG_NOSIGNAL | (more ? MSG_MORE : 0));
+        }
+        loop.CountSyscall();
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                conn.writable = false;
+                // 套接字缓冲区已满：报告本次写出的进展(慢速客户端下载期间保持连接活跃)
+                if (conn.pending > 0) {
+                    size_t sent = conn.pending;
+                    conn.pending = 0;
+                    CheckLowWater(loop, socket, conn);
+                    handler_->OnSend(loop.index, socket, sent);
+                }
+                return true;
+            }
+            return false;
+        }
+
+        size_t written = static_cast<size_t>(n);
+        conn.pending += written;
+        conn.queued -= written;
+        if (front.IsFile()) {
+            if (written == 0) return false;  // 文件在发送期间被截断
+            front.offset += written;
+            front.remaining -= written;
+            if (front.remaining == 0) conn.output.pop_front();
+            continue;
+        }
+
+        // 移除已完整写出的内存数据
+        while (written > 0) {
+            size_t left = conn.output.front().Size() - conn.offset;
+            if (written < left) {
+                conn.offset += written;
+                break;
+            }
+            written -= left;
+            conn.output.pop_front();
+            conn.offset = 0;
+        }
+    }
+
+    // 队列已清空，通知发送完成；要求写完后关闭的连接发出FIN，对端关闭后由HandleRead回收
+    size_t sent = conn.pending;
+    conn.pending = 0;
+    CheckLowWater(loop, socket, conn);
+    handler_->OnSend(loop.index, socket, sent);
+    if (conn.closeAfterSend) {
+        conn.closeAfterSend = false;
+        shutdown(socket, SHUT_WR);
+        loop.CountSyscall();
+    }
+    return true;
+}
+
+// 聚合写出本轮有新数据的连接
+void EpollEngine::FlushPending(Loop& loop) {
+    for (size_t i = 0; i < loop.flushList.size(); ++i) {
+        ConnectionHandle handle = loop.flushList[i];
+        Connection* found = loop.connections.Find(handle);  // 已关闭(或fd已被复用)的连接跳过
+        if (!found) continue;
+        SOCKET socket = handle.socket;
+        Connection& conn = *found;
+        conn.flushQueued = false;
+
+        // 等待EPOLLOUT的连接由HandleWrite继续发送
+        if (!conn.writable || conn.output.empty()) continue;
+        if (!FlushOutput(loop, socket, conn)) {
+            CloseConnection(loop, socket);
+        }
+    }
+    loop.flushList.clear();
+}
+
+// 读取解除背压的连接：数据在暂停期间已经到达，边缘触发不会再次通知
+void EpollEngine::ResumeReads(Loop& loop) {
+    loop.resuming.swap(loop.resumeList);
+    for (ConnectionHandle handle : loop.resuming) {
+        // 已关闭(或fd已被复用)的连接跳过，再次进入背压的连接由HandleRead跳过
+        if (loop.connections.Find(handle)) HandleRead(loop, handle.socket);
+    }
+    loop.resuming.clear();
+}
+
+// 发送队列回落到低水位以下时解除背压，本轮末尾恢复读取(在OnSend之前调用，处理器据此继续处理请求)
+void EpollEngine::CheckLowWater(Loop& loop, SOCKET socket, Connection& conn) {
+    if (conn.paused && conn.queued <= options_.outputLowWater) {
+        conn.paused = false;
+        loop.resumeList.push_back(loop.connections.Handle(socket));
+    }
+}
+
+// 放入发送队列，本轮事件处理完后写出
+void EpollEngine::QueueOutput(Loop& loop, SOCKET socket, OutputSegment segment) {
+    Connection* found = loop.connections.Find(socket);
+    if (!found) return;
+
+    Connection& conn = *found;
+    conn.queued += segment.Bytes();
+    if (conn.queued > options_.outputHighWater) conn.paused = true;  // 超过高水位，暂停读取
+    conn.output.push_back(std::move(segment));
+    if (!conn.flushQueued) {
+        conn.flushQueued = true;
+        loop.flushList.push_back(loop.connections.Handle(socket));
+    }
+}
+
+// 异步发送数据
+void EpollEngine::Send(SOCKET socket, std::string data) {
+    Loop* loop = static_cast<Loop*>(currentLoop);
+    if (!loop) {
+        std::cerr << "EpollEngine::Send called outside of an I/O thread" << std::endl;
+        return;
+    }
+    if (data.empty()) return;
+    QueueOutput(*loop, socket, OutputSegment(std::move(data)));
+}
+
+// 异步发送共享缓冲区
+void EpollEngine::Send(SOCKET socket, SharedBuffer data) {
+    Loop* loop = static_cast<Loop*>(currentLoop);
+    if (!loop) {
+        std::cerr << "EpollEngine::Send called outside of an I/O thread" << std::endl;
+        return;
+    }
+    if (!data || data->empty()) return;
+    QueueOutput(*loop, socket, OutputSegment(std::move(data)));
+}
+
+// 异步发送共享缓冲区的一部分
+void EpollEngine::Send(SOCKET socket, SharedBuffer data, size_t offset, size_t length) {
+    Loop* loop = static_cast<Loop*>(currentLoop);
+    if (!loop) {
+        std::cerr << "EpollEngine::Send called outside of an I/O thread" << std::endl;
+        return;
+    }
+    if (!data || length == 0) return;
+    QueueOutput(*loop, socket, OutputSegment(std::move(data), offset, length));
+}
+
+// 异步发送文件区间
+void EpollEngine::SendFile(SOCKET socket, FileHandle file, uint64_t offset, uint64_t length) {
+    OutputSegment segment(file, offset, length);  // 接管文件，出错时自动关闭
+    Loop* loop = static_cast<Loop*>(currentLoop);
+    if (!loop) {
+        std::cerr << "EpollEngine::SendFile called outside of an I/O thread" << std::endl;
+        return;
+    }
+    if (length == 0) return;
+    QueueOutput(*loop, socket, std::move(segment));
+}
+
+// 关闭连接
+void EpollEngine::Close(SOCKET socket) {
+    // shutdown是线程安全的：它会在所属线程上产生EOF事件，
+    // 由所属线程完成资源回收，避免跨线程关闭fd导致的复用竞争
+    shutdown(socket, SHUT_RDWR);
+}
+
+// 发送队列写完后关闭连接(队列已空时立即关闭写端)
+void EpollEngine::CloseAfterSend(SOCKET socket) {
+    Loop* loop = static_cast<Loop*>(currentLoop);
+    Connection* conn = loop ? loop->connections.Find(socket) : nullptr;
+    if (!conn) return;
+    if (conn->output.empty()) {
+        shutdown(socket, SHUT_WR);
+        loop->CountSyscall();
+        return;
+    }
+    conn->closeAfterSend = true;
+}
+
+// 连接是否处于背压状态
+bool EpollEngine::Backpressured(SOCKET socket) {
+    Loop* loop = static_cast<Loop*>(currentLoop);
+    if (!loop) return false;
+    Connection* conn = loop->connections.Find(socket);
+    return conn && conn->paused;
+}
+
+// 投递任务到指定事件循环(队列由空变为非空时才唤醒，之后的投递由同一次唤醒处理)
+void EpollEngine::Post(size_t loop, std::function<void()> task) {
+    Loop& target = *loops_[loop];
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(target.postMutex);
+        wake = target.posted.empty();
+        target.posted.push_back(std::move(task));
+    }
+    uint64_t one = 1;
+    if (wake && write(target.wakeFd, &one, sizeof(one)) < 0) {
+        std::cerr << "Failed to wake I/O thread: " << strerror(errno) << std::endl;
+    }
+}
+
+// 执行其他线程投递的任务(产生的响应在本轮末尾统一写出)
+void EpollEngine::RunPosted(Loop& loop) {
+    {
+        std::lock_guard<std::mutex> lock(loop.postMutex);
+        loop.running.swap(loop.posted);
+    }
+    for (auto& task : loop.running) {
+        task();
+    }
+    loop.running.clear();
+}
+
+// 指定事件循环的定时器
+TimerWheel& EpollEngine::Timers(size_t loop) {
+    return loops_[loop]->timers;
+}
+
+// 关闭并移除连接
+void EpollEngine::CloseConnection(Loop& loop, SOCKET socket) {
+    if (!loop.connections.Erase(socket)) return;
+    // 先通知上层清理状态，再关闭fd，防止fd被复用后状态错乱
+    handler_->OnClose(loop.index, socket);
+    closesocket(socket);
+    loop.CountSyscall();
+
+    if (loop.acceptPaused && loop.connections.Size() < connectionLimit_) {
+        loop.acceptPaused = false;
+        loop.resumeAccept = true;
+    }
+}
+
+// 累计系统调用次数
+uint64_t EpollEngine::SyscallCount() const {
+    uint64_t total = 0;
+    for (const auto& loop : loops_) {
+        total += loop->syscalls.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+// 累计暂停accept的次数
+uint64_t EpollEngine::AcceptPauseCount() const {
+    uint64_t total = 0;
+    for (const auto& loop : loops_) {
+        total += loop->acceptPauses.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+// 停止引擎
+void EpollEngine::Stop() {
+    // 唤醒并等待所有I/O线程结束
+    if (running_.exchange(false)) {
+        for (auto& loop : loops_) {
+            uint64_t one = 1;
+            if (write(loop->wakeFd, &one, sizeof(one)) < 0) {
+                std::cerr << "Failed to wake I/O thread: " << strerror(errno) << std::endl;
+            }
+        }
+        for (auto& loop : loops_) {
+            if (loop->thread.joinable()) loop->thread.join();
+        }
+    }
+
+    // 关闭所有连接和事件循环
+    for (auto& loop : loops_) {
+        loop->connections.ForEach([this, &loop](SOCKET socket, Connection&) { CloseConnection(*loop, socket); });
+        DestroyLoop(*loop);
+    }
+    loops_.clear();
+
+    // 关闭监听套接字
+    if (listenSocket_ != INVALID_SOCKET) {
+        closesocket(listenSocket_);
+        listenSocket_ = INVALID_SOCKET;
+    }
+}
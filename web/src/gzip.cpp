@@ -0,0 +1,528 @@
+#include "gzip.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <queue>
+
+namespace {
+
+// CRC-32的查找表
+constexpr std::array<uint32_t, 256> MakeCrcTable() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+        table[i] = c;
+    }
+    return table;
+}
+constexpr std::array<uint32_t, 256> CRC_TABLE = MakeCrcTable();
+
+// 长度符号(257+下标)的基数与附加位数
+constexpr uint16_t LENGTH_BASE[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                      35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr uint8_t LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                      3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+// 距离符号的基数与附加位数
+constexpr uint16_t DISTANCE_BASE[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                        257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                        8193, 12289, 16385, 24577};
+constexpr uint8_t DISTANCE_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                        7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+// 码长码的发送顺序
+constexpr uint8_t CODE_LENGTH_ORDER[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+// 匹配长度-3 -> 长度符号下标
+constexpr std::array<uint8_t, 256> MakeLengthCodes() {
+    std::array<uint8_t, 256> table{};
+    for (uint8_t code = 0; code < 28; ++code) {
+        for (int i = 0; i < (1 << LENGTH_EXTRA[code]); ++i) table[LENGTH_BASE[code] - 3 + i] = code;
+    }
+    table[255] = 28;
+    return table;
+}
+constexpr std::array<uint8_t, 256> LENGTH_CODE = MakeLengthCodes();
+
+// 距离 -> 距离符号
+int DistanceCode(int distance) {
+    unsigned x = static_cast<unsigned>(distance - 1);
+    if (x < 4) return static_cast<int>(x);
+    int n = std::bit_width(x) - 1;
+    return 2 * n + static_cast<int>((x >> (n - 1)) & 1);
+}
+
+// 压缩级别的参数(与zlib的配置表相同)
+struct LevelConfig {
+    int good, lazy, nice, chain;
+};
+constexpr LevelConfig LEVELS[10] = {
+    {0, 0, 0, 0},          {4, 4, 8, 4},         {4, 5, 16, 8},         {4, 6, 32, 32},
+    {4, 4, 16, 16},        {8, 16, 32, 32},      {8, 16, 128, 128},     {8, 32, 128, 256},
+    {32, 128, 258, 1024},  {32, 258, 258, 4096},
+};
+
+// 按频率计算哈夫曼码长(不超过limit)：超过时把频率减半后重建，直到满足限制
+void BuildLengths(const uint32_t* freq, int count, int limit, uint8_t* lengths) {
+    std::vector<uint32_t> weights(freq, freq + count);
+    std::vector<uint64_t> nodeWeight;
+    std::vector<int> parent;
+    while (true) {
+        std::fill(lengths, lengths + count, 0);
+        nodeWeight.assign(weights.begin(), weights.end());
+        parent.assign(count, -1);
+        using Item = std::pair<uint64_t, int>;  // (权重, 节点)，权重相同时按下标，结果确定
+        std::priority_queue<Item, std::vector<Item>, std::greater<Item>> heap;
+        for (int i = 0; i < count; ++i) {
+            if (weights[i] > 0) heap.push({weights[i], i});
+        }
+        if (heap.empty()) return;
+        if (heap.size() == 1) {
+            lengths[heap.top().second] = 1;
+            return;
+        }
+        while (heap.size() > 1) {
+            Item a = heap.top();
+            heap.pop();
+            Item b = heap.top();
+            heap.pop();
+            int node = static_cast<int>(nodeWeight.size());
+            nodeWeight.push_back(a.first + b.first);
+            parent.push_back(-1);
+            parent[a.second] = node;
+            parent[b.second] = node;
+            heap.push({a.first + b.first, node});
+        }
+        int maxLength = 0;
+        for (int i = 0; i < count; ++i) {
+            if (weights[i] == 0) continue;
+            int depth = 0;
+            for (int node = i; parent[node] >= 0; node = parent[node]) ++depth;
+            lengths[i] = static_cast<uint8_t>(std::min(depth, 255));
+            maxLength = std::max(maxLength, depth);
+        }
+        if (maxLength <= limit) return;
+        for (auto& weight : weights) {
+            if (weight > 0) weight = (weight >> 1) | 1;
+        }
+    }
+}
+
+// 由码长生成范式哈夫曼码(按位反转，便于从低位开始输出)
+void BuildCodes(const uint8_t* lengths, int count, uint16_t* codes) {
+    int lengthCount[16] = {};
+    for (int i = 0; i < count; ++i) lengthCount[lengths[i]]++;
+    lengthCount[0] = 0;
+    int next[16] = {};
+    int code = 0;
+    for (int bits = 1; bits < 16; ++bits) {
+        code = (code + lengthCount[bits - 1]) << 1;
+        next[bits] = code;
+    }
+    for (int i = 0; i < count; ++i) {
+        int length = lengths[i];
+        if (length == 0) continue;
+        int value = next[length]++;
+        int reversed = 0;
+        for (int b = 0; b < length; ++b) reversed |= ((value >> b) & 1) << (length - 1 - b);
+        codes[i] = static_cast<uint16_t>(reversed);
+    }
+}
+
+// 固定哈夫曼编码(BTYPE=01)
+struct FixedCodes {
+    uint8_t literalLengths[288];
+    uint16_t literalCodes[288];
+    uint8_t distanceLengths[30];
+    uint16_t distanceCodes[30];
+
+    FixedCodes() {
+        for (int i = 0; i < 288; ++i) literalLengths[i] = i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8;
+        for (int i = 0; i < 30; ++i) distanceLengths[i] = 5;
+        BuildCodes(literalLengths, 288, literalCodes);
+        BuildCodes(distanceLengths, 30, distanceCodes);
+    }
+};
+const FixedCodes FIXED;
+
+// 码长序列的游程编码中的一项：0-15为码长，16重复前一个(3-6次)，17/18为连续的0(3-10/11-138个)
+struct CodeLengthSymbol {
+    uint8_t symbol;
+    uint8_t extra;
+};
+constexpr uint8_t CODE_LENGTH_EXTRA_BITS[19] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 3, 7};
+
+void EncodeCodeLengths(const uint8_t* lengths, int count, std::vector<CodeLengthSymbol>& out) {
+    int i = 0;
+    while (i < count) {
+        uint8_t length = lengths[i];
+        int run = 1;
+        while (i + run < count && lengths[i + run] == length) ++run;
+        i += run;
+        if (length == 0) {
+            while (run >= 11) {
+                int n = std::min(run, 138);
+                out.push_back({18, static_cast<uint8_t>(n - 11)});
+                run -= n;
+            }
+            if (run >= 3) {
+                out.push_back({17, static_cast<uint8_t>(run - 3)});
+                run = 0;
+            }
+        } else {
+            out.push_back({length, 0});
+            --run;
+            while (run >= 3) {
+                int n = std::min(run, 6);
+                out.push_back({16, static_cast<uint8_t>(n - 3)});
+                run -= n;
+            }
+        }
+        while (run-- > 0) out.push_back({length, 0});
+    }
+}
+
+}
+
+// 计算CRC-32(可分段：crc为之前各段的结果)
+uint32_t Crc32(std::string_view data, uint32_t crc) {
+    crc ^= 0xffffffffu;
+    for (unsigned char c : data) crc = CRC_TABLE[(crc ^ c) & 0xff] ^ (crc >> 8);
+    return crc ^ 0xffffffffu;
+}
+
+// 构造函数
+GzipEncoder::GzipEncoder(int level) :
+    window_(2 * WINDOW_SIZE),
+    head_(HASH_SIZE, NIL),
+    prev_(WINDOW_SIZE, NIL) {
+    const LevelConfig& config = LEVELS[std::clamp(level, 1, 9)];
+    goodLength_ = config.good;
+    maxLazy_ = config.lazy;
+    niceLength_ = config.nice;
+    maxChain_ = config.chain;
+    symbols_.reserve(MAX_SYMBOLS);
+}
+
+// 一次压缩整段数据
+std::string GzipEncoder::Compress(std::string_view data, int level) {
+    GzipEncoder encoder(level);
+    std::string out;
+    out.reserve(data.size() / 3 + 64);
+    encoder.Write(data, out);
+    encoder.Finish(out);
+    return out;
+}
+
+// 开始一次调用：首次调用时写入gzip头(无文件名与修改时间，操作系统未知)
+void GzipEncoder::Begin(std::string& out) {
+    out_ = &out;
+    if (started_) return;
+    started_ = true;
+    const char header[10] = {'\x1f', '\x8b', 8, 0, 0, 0, 0, 0, 0, '\xff'};
+    out.append(header, sizeof(header));
+}
+
+// 压缩一段输入
+void GzipEncoder::Write(std::string_view data, std::string& out) {
+    if (finished_ || data.empty()) return;
+    Begin(out);
+    bytesIn_ += data.size();
+    crc_ = Crc32(data, crc_);
+    input_ = data;
+    while (!input_.empty()) {
+        FillWindow();
+        Deflate(false);
+    }
+}
+
+// 同步刷新：压缩全部待处理的数据，结束当前块，再输出一个空的存储块使输出按字节对齐
+void GzipEncoder::Flush(std::string& out) {
+    if (finished_) return;
+    Begin(out);
+    Deflate(true);
+    if (!symbols_.empty()) FlushBlock(strStart_, false);
+    PutBits(0, 3);
+    AlignToByte();
+    PutBits(0, 16);
+    PutBits(0xffff, 16);
+}
+
+// 结束压缩流：最后一块、CRC-32与原始长度
+void GzipEncoder::Finish(std::string& out) {
+    if (finished_) return;
+    Begin(out);
+    Deflate(true);
+    FlushBlock(strStart_, true);
+    AlignToByte();
+    PutBits(crc_ & 0xffff, 16);
+    PutBits(crc_ >> 16, 16);
+    PutBits(static_cast<uint32_t>(bytesIn_) & 0xffff, 16);
+    PutBits(static_cast<uint32_t>(bytesIn_ >> 16) & 0xffff, 16);
+    finished_ = true;
+}
+
+// 补充窗口：当前位置进入后半窗口的末端时，先输出当前块，再把后半窗口移到前半
+void GzipEncoder::FillWindow() {
+    if (strStart_ >= WINDOW_SIZE + MAX_DISTANCE) {
+        FlushBlock(strStart_ - (matchAvailable_ ? 1 : 0), false);
+        memmove(window_.data(), window_.data() + WINDOW_SIZE, WINDOW_SIZE);
+        matchStart_ -= WINDOW_SIZE;
+        strStart_ -= WINDOW_SIZE;
+        blockStart_ -= WINDOW_SIZE;
+        for (int& position : head_) position = position >= WINDOW_SIZE ? position - WINDOW_SIZE : NIL;
+        for (int& position : prev_) position = position >= WINDOW_SIZE ? position - WINDOW_SIZE : NIL;
+    }
+    size_t space = window_.size() - static_cast<size_t>(strStart_ + lookahead_);
+    size_t count = std::min(space, input_.size());
+    memcpy(window_.data() + strStart_ + lookahead_, input_.data(), count);
+    lookahead_ += static_cast<int>(count);
+    input_.remove_prefix(count);
+}
+
+// 把position起的3字节加入哈希链
+int GzipEncoder::InsertString(int position) {
+    uint32_t key = static_cast<uint32_t>(window_[position]) | (static_cast<uint32_t>(window_[position + 1]) << 8) |
+                   (static_cast<uint32_t>(window_[position + 2]) << 16);
+    uint32_t hash = (key * 2654435761u) >> (32 - 15);
+    int previous = head_[hash];
+    prev_[position & (WINDOW_SIZE - 1)] = previous;
+    head_[hash] = position;
+    return previous;
+}
+
+// 沿哈希链查找比prevLength_更长的匹配
+int GzipEncoder::LongestMatch(int chain) {
+    int chainLength = prevLength_ >= goodLength_ ? maxChain_ >> 2 : maxChain_;
+    int maxLength = std::min(MAX_MATCH, lookahead_);
+    int nice = std::min(niceLength_, maxLength);
+    int best = prevLength_;
+    int limit = strStart_ > MAX_DISTANCE ? strStart_ - MAX_DISTANCE : NIL;
+    const uint8_t* scan = window_.data() + strStart_;
+    do {
+        const uint8_t* match = window_.data() + chain;
+        if (match[best] != scan[best] || match[0] != scan[0] || match[1] != scan[1]) continue;
+        int length = 2;
+        while (length < maxLength && match[length] == scan[length]) ++length;
+        if (length > best) {
+            matchStart_ = chain;
+            best = length;
+            if (length >= nice) break;
+        }
+    } while ((chain = prev_[chain & (WINDOW_SIZE - 1)]) > limit && --chainLength != 0);
+    return std::min(best, lookahead_);
+}
+
+bool GzipEncoder::TallyLiteral(uint8_t byte) {
+    symbols_.push_back({byte, 0});
+    literalFreq_[byte]++;
+    return symbols_.size() == MAX_SYMBOLS;
+}
+
+bool GzipEncoder::TallyMatch(int distance, int length) {
+    symbols_.push_back({static_cast<uint16_t>(length), static_cast<uint16_t>(distance)});
+    literalFreq_[257 + LENGTH_CODE[length - MIN_MATCH]]++;
+    distanceFreq_[DistanceCode(distance)]++;
+    return symbols_.size() == MAX_SYMBOLS;
+}
+
+// 惰性匹配：当前位置找到匹配后先不输出，若下一个位置的匹配更长则把当前字节作为字面量输出
+void GzipEncoder::Deflate(bool flush) {
+    while (true) {
+        if (lookahead_ < MIN_LOOKAHEAD && !flush) return;  // 等待更多输入
+        if (lookahead_ == 0) break;
+
+        int chain = NIL;
+        if (lookahead_ >= MIN_MATCH) chain = InsertString(strStart_);
+        prevLength_ = matchLength_;
+        prevMatch_ = matchStart_;
+        matchLength_ = MIN_MATCH - 1;
+        if (chain != NIL && prevLength_ < maxLazy_ && strStart_ - chain <= MAX_DISTANCE) {
+            matchLength_ = LongestMatch(chain);
+            // 距离很远的3字节匹配不比3个字面量更短
+            if (matchLength_ == MIN_MATCH && strStart_ - matchStart_ > 4096) matchLength_ = MIN_MATCH - 1;
+        }
+
+        if (prevLength_ >= MIN_MATCH && matchLength_ <= prevLength_) {
+            // 输出上一个位置的匹配，并把匹配覆盖的位置加入哈希链
+            int maxInsert = strStart_ + lookahead_ - MIN_MATCH;
+            bool full = TallyMatch(strStart_ - 1 - prevMatch_, prevLength_);
+            lookahead_ -= prevLength_ - 1;
+            prevLength_ -= 2;
+            do {
+                if (++strStart_ <= maxInsert) InsertString(strStart_);
+            } while (--prevLength_ != 0);
+            matchAvailable_ = false;
+            matchLength_ = MIN_MATCH - 1;
+            ++strStart_;
+            if (full) FlushBlock(strStart_, false);
+        } else if (matchAvailable_) {
+            // 当前位置的匹配更长：上一个字节作为字面量输出
+            if (TallyLiteral(window_[strStart_ - 1])) FlushBlock(strStart_, false);
+            ++strStart_;
+            --lookahead_;
+        } else {
+            matchAvailable_ = true;
+            ++strStart_;
+            --lookahead_;
+        }
+    }
+    if (matchAvailable_) {
+        TallyLiteral(window_[strStart_ - 1]);
+        matchAvailable_ = false;
+    }
+    matchLength_ = MIN_MATCH - 1;
+    prevLength_ = MIN_MATCH - 1;
+}
+
+// 输出一块：比较动态哈夫曼、固定哈夫曼与存储块的大小，取最小者
+void GzipEncoder::FlushBlock(int end, bool last) {
+    literalFreq_[256]++;  // 块结束符
+
+    // 动态编码的码长(每棵树至少两个码，解码器才能接受)
+    uint32_t literalFreq[286];
+    uint32_t distanceFreq[30];
+    memcpy(literalFreq, literalFreq_, sizeof(literalFreq));
+    memcpy(distanceFreq, distanceFreq_, sizeof(distanceFreq));
+    for (uint32_t* freq : {literalFreq, distanceFreq}) {
+        int count = freq == literalFreq ? 286 : 30;
+        int used = static_cast<int>(std::count_if(freq, freq + count, [](uint32_t f) { return f > 0; }));
+        for (int i = 0; used < 2; ++i) {
+            if (freq[i] == 0) {
+                freq[i] = 1;
+                ++used;
+            }
+        }
+    }
+    uint8_t literalLengths[286];
+    uint8_t distanceLengths[30];
+    BuildLengths(literalFreq, 286, 15, literalLengths);
+    BuildLengths(distanceFreq, 30, 15, distanceLengths);
+    int literalCount = 286;
+    while (literalCount > 257 && literalLengths[literalCount - 1] == 0) --literalCount;
+    int distanceCount = 30;
+    while (distanceCount > 1 && distanceLengths[distanceCount - 1] == 0) --distanceCount;
+
+    // 码长序列(字面/长度与距离两部分连在一起游程编码)及其编码
+    uint8_t allLengths[286 + 30];
+    memcpy(allLengths, literalLengths, literalCount);
+    memcpy(allLengths + literalCount, distanceLengths, distanceCount);
+    std::vector<CodeLengthSymbol> codeLengthSymbols;
+    EncodeCodeLengths(allLengths, literalCount + distanceCount, codeLengthSymbols);
+    uint32_t codeLengthFreq[19] = {};
+    for (const auto& item : codeLengthSymbols) codeLengthFreq[item.symbol]++;
+    uint8_t codeLengthLengths[19];
+    BuildLengths(codeLengthFreq, 19, 7, codeLengthLengths);
+    int codeLengthCount = 19;
+    while (codeLengthCount > 4 && codeLengthLengths[CODE_LENGTH_ORDER[codeLengthCount - 1]] == 0) --codeLengthCount;
+
+    // 三种方式的位数
+    uint64_t extraBits = 0;
+    for (int i = 0; i < 29; ++i) extraBits += static_cast<uint64_t>(literalFreq_[257 + i]) * LENGTH_EXTRA[i];
+    for (int i = 0; i < 30; ++i) extraBits += static_cast<uint64_t>(distanceFreq_[i]) * DISTANCE_EXTRA[i];
+    uint64_t dynamicBits = 3 + 14 + 3 * static_cast<uint64_t>(codeLengthCount) + extraBits;
+    for (int i = 0; i < 19; ++i) {
+        dynamicBits += static_cast<uint64_t>(codeLengthFreq[i]) * (codeLengthLengths[i] + CODE_LENGTH_EXTRA_BITS[i]);
+    }
+    uint64_t fixedBits = 3 + extraBits;
+    for (int i = 0; i < 286; ++i) {
+        dynamicBits += static_cast<uint64_t>(literalFreq_[i]) * literalLengths[i];
+        fixedBits += static_cast<uint64_t>(literalFreq_[i]) * FIXED.literalLengths[i];
+    }
+    for (int i = 0; i < 30; ++i) {
+        dynamicBits += static_cast<uint64_t>(distanceFreq_[i]) * distanceLengths[i];
+        fixedBits += static_cast<uint64_t>(distanceFreq_[i]) * FIXED.distanceLengths[i];
+    }
+    size_t storedLength = static_cast<size_t>(end - blockStart_);
+    size_t storedChunks = std::max<size_t>(1, (storedLength + 65534) / 65535);
+    uint64_t storedBits = storedChunks * (3 + 7 + 32) + 8 * static_cast<uint64_t>(storedLength);
+
+    if (storedBits <= dynamicBits && storedBits <= fixedBits) {
+        // 存储块：直接复制原始数据(每块最多65535字节)
+        size_t offset = static_cast<size_t>(blockStart_);
+        for (size_t chunk = 0; chunk < storedChunks; ++chunk) {
+            size_t length = std::min<size_t>(65535, storedLength - chunk * 65535);
+            PutBits(last && chunk + 1 == storedChunks ? 1 : 0, 1);
+            PutBits(0, 2);
+            AlignToByte();
+            PutBits(static_cast<uint32_t>(length), 16);
+            PutBits(static_cast<uint32_t>(~length) & 0xffff, 16);
+            out_->append(reinterpret_cast<const char*>(window_.data() + offset), length);
+            offset += length;
+        }
+    } else {
+        const uint8_t* litLengths = FIXED.literalLengths;
+        const uint16_t* litCodes = FIXED.literalCodes;
+        const uint8_t* distLengths = FIXED.distanceLengths;
+        const uint16_t* distCodes = FIXED.distanceCodes;
+        uint16_t literalCodes[286];
+        uint16_t distanceCodes[30];
+        if (dynamicBits < fixedBits) {
+            BuildCodes(literalLengths, 286, literalCodes);
+            BuildCodes(distanceLengths, 30, distanceCodes);
+            uint16_t codeLengthCodes[19];
+            BuildCodes(codeLengthLengths, 19, codeLengthCodes);
+            PutBits(last ? 1 : 0, 1);
+            PutBits(2, 2);
+            PutBits(static_cast<uint32_t>(literalCount - 257), 5);
+            PutBits(static_cast<uint32_t>(distanceCount - 1), 5);
+            PutBits(static_cast<uint32_t>(codeLengthCount - 4), 4);
+            for (int i = 0; i < codeLengthCount; ++i) PutBits(codeLengthLengths[CODE_LENGTH_ORDER[i]], 3);
+            for (const auto& item : codeLengthSymbols) {
+                PutBits(codeLengthCodes[item.symbol], codeLengthLengths[item.symbol]);
+                if (CODE_LENGTH_EXTRA_BITS[item.symbol]) PutBits(item.extra, CODE_LENGTH_EXTRA_BITS[item.symbol]);
+            }
+            litLengths = literalLengths;
+            litCodes = literalCodes;
+            distLengths = distanceLengths;
+            distCodes = distanceCodes;
+        } else {
+            PutBits(last ? 1 : 0, 1);
+            PutBits(1, 2);
+        }
+        for (const Symbol& symbol : symbols_) {
+            if (symbol.distance == 0) {
+                PutBits(litCodes[symbol.value], litLengths[symbol.value]);
+                continue;
+            }
+            int lengthCode = LENGTH_CODE[symbol.value - MIN_MATCH];
+            PutBits(litCodes[257 + lengthCode], litLengths[257 + lengthCode]);
+            if (LENGTH_EXTRA[lengthCode]) PutBits(symbol.value - LENGTH_BASE[lengthCode], LENGTH_EXTRA[lengthCode]);
+            int distanceCode = DistanceCode(symbol.distance);
+            PutBits(distCodes[distanceCode], distLengths[distanceCode]);
+            if (DISTANCE_EXTRA[distanceCode]) {
+                PutBits(symbol.distance - DISTANCE_BASE[distanceCode], DISTANCE_EXTRA[distanceCode]);
+            }
+        }
+        PutBits(litCodes[256], litLengths[256]);
+    }
+
+    symbols_.clear();
+    memset(literalFreq_, 0, sizeof(literalFreq_));
+    memset(distanceFreq_, 0, sizeof(distanceFreq_));
+    blockStart_ = end;
+}
+
+// 从低位开始写入count位(攒满32位时输出4字节)
+void GzipEncoder::PutBits(uint32_t value, int count) {
+    bitBuffer_ |= static_cast<uint64_t>(value) << bitCount_;
+    bitCount_ += count;
+    if (bitCount_ >= 32) {
+        char bytes[4] = {static_cast<char>(bitBuffer_), static_cast<char>(bitBuffer_ >> 8),
+                         static_cast<char>(bitBuffer_ >> 16), static_cast<char>(bitBuffer_ >> 24)};
+        out_->append(bytes, 4);
+        bitBuffer_ >>= 32;
+        bitCount_ -= 32;
+    }
+}
+
+// 输出剩余的位，补齐到字节边界
+void GzipEncoder::AlignToByte() {
+    while (bitCount_ > 0) {
+        out_->push_back(static_cast<char>(bitBuffer_));
+        bitBuffer_ >>= 8;
+        bitCount_ -= 8;
+    }
+    bitBuffer_ = 0;
+    bitCount_ = 0;
+}
@@ -0,0 +1,196 @@
+#include "http_conditional.hpp"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+const char* const MONTHS[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+// 写入十六进制数(不含前导零)，返回写入的字符数
+size_t PutHex(char* out, uint64_t value) {
+    auto result = std::to_chars(out, out + 16, value, 16);
+    return static_cast<size_t>(result.ptr - out);
+}
+
+// 去除首尾的空格与制表符
+std::string_view Trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+    return text;
+}
+
+// 解析十进制数(只允许数字，不允许为空或溢出)
+bool ParseNumber(std::string_view text, uint64_t& value) {
+    if (text.empty()) return false;
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+// 解析两位数字
+bool Parse2(const char* p, int& value) {
+    if (p[0] < '0' || p[0] > '9' || p[1] < '0' || p[1] > '9') return false;
+    value = (p[0] - '0') * 10 + (p[1] - '0');
+    return true;
+}
+
+// 公历日期距1970-01-01的天数
+int64_t DaysFromCivil(int64_t year, int month, int day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int64_t yearOfEra = year - era * 400;
+    int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+// 去掉弱校验的"W/"前缀
+std::string_view Opaque(std::string_view tag) {
+    return tag.substr(0, 2) == "W/" ? tag.substr(2) : tag;
+}
+
+// 合并重叠或间隔不超过RANGE_COALESCE_GAP的范围(RFC 9110 §14.2)：重复的"0-"不会让整个文件发送多次；
+// 没有需要合并的范围时保持请求的顺序
+void CoalesceRanges(RangeSet& set) {
+    ByteRange* ranges = set.ranges;
+    auto near = [](const ByteRange& a, const ByteRange& b) {
+        return a.offset <= b.offset + b.length + RANGE_COALESCE_GAP &&
+               b.offset <= a.offset + a.length + RANGE_COALESCE_GAP;
+    };
+    bool needed = false;
+    for (size_t i = 0; i < set.count && !needed; ++i) {
+        for (size_t j = i + 1; j < set.count && !needed; ++j) needed = near(ranges[i], ranges[j]);
+    }
+    if (!needed) return;
+
+    std::sort(ranges, ranges + set.count, [](const ByteRange& a, const ByteRange& b) { return a.offset < b.offset; });
+    size_t count = 1;
+    for (size_t i = 1; i < set.count; ++i) {
+        ByteRange& last = ranges[count - 1];
+        if (ranges[i].offset <= last.offset + last.length + RANGE_COALESCE_GAP) {
+            last.length = std::max(last.offset + last.length, ranges[i].offset + ranges[i].length) - last.offset;
+        } else {
+            ranges[count++] = ranges[i];
+        }
+    }
+    set.count = count;
+}
+
+}
+
+// 由文件大小与修改时间生成校验信息
+Validators MakeValidators(uint64_t size, std::filesystem::file_time_type mtime, std::string_view coding) {
+    Validators validators;
+    char* p = validators.etag;
+    *p++ = '"';
+    p += PutHex(p, size);
+    *p++ = '-';
+    p += PutHex(p, static_cast<uint64_t>(mtime.time_since_epoch().count()));
+    if (!coding.empty() && coding.size() < ETAG_MAX - 36) {
+        *p++ = '-';
+        memcpy(p, coding.data(), coding.size());
+        p += coding.size();
+    }
+    *p++ = '"';
+    validators.etagSize = static_cast<size_t>(p - validators.etag);
+
+    auto systemTime = std::chrono::file_clock::to_sys(mtime);
+    validators.modified = std::chrono::system_clock::to_time_t(
+        std::chrono::time_point_cast<std::chrono::seconds>(systemTime));
+    FormatHttpDate(validators.modified, validators.lastModified);
+    return validators;
+}
+
+// 解析IMF-fixdate
+std::optional<std::time_t> ParseHttpDate(std::string_view text) {
+    if (text.size() != HTTP_DATE_SIZE || text[3] != ',' || text[4] != ' ' || text[7] != ' ' ||
+        text[11] != ' ' || text[16] != ' ' || text[19] != ':' || text[22] != ':' || text.substr(25) != " GMT") {
+        return std::nullopt;
+    }
+    int month = 0;
+    while (month < 12 && text.substr(8, 3) != MONTHS[month]) ++month;
+    int day, century, year, hour, minute, second;
+    if (month == 12 || !Parse2(&text[5], day) || !Parse2(&text[12], century) || !Parse2(&text[14], year) ||
+        !Parse2(&text[17], hour) || !Parse2(&text[20], minute) || !Parse2(&text[23], second)) {
+        return std::nullopt;
+    }
+    if (day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) return std::nullopt;
+    int64_t days = DaysFromCivil(century * 100 + year, month + 1, day);
+    return static_cast<std::time_t>(days * 86400 + hour * 3600 + minute * 60 + second);
+}
+
+// If-None-Match("*"或逗号分隔的ETag列表，弱比较)，没有时按If-Modified-Since
+bool NotModified(const HttpRequest& request, const Validators& validators) {
+    std::string_view ifNoneMatch = request.header(KnownHeader::IF_NONE_MATCH);
+    if (!ifNoneMatch.empty()) {
+        if (Trim(ifNoneMatch) == "*") return true;
+        std::string_view etag = validators.ETag();
+        while (!ifNoneMatch.empty()) {
+            size_t comma = ifNoneMatch.find(',');
+            if (Opaque(Trim(ifNoneMatch.substr(0, comma))) == etag) return true;
+            if (comma == std::string_view::npos) break;
+            ifNoneMatch.remove_prefix(comma + 1);
+        }
+        return false;
+    }
+    std::string_view ifModifiedSince = request.header(KnownHeader::IF_MODIFIED_SINCE);
+    if (ifModifiedSince.empty()) return false;
+    std::optional<std::time_t> since = ParseHttpDate(ifModifiedSince);
+    return since && validators.modified <= *since;
+}
+
+// If-Range：ETag须强匹配(弱ETag不匹配)，日期须与Last-Modified相同
+bool IfRangeMatches(const HttpRequest& request, const Validators& validators) {
+    std::string_view ifRange = request.header(KnownHeader::IF_RANGE);
+    if (ifRange.empty()) return true;
+    if (ifRange.front() == '"' || ifRange.substr(0, 2) == "W/") return ifRange == validators.ETag();
+    std::optional<std::time_t> date = ParseHttpDate(ifRange);
+    return date && *date == validators.modified;
+}
+
+// 解析Range头：任何一个范围格式错误时忽略整个头；起点超出文件的范围不可满足；
+// 终点超出文件末尾时截断，"-n"表示最后n字节；重叠或相近的范围合并
+RangeStatus ParseRange(std::string_view header, uint64_t size, RangeSet& ranges) {
+    ranges.count = 0;
+    if (header.size() < 6 || header.substr(0, 6) != "bytes=") return RangeStatus::NONE;
+    header.remove_prefix(6);
+
+    bool any = false;  // 至少有一个格式正确的范围
+    while (!header.empty()) {
+        size_t comma = header.find(',');
+        std::string_view spec = Trim(header.substr(0, comma));
+        header = comma == std::string_view::npos ? std::string_view() : header.substr(comma + 1);
+        if (spec.empty()) continue;  // 列表中允许空元素
+
+        size_t dash = spec.find('-');
+        if (dash == std::string_view::npos) return RangeStatus::NONE;
+        std::string_view first = spec.substr(0, dash);
+        std::string_view last = spec.substr(dash + 1);
+        uint64_t start = 0, end = 0;
+        if (first.empty()) {
+            // 后缀范围：最后n字节(n为0时不可满足)
+            uint64_t suffix = 0;
+            if (!ParseNumber(last, suffix)) return RangeStatus::NONE;
+            any = true;
+            if (suffix == 0 || size == 0) continue;
+            start = suffix < size ? size - suffix : 0;
+            end = size - 1;
+        } else {
+            if (!ParseNumber(first, start)) return RangeStatus::NONE;
+            if (last.empty()) {
+                end = UINT64_MAX;
+            } else if (!ParseNumber(last, end) || end < start) {
+                return RangeStatus::NONE;
+            }
+            any = true;
+            if (start >= size) continue;
+            end = end < size - 1 ? end : size - 1;
+        }
+        if (ranges.count == MAX_RANGES) return RangeStatus::NONE;
+        ranges.ranges[ranges.count++] = ByteRange{start, end - start + 1};
+    }
+    if (ranges.count > 1) CoalesceRanges(ranges);
+    if (ranges.count > 0) return RangeStatus::PARTIAL;
+    return any ? RangeStatus::UNSATISFIABLE : RangeStatus::NONE;
+}
@@ -1,119 +1,280 @@
 #include "http_parser.hpp"
+#include "http_scan.hpp"
 #include <algorithm>
-#include <cctype>
+#include <charconv>
+
+namespace {
+
+// 常用头名称表(与KnownHeader顺序一致)
+const std::string_view KNOWN_HEADER_NAMES[] = {
+    "Host",
+    "Content-Length",
+    "Content-Type",
+    "Connection",
+    "Accept-Encoding",
+    "Range",
+    "If-None-Match",
+    "If-Modified-Since",
+    "If-Range",
+    "Transfer-Encoding",
+};
+static_assert(sizeof(KNOWN_HEADER_NAMES) / sizeof(KNOWN_HEADER_NAMES[0]) ==
+              static_cast<size_t>(KnownHeader::COUNT), "known header table mismatch");
+
+// ASCII小写转换(不依赖locale)
+inline char ToLowerAscii(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+// 不区分大小写比较
+bool EqualsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (ToLowerAscii(a[i]) != ToLowerAscii(b[i])) return false;
+    }
+    return true;
+}
+
+// 查找常用头，未找到时返回COUNT
+KnownHeader FindKnownHeader(std::string_view name) {
+    for (size_t i = 0; i < static_cast<size_t>(KnownHeader::COUNT); ++i) {
+        if (EqualsIgnoreCase(name, KNOWN_HEADER_NAMES[i])) return static_cast<KnownHeader>(i);
+    }
+    return KnownHeader::COUNT;
+}
+
+}
+
+// 按名称获取头值
+std::string_view HttpRequest::header(std::string_view name) const {
+    for (size_t i = 0; i < headerCount; ++i) {
+        if (EqualsIgnoreCase(headers[i].name, name)) return headers[i].value;
+    }
+    return {};
+}
 
 // 构造函数，初始化状态
-HttpParser::HttpParser() : 
-    state_(State::METHOD), 
-    content_length_(0),
-    bytes_remaining_(0) {}
+HttpParser::HttpParser() { reset(); }
 
 // 重置解析器状态
 void HttpParser::reset() {
     state_ = State::METHOD;
-    request_ = HttpRequest{};
-    current_header_.clear();
+    offset_ = 0;
+    token_start_ = 0;
+    value_start_ = 0;
+    uri_ = Span();
+    version_ = Span();
+    body_ = Span();
+    request_.method = HttpMethod::UNKNOWN;
+    request_.headerCount = 0;
     content_length_ = 0;
+    has_content_length_ = false;
+    has_transfer_encoding_ = false;
     bytes_remaining_ = 0;
 }
 
-// 解析HTTP数据
+// 解析HTTP数据(从offset_处继续)
+// 各状态用ScanSpan成块跳过普通字符，只在停止字节(空格、冒号、CR/LF、非法字符)处处理
 ParseStatus HttpParser::parse(const char* data, size_t length) {
-    for (size_t i = 0; i < length; ++i) {
-        char c = data[i];
-        
+    size_t i = offset_;
+    while (i < length) {
         switch (state_) {
-            case State::METHOD:
-                if (c == ' ') {
-                    // 确定HTTP方法
-                    if (current_header_ == "GET") {
-                        request_.method = HttpMethod::GET;
-                    } else if (current_header_ == "POST") {
-                        request_.method = HttpMethod::POST;
-                    } else {
-                        return ParseStatus::FAILED;  // 未知方法
-                    }
-                    current_header_.clear();
-                    state_ = State::URI;
+            case State::METHOD: {
+                i += ScanSpan(data + i, length - i, ScanClass::TOKEN);
+                if (i == length) break;
+                if (data[i] != ' ') return ParseStatus::FAILED;
+
+                // 确定HTTP方法
+                std::string_view method(data + token_start_, i - token_start_);
+                if (method == "GET") {
+                    request_.method = HttpMethod::GET;
+                } else if (method == "POST") {
+                    request_.method = HttpMethod::POST;
                 } else {
-                    current_header_ += c;  // 累积方法字符
+                    return ParseStatus::FAILED;  // 未知方法
                 }
+                token_start_ = ++i;
+                state_ = State::URI;
                 break;
+            }
                 
             case State::URI:
-                if (c == ' ') {
-                    state_ = State::VERSION;  // 转到版本解析
-                } else {
-                    request_.uri += c;  // 累积URI字符
-                }
+                i += ScanSpan(data + i, length - i, ScanClass::URI);
+                if (i == length) break;
+                if (data[i] != ' ' || i == token_start_) return ParseStatus::FAILED;
+                uri_ = {token_start_, i - token_start_};
+                token_start_ = ++i;
+                state_ = State::VERSION;  // 转到版本解析
                 break;
                 
-            case State::VERSION:
-                if (c == '\r') {
-                    state_ = State::HEADER_NAME;  // 转到头解析
-                } else if (c != '\n') {
-                    request_.version += c;  // 累积版本字符
+            case State::VERSION: {
+                i += ScanSpan(data + i, length - i, ScanClass::URI);
+                if (i == length) break;
+                size_t end = i;
+                int eol = LineEnding(data, i, length);
+                if (eol == 0) {
+                    offset_ = i;  // CR之后的字节尚未到达，下次从CR处继续
+                    return ParseStatus::INCOMPLETE;
                 }
+                if (eol < 0) return ParseStatus::FAILED;
+                version_ = {token_start_, end - token_start_};
+                i += eol;
+                token_start_ = i;
+                state_ = State::HEADER_NAME;  // 转到头解析
                 break;
+            }
                 
-            case State::HEADER_NAME:
-                if (c == ':') {
-                    state_ = State::HEADER_VALUE;  // 转到头值解析
-                } else if (c == '\r') {
+            case State::HEADER_NAME: {
+                // 行首为CR/LF：空行，头部结束
+                if (i == token_start_ && (data[i] == '\r' || data[i] == '\n')) {
+                    int eol = LineEnding(data, i, length);
+                    if (eol == 0) {
+                        offset_ = i;
+                        return ParseStatus::INCOMPLETE;
+                    }
+                    if (eol < 0) return ParseStatus::FAILED;
+                    i += eol;
+
+                    // 带Transfer-Encoding的请求体边界无法按Content-Length确定，不能把之后的字节当作下一个请求(请求走私)：
+                    // 同时带Content-Length时格式错误，否则为不支持的功能
+                    if (has_transfer_encoding_) {
+                        offset_ = i;
+                        return has_content_length_ ? ParseStatus::FAILED : ParseStatus::UNSUPPORTED;
+                    }
+
                     // 检查是否需要解析体
-                    if (request_.method == HttpMethod::POST && content_length_ > 0) {
+                    body_.offset = i;
+                    if (content_length_ > 0 && header_only_) {
+                        state_ = State::COMPLETE;  // 请求体由调用者读取
+                        offset_ = i;
+                        Finish(data);
+                        return ParseStatus::SUCCESS;
+                    }
+                    if (content_length_ > 0) {
                         bytes_remaining_ = content_length_;
                         state_ = State::BODY;
-                    } else {
-                        state_ = State::COMPLETE;  // 完成解析
+                        break;
                     }
-                } else {
-                    current_header_ += c;  // 累积头名字符
+                    state_ = State::COMPLETE;  // 完成解析
+                    offset_ = i;
+                    Finish(data);
+                    return ParseStatus::SUCCESS;
                 }
+
+                i += ScanSpan(data + i, length - i, ScanClass::TOKEN);
+                if (i == length) break;
+                if (data[i] != ':' || i == token_start_) {
+                    return ParseStatus::FAILED;  // 头名称为空、含非法字符或缺少冒号
+                }
+                value_start_ = ++i;
+                state_ = State::HEADER_VALUE;  // 转到头值解析
                 break;
+            }
                 
-            case State::HEADER_VALUE:
-                if (c == '\r') {
-                    // 处理头值
-                    std::string value = current_header_;
-                    value.erase(0, value.find_first_not_of(" \t"));  // 去除前导空白
-                    value.erase(value.find_last_not_of(" \t") + 1);   // 去除尾部空白
-                    
-                    // 特殊处理Content-Length头
-                    if (current_header_ == "Content-Length") {
-                        try {
-                            content_length_ = std::stoul(value);  // 转换内容长度
-                        } catch (...) {
-                            return ParseStatus::FAILED;  // 转换失败
-                        }
-                    }
-                    
-                    // 存储头字段
-                    request_.headers[current_header_] = value;
-                    current_header_.clear();
-                    state_ = State::HEADER_NAME;
-                } else if (c != '\n') {
-                    current_header_ += c;  // 累积头值字符
+            case State::HEADER_VALUE: {
+                i += ScanSpan(data + i, length - i, ScanClass::HEADER_VALUE);
+                if (i == length) break;
+                int eol = LineEnding(data, i, length);
+                if (eol == 0) {
+                    offset_ = i;
+                    return ParseStatus::INCOMPLETE;
                 }
+                if (eol < 0) return ParseStatus::FAILED;  // 头值含控制字符
+                if (!AddHeader(data, i)) return ParseStatus::FAILED;
+                i += eol;
+                token_start_ = i;
+                state_ = State::HEADER_NAME;
                 break;
+            }
                 
-            case State::BODY:
-                request_.body += c;  // 累积体数据
-                if (--bytes_remaining_ == 0) {
+            case State::BODY: {
+                // 体数据无需逐字节处理，直接跳过
+                size_t chunk = std::min(bytes_remaining_, length - i);
+                bytes_remaining_ -= chunk;
+                i += chunk;
+                if (bytes_remaining_ == 0) {
+                    body_.length = content_length_;
                     state_ = State::COMPLETE;  // 完成体解析
+                    offset_ = i;
+                    Finish(data);
+                    return ParseStatus::SUCCESS;
                 }
                 break;
+            }
                 
             case State::COMPLETE:
                 return ParseStatus::SUCCESS;  // 返回成功
         }
     }
     
-    // 返回当前状态
+    // 记录断点，下次从这里继续
+    if (state_ != State::COMPLETE) offset_ = length;
     return (state_ == State::COMPLETE) ? ParseStatus::SUCCESS : ParseStatus::INCOMPLETE;
 }
 
+// 只解析请求头(请求体不计入consumed())
+ParseStatus HttpParser::parseHeader(const char* data, size_t length) {
+    header_only_ = true;
+    ParseStatus status = parse(data, length);
+    header_only_ = false;
+    return status;
+}
+
+// 检查data[i]处的行结束符：返回其长度(LF为1，CRLF为2)，数据不足返回0，不是行结束符返回-1
+int HttpParser::LineEnding(const char* data, size_t i, size_t length) {
+    if (data[i] == '\n') return 1;
+    if (data[i] != '\r') return -1;
+    if (i + 1 == length) return 0;
+    return data[i + 1] == '\n' ? 2 : -1;
+}
+
+// 保存一个头字段(lineEnd为行结束符的偏移)
+bool HttpParser::AddHeader(const char* data, size_t lineEnd) {
+    if (request_.headerCount == MAX_HEADERS) return false;  // 头字段过多
+
+    // 去除值的首尾空白
+    size_t begin = value_start_;
+    size_t end = lineEnd;
+    while (begin < end && (data[begin] == ' ' || data[begin] == '\t')) ++begin;
+    while (end > begin && (data[end - 1] == ' ' || data[end - 1] == '\t')) --end;
+
+    size_t index = request_.headerCount++;
+    header_names_[index] = {token_start_, value_start_ - 1 - token_start_};
+    header_values_[index] = {begin, end - begin};
+
+    // 特殊处理Content-Length头：重复出现时值必须相同，否则前后两级对请求边界的理解可能不同(请求走私)
+    std::string_view name(data + token_start_, header_names_[index].length);
+    if (EqualsIgnoreCase(name, KNOWN_HEADER_NAMES[static_cast<size_t>(KnownHeader::CONTENT_LENGTH)])) {
+        size_t length = 0;
+        auto result = std::from_chars(data + begin, data + end, length);
+        if (result.ec != std::errc() || result.ptr != data + end) {
+            return false;  // 转换失败
+        }
+        if (has_content_length_ && length != content_length_) return false;  // 相互矛盾的长度
+        content_length_ = length;
+        has_content_length_ = true;
+    } else if (EqualsIgnoreCase(name, KNOWN_HEADER_NAMES[static_cast<size_t>(KnownHeader::TRANSFER_ENCODING)])) {
+        has_transfer_encoding_ = true;
+    }
+    return true;
+}
+
+// 生成请求中的string_view(缓冲区可能在多次parse之间扩容，因此只在完成时生成)
+void HttpParser::Finish(const char* data) {
+    request_.uri = std::string_view(data + uri_.offset, uri_.length);
+    request_.version = std::string_view(data + version_.offset, version_.length);
+    request_.body = std::string_view(data + body_.offset, body_.length);
+    std::fill(std::begin(request_.known), std::end(request_.known), std::string_view());
+    for (size_t i = 0; i < request_.headerCount; ++i) {
+        HttpHeader& header = request_.headers[i];
+        header.name = std::string_view(data + header_names_[i].offset, header_names_[i].length);
+        header.value = std::string_view(data + header_values_[i].offset, header_values_[i].length);
+        KnownHeader id = FindKnownHeader(header.name);
+        if (id != KnownHeader::COUNT) request_.known[static_cast<size_t>(id)] = header.value;
+    }
+}
+
 // 获取解析后的请求
 const HttpRequest& HttpParser::request() const {
     return request_;
-}
\ No newline at end of file
+}
@@ -0,0 +1,212 @@
+#include "http_scan.hpp"
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define HTTP_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// 字符类别描述
+// ranges为停止字节的闭区间列表(最多8个，供PCMPESTRI使用)，允许是停止集合的超集，
+// stop表是唯一权威的判定：向量化路径命中后由stop表复核，误报的字节会被跳过
+struct ClassInfo {
+    const char* ranges;
+    int rangeBytes;
+    bool stop[256];
+};
+
+ClassInfo classes[3];
+
+#ifdef HTTP_SCAN_X86
+// tchar的半字节位图：bit(hi)置于TOKEN_LOW[lo]表示字节(hi<<4|lo)是tchar，
+// 由ClassInit从stop表生成，AVX2路径用两次PSHUFB完成精确分类
+alignas(32) uint8_t TOKEN_LOW[32];
+alignas(32) uint8_t TOKEN_HIGH[32];
+#endif
+
+// 初始化字符类别
+struct ClassInit {
+    ClassInit() {
+        // tchar之外的字节："\"(),/:;<=>?@[\]{}、空白、控制字符与非ASCII字节
+        // 向量化区间把{|}~与DEL及以上合并为一个区间，|和~由stop表复核放行
+        ClassInfo& token = classes[static_cast<int>(ScanClass::TOKEN)];
+        token.ranges = "\x00\x20\"\"()\x2c\x2c//:@[]{\xff";
+        token.rangeBytes = 16;
+        for (int c = 0; c < 256; ++c) {
+            bool alnum = (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+            bool symbol = c != 0 && c < 0x80 && std::strchr("!#$%&'*+-.^_`|~", c) != nullptr;
+            token.stop[c] = !(alnum || symbol);
+        }
+
+        ClassInfo& uri = classes[static_cast<int>(ScanClass::URI)];
+        uri.ranges = "\x00\x20\x7f\x7f";
+        uri.rangeBytes = 4;
+        for (int c = 0; c < 256; ++c) uri.stop[c] = c <= 0x20 || c == 0x7f;
+
+        ClassInfo& value = classes[static_cast<int>(ScanClass::HEADER_VALUE)];
+        value.ranges = "\x00\x08\x0a\x1f\x7f\x7f";
+        value.rangeBytes = 6;
+        for (int c = 0; c < 256; ++c) value.stop[c] = (c < 0x20 && c != '\t') || c == 0x7f;
+
+#ifdef HTTP_SCAN_X86
+        // 生成tchar半字节位图(两个128位通道各一份)
+        for (int c = 0; c < 0x80; ++c) {
+            if (!token.stop[c]) {
+                TOKEN_LOW[c & 0x0f] |= static_cast<uint8_t>(1 << (c >> 4));
+                TOKEN_LOW[16 + (c & 0x0f)] |= static_cast<uint8_t>(1 << (c >> 4));
+            }
+        }
+        for (int h = 0; h < 8; ++h) {
+            TOKEN_HIGH[h] = TOKEN_HIGH[16 + h] = static_cast<uint8_t>(1 << h);
+        }
+#endif
+    }
+} classInit;
+
+// 标量实现：逐字节查表
+size_t ScanScalar(const char* data, size_t length, const ClassInfo& cls) {
+    for (size_t i = 0; i < length; ++i) {
+        if (cls.stop[static_cast<unsigned char>(data[i])]) return i;
+    }
+    return length;
+}
+
+#ifdef HTTP_SCAN_X86
+// SSE4.2实现：PCMPESTRI一次在16字节中查找落入任一区间的字节
+__attribute__((target("sse4.2")))
+size_t ScanSse42(const char* data, size_t length, const ClassInfo& cls) {
+    __m128i ranges = _mm_setzero_si128();
+    __builtin_memcpy(&ranges, cls.ranges, cls.rangeBytes);
+    size_t i = 0;
+    while (i + 16 <= length) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        int index = _mm_cmpestri(ranges, cls.rangeBytes, chunk, 16,
+                                 _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+        if (index == 16) {
+            i += 16;
+        } else if (cls.stop[static_cast<unsigned char>(data[i + index])]) {
+            return i + index;
+        } else {
+            i += index + 1;  // 区间误报，跳过该字节
+        }
+    }
+    return i + ScanScalar(data + i, length - i, cls);
+}
+
+// AVX2实现：每次32字节，按类别使用专门的比较序列
+__attribute__((target("avx2")))
+inline uint32_t StopMaskAvx2(__m256i chunk, ScanClass cls) {
+    __m256i stop;
+    switch (cls) {
+        case ScanClass::TOKEN: {
+            __m256i low = _mm256_and_si256(chunk, _mm256_set1_epi8(0x0f));
+            __m256i high = _mm256_and_si256(_mm256_srli_epi16(chunk, 4), _mm256_set1_epi8(0x0f));
+            __m256i bits = _mm256_and_si256(
+                _mm256_shuffle_epi8(_mm256_load_si256(reinterpret_cast<const __m256i*>(TOKEN_LOW)), low),
+                _mm256_shuffle_epi8(_mm256_load_si256(reinterpret_cast<const __m256i*>(TOKEN_HIGH)), high));
+            stop = _mm256_cmpeq_epi8(bits, _mm256_setzero_si256());
+            break;
+        }
+        case ScanClass::URI: {
+            // x <= 0x20 或 x == 0x7f
+            __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, _mm256_set1_epi8(0x20)), chunk);
+            stop = _mm256_or_si256(control, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(0x7f)));
+            break;
+        }
+        default: {
+            // x < 0x20 且 x != '\t'，或 x == 0x7f
+            __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, _mm256_set1_epi8(0x1f)), chunk);
+            control = _mm256_andnot_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t')), control);
+            stop = _mm256_or_si256(control, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(0x7f)));
+            break;
+        }
+    }
+    return static_cast<uint32_t>(_mm256_movemask_epi8(stop));
+}
+
+__attribute__((target("avx2")))
+size_t ScanAvx2(const char* data, size_t length, const ClassInfo& cls) {
+    ScanClass id = static_cast<ScanClass>(&cls - classes);
+    size_t i = 0;
+    while (i + 32 <= length) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        uint32_t mask = StopMaskAvx2(chunk, id);
+        if (mask != 0) return i + __builtin_ctz(mask);
+        i += 32;
+    }
+    // 不足32字节的尾部交给SSE4.2(AVX2处理器均支持SSE4.2)
+    return i + ScanSse42(data + i, length - i, cls);
+}
+#endif
+
+using ScanFn = size_t (*)(const char*, size_t, const ClassInfo&);
+
+// 检测CPU是否支持指定实现
+bool Supported(ScanLevel level) {
+    switch (level) {
+        case ScanLevel::SCALAR:
+            return true;
+#ifdef HTTP_SCAN_X86
+        case ScanLevel::SSE42:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse4.2");
+        case ScanLevel::AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+ScanFn FunctionFor(ScanLevel level) {
+    switch (level) {
+#ifdef HTTP_SCAN_X86
+        case ScanLevel::SSE42: return ScanSse42;
+        case ScanLevel::AVX2: return ScanAvx2;
+#endif
+        default: return ScanScalar;
+    }
+}
+
+// 启动时选择CPU支持的最快实现
+ScanLevel DetectLevel() {
+    if (Supported(ScanLevel::AVX2)) return ScanLevel::AVX2;
+    if (Supported(ScanLevel::SSE42)) return ScanLevel::SSE42;
+    return ScanLevel::SCALAR;
+}
+
+ScanLevel currentLevel = DetectLevel();
+ScanFn currentScan = FunctionFor(currentLevel);
+
+}
+
+// 返回第一个停止字节的下标
+size_t ScanSpan(const char* data, size_t length, ScanClass cls) {
+    return currentScan(data, length, classes[static_cast<int>(cls)]);
+}
+
+// 当前使用的实现
+ScanLevel GetScanLevel() {
+    return currentLevel;
+}
+
+// 切换实现
+bool SetScanLevel(ScanLevel level) {
+    if (!Supported(level)) return false;
+    currentLevel = level;
+    currentScan = FunctionFor(level);
+    return true;
+}
+
+// 实现名称
+const char* ScanLevelName(ScanLevel level) {
+    switch (level) {
+        case ScanLevel::SSE42: return "sse4.2";
+        case ScanLevel::AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
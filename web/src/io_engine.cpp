@@ -0,0 +1,123 @@
+#include "io_engine.hpp"
+#ifdef _WIN32
+#include "iocp_engine.hpp"
+#else
+#include "epoll_engine.hpp"
+#include "uring_engine.hpp"
+#endif
+
+// 移动构造(转移文件所有权)
+OutputSegment::OutputSegment(OutputSegment&& other) noexcept :
+    data(std::move(other.data)),
+    shared(std::move(other.shared)),
+    file(other.file),
+    offset(other.offset),
+    remaining(other.remaining) {
+    other.file = INVALID_FILE;
+}
+
+// 移动赋值
+OutputSegment& OutputSegment::operator=(OutputSegment&& other) noexcept {
+    if (this != &other) {
+        if (IsFile()) CloseFile(file);
+        data = std::move(other.data);
+        shared = std::move(other.shared);
+        file = other.file;
+        offset = other.offset;
+        remaining = other.remaining;
+        other.file = INVALID_FILE;
+    }
+    return *this;
+}
+
+// 析构时关闭持有的文件
+OutputSegment::~OutputSegment() {
+    if (IsFile()) CloseFile(file);
+}
+
+// 移动构造(接管槽位)
+OutputQueue::OutputQueue(OutputQueue&& other) noexcept :
+    slots_(std::move(other.slots_)),
+    capacity_(other.capacity_),
+    head_(other.head_),
+    count_(other.count_) {
+    other.capacity_ = other.head_ = other.count_ = 0;
+}
+
+// 移动赋值
+OutputQueue& OutputQueue::operator=(OutputQueue&& other) noexcept {
+    if (this != &other) {
+        slots_ = std::move(other.slots_);
+        capacity_ = other.capacity_;
+        head_ = other.head_;
+        count_ = other.count_;
+        other.capacity_ = other.head_ = other.count_ = 0;
+    }
+    return *this;
+}
+
+// 追加到队尾
+void OutputQueue::push_back(OutputSegment segment) {
+    if (count_ == capacity_) Grow();
+    slots_[(head_ + count_) & (capacity_ - 1)] = std::move(segment);
+    ++count_;
+}
+
+// 放回队首
+void OutputQueue::push_front(OutputSegment segment) {
+    if (count_ == capacity_) Grow();
+    head_ = (head_ + capacity_ - 1) & (capacity_ - 1);
+    slots_[head_] = std::move(segment);
+    ++count_;
+}
+
+// 移除队首：移出后立即析构，释放数据、共享引用或文件
+void OutputQueue::pop_front() {
+    OutputSegment released(std::move(slots_[head_]));
+    head_ = (head_ + 1) & (capacity_ - 1);
+    --count_;
+}
+
+// 移除全部
+void OutputQueue::clear() {
+    while (count_ > 0) pop_front();
+    head_ = 0;
+}
+
+// 容量翻倍，按队列顺序搬到新槽位
+void OutputQueue::Grow() {
+    size_t capacity = capacity_ ? capacity_ * 2 : 4;
+    std::unique_ptr<OutputSegment[]> slots(new OutputSegment[capacity]);
+    for (size_t i = 0; i < count_; ++i) {
+        slots[i] = std::move((*this)[i]);
+    }
+    slots_ = std::move(slots);
+    capacity_ = capacity;
+    head_ = 0;
+}
+
+// 每个事件循环分得的连接上限
+size_t LoopConnectionLimit(const IoEngineOptions& options, size_t loops) {
+    if (options.maxConnections == 0 || loops == 0) return SIZE_MAX;
+    return (options.maxConnections + loops - 1) / loops;
+}
+
+// 当前平台的默认引擎名称
+const char* DefaultIoEngineName() {
+#ifdef _WIN32
+    return "iocp";
+#else
+    return "epoll";
+#endif
+}
+
+// 根据名称创建I/O引擎
+std::unique_ptr<IoEngine> CreateIoEngine(const std::string& name) {
+#ifdef _WIN32
+    if (name == "iocp") return std::make_unique<IocpEngine>();
+#else
+    if (name == "epoll") return std::make_unique<EpollEngine>();
+    if (name == "uring") return std::make_unique<UringEngine>();
+#endif
+    return nullptr;
+}
@@ -0,0 +1,767 @@
+#include "iocp_engine.hpp"
+#include <algorithm>
+
+namespace {
+// 单次WSASend最多聚合的缓冲区数
+const size_t MAX_SEND_BUFFERS = 64;
+// 单次TransmitFile最多发送的字节数(上限为2^31-2)
+const uint64_t MAX_TRANSMIT_CHUNK = 0x7ffffffe;
+
+// 当前线程是否正在执行接收回调(此时发送延迟到回调返回后聚合)
+thread_local bool inRecvCallback = false;
+// 投递任务的完成键(停止通知的完成键为0)
+const ULONG_PTR POST_KEY = 1;
+}
+
+// 构造函数
+IocpEngine::IocpEngine() :
+    running_(false),
+    iocpHandle_(NULL),
+    listenSocket_(INVALID_SOCKET),
+    handler_(nullptr),
+    threadCount_(0),
+    lazyRecv_(false),
+    outputHighWater_(OUTPUT_HIGH_WATER),
+    outputLowWater_(OUTPUT_LOW_WATER),
+    maxConnections_(SIZE_MAX),
+    acceptPaused_(false),
+    acceptPauses_(0),
+    syscalls_(0) {}
+
+// 析构函数
+IocpEngine::~IocpEngine() { Stop(); }
+
+// 初始化引擎
+bool IocpEngine::Initialize(const IoEngineOptions& options, IoHandler* handler) {
+    handler_ = handler;
+    threadCount_ = static_cast<size_t>(std::max(options.threadCount, 1));
+    lazyRecv_ = options.lazyRecv;
+    outputHighWater_ = options.outputHighWater;
+    outputLowWater_ = options.outputLowWater;
+    maxConnections_ = LoopConnectionLimit(options, 1);
+    int port = options.port;
+    if (options.reusePort) {
+        std::cerr << "SO_REUSEPORT sharding is not supported by the IOCP engine, using a single port" << std::endl;
+    }
+
+    // 初始化Winsock
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        std::cerr << "WSAStartup failed: " << WSAGetLastError() << std::endl;
+        return false;
+    }
+
+    // 创建监听套接字
+    if (!CreateListenSocket(port)) {
+        WSACleanup();
+        return false;
+    }
+
+    // 设置完成端口
+    if (!SetupCompletionPort()) {
+        closesocket(listenSocket_);
+        listenSocket_ = INVALID_SOCKET;
+        WSACleanup();
+        return false;
+    }
+
+    return true;
+}
+
+// 创建监听套接字
+bool IocpEngine::CreateListenSocket(int port) {
+    // 创建支持重叠I/O的套接字
+    listenSocket_ = WSASocket(AF_INET, SOCK_STREAM, IPPROTO_TCP, NULL, 0, WSA_FLAG_OVERLAPPED);
+    if (listenSocket_ == INVALID_SOCKET) {
+        std::cerr << "WSASocket failed: " << WSAGetLastError() << std::endl;
+        return false;
+    }
+
+    // 设置套接字选项
+    int reuse = 1;
+    if (setsockopt(listenSocket_, SOL_SOCKET, SO_REUSEADDR,
+                  (const char*)&reuse, sizeof(reuse)) == SOCKET_ERROR) {
+        std::cerr << "setsockopt(SO_REUSEADDR) failed: " << WSAGetLastError() << std::endl;
+    }
+
+    // 禁用Nagle算法
+    int nodelay = 1;
+    if (setsockopt(listenSocket_, IPPROTO_TCP, TCP_NODELAY,
+                  (const char*)&nodelay, sizeof(nodelay)) == SOCKET_ERROR) {
+        std::cerr << "setsockopt(TCP_NODELAY) failed: " << WSAGetLastError() << std::endl;
+    }
+
+    // 设置接收缓冲区大小
+    int recvBufSize = 64 * 1024; // 64KB
+    if (setsockopt(listenSocket_, SOL_SOCKET, SO_RCVBUF,
+                  (const char*)&recvBufSize, sizeof(recvBufSize)) == SOCKET_ERROR) {
+        std::cerr << "setsockopt(SO_RCVBUF) failed: " << WSAGetLastError() << std::endl;
+    }
+
+    // 绑定套接字
+    sockaddr_in serverAddr;
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_addr.s_addr = htonl(INADDR_ANY);
+    serverAddr.sin_port = htons(port);
+
+    if (bind(listenSocket_, (sockaddr*)&serverAddr, sizeof(serverAddr)) == SOCKET_ERROR) {
+        std::cerr << "bind failed: " << WSAGetLastError() << std::endl;
+        closesocket(listenSocket_);
+        return false;
+    }
+
+    // 开始监听
+    if (listen(listenSocket_, SOMAXCONN) == SOCKET_ERROR) {
+        std::cerr << "listen failed: " << WSAGetLastError() << std::endl;
+        closesocket(listenSocket_);
+        return false;
+    }
+
+    return true;
+}
+
+// 设置完成端口
+bool IocpEngine::SetupCompletionPort() {
+    // 创建IOCP内核对象
+    iocpHandle_ = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 0);
+    if (iocpHandle_ == NULL) {
+        std::cerr << "CreateIoCompletionPort failed: " << GetLastError() << std::endl;
+        return false;
+    }
+
+    // 关联监听套接字
+    if (CreateIoCompletionPort((HANDLE)listenSocket_, iocpHandle_, (ULONG_PTR)listenSocket_, 0) == NULL) {
+        std::cerr << "Associating listen socket failed: " << GetLastError() << std::endl;
+        CloseHandle(iocpHandle_);
+        iocpHandle_ = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+// 启动引擎
+void IocpEngine::Start() {
+    if (running_.exchange(true)) return;
+    CreateWorkerThreads();
+    StartAccept();  // 开始接受连接
+}
+
+// 创建工作线程
+void IocpEngine::CreateWorkerThreads() {
+    workerThreads_.reserve(threadCount_);
+
+    for (size_t i = 0; i < threadCount_; ++i) {
+        workerThreads_.emplace_back([this]() {
+            DWORD bytesTransferred;
+            ULONG_PTR completionKey;
+            LPOVERLAPPED overlapped;
+
+            while (running_) {
+                // 最多等到下一个定时器到期(没有定时器时无限期等待)
+                DWORD timeout = INFINITE;
+                {
+                    std::lock_guard<std::recursive_mutex> lock(handlerMutex_);
+                    int next = timers_.NextTimeout();
+                    if (next >= 0) timeout = static_cast<DWORD>(next);
+                }
+
+                // 从完成端口获取I/O操作结果
+                BOOL result = GetQueuedCompletionStatus(
+                    iocpHandle_,
+                    &bytesTransferred,
+                    &completionKey,
+                    &overlapped,
+                    timeout);
+                syscalls_.fetch_add(1, std::memory_order_relaxed);
+
+                if (!running_) break;
+
+                // 处理到期定时器(回调与处理器回调一样串行执行)
+                {
+                    std::lock_guard<std::recursive_mutex> lock(handlerMutex_);
+                    timers_.Expire();
+                }
+
+                // 处理I/O错误
+                if (!result) {
+                    DWORD error = GetLastError();
+                    if (!overlapped && error == WAIT_TIMEOUT) continue;  // 只是定时器到期
+                    switch (error) {
+                        case ERROR_NETNAME_DELETED:    // 正常连接断开
+                        case ERROR_CONNECTION_ABORTED: // 连接中止
+                        case ERROR_OPERATION_ABORTED:  // 套接字已被关闭
+                            break;
+                        default:
+                            std::cerr << "IOCP Error (code " << error << "): ";
+                            PrintWindowsError(error);
+                    }
+
+                    // 清理资源
+                    if (overlapped) {
+                        PerIoData* perIoData = CONTAINING_RECORD(overlapped, PerIoData, overlapped);
+                        if (perIoData->operation == IoOperation::ACCEPT) {
+                            closesocket(perIoData->socket);
+                            StartAccept();
+                        } else if (IsCurrent(perIoData)) {
+                            // 已关闭的连接的操作以ERROR_OPERATION_ABORTED完成，此时句柄值可能已属于新连接
+                            CloseClientSocket(perIoData->socket);
+                        }
+                        ReleaseIo(perIoData);
+                    }
+                    continue;
+                }
+
+                // 不带OVERLAPPED的通知：其他线程投递了任务
+                if (!overlapped && completionKey == POST_KEY) {
+                    RunPosted();
+                    continue;
+                }
+
+                // 检查重叠结构是否有效
+                if (!overlapped) {
+                    std::cerr << "Warning: Null OVERLAPPED received" << std::endl;
+                    continue;
+                }
+
+                // 处理完成的I/O操作
+                PerIoData* perIoData = CONTAINING_RECORD(overlapped, PerIoData, overlapped);
+                HandleIoCompletion(bytesTransferred, perIoData);
+            }
+        });
+    }
+}
+
+// 开始接受连接
+void IocpEngine::StartAccept() {
+    // 创建客户端套接字
+    SOCKET clientSocket = WSASocket(AF_INET, SOCK_STREAM, IPPROTO_TCP, NULL, 0, WSA_FLAG_OVERLAPPED);
+    if (clientSocket == INVALID_SOCKET) {
+        std::cerr << "Accept socket failed: " << WSAGetLastError() << std::endl;
+        return;
+    }
+
+    // 创建Accept专用的I/O数据结构
+    PerIoData* acceptData = AcquireIo(clientSocket, IoOperation::ACCEPT);
+
+    // 发起异步AcceptEx操作
+    syscalls_.fetch_add(1, std::memory_order_relaxed);
+    if (AcceptEx(listenSocket_, clientSocket, acceptData->addresses, 0,
+                ACCEPT_ADDRESS_SIZE, ACCEPT_ADDRESS_SIZE,
+                NULL, &acceptData->overlapped) == FALSE) {
+        DWORD error = WSAGetLastError();
+        if (error != ERROR_IO_PENDING) {
+            std::cerr << "AcceptEx failed: " << error << std::endl;
+            closesocket(clientSocket);
+            ReleaseIo(acceptData);
+        }
+    }
+}
+
+// 处理I/O完成
+void IocpEngine::HandleIoCompletion(DWORD bytesTransferred, PerIoData* perIoData) {
+    // 连接已关闭(句柄值可能已被新连接复用)：丢弃陈旧的完成事件
+    if (perIoData->operation != IoOperation::ACCEPT && !IsCurrent(perIoData)) {
+        ReleaseIo(perIoData);
+        return;
+    }
+
+    switch (perIoData->operation) {
+        case IoOperation::ACCEPT:
+            HandleAccept(perIoData);
+            break;
+        case IoOperation::RECV:
+            HandleRecv(perIoData, bytesTransferred);
+            break;
+        case IoOperation::SEND:
+            HandleSend(perIoData, bytesTransferred);
+            break;
+    }
+}
+
+// 处理接受连接
+void IocpEngine::HandleAccept(PerIoData* acceptData) {
+    SOCKET clientSocket = acceptData->socket;
+    ReleaseIo(acceptData);
+
+    // 设置TCP_NODELAY选项
+    int opt = 1;
+    setsockopt(clientSocket, IPPROTO_TCP, TCP_NODELAY, (const char*)&opt, sizeof(opt));
+
+    // 零字节接收模式下用非阻塞recv读空套接字
+    if (lazyRecv_) {
+        u_long nonBlocking = 1;
+        ioctlsocket(clientSocket, FIONBIO, &nonBlocking);
+    }
+
+    // 将客户端套接字与IOCP关联
+    if (CreateIoCompletionPort((HANDLE)clientSocket, iocpHandle_, (ULONG_PTR)clientSocket, 0) == NULL) {
+        std::cerr << "Failed to associate client socket: " << GetLastError() << std::endl;
+        closesocket(clientSocket);
+        StartAccept();
+        return;
+    }
+
+    uint32_t generation;
+    bool full;
+    {
+        std::lock_guard<std::mutex> lock(socketsMutex_);
+        sockets_.Insert(clientSocket);
+        generation = sockets_.Handle(clientSocket).generation;
+        full = sockets_.Size() >= maxConnections_;
+        if (full) {
+            acceptPaused_ = true;
+            acceptPauses_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // 继续接受新连接；达到上限时暂停，新连接留在监听队列中，由CloseClientSocket恢复
+    if (!full) StartAccept();
+    {
+        std::lock_guard<std::recursive_mutex> lock(handlerMutex_);
+        handler_->OnAccept(0, clientSocket);
+    }
+
+    // 开始接收数据
+    PostRecv(AcquireIo(clientSocket, IoOperation::RECV, generation));
+}
+
+// 处理接收数据
+void IocpEngine::HandleRecv(PerIoData* recvData, DWORD bytesTransferred) {
+    SOCKET clientSocket = recvData->socket;
+
+    bool open;
+    if (lazyRecv_) {
+        // 零字节接收完成表示套接字可读，EOF由随后的recv发现
+        open = DrainSocket(clientSocket);
+    } else {
+        open = bytesTransferred > 0;
+        if (open) DeliverRecv(clientSocket, recvData->recvBuffer->data, bytesTransferred);
+    }
+    if (!open) {
+        CloseClientSocket(clientSocket);
+        ReleaseIo(recvData);
+        return;
+    }
+
+    // 本次接收产生的所有响应一次发出
+    FlushSend(clientSocket);
+
+    // 发送队列超过高水位时暂缓接收，回落后由HandleSend投递
+    {
+        std::lock_guard<std::mutex> lock(socketsMutex_);
+        Connection* conn = sockets_.Find(ConnectionHandle{clientSocket, recvData->generation});
+        if (conn && conn->paused) {
+            conn->parkedRecv = recvData;
+            return;
+        }
+    }
+
+    // 重用I/O操作对象投递下一次接收
+    PostRecv(recvData);
+}
+
+// 借用缓冲区非阻塞地读空套接字，读完立即归还(空闲连接不持有接收缓冲区)
+bool IocpEngine::DrainSocket(SOCKET socket) {
+    RecvBuffer* buffer;
+    {
+        std::lock_guard<std::mutex> lock(poolMutex_);
+        buffer = bufferPool_.Acquire();
+    }
+
+    bool open = true;
+    while (true) {
+        int n = recv(socket, buffer->data, sizeof(buffer->data), 0);
+        syscalls_.fetch_add(1, std::memory_order_relaxed);
+        if (n > 0) {
+            DeliverRecv(socket, buffer->data, static_cast<size_t>(n));
+            continue;
+        }
+        if (n == SOCKET_ERROR && WSAGetLastError() == WSAEWOULDBLOCK) break;
+        open = false;  // 对端关闭或出错
+        break;
+    }
+
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    bufferPool_.Release(buffer);
+    return open;
+}
+
+// 把收到的数据交给处理器(回调期间的发送延迟到返回后聚合)
+void IocpEngine::DeliverRecv(SOCKET socket, const char* data, size_t length) {
+    std::lock_guard<std::recursive_mutex> lock(handlerMutex_);
+    inRecvCallback = true;
+    handler_->OnRecv(0, socket, data, length);
+    inRecvCallback = false;
+}
+
+// 处理发送完成
+void IocpEngine::HandleSend(PerIoData* sendData, DWORD bytesTransferred) {
+    SOCKET socket = sendData->socket;
+    PerIoData* resumeRecv = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(socketsMutex_);
+        Connection* found = sockets_.Find(ConnectionHandle{socket, sendData->generation});
+        if (found) {
+            Connection& conn = *found;
+            conn.sendInFlight = false;
+            conn.queued -= std::min<uint64_t>(conn.queued, bytesTransferred);
+
+            if (sendData->fileSegment.IsFile()) {
+                // 文件段未发完时放回队首继续发送
+                OutputSegment& segment = sendData->fileSegment;
+                segment.offset += bytesTransferred;
+                segment.remaining -= std::min<uint64_t>(segment.remaining, bytesTransferred);
+                if (segment.remaining > 0) conn.output.push_front(std::move(segment));
+            } else {
+                // 部分发送时把未发送的数据段按原顺序放回队首，并记录首段已发送的字节数(不复制数据)
+                std::vector<OutputSegment>& sent = sendData->sendData;
+                size_t skip = sendData->sendOffset + bytesTransferred;
+                size_t first = 0;
+                while (first < sent.size() && skip >= sent[first].Size()) {
+                    skip -= sent[first].Size();
+                    ++first;
+                }
+                for (size_t i = sent.size(); i-- > first;) {
+                    conn.output.push_front(std::move(sent[i]));
+                }
+                conn.offset = first < sent.size() ? skip : 0;
+            }
+
+            // 回落到低水位以下：解除背压，取回暂缓的接收操作
+            if (conn.paused && conn.queued <= outputLowWater_) {
+                conn.paused = false;
+                resumeRecv = conn.parkedRecv;
+                conn.parkedRecv = nullptr;
+            }
+        }
+    }
+    ReleaseIo(sendData);
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(handlerMutex_);
+        handler_->OnSend(0, socket, bytesTransferred);
+    }
+
+    // 继续发送期间新排队的数据
+    FlushSend(socket);
+
+    // 恢复接收(处理器已在OnSend中处理完积压的请求)
+    if (resumeRecv) PostRecv(resumeRecv);
+}
+
+// 投递接收操作
+void IocpEngine::PostRecv(PerIoData* perIoData) {
+    DWORD flags = 0;
+    DWORD bytesRecv = 0;
+
+    // 只重置OVERLAPPED，接收缓冲区不清零(内核只会写入本次收到的字节)
+    ZeroMemory(&perIoData->overlapped, sizeof(OVERLAPPED));
+    if (lazyRecv_) {
+        // 零字节接收：只等待可读，不占用缓冲区
+        perIoData->wsaBuf.buf = nullptr;
+        perIoData->wsaBuf.len = 0;
+    } else {
+        if (!perIoData->recvBuffer) {
+            std::lock_guard<std::mutex> lock(poolMutex_);
+            perIoData->recvBuffer = bufferPool_.Acquire();
+        }
+        perIoData->wsaBuf.buf = perIoData->recvBuffer->data;
+        perIoData->wsaBuf.len = sizeof(perIoData->recvBuffer->data);
+    }
+
+    syscalls_.fetch_add(1, std::memory_order_relaxed);
+    if (WSARecv(
+        perIoData->socket,
+        &perIoData->wsaBuf,
+        1,
+        &bytesRecv,
+        &flags,
+        &perIoData->overlapped,
+        NULL
+    ) == SOCKET_ERROR) {
+        DWORD err = WSAGetLastError();
+        if (err != WSA_IO_PENDING) {
+            std::cerr << "WSARecv error: " << err << std::endl;
+            CloseClientSocket(perIoData->socket);
+            ReleaseIo(perIoData);
+        }
+    }
+}
+
+// 聚合发送队列中的数据(每个连接同一时刻只有一个WSASend在途)
+void IocpEngine::FlushSend(SOCKET socket) {
+    PerIoData* sendData = nullptr;
+    bool drained = false;
+    {
+        std::lock_guard<std::mutex> lock(socketsMutex_);
+        Connection* found = sockets_.Find(socket);
+        if (!found) return;
+        Connection& conn = *found;
+        if (conn.sendInFlight) return;
+        if (conn.output.empty()) {
+            drained = conn.closeAfterSend;  // 要求写完后关闭的连接已写完
+            conn.closeAfterSend = false;
+        } else {
+            sendData = AcquireIo(socket, IoOperation::SEND, sockets_.Handle(socket).generation);
+            if (conn.output.front().IsFile()) {
+                // 文件段：PerIoData持有文件直到TransmitFile完成
+                sendData->fileSegment = std::move(conn.output.front());
+                conn.output.pop_front();
+            } else {
+                sendData->sendOffset = conn.offset;
+                conn.offset = 0;
+                while (!conn.output.empty() && !conn.output.front().IsFile() &&
+                       sendData->sendData.size() < MAX_SEND_BUFFERS) {
+                    sendData->sendData.push_back(std::move(conn.output.front()));
+                    conn.output.pop_front();
+                }
+            }
+            conn.sendInFlight = true;
+        }
+    }
+    if (!sendData) {
+        // 发出FIN，接收继续直到对端关闭(HandleRecv读到EOF时回收)
+        if (drained) shutdown(socket, SD_SEND);
+        return;
+    }
+
+    BOOL ok;
+    syscalls_.fetch_add(1, std::memory_order_relaxed);
+    if (sendData->fileSegment.IsFile()) {
+        // 发起异步TransmitFile，起始偏移通过OVERLAPPED指定
+        OutputSegment& segment = sendData->fileSegment;
+        sendData->overlapped.Offset = static_cast<DWORD>(segment.offset & 0xffffffffu);
+        sendData->overlapped.OffsetHigh = static_cast<DWORD>(segment.offset >> 32);
+        ok = TransmitFile(socket, segment.file,
+                          static_cast<DWORD>(std::min(segment.remaining, MAX_TRANSMIT_CHUNK)),
+                          0, &sendData->overlapped, NULL, 0);
+    } else {
+        size_t skip = sendData->sendOffset;
+        for (auto& segment : sendData->sendData) {
+            WSABUF buf;
+            buf.buf = const_cast<char*>(segment.Data()) + skip;
+            buf.len = static_cast<ULONG>(segment.Size() - skip);
+            sendData->sendBufs.push_back(buf);
+            skip = 0;
+        }
+
+        // 发起异步发送操作
+        DWORD bytesSent = 0;
+        ok = WSASend(
+            socket,
+            sendData->sendBufs.data(),
+            static_cast<DWORD>(sendData->sendBufs.size()),
+            &bytesSent,
+            0,
+            &sendData->overlapped,
+            NULL
+        ) != SOCKET_ERROR;
+    }
+
+    if (!ok) {
+        DWORD error = WSAGetLastError();
+        if (error != WSA_IO_PENDING) {
+            std::cerr << "Send failed: " << error << std::endl;
+            CloseClientSocket(socket);
+            ReleaseIo(sendData);
+        }
+    }
+}
+
+// 放入发送队列(接收回调中调用时延迟到回调返回后聚合发送)
+void IocpEngine::QueueOutput(SOCKET socket, OutputSegment segment) {
+    {
+        std::lock_guard<std::mutex> lock(socketsMutex_);
+        Connection* found = sockets_.Find(socket);
+        if (!found) return;
+        Connection& conn = *found;
+        conn.queued += segment.Bytes();
+        if (conn.queued > outputHighWater_) conn.paused = true;  // 超过高水位，暂缓接收
+        conn.output.push_back(std::move(segment));
+    }
+    if (!inRecvCallback) {
+        FlushSend(socket);
+    }
+}
+
+// 异步发送数据
+void IocpEngine::Send(SOCKET socket, std::string data) {
+    if (data.empty()) return;
+    QueueOutput(socket, OutputSegment(std::move(data)));
+}
+
+// 异步发送共享缓冲区
+void IocpEngine::Send(SOCKET socket, SharedBuffer data) {
+    if (!data || data->empty()) return;
+    QueueOutput(socket, OutputSegment(std::move(data)));
+}
+
+// 异步发送共享缓冲区的一部分
+void IocpEngine::Send(SOCKET socket, SharedBuffer data, size_t offset, size_t length) {
+    if (!data || length == 0) return;
+    QueueOutput(socket, OutputSegment(std::move(data), offset, length));
+}
+
+// 异步发送文件区间
+void IocpEngine::SendFile(SOCKET socket, FileHandle file, uint64_t offset, uint64_t length) {
+    OutputSegment segment(file, offset, length);  // 接管文件，出错时自动关闭
+    if (length == 0) return;
+    QueueOutput(socket, std::move(segment));
+}
+
+// 连接是否处于背压状态
+bool IocpEngine::Backpressured(SOCKET socket) {
+    std::lock_guard<std::mutex> lock(socketsMutex_);
+    Connection* conn = sockets_.Find(socket);
+    return conn && conn->paused;
+}
+
+// 投递任务(队列由空变为非空时才通知完成端口，之后的投递由同一次通知处理)
+void IocpEngine::Post(size_t loop, std::function<void()> task) {
+    (void)loop;
+    bool notify;
+    {
+        std::lock_guard<std::mutex> lock(postMutex_);
+        notify = posted_.empty();
+        posted_.push_back(std::move(task));
+    }
+    if (notify && !PostQueuedCompletionStatus(iocpHandle_, 0, POST_KEY, NULL)) {
+        std::cerr << "PostQueuedCompletionStatus failed: " << GetLastError() << std::endl;
+    }
+}
+
+// 执行其他线程投递的任务(与处理器回调一样串行执行，其中的发送立即写出)
+void IocpEngine::RunPosted() {
+    std::vector<std::function<void()>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(postMutex_);
+        tasks.swap(posted_);
+    }
+    std::lock_guard<std::recursive_mutex> lock(handlerMutex_);
+    for (auto& task : tasks) {
+        task();
+    }
+}
+
+// 定时器(只有一个事件循环，由处理器回调锁保护)
+TimerWheel& IocpEngine::Timers(size_t loop) {
+    (void)loop;
+    return timers_;
+}
+
+// 从池中取出I/O操作对象
+PerIoData* IocpEngine::AcquireIo(SOCKET socket, IoOperation operation, uint32_t generation) {
+    PerIoData* perIoData;
+    {
+        std::lock_guard<std::mutex> lock(poolMutex_);
+        perIoData = ioPool_.Acquire();
+    }
+    ZeroMemory(&perIoData->overlapped, sizeof(OVERLAPPED));
+    perIoData->socket = socket;
+    perIoData->generation = generation;
+    perIoData->operation = operation;
+    return perIoData;
+}
+
+// 归还I/O操作对象：清空数据段(保留容量)，连同接收缓冲区一起放回池中
+void IocpEngine::ReleaseIo(PerIoData* perIoData) {
+    perIoData->sendData.clear();
+    perIoData->sendBufs.clear();
+    perIoData->sendOffset = 0;
+    perIoData->fileSegment = OutputSegment();
+
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    if (perIoData->recvBuffer) {
+        bufferPool_.Release(perIoData->recvBuffer);
+        perIoData->recvBuffer = nullptr;
+    }
+    ioPool_.Release(perIoData);
+}
+
+// 操作是否属于套接字当前的连接(代数相同)
+bool IocpEngine::IsCurrent(const PerIoData* perIoData) {
+    std::lock_guard<std::mutex> lock(socketsMutex_);
+    return sockets_.Find(ConnectionHandle{perIoData->socket, perIoData->generation}) != nullptr;
+}
+
+// 关闭连接
+void IocpEngine::Close(SOCKET socket) {
+    CloseClientSocket(socket);
+}
+
+// 发送队列写完后关闭连接(由FlushSend在队列清空且没有在途发送时关闭写端)
+void IocpEngine::CloseAfterSend(SOCKET socket) {
+    {
+        std::lock_guard<std::mutex> lock(socketsMutex_);
+        Connection* conn = sockets_.Find(socket);
+        if (!conn) return;
+        conn->closeAfterSend = true;
+    }
+    if (!inRecvCallback) FlushSend(socket);
+}
+
+// 关闭客户端套接字(只执行一次)
+void IocpEngine::CloseClientSocket(SOCKET socket) {
+    PerIoData* parkedRecv;
+    bool resumeAccept;
+    {
+        std::lock_guard<std::mutex> lock(socketsMutex_);
+        Connection* conn = sockets_.Find(socket);
+        if (!conn) return;
+        parkedRecv = conn->parkedRecv;
+        sockets_.Erase(socket);
+        resumeAccept = acceptPaused_ && sockets_.Size() < maxConnections_;
+        if (resumeAccept) acceptPaused_ = false;
+    }
+    if (parkedRecv) ReleaseIo(parkedRecv);
+    {
+        std::lock_guard<std::recursive_mutex> lock(handlerMutex_);
+        handler_->OnClose(0, socket);
+    }
+    closesocket(socket);
+
+    // 腾出名额后恢复接受连接
+    if (resumeAccept && running_) StartAccept();
+}
+
+// 停止引擎
+void IocpEngine::Stop() {
+    bool wasRunning = running_.exchange(false);
+
+    // 通知所有工作线程退出
+    if (wasRunning) {
+        for (size_t i = 0; i < workerThreads_.size(); ++i) {
+            PostQueuedCompletionStatus(iocpHandle_, 0, 0, NULL);
+        }
+    }
+
+    // 等待所有工作线程结束
+    for (auto& thread : workerThreads_) {
+        if (thread.joinable()) thread.join();
+    }
+    workerThreads_.clear();
+
+    // 关闭所有客户端连接
+    std::vector<SOCKET> sockets;
+    {
+        std::lock_guard<std::mutex> lock(socketsMutex_);
+        sockets_.ForEach([&sockets](SOCKET socket, Connection&) { sockets.push_back(socket); });
+    }
+    for (SOCKET s : sockets) {
+        CloseClientSocket(s);
+    }
+
+    // 关闭监听套接字
+    if (listenSocket_ != INVALID_SOCKET) {
+        closesocket(listenSocket_);
+        listenSocket_ = INVALID_SOCKET;
+    }
+
+    // 关闭IOCP句柄并清理Winsock
+    if (iocpHandle_ != NULL) {
+        CloseHandle(iocpHandle_);
+        iocpHandle_ = NULL;
+        WSACleanup();
+    }
+}
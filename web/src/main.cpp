@@ -1,8 +1,11 @@
-#include "iocp_server.hpp"
+#include "web_server.hpp"
 #include <iostream>
 #include <csignal>
+#include <cstring>
+#include <algorithm>
+#include <thread>
 
-std::unique_ptr<IocpServer> server;  // 服务器实例
+std::unique_ptr<WebServer> server;  // 服务器实例
 
 // 信号处理函数
 void SignalHandler(int signal) {
@@ -12,16 +15,88 @@ void SignalHandler(int signal) {
     }
 }
 
+// 打印用法
+void PrintUsage(const char* program) {
+    std::cout << "Usage: " << program << " [--engine=NAME] [--port=N] [--threads=N] [--reuseport] [--lazy-recv]\n"
+              << "         [--cache-size=MB] [--idle-timeout=S] [--header-timeout=S] [--body-timeout=S]\n"
+              << "         [--max-connections=N] [--shed-queue-delay=MS] [--shed-service-time=MS] [--compute-threads=N]\n"
+              << "         [--max-body=MB]\n"
+              << "  --engine=NAME       I/O engine: iocp (Windows), epoll or uring (Linux)\n"
+              << "  --port=N            listening port (default " << DEFAULT_PORT << ")\n"
+              << "  --threads=N         number of I/O threads (default depends on mode)\n"
+              << "  --reuseport         one pinned reactor per core, each with its own SO_REUSEPORT socket\n"
+              << "  --lazy-recv         borrow receive buffers only when a socket is readable (IOCP zero-byte recv)\n"
+              << "  --cache-size=MB     static asset cache budget, 0 disables (default "
+              << DEFAULT_CACHE_CAPACITY / (1024 * 1024) << ")\n"
+              << "  --idle-timeout=S    close keep-alive connections idle for S seconds (default "
+              << DEFAULT_IDLE_TIMEOUT.count() / 1000 << ")\n"
+              << "  --header-timeout=S  time allowed to receive request headers (default "
+              << DEFAULT_HEADER_TIMEOUT.count() / 1000 << ")\n"
+              << "  --body-timeout=S    max gap between request body reads (default "
+              << DEFAULT_BODY_TIMEOUT.count() / 1000 << ")\n"
+              << "  --max-connections=N stop accepting above N concurrent connections, 0 = unlimited (default "
+              << MAX_CONCURRENT << ")\n"
+              << "  --shed-queue-delay=MS   answer 503 while the event loop lags more than MS, 0 disables (default "
+              << DEFAULT_SHED_QUEUE_DELAY.count() << ")\n"
+              << "  --shed-service-time=MS  answer 503 while the average service time exceeds MS, 0 disables (default "
+              << DEFAULT_SHED_SERVICE_TIME.count() << ")\n"
+              << "  --compute-threads=N threads for CPU-heavy handlers, 0 = one per core, -1 = run on the I/O threads\n"
+              << "  --max-body=MB       answer 413 to request bodies larger than MB (default "
+              << DEFAULT_MAX_REQUEST_BODY / (1024 * 1024) << ")" << std::endl;
+}
+
 // 主函数
-int main() {
+int main(int argc, char* argv[]) {
     signal(SIGINT, SignalHandler);  // 设置信号处理
+
+    // 解析命令行参数
+    ServerConfig config;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--engine=", 9) == 0) {
+            config.engine = argv[i] + 9;
+        } else if (strncmp(argv[i], "--port=", 7) == 0) {
+            config.port = std::atoi(argv[i] + 7);
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            config.threads = std::atoi(argv[i] + 10);
+        } else if (strcmp(argv[i], "--reuseport") == 0) {
+            config.reusePort = true;
+        } else if (strcmp(argv[i], "--lazy-recv") == 0) {
+            config.lazyRecv = true;
+        } else if (strncmp(argv[i], "--cache-size=", 13) == 0) {
+            config.cacheCapacity = static_cast<size_t>(std::atoll(argv[i] + 13)) * 1024 * 1024;
+        } else if (strncmp(argv[i], "--idle-timeout=", 15) == 0) {
+            config.idleTimeout = std::chrono::milliseconds(static_cast<int64_t>(std::atof(argv[i] + 15) * 1000));
+        } else if (strncmp(argv[i], "--header-timeout=", 17) == 0) {
+            config.headerTimeout = std::chrono::milliseconds(static_cast<int64_t>(std::atof(argv[i] + 17) * 1000));
+        } else if (strncmp(argv[i], "--body-timeout=", 15) == 0) {
+            config.bodyTimeout = std::chrono::milliseconds(static_cast<int64_t>(std::atof(argv[i] + 15) * 1000));
+        } else if (strncmp(argv[i], "--max-connections=", 18) == 0) {
+            config.maxConnections = static_cast<size_t>(std::atoll(argv[i] + 18));
+        } else if (strncmp(argv[i], "--shed-queue-delay=", 19) == 0) {
+            config.shedQueueDelay = std::chrono::milliseconds(std::atoll(argv[i] + 19));
+        } else if (strncmp(argv[i], "--shed-service-time=", 20) == 0) {
+            config.shedServiceTime = std::chrono::milliseconds(std::atoll(argv[i] + 20));
+        } else if (strncmp(argv[i], "--compute-threads=", 18) == 0) {
+            config.computeThreads = std::atoi(argv[i] + 18);
+        } else if (strncmp(argv[i], "--max-body=", 11) == 0) {
+            config.maxRequestBody = static_cast<size_t>(std::atof(argv[i] + 11) * 1024 * 1024);
+        } else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    // 每核一个反应器：默认线程数等于CPU核心数
+    if (config.reusePort && config.threads <= 0) {
+        config.threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
     
     try {
-        std::cout << "Starting IOCP Web Server..." << std::endl;
-        server = std::make_unique<IocpServer>();  // 创建服务器实例
+        std::cout << "Starting Web Server..." << std::endl;
+        server = std::make_unique<WebServer>();  // 创建服务器实例
         
         // 初始化服务器
-        if (!server->Initialize()) {
+        if (!server->Initialize(config)) {
             std::cerr << "Initialization failed" << std::endl;
             return 1;
         }
@@ -0,0 +1,201 @@
+#include "metrics.hpp"
+#include <cstdio>
+
+namespace {
+// 导出的直方图边界：2^10 ~ 2^34纳秒(约1微秒 ~ 17秒)，每次乘4
+const int EXPORT_FIRST_POWER = 10;
+const int EXPORT_LAST_POWER = 34;
+const int EXPORT_POWER_STEP = 2;
+
+// 最高有效位的位置(value > 0)
+inline int HighestBit(uint64_t value) {
+    return 63 - __builtin_clzll(value);
+}
+
+// 追加一行"name{labels} value"
+void AppendSample(std::string& out, std::string_view name, std::string_view labels, const char* value) {
+    out.append(name);
+    if (!labels.empty()) {
+        out += '{';
+        out.append(labels);
+        out += '}';
+    }
+    out += ' ';
+    out += value;
+    out += '\n';
+}
+
+// 追加HELP与TYPE注释
+void AppendHeader(std::string& out, std::string_view name, std::string_view type, std::string_view help) {
+    out += "# HELP ";
+    out.append(name);
+    out += ' ';
+    out.append(help);
+    out += "\n# TYPE ";
+    out.append(name);
+    out += ' ';
+    out.append(type);
+    out += '\n';
+}
+}
+
+// 值所在的桶：小于16时直接作为下标，否则由最高位(所在的2的幂区间)与其后4位(线性子桶)决定
+size_t LatencyHistogram::BucketOf(uint64_t value) {
+    if (value < SUB_COUNT) return static_cast<size_t>(value);
+    int magnitude = HighestBit(value);
+    size_t sub = static_cast<size_t>(value >> (magnitude - SUB_BITS)) - SUB_COUNT;
+    return static_cast<size_t>(magnitude - SUB_BITS + 1) * SUB_COUNT + sub;
+}
+
+// 桶内的最大值
+uint64_t LatencyHistogram::BucketUpperBound(size_t bucket) {
+    if (bucket < SUB_COUNT) return bucket;
+    int shift = static_cast<int>(bucket / SUB_COUNT) - 1;
+    uint64_t lower = static_cast<uint64_t>(SUB_COUNT + bucket % SUB_COUNT) << shift;
+    return lower + ((uint64_t(1) << shift) - 1);
+}
+
+// 记录一个值
+void LatencyHistogram::Record(uint64_t value) {
+    std::atomic<uint64_t>& count = counts_[BucketOf(value)];
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    total_.Add();
+    sum_.Add(value);
+}
+
+// 累加一个直方图
+void HistogramSnapshot::Add(const LatencyHistogram& histogram) {
+    for (size_t i = 0; i < LatencyHistogram::BUCKETS; ++i) {
+        counts[i] += histogram.Count(i);
+    }
+    count += histogram.Total();
+    sum += histogram.Sum();
+}
+
+// 分位数：累计计数首次达到quantile比例的桶的上界
+uint64_t HistogramSnapshot::Percentile(double quantile) const {
+    uint64_t total = 0;
+    for (uint64_t n : counts) total += n;
+    if (total == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(quantile * static_cast<double>(total) + 0.5);
+    if (rank < 1) rank = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= rank) return LatencyHistogram::BucketUpperBound(i);
+    }
+    return LatencyHistogram::BucketUpperBound(counts.size() - 1);
+}
+
+// 最大值所在桶的上界
+uint64_t HistogramSnapshot::Max() const {
+    for (size_t i = counts.size(); i > 0; --i) {
+        if (counts[i - 1] != 0) return LatencyHistogram::BucketUpperBound(i - 1);
+    }
+    return 0;
+}
+
+// 记录一个请求的状态码与处理时间
+void ThreadMetrics::RecordRequest(int statusCode, std::chrono::steady_clock::duration elapsed) {
+    size_t slot = STATUS_SLOTS - 1;
+    for (size_t i = 0; i + 1 < STATUS_SLOTS; ++i) {
+        if (TRACKED_STATUS[i] == statusCode) {
+            slot = i;
+            break;
+        }
+    }
+    requests[slot].Add();
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    latency.Record(ns > 0 ? static_cast<uint64_t>(ns) : 0);
+}
+
+// 累加一个线程的指标(与写入线程并发读取，各计数器分别是一致的)
+void MetricsSnapshot::Add(const ThreadMetrics& metrics) {
+    accepts += metrics.accepts.Get();
+    closes += metrics.closes.Get();
+    bytesIn += metrics.bytesIn.Get();
+    bytesOut += metrics.bytesOut.Get();
+    parseFailures += metrics.parseFailures.Get();
+    timeouts += metrics.timeouts.Get();
+    shed += metrics.shed.Get();
+    overloads += metrics.overloads.Get();
+    recoveries += metrics.recoveries.Get();
+    offloaded += metrics.offloaded.Get();
+    encoded += metrics.encoded.Get();
+    cacheHits += metrics.cacheHits.Get();
+    cacheMisses += metrics.cacheMisses.Get();
+    for (size_t i = 0; i < STATUS_SLOTS; ++i) {
+        requests[i] += metrics.requests[i].Get();
+    }
+    latency.Add(metrics.latency);
+}
+
+// 以Prometheus文本格式输出
+void MetricsSnapshot::WritePrometheus(std::string& out) const {
+    char value[64];
+    char labels[64];
+
+    WriteMetric(out, "web_connections_accepted_total", "counter", "Accepted connections.", accepts);
+    WriteMetric(out, "web_connections_active", "gauge", "Currently open connections.",
+                accepts >= closes ? accepts - closes : 0);
+    WriteMetric(out, "web_connection_timeouts_total", "counter", "Connections closed by a timeout.", timeouts);
+    WriteMetric(out, "web_received_bytes_total", "counter", "Bytes received from clients.", bytesIn);
+    WriteMetric(out, "web_sent_bytes_total", "counter", "Bytes written to clients.", bytesOut);
+    WriteMetric(out, "web_parse_failures_total", "counter", "Malformed requests.", parseFailures);
+    WriteMetric(out, "web_requests_shed_total", "counter", "Requests rejected with 503 while overloaded.", shed);
+    WriteMetric(out, "web_overloads_total", "counter", "Times an event loop started shedding load.", overloads);
+    WriteMetric(out, "web_overloaded_loops", "gauge", "Event loops currently shedding load.",
+                overloads >= recoveries ? overloads - recoveries : 0);
+    WriteMetric(out, "web_requests_offloaded_total", "counter", "Requests handed to the compute pool.", offloaded);
+    WriteMetric(out, "web_responses_encoded_total", "counter", "Responses sent with a gzip or br content coding.",
+                encoded);
+
+    AppendHeader(out, "web_requests_total", "counter", "Requests by response status.");
+    for (size_t i = 0; i < STATUS_SLOTS; ++i) {
+        if (i + 1 < STATUS_SLOTS) {
+            snprintf(labels, sizeof(labels), "status=\"%d\"", TRACKED_STATUS[i]);
+        } else {
+            snprintf(labels, sizeof(labels), "status=\"other\"");
+        }
+        snprintf(value, sizeof(value), "%llu", static_cast<unsigned long long>(requests[i]));
+        AppendSample(out, "web_requests_total", labels, value);
+    }
+
+    // 直方图：只导出2的幂边界(正好落在对数线性桶的边界上，累计计数是精确的)
+    AppendHeader(out, "web_request_duration_seconds", "histogram", "Request service time.");
+    uint64_t cumulative = 0;
+    size_t bucket = 0;
+    for (int power = EXPORT_FIRST_POWER; power <= EXPORT_LAST_POWER; power += EXPORT_POWER_STEP) {
+        uint64_t bound = uint64_t(1) << power;
+        while (bucket < latency.counts.size() && LatencyHistogram::BucketUpperBound(bucket) < bound) {
+            cumulative += latency.counts[bucket++];
+        }
+        snprintf(labels, sizeof(labels), "le=\"%g\"", static_cast<double>(bound) / 1e9);
+        snprintf(value, sizeof(value), "%llu", static_cast<unsigned long long>(cumulative));
+        AppendSample(out, "web_request_duration_seconds_bucket", labels, value);
+    }
+    snprintf(value, sizeof(value), "%llu", static_cast<unsigned long long>(latency.count));
+    AppendSample(out, "web_request_duration_seconds_bucket", "le=\"+Inf\"", value);
+    snprintf(value, sizeof(value), "%.9f", static_cast<double>(latency.sum) / 1e9);
+    AppendSample(out, "web_request_duration_seconds_sum", "", value);
+    snprintf(value, sizeof(value), "%llu", static_cast<unsigned long long>(latency.count));
+    AppendSample(out, "web_request_duration_seconds_count", "", value);
+
+    // 由完整分辨率的直方图计算的分位数
+    AppendHeader(out, "web_request_duration_quantile_seconds", "gauge",
+                 "Request service time quantiles (upper bound of the HDR bucket).");
+    for (double quantile : {0.5, 0.9, 0.99, 0.999}) {
+        snprintf(labels, sizeof(labels), "quantile=\"%g\"", quantile);
+        snprintf(value, sizeof(value), "%.9f", static_cast<double>(latency.Percentile(quantile)) / 1e9);
+        AppendSample(out, "web_request_duration_quantile_seconds", labels, value);
+    }
+}
+
+// 输出一个不带标签的指标
+void WriteMetric(std::string& out, std::string_view name, std::string_view type,
+                 std::string_view help, uint64_t value) {
+    char text[32];
+    snprintf(text, sizeof(text), "%llu", static_cast<unsigned long long>(value));
+    AppendHeader(out, name, type, help);
+    AppendSample(out, name, "", text);
+}
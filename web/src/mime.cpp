@@ -0,0 +1,74 @@
+#include "mime.hpp"
+#include "static_map.hpp"
+
+namespace {
+
+// 扩展名(小写) -> Content-Type
+constexpr auto MIME_TYPES = MakeStaticMap<std::string_view>({
+    {"html", "text/html"},
+    {"htm", "text/html"},
+    {"css", "text/css"},
+    {"js", "application/javascript"},
+    {"mjs", "application/javascript"},
+    {"json", "application/json"},
+    {"map", "application/json"},
+    {"txt", "text/plain"},
+    {"csv", "text/csv"},
+    {"xml", "application/xml"},
+    {"wasm", "application/wasm"},
+    {"pdf", "application/pdf"},
+    {"zip", "application/zip"},
+    {"png", "image/png"},
+    {"jpg", "image/jpeg"},
+    {"jpeg", "image/jpeg"},
+    {"gif", "image/gif"},
+    {"webp", "image/webp"},
+    {"avif", "image/avif"},
+    {"svg", "image/svg+xml"},
+    {"ico", "image/x-icon"},
+    {"woff", "font/woff"},
+    {"woff2", "font/woff2"},
+    {"ttf", "font/ttf"},
+    {"otf", "font/otf"},
+    {"mp3", "audio/mpeg"},
+    {"ogg", "audio/ogg"},
+    {"wav", "audio/wav"},
+    {"mp4", "video/mp4"},
+    {"webm", "video/webm"},
+});
+
+const std::string_view DEFAULT_MIME_TYPE = "text/plain";
+const size_t MAX_EXTENSION = 8;  // 超过此长度的扩展名不可能在表中
+
+// 查找扩展名(在栈上转为小写，不分配内存)
+std::string_view Lookup(std::string_view extension) {
+    if (extension.empty()) return DEFAULT_MIME_TYPE;
+    char lower[MAX_EXTENSION];
+    for (size_t i = 0; i < extension.size(); ++i) {
+        char c = extension[i];
+        lower[i] = (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+    const std::string_view* type = MIME_TYPES.Find(std::string_view(lower, extension.size()));
+    return type ? *type : DEFAULT_MIME_TYPE;
+}
+
+}
+
+// 按扩展名确定Content-Type：从末尾向前找'.'，先遇到'/'或超过最长扩展名时没有可识别的扩展名
+std::string_view MimeType(std::string_view path) {
+    size_t limit = path.size() > MAX_EXTENSION + 1 ? path.size() - MAX_EXTENSION - 1 : 0;
+    for (size_t i = path.size(); i > limit; --i) {
+        char c = path[i - 1];
+        if (c == '/') break;
+        if (c == '.') return Lookup(path.substr(i));
+    }
+    return DEFAULT_MIME_TYPE;
+}
+
+// 可压缩的类型(忽略"; charset=..."等参数)
+bool CompressibleType(std::string_view contentType) {
+    contentType = contentType.substr(0, contentType.find(';'));
+    if (contentType.substr(0, 5) == "text/") return true;
+    return contentType == "application/javascript" || contentType == "application/json" ||
+           contentType == "application/xml" || contentType == "application/wasm" || contentType == "image/svg+xml";
+}
@@ -0,0 +1,34 @@
+#include "overload.hpp"
+
+// 构造函数
+OverloadDetector::OverloadDetector(Duration queueDelayLimit, Duration serviceTimeLimit) :
+    queueDelayLimit_(queueDelayLimit.count()),
+    serviceTimeLimit_(serviceTimeLimit.count()) {}
+
+// 记录一次事件循环延迟采样(只保留最近一次：延迟本身已是这段时间内积压的结果)
+void OverloadDetector::RecordQueueDelay(Duration delay) {
+    queueDelay_ = delay.count() > 0 ? delay.count() : 0;
+    Update();
+}
+
+// 记录一个请求的处理时间：avg += (x - avg) / 8
+void OverloadDetector::RecordServiceTime(Duration elapsed) {
+    int64_t sample = elapsed.count() > 0 ? elapsed.count() : 0;
+    serviceTime_ += (sample - serviceTime_) / 8;
+    Update();
+}
+
+// 任一信号超过阈值时进入过载，两者都回落到阈值的一半以下时退出
+void OverloadDetector::Update() {
+    bool queueHigh = queueDelayLimit_ > 0 && queueDelay_ > queueDelayLimit_;
+    bool serviceHigh = serviceTimeLimit_ > 0 && serviceTime_ > serviceTimeLimit_;
+    if (queueHigh || serviceHigh) {
+        overloaded_ = true;
+        return;
+    }
+    if (overloaded_) {
+        bool queueLow = queueDelayLimit_ == 0 || queueDelay_ < queueDelayLimit_ / 2;
+        bool serviceLow = serviceTimeLimit_ == 0 || serviceTime_ < serviceTimeLimit_ / 2;
+        overloaded_ = !(queueLow && serviceLow);
+    }
+}
@@ -0,0 +1,149 @@
+#include "response_writer.hpp"
+#include <charconv>
+#include <cstring>
+
+namespace {
+const char WEEKDAYS[7][4] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+const char MONTHS[12][4] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+// 每个线程缓存的Date头整行
+struct DateCache {
+    std::time_t second = -1;                   // 缓存对应的秒
+    std::shared_ptr<const std::string> line;   // "Date: ...\r\n"
+};
+thread_local DateCache dateCache;
+
+// 写入两位数字
+inline void Put2(char* out, int value) {
+    out[0] = static_cast<char>('0' + value / 10);
+    out[1] = static_cast<char>('0' + value % 10);
+}
+}
+
+// 格式化IMF-fixdate(不依赖strftime与区域设置)
+void FormatHttpDate(std::time_t time, char* out) {
+    std::tm tm{};
+#ifdef _WIN32
+    gmtime_s(&tm, &time);
+#else
+    gmtime_r(&time, &tm);
+#endif
+    memcpy(out, WEEKDAYS[tm.tm_wday], 3);
+    out[3] = ',';
+    out[4] = ' ';
+    Put2(out + 5, tm.tm_mday);
+    out[7] = ' ';
+    memcpy(out + 8, MONTHS[tm.tm_mon], 3);
+    out[11] = ' ';
+    int year = tm.tm_year + 1900;
+    Put2(out + 12, year / 100 % 100);
+    Put2(out + 14, year % 100);
+    out[16] = ' ';
+    Put2(out + 17, tm.tm_hour);
+    out[19] = ':';
+    Put2(out + 20, tm.tm_min);
+    out[22] = ':';
+    Put2(out + 23, tm.tm_sec);
+    memcpy(out + 25, " GMT", 4);
+}
+
+// 当前时刻的Date头整行(秒数变化时才重新格式化)
+const std::shared_ptr<const std::string>& DateHeaderLine() {
+    std::time_t now = std::time(nullptr);
+    if (now != dateCache.second) {
+        std::string line(DATE_LINE_SIZE, ' ');
+        memcpy(&line[0], "Date: ", 6);
+        FormatHttpDate(now, &line[6]);
+        memcpy(&line[6 + HTTP_DATE_SIZE], "\r\n", 2);
+        dateCache.line = std::make_shared<const std::string>(std::move(line));
+        dateCache.second = now;
+    }
+    return dateCache.line;
+}
+
+// 常用状态码的状态行
+std::string_view ResponseWriter::StatusLineFor(int statusCode) {
+    switch (statusCode) {
+        case 200: return "HTTP/1.1 200 OK\r\n";
+        case 206: return "HTTP/1.1 206 Partial Content\r\n";
+        case 304: return "HTTP/1.1 304 Not Modified\r\n";
+        case 400: return "HTTP/1.1 400 Bad Request\r\n";
+        case 403: return "HTTP/1.1 403 Forbidden\r\n";
+        case 404: return "HTTP/1.1 404 Not Found\r\n";
+        case 413: return "HTTP/1.1 413 Payload Too Large\r\n";
+        case 416: return "HTTP/1.1 416 Range Not Satisfiable\r\n";
+        case 431: return "HTTP/1.1 431 Request Header Fields Too Large\r\n";
+        case 500: return "HTTP/1.1 500 Internal Server Error\r\n";
+        case 501: return "HTTP/1.1 501 Not Implemented\r\n";
+        case 503: return "HTTP/1.1 503 Service Unavailable\r\n";
+        default: return std::string_view();
+    }
+}
+
+// 追加文本(空间不足时标记溢出，之后的写入都被忽略)
+void ResponseWriter::Append(std::string_view text) {
+    if (overflow_ || static_cast<size_t>(end_ - pos_) < text.size()) {
+        overflow_ = true;
+        return;
+    }
+    memcpy(pos_, text.data(), text.size());
+    pos_ += text.size();
+}
+
+// 状态行：常用状态码使用常量片段，其他状态码只写数字(原因短语可以为空)
+void ResponseWriter::StatusLine(int statusCode) {
+    std::string_view line = StatusLineFor(statusCode);
+    if (!line.empty()) {
+        Append(line);
+        return;
+    }
+    char digits[16];
+    auto result = std::to_chars(digits, digits + sizeof(digits), statusCode);
+    Append("HTTP/1.1 ");
+    Append(std::string_view(digits, static_cast<size_t>(result.ptr - digits)));
+    Append(" \r\n");
+}
+
+// Date头
+void ResponseWriter::Date() {
+    Append(*DateHeaderLine());
+}
+
+// Content-Type头
+void ResponseWriter::ContentType(std::string_view type) {
+    Append("Content-Type: ");
+    Append(type);
+    Append("\r\n");
+}
+
+// Content-Length头
+void ResponseWriter::ContentLength(uint64_t length) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), length);
+    Append("Content-Length: ");
+    Append(std::string_view(digits, static_cast<size_t>(result.ptr - digits)));
+    Append("\r\n");
+}
+
+// 长连接头
+void ResponseWriter::KeepAlive() {
+    Append("Connection: keep-alive\r\n");
+}
+
+// 按请求决定的连接头
+void ResponseWriter::Connection(bool keepAlive) {
+    Append(keepAlive ? std::string_view("Connection: keep-alive\r\n") : std::string_view("Connection: close\r\n"));
+}
+
+// 任意响应头
+void ResponseWriter::Header(std::string_view name, std::string_view value) {
+    Append(name);
+    Append(": ");
+    Append(value);
+    Append("\r\n");
+}
+
+// 头部结束
+void ResponseWriter::End() {
+    Append("\r\n");
+}
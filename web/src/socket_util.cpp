@@ -0,0 +1,74 @@
+#include "socket_util.hpp"
+#include <pthread.h>
+#include <sched.h>
+
+// 创建监听套接字
+SOCKET CreateListenSocket(int port, bool nonBlocking, bool reusePort) {
+    int type = SOCK_STREAM | SOCK_CLOEXEC | (nonBlocking ? SOCK_NONBLOCK : 0);
+    SOCKET listenSocket = socket(AF_INET, type, IPPROTO_TCP);
+    if (listenSocket == INVALID_SOCKET) {
+        std::cerr << "socket failed: " << strerror(errno) << std::endl;
+        return INVALID_SOCKET;
+    }
+
+    // 设置套接字选项
+    int reuse = 1;
+    if (setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) == SOCKET_ERROR) {
+        std::cerr << "setsockopt(SO_REUSEADDR) failed: " << strerror(errno) << std::endl;
+    }
+
+    // 允许多个监听套接字绑定同一端口
+    if (reusePort &&
+        setsockopt(listenSocket, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse)) == SOCKET_ERROR) {
+        std::cerr << "setsockopt(SO_REUSEPORT) failed: " << strerror(errno) << std::endl;
+        closesocket(listenSocket);
+        return INVALID_SOCKET;
+    }
+
+    // 禁用Nagle算法(Linux上由accept出的套接字继承)
+    int nodelay = 1;
+    if (setsockopt(listenSocket, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay)) == SOCKET_ERROR) {
+        std::cerr << "setsockopt(TCP_NODELAY) failed: " << strerror(errno) << std::endl;
+    }
+
+    // 设置接收缓冲区大小
+    int recvBufSize = 64 * 1024; // 64KB
+    if (setsockopt(listenSocket, SOL_SOCKET, SO_RCVBUF, &recvBufSize, sizeof(recvBufSize)) == SOCKET_ERROR) {
+        std::cerr << "setsockopt(SO_RCVBUF) failed: " << strerror(errno) << std::endl;
+    }
+
+    // 绑定套接字
+    sockaddr_in serverAddr{};
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_addr.s_addr = htonl(INADDR_ANY);
+    serverAddr.sin_port = htons(port);
+
+    if (bind(listenSocket, (sockaddr*)&serverAddr, sizeof(serverAddr)) == SOCKET_ERROR) {
+        std::cerr << "bind failed: " << strerror(errno) << std::endl;
+        closesocket(listenSocket);
+        return INVALID_SOCKET;
+    }
+
+    // 开始监听
+    if (listen(listenSocket, SOMAXCONN) == SOCKET_ERROR) {
+        std::cerr << "listen failed: " << strerror(errno) << std::endl;
+        closesocket(listenSocket);
+        return INVALID_SOCKET;
+    }
+
+    return listenSocket;
+}
+
+// 绑定当前线程到CPU核心
+void PinCurrentThread(size_t index) {
+    unsigned cpus = std::thread::hardware_concurrency();
+    if (cpus == 0) return;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % cpus, &set);
+    int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (err != 0) {
+        std::cerr << "pthread_setaffinity_np failed: " << strerror(err) << std::endl;
+    }
+}
@@ -0,0 +1,126 @@
+#include "task_pool.hpp"
+
+namespace {
+// 当前线程所属的线程池及其队列编号(非工作线程为nullptr)
+thread_local const TaskPool* currentPool = nullptr;
+thread_local size_t currentWorker = 0;
+}
+
+// 创建并启动工作线程
+TaskPool::TaskPool(size_t threads) {
+    if (threads == 0) threads = 1;
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        workers_[i]->thread = std::thread([this, i]() { Run(i); });
+    }
+}
+
+// 析构函数
+TaskPool::~TaskPool() { Stop(); }
+
+// 提交任务：工作线程提交的子任务放入自己的队列，其他线程提交的任务轮流分配
+void TaskPool::Submit(Task task) {
+    if (stopping_.load(std::memory_order_relaxed)) return;
+    size_t index = currentPool == this ? currentWorker
+                                       : next_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+    // 先在sleepMutex_下增加计数(休眠前检查计数的工作线程不会错过这次唤醒)，再放入队列
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        pending_.fetch_add(1, std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+        workers_[index]->tasks.push_back(std::move(task));
+    }
+    wake_.notify_one();
+}
+
+// 从自己的队首取任务
+bool TaskPool::TryPop(size_t index, Task& task) {
+    Worker& worker = *workers_[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) return false;
+    task = std::move(worker.tasks.front());
+    worker.tasks.pop_front();
+    return true;
+}
+
+// 从其他队列的队尾窃取任务(从下一个队列开始，避免所有线程都先去窃取同一个队列)
+bool TaskPool::TrySteal(size_t index, Task& task) {
+    for (size_t i = 1; i < workers_.size(); ++i) {
+        Worker& victim = *workers_[(index + i) % workers_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty()) continue;
+        task = std::move(victim.tasks.back());
+        victim.tasks.pop_back();
+        return true;
+    }
+    return false;
+}
+
+// 工作线程主循环
+void TaskPool::Run(size_t index) {
+    currentPool = this;
+    currentWorker = index;
+    Worker& self = *workers_[index];
+
+    while (!stopping_.load(std::memory_order_relaxed)) {
+        Task task;
+        bool stolen = false;
+        if (!TryPop(index, task)) {
+            stolen = TrySteal(index, task);
+            if (!stolen) {
+                // 所有队列都空：休眠到有新任务(取走任务的线程可能不是被唤醒的那个，醒来后重新查找)
+                std::unique_lock<std::mutex> lock(sleepMutex_);
+                wake_.wait(lock, [this]() {
+                    return stopping_.load(std::memory_order_relaxed) || pending_.load(std::memory_order_relaxed) > 0;
+                });
+                continue;
+            }
+        }
+
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        task();
+        self.executed.store(self.executed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (stolen) self.stolen.store(self.stolen.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    currentPool = nullptr;
+}
+
+// 停止工作线程并丢弃尚未执行的任务
+void TaskPool::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        if (stopping_.exchange(true)) return;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+    for (auto& worker : workers_) {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        pending_.fetch_sub(worker->tasks.size(), std::memory_order_relaxed);
+        worker->tasks.clear();
+    }
+}
+
+// 累计执行的任务数
+uint64_t TaskPool::Executed() const {
+    uint64_t total = 0;
+    for (const auto& worker : workers_) {
+        total += worker->executed.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+// 累计窃取的任务数
+uint64_t TaskPool::Stolen() const {
+    uint64_t total = 0;
+    for (const auto& worker : workers_) {
+        total += worker->stolen.load(std::memory_order_relaxed);
+    }
+    return total;
+}
@@ -2,71 +2,201 @@
 #include <algorithm>
 
 // 构造函数
-TimerWheel::TimerWheel(size_t slots, std::chrono::milliseconds interval)
-    : slots_(slots),
+TimerWheel::TimerWheel(std::chrono::milliseconds interval)
+    : slots_(ROOT_SIZE + (LEVELS - 1) * LEVEL_SIZE),
       interval_(interval),
-      current_slot_(0),
-      next_id_(0),
-      running_(false) {
-    if (slots == 0) {
-        throw std::invalid_argument("Timer wheel slots cannot be zero");
-    }
+      start_(Clock::now()),
+      now_(0),
+      count_(0),
+      next_id_(0) {
     if (interval <= 0ms) {
         throw std::invalid_argument("Timer interval must be positive");
     }
-    wheel_.resize(slots_);  // 初始化轮
+    // 每个槽位是一个空的循环链表
+    for (auto& head : slots_) {
+        head.prev = &head;
+        head.next = &head;
+    }
 }
 
-// 析构函数
-TimerWheel::~TimerWheel() {
-    Stop();  // 停止定时器
-    if (worker_thread_.joinable()) {
-        worker_thread_.join();  // 等待工作线程结束
-    }
+// 超时换算为tick数(向上取整)
+uint64_t TimerWheel::ToTicks(std::chrono::milliseconds timeout) const {
+    if (timeout <= 0ms) return 0;
+    return static_cast<uint64_t>((timeout + interval_ - 1ms) / interval_);
 }
 
-// 启动定时器
-void TimerWheel::Start() {
-    if (!running_.exchange(true)) {
-        worker_thread_ = std::thread(&TimerWheel::RunLoop, this);  // 创建工作线程
+// 按到期tick放入对应层的槽位：距离小于256个tick放入第0层，否则放入能容纳该距离的最低层
+void TimerWheel::Link(TimerNode& node) {
+    uint64_t expires = std::max(node.expires, now_);
+    uint64_t delta = expires - now_;
+    if (delta >= MAX_SPAN) {
+        // 超出轮的范围：先放在最远的槽位，级联时按真实到期时间重新放置
+        delta = MAX_SPAN - 1;
+        expires = now_ + delta;
     }
+
+    TimerLink* head;
+    if (delta < ROOT_SIZE) {
+        head = &slots_[expires & (ROOT_SIZE - 1)];
+    } else {
+        int level = 1;
+        while (delta >= (1ull << (ROOT_BITS + level * LEVEL_BITS))) ++level;
+        int shift = ROOT_BITS + (level - 1) * LEVEL_BITS;
+        size_t index = (expires >> shift) & (LEVEL_SIZE - 1);
+        head = &slots_[ROOT_SIZE + (level - 1) * LEVEL_SIZE + index];
+    }
+
+    // 追加到槽位链表尾部
+    node.prev = head->prev;
+    node.next = head;
+    head->prev->next = &node;
+    head->prev = &node;
 }
 
-// 停止定时器
-void TimerWheel::Stop() {
-    running_ = false;
+// 从所在槽位摘除
+void TimerWheel::Unlink(TimerLink& node) {
+    node.prev->next = node.next;
+    node.next->prev = node.prev;
+    node.prev = nullptr;
+    node.next = nullptr;
 }
 
-// 运行循环
-void TimerWheel::RunLoop() {
-    using clock = std::chrono::steady_clock;
-    auto next_tick = clock::now() + interval_;  // 计算下一个tick时间
-    
-    while (running_) {
-        std::vector<TimerTask> tasks_to_run;
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            auto& tasks = wheel_[current_slot_];  // 获取当前槽位的任务
-            
-            // 移动所有任务到执行列表
-            for (auto it = tasks.begin(); it != tasks.end();) {
-                tasks_to_run.push_back(std::move(it->second));
-                it = tasks.erase(it);
-            }
-            
-            current_slot_ = (current_slot_ + 1) % slots_;  // 移动到下一个槽位
+// 把高层槽位中的节点重新放置到低层(此时它们的到期距离已小于该层一个槽位的跨度)
+void TimerWheel::Cascade(int level, size_t index) {
+    TimerLink& head = slots_[ROOT_SIZE + (level - 1) * LEVEL_SIZE + index];
+    TimerLink* link = head.next;
+    head.prev = &head;
+    head.next = &head;
+    while (link != &head) {
+        TimerLink* next = link->next;
+        Link(static_cast<TimerNode&>(*link));
+        link = next;
+    }
+}
+
+// 处理当前tick：第0层转完一圈时先从高层级联，再逐个执行当前槽位的回调
+size_t TimerWheel::RunTick() {
+    size_t index = now_ & (ROOT_SIZE - 1);
+    if (index == 0) {
+        for (int level = 1; level < LEVELS; ++level) {
+            size_t levelIndex = (now_ >> (ROOT_BITS + (level - 1) * LEVEL_BITS)) & (LEVEL_SIZE - 1);
+            Cascade(level, levelIndex);
+            if (levelIndex != 0) break;  // 该层未转完一圈，更高层无需级联
+        }
+    }
+
+    // 先把当前槽位整体移到临时链表：回调中新加入的定时器最早在下一个tick执行，
+    // 回调中取消同一批的其他定时器也能正确生效
+    TimerLink& head = slots_[index];
+    TimerLink expired;
+    if (head.next == &head) {
+        ++now_;
+        return 0;
+    }
+    expired.next = head.next;
+    expired.prev = head.prev;
+    expired.next->prev = &expired;
+    expired.prev->next = &expired;
+    head.prev = &head;
+    head.next = &head;
+    ++now_;
+
+    size_t fired = 0;
+    while (expired.next != &expired) {
+        TimerNode& node = static_cast<TimerNode&>(*expired.next);
+        Unlink(node);
+
+        // 期限被Touch延后过：此时才按新期限重新放置
+        if (node.deadline > node.expires) {
+            node.expires = node.deadline;
+            Link(node);
+            continue;
         }
-        
-        // 执行所有到期任务
-        for (auto& task : tasks_to_run) {
-            try {
-                task.callback();  // 执行回调
-            } catch (...) {}  // 忽略异常
+        --count_;
+        ++fired;
+
+        // 回调可能销毁节点所在的对象，先把回调移出节点
+        TimeoutCallback callback;
+        if (node.id != 0) {
+            callback = std::move(node.callback);
+            owned_.erase(node.id);
+        } else {
+            callback = node.callback;
         }
-        
-        // 等待到下一个tick
-        std::this_thread::sleep_until(next_tick);
-        next_tick += interval_;
+        try {
+            callback();  // 执行回调
+        } catch (...) {}  // 忽略异常
+    }
+    return fired;
+}
+
+// 推进指定数量的tick并执行到期回调
+size_t TimerWheel::Advance(uint64_t ticks) {
+    size_t fired = 0;
+    for (uint64_t i = 0; i < ticks; ++i) {
+        fired += RunTick();
+    }
+    return fired;
+}
+
+// 处理now之前到期的全部tick
+size_t TimerWheel::Expire(Clock::time_point now) {
+    if (now < start_) return 0;
+    uint64_t due = static_cast<uint64_t>((now - start_) / interval_) + 1;
+    if (due <= now_) return 0;
+    if (count_ == 0) {
+        now_ = due;  // 没有定时器时直接跳到当前tick
+        return 0;
+    }
+    return Advance(due - now_);
+}
+
+// 距下一次需要处理的毫秒数：第0层本圈内第一个非空槽位，或下一次级联的时刻
+int TimerWheel::NextTimeout(Clock::time_point now) const {
+    if (count_ == 0) return -1;
+
+    uint64_t next = (now_ | (ROOT_SIZE - 1)) + 1;  // 第0层下一圈的起点(级联时刻)
+    for (uint64_t tick = now_; tick < next; ++tick) {
+        const TimerLink& head = slots_[tick & (ROOT_SIZE - 1)];
+        if (head.next != &head) {
+            next = tick;
+            break;
+        }
+    }
+
+    auto deadline = start_ + interval_ * next;
+    if (deadline <= now) return 0;
+    auto wait = std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count();
+    return static_cast<int>(std::min<int64_t>(wait, INT32_MAX));
+}
+
+// 添加或重新调度侵入式节点
+void TimerWheel::Schedule(TimerNode& node, std::chrono::milliseconds timeout) {
+    if (node.Linked()) {
+        Unlink(node);
+        --count_;
+    }
+    node.expires = now_ + ToTicks(timeout);
+    node.deadline = node.expires;
+    Link(node);
+    ++count_;
+}
+
+// 刷新期限：新期限不早于当前槽位时只记录(O(1)且不触碰链表)，提前时才真正重新调度
+void TimerWheel::Touch(TimerNode& node, std::chrono::milliseconds timeout) {
+    uint64_t deadline = now_ + ToTicks(timeout);
+    if (node.Linked() && deadline >= node.expires) {
+        node.deadline = deadline;
+        return;
+    }
+    Schedule(node, timeout);
+}
+
+// 取消侵入式节点
+void TimerWheel::Cancel(TimerNode& node) {
+    if (node.Linked()) {
+        Unlink(node);
+        --count_;
     }
 }
 
@@ -77,65 +207,65 @@ uint64_t TimerWheel::AddTimeout(std::chrono::milliseconds timeout, TimeoutCallba
         return ++next_id_;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    uint64_t id = ++next_id_;
-    
-    // 计算需要的ticks和目标槽位
-    size_t ticks = (timeout + interval_ - 1ms) / interval_;
-    size_t target_slot = (current_slot_ + ticks) % slots_;
-    
-    // 添加到目标槽位
-    wheel_[target_slot].emplace(id, TimerTask{id, std::move(cb)});
+    auto node = std::make_unique<TimerNode>();
+    node->id = ++next_id_;
+    node->callback = std::move(cb);
+
+    node->expires = now_ + ToTicks(timeout);
+    node->deadline = node->expires;
+    Link(*node);
+    ++count_;
+    uint64_t id = node->id;
+    owned_.emplace(id, std::move(node));
     return id;
 }
 
 // 取消超时任务
 void TimerWheel::CancelTimeout(uint64_t id) {
     if (id == 0) return;
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (auto& slot : wheel_) {
-        if (slot.erase(id) > 0) break;  // 找到并删除任务
-    }
+    auto it = owned_.find(id);
+    if (it == owned_.end()) return;  // 已到期或已取消
+    Unlink(*it->second);
+    --count_;
+    owned_.erase(it);
 }
 
-// 获取当前槽位
+// 获取第0层当前槽位
 size_t TimerWheel::GetCurrentSlot() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return current_slot_;
+    return now_ & (ROOT_SIZE - 1);
 }
 
-// 获取轮大小
+// 获取第0层槽位数
 size_t TimerWheel::GetWheelSize() const {
-    return slots_;
+    return ROOT_SIZE;
 }
 
-// 检查是否运行中
-bool TimerWheel::IsRunning() const {
-    return running_;
+// 获取当前tick
+uint64_t TimerWheel::GetCurrentTick() const {
+    return now_;
 }
 
 // 统计任务数
 size_t TimerWheel::CountTasks() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    size_t count = 0;
-    for (const auto& slot : wheel_) {
-        count += slot.size();  // 累加每个槽位的任务数
-    }
-    return count;
+    return count_;
 }
 
 // 打印调试信息
 void TimerWheel::PrintDebugInfo() const {
-    std::lock_guard<std::mutex> lock(mutex_);
     std::cout << "=== Timer Debug ==="
-              << "\nCurrent slot: " << current_slot_
-              << "\nRunning: " << running_
-              << "\nTotal tasks: " << CountTasks()
-              << "\nTasks per slot:";
-    for (size_t i = 0; i < wheel_.size(); ++i) {
-        if (!wheel_[i].empty()) {
-            std::cout << "\n  Slot " << i << ": " << wheel_[i].size() << " tasks";
+              << "\nCurrent tick: " << now_
+              << "\nTotal tasks: " << count_
+              << "\nTasks per level:";
+    for (int level = 0; level < LEVELS; ++level) {
+        size_t begin = level == 0 ? 0 : ROOT_SIZE + (level - 1) * LEVEL_SIZE;
+        size_t end = level == 0 ? ROOT_SIZE : begin + LEVEL_SIZE;
+        size_t tasks = 0;
+        for (size_t i = begin; i < end; ++i) {
+            for (const TimerLink* link = slots_[i].next; link != &slots_[i]; link = link->next) {
+                ++tasks;
+            }
         }
+        std::cout << "\n  Level " << level << ": " << tasks << " tasks";
     }
     std::cout << std::endl;
-}
\ No newline at end of file
+}
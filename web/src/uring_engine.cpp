@@ -0,0 +1,1069 @@
+#include "uring_engine.hpp"
+#include "socket_util.hpp"
+#include "object_pool.hpp"
+#include "connection_table.hpp"
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <algorithm>
+#include <csignal>
+
+namespace {
+// 提交队列深度与完成队列倍数
+const unsigned RING_ENTRIES = 1024;
+const unsigned CQ_MULTIPLIER = 4;
+// 每个线程提供给内核的接收缓冲区个数(必须是2的幂)
+const unsigned BUFFER_RING_ENTRIES = 256;
+// 缓冲区组ID
+const uint16_t BUFFER_GROUP = 0;
+// 单次sendmsg最多聚合的缓冲区数
+const int MAX_IOVECS = 64;
+// 单次splice搬运的字节数(不超过默认管道容量)
+const unsigned SPLICE_CHUNK = 64 * 1024;
+
+// 完成事件类型(编码在user_data最高8位，其下是连接句柄：24位代数与32位fd)
+enum class OpType : uint32_t {
+    ACCEPT = 1, RECV = 2, SEND = 3, WAKE = 4, PROVIDE = 5, SPLICE_IN = 6, SPLICE_OUT = 7, CANCEL = 8
+};
+const int OP_SHIFT = 56;
+
+inline uint64_t MakeUserData(OpType op, ConnectionHandle handle) {
+    return (static_cast<uint64_t>(op) << OP_SHIFT) | handle.Pack();
+}
+
+// 不属于连接的操作(监听套接字、eventfd等)，代数为0
+inline uint64_t MakeUserData(OpType op, SOCKET socket) {
+    return MakeUserData(op, ConnectionHandle{socket, 0});
+}
+
+// 当前I/O线程所属的事件循环
+thread_local void* currentLoop = nullptr;
+
+// 不依赖liburing的最小环封装
+struct Ring {
+    int fd = -1;
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned sqMask = 0;
+    unsigned sqEntries = 0;
+    unsigned localTail = 0;   // 已填充但尚未发布的SQE尾指针
+    unsigned submitted = 0;   // 已发布给内核的尾指针
+    io_uring_sqe* sqes = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+    void* sqPtr = MAP_FAILED;
+    size_t sqSize = 0;
+    void* cqPtr = MAP_FAILED;
+    size_t cqSize = 0;
+    size_t sqesSize = 0;
+
+    // 创建环并映射共享内存
+    bool Setup(unsigned entries) {
+        io_uring_params params{};
+        params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SUBMIT_ALL | IORING_SETUP_COOP_TASKRUN;
+        params.cq_entries = entries * CQ_MULTIPLIER;
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0 && errno == EINVAL) {
+            // 旧内核不支持部分标志时退化
+            params = io_uring_params{};
+            params.flags = IORING_SETUP_CQSIZE;
+            params.cq_entries = entries * CQ_MULTIPLIER;
+            fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        }
+        if (fd < 0) {
+            std::cerr << "io_uring_setup failed: " << strerror(errno) << std::endl;
+            return false;
+        }
+
+        // 定时器依赖带超时的io_uring_enter(5.11+)
+        if (!(params.features & IORING_FEAT_EXT_ARG)) {
+            std::cerr << "io_uring_enter timeout (IORING_FEAT_EXT_ARG) not supported" << std::endl;
+            close(fd);
+            fd = -1;
+            return false;
+        }
+
+        sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMmap) {
+            sqSize = cqSize = std::max(sqSize, cqSize);
+        }
+
+        sqPtr = mmap(nullptr, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sqPtr == MAP_FAILED) {
+            std::cerr << "mmap(sq ring) failed: " << strerror(errno) << std::endl;
+            return false;
+        }
+        cqPtr = singleMmap ? sqPtr :
+            mmap(nullptr, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (cqPtr == MAP_FAILED) {
+            std::cerr << "mmap(cq ring) failed: " << strerror(errno) << std::endl;
+            return false;
+        }
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqesPtr = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sqesPtr == MAP_FAILED) {
+            std::cerr << "mmap(sqes) failed: " << strerror(errno) << std::endl;
+            sqesSize = 0;
+            return false;
+        }
+        sqes = static_cast<io_uring_sqe*>(sqesPtr);
+
+        char* sq = static_cast<char*>(sqPtr);
+        sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqEntries = params.sq_entries;
+        localTail = submitted = *sqTail;
+
+        // SQ索引数组固定为恒等映射，之后只需推进尾指针
+        unsigned* array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        for (unsigned i = 0; i < sqEntries; ++i) {
+            array[i] = i;
+        }
+
+        char* cq = static_cast<char*>(cqPtr);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    // 解除映射并关闭环
+    void Destroy() {
+        if (sqesSize) munmap(sqes, sqesSize);
+        if (cqPtr != MAP_FAILED && cqPtr != sqPtr) munmap(cqPtr, cqSize);
+        if (sqPtr != MAP_FAILED) munmap(sqPtr, sqSize);
+        if (fd >= 0) close(fd);
+        sqesSize = 0;
+        sqPtr = cqPtr = MAP_FAILED;
+        fd = -1;
+    }
+
+    // 发布已填充的SQE并进入内核(waitNr>0时同时等待完成事件)
+    int Enter(unsigned waitNr, int timeoutMs = -1) {
+        __atomic_store_n(sqTail, localTail, __ATOMIC_RELEASE);
+        unsigned toSubmit = localTail - submitted;
+        unsigned flags = waitNr > 0 ? IORING_ENTER_GETEVENTS : 0;
+        int ret;
+        if (waitNr > 0 && timeoutMs >= 0) {
+            // 带超时等待(IORING_ENTER_EXT_ARG)，超时返回ETIME
+            __kernel_timespec ts{};
+            ts.tv_sec = timeoutMs / 1000;
+            ts.tv_nsec = static_cast<long long>(timeoutMs % 1000) * 1000000;
+            io_uring_getevents_arg arg{};
+            arg.ts = reinterpret_cast<uint64_t>(&ts);
+            ret = static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, waitNr,
+                                           flags | IORING_ENTER_EXT_ARG, &arg, sizeof(arg)));
+        } else {
+            ret = static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, waitNr, flags, nullptr, 0));
+        }
+        if (ret >= 0) {
+            submitted += static_cast<unsigned>(ret);
+        }
+        return ret;
+    }
+
+    // 未提交的SQE数量
+    unsigned Pending() const { return localTail - submitted; }
+
+    // 获取一个空闲SQE，队列满时返回nullptr
+    io_uring_sqe* TryGetSqe() {
+        unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        if (localTail - head >= sqEntries) return nullptr;
+        io_uring_sqe* sqe = &sqes[localTail & sqMask];
+        ++localTail;
+        memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    }
+};
+
+// 在途sendmsg的参数(完成前必须保持有效)：只在发送期间从事件循环的池中借用，
+// 空闲连接不占用这约1KB
+struct SendBatch {
+    iovec iov[MAX_IOVECS];  // 聚合的缓冲区
+    msghdr msg;             // 消息头
+};
+}
+
+// 连接状态
+struct UringEngine::Connection {
+    OutputQueue output;              // 待发送数据队列
+    size_t offset = 0;               // 队首内存数据已发送的字节数
+    size_t pending = 0;              // 本轮发送完成前已写出的字节数
+    uint64_t queued = 0;             // 队列中待发送的字节数(含文件段)
+    bool recvArmed = false;          // multishot recv是否仍然有效
+    bool paused = false;             // 发送队列超过高水位，暂停接收
+    bool sendInFlight = false;       // 是否有未完成的send/splice
+    bool flushQueued = false;        // 是否已加入本轮的待刷新列表
+    bool closing = false;            // 正在关闭
+    bool closeAfterSend = false;     // 发送队列写完后关闭
+    SendBatch* batch = nullptr;      // 在途sendmsg的参数(发送期间借用)
+    int pipeFds[2] = {-1, -1};       // 发送文件用的管道(首次发送文件时创建)
+    size_t piped = 0;                // 已搬入管道、尚未发往套接字的字节数
+
+    // 关闭管道
+    void ClosePipe() {
+        if (pipeFds[0] >= 0) close(pipeFds[0]);
+        if (pipeFds[1] >= 0) close(pipeFds[1]);
+        pipeFds[0] = pipeFds[1] = -1;
+    }
+};
+
+// 事件循环
+struct UringEngine::Loop {
+    size_t index = 0;              // 事件循环编号
+    SOCKET listenSocket = INVALID_SOCKET;  // 监听套接字(共享或独立)
+    Ring ring;                     // io_uring环
+    int wakeFd = -1;               // 用于唤醒的eventfd
+    uint64_t wakeValue = 0;        // eventfd读缓冲
+    std::thread thread;            // I/O线程
+    io_uring_buf_ring* bufRing = nullptr;  // 提供给内核的缓冲区环
+    size_t bufRingSize = 0;
+    std::unique_ptr<char[]> buffers;  // 缓冲区内存(BUFFER_RING_ENTRIES * BUFFER_SIZE)
+    uint16_t bufTail = 0;          // 缓冲区环尾指针
+    bool legacyBuffers = false;    // 缓冲区环不可用时退化为IORING_OP_PROVIDE_BUFFERS
+    std::vector<uint16_t> deferredBuffers;  // 提交队列满时未能归还的缓冲区(下一轮重新提供)
+    ConnectionTable<Connection> connections;  // 本线程拥有的连接(按fd下标)
+    std::vector<ConnectionHandle> flushList;  // 本轮有新数据待发送的连接
+    ObjectPool<SendBatch> sendBatches;  // 在途sendmsg参数池
+    TimerWheel timers;             // 本循环的定时器(决定io_uring_enter的等待时长)
+    std::mutex postMutex;          // 保护posted(其他线程投递任务)
+    std::vector<std::function<void()>> posted;   // 其他线程投递的任务
+    std::vector<std::function<void()>> running;  // 正在执行的任务(与posted交换，避免分配)
+    bool acceptArmed = false;      // multishot accept在途
+    bool acceptPaused = false;     // 连接数达到上限，暂停accept
+    std::atomic<uint64_t> syscalls{0};      // 系统调用计数(仅本线程写入)
+    std::atomic<uint64_t> acceptPauses{0};  // 暂停accept的次数(仅本线程写入)
+
+    void CountSyscall() { syscalls.store(syscalls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+
+    // 获取SQE，提交队列满时先提交一次
+    io_uring_sqe* GetSqe() {
+        io_uring_sqe* sqe = ring.TryGetSqe();
+        if (!sqe) {
+            ring.Enter(0);
+            CountSyscall();
+            sqe = ring.TryGetSqe();
+        }
+        return sqe;
+    }
+
+    // 缓冲区地址
+    char* BufferAt(uint16_t bid) const {
+        return buffers.get() + static_cast<size_t>(bid) * BUFFER_SIZE;
+    }
+
+    // 通过SQE提供连续的缓冲区(随下一次io_uring_enter批量提交)；
+    // 提交一次后队列仍满时记下这些缓冲区，下一轮再提供，缓冲区组不会因此永久缩小
+    void ProvideBuffers(uint16_t bid, unsigned count) {
+        io_uring_sqe* sqe = GetSqe();
+        if (!sqe) {
+            for (unsigned i = 0; i < count; ++i) deferredBuffers.push_back(static_cast<uint16_t>(bid + i));
+            return;
+        }
+        sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+        sqe->fd = static_cast<int>(count);
+        sqe->addr = reinterpret_cast<uint64_t>(BufferAt(bid));
+        sqe->len = BUFFER_SIZE;
+        sqe->off = bid;
+        sqe->buf_group = BUFFER_GROUP;
+        sqe->user_data = MakeUserData(OpType::PROVIDE, 0);
+    }
+
+    // 重新提供上一轮未能归还的缓冲区(仍然没有空闲SQE时留到下一轮)
+    void ProvideDeferred() {
+        while (!deferredBuffers.empty()) {
+            uint16_t bid = deferredBuffers.back();
+            deferredBuffers.pop_back();
+            size_t before = deferredBuffers.size();
+            ProvideBuffers(bid, 1);
+            if (deferredBuffers.size() > before) return;
+        }
+    }
+
+    // 将缓冲区归还给内核
+    void RecycleBuffer(uint16_t bid) {
+        if (legacyBuffers) {
+            ProvideBuffers(bid, 1);
+            return;
+        }
+        io_uring_buf* buf = &bufRing->bufs[bufTail & (BUFFER_RING_ENTRIES - 1)];
+        buf->addr = reinterpret_cast<uint64_t>(BufferAt(bid));
+        buf->len = BUFFER_SIZE;
+        buf->bid = bid;
+        ++bufTail;
+        __atomic_store_n(&bufRing->tail, bufTail, __ATOMIC_RELEASE);
+    }
+};
+
+// 构造函数
+UringEngine::UringEngine() :
+    running_(false),
+    connectionLimit_(SIZE_MAX),
+    listenSocket_(INVALID_SOCKET),
+    handler_(nullptr) {}
+
+// 析构函数
+UringEngine::~UringEngine() { Stop(); }
+
+// 初始化引擎
+bool UringEngine::Initialize(const IoEngineOptions& options, IoHandler* handler) {
+    options_ = options;
+    handler_ = handler;
+
+    // 对端关闭时让发送返回EPIPE而不是终止进程
+    signal(SIGPIPE, SIG_IGN);
+
+    // io_uring下套接字无需非阻塞；共享模式下所有环在同一监听套接字上accept
+    if (!options_.reusePort) {
+        listenSocket_ = CreateListenSocket(options_.port, false);
+        if (listenSocket_ == INVALID_SOCKET) {
+            return false;
+        }
+    }
+
+    // 为每个I/O线程创建独立的环
+    for (int i = 0; i < std::max(options_.threadCount, 1); ++i) {
+        auto loop = std::make_unique<Loop>();
+        loop->index = static_cast<size_t>(i);
+        if (!SetupLoop(*loop)) {
+            DestroyLoop(*loop);
+            for (auto& l : loops_) DestroyLoop(*l);
+            loops_.clear();
+            if (listenSocket_ != INVALID_SOCKET) {
+                closesocket(listenSocket_);
+                listenSocket_ = INVALID_SOCKET;
+            }
+            return false;
+        }
+        loops_.push_back(std::move(loop));
+    }
+    connectionLimit_ = LoopConnectionLimit(options_, loops_.size());
+
+    return true;
+}
+
+// 创建环、唤醒fd并注册缓冲区环
+bool UringEngine::SetupLoop(Loop& loop) {
+    // reusePort模式下每个环拥有独立的监听套接字
+    loop.listenSocket = options_.reusePort ?
+        CreateListenSocket(options_.port, false, true) : listenSocket_;
+    if (loop.listenSocket == INVALID_SOCKET) {
+        return false;
+    }
+
+    if (!loop.ring.Setup(RING_ENTRIES)) {
+        return false;
+    }
+
+    loop.wakeFd = eventfd(0, EFD_CLOEXEC);
+    if (loop.wakeFd < 0) {
+        std::cerr << "eventfd failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // 分配缓冲区环(页对齐)并注册为缓冲区组
+    loop.bufRingSize = BUFFER_RING_ENTRIES * sizeof(io_uring_buf);
+    void* ringMem = mmap(nullptr, loop.bufRingSize, PROT_READ | PROT_WRITE,
+                         MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (ringMem == MAP_FAILED) {
+        std::cerr << "mmap(buffer ring) failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+    loop.bufRing = static_cast<io_uring_buf_ring*>(ringMem);
+
+    io_uring_buf_reg reg{};
+    reg.ring_addr = reinterpret_cast<uint64_t>(loop.bufRing);
+    reg.ring_entries = BUFFER_RING_ENTRIES;
+    reg.bgid = BUFFER_GROUP;
+    if (syscall(__NR_io_uring_register, loop.ring.fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        std::cerr << "io_uring_register(PBUF_RING) failed: " << strerror(errno)
+                  << " (kernel 5.19+ required)" << std::endl;
+        return false;
+    }
+
+    loop.buffers.reset(new char[static_cast<size_t>(BUFFER_RING_ENTRIES) * BUFFER_SIZE]);
+    for (unsigned i = 0; i < BUFFER_RING_ENTRIES; ++i) {
+        loop.RecycleBuffer(static_cast<uint16_t>(i));
+    }
+
+    // 部分内核虽然接受注册但无法从缓冲区环取到缓冲区，此时退化为逐个提供缓冲区
+    if (!ProbeBufferRing(loop)) {
+        std::cerr << "io_uring buffer ring unusable, falling back to IORING_OP_PROVIDE_BUFFERS" << std::endl;
+        io_uring_buf_reg unreg{};
+        unreg.bgid = BUFFER_GROUP;
+        syscall(__NR_io_uring_register, loop.ring.fd, IORING_UNREGISTER_PBUF_RING, &unreg, 1);
+        munmap(loop.bufRing, loop.bufRingSize);
+        loop.bufRing = nullptr;
+        loop.legacyBuffers = true;
+        loop.ProvideBuffers(0, BUFFER_RING_ENTRIES);
+    }
+    return true;
+}
+
+// 用socketpair验证内核能否从缓冲区环中选择缓冲区
+bool UringEngine::ProbeBufferRing(Loop& loop) {
+    int pair[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, pair) < 0) {
+        return true;
+    }
+
+    char byte = 0;
+    bool ok = false;
+    io_uring_sqe* sqe = loop.GetSqe();
+    if (sqe && write(pair[1], &byte, 1) == 1) {
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = pair[0];
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = BUFFER_GROUP;
+        sqe->user_data = MakeUserData(OpType::RECV, pair[0]);
+
+        if (loop.ring.Enter(1) >= 0) {
+            unsigned head = *loop.ring.cqHead;
+            const io_uring_cqe& cqe = loop.ring.cqes[head & loop.ring.cqMask];
+            ok = cqe.res > 0 && (cqe.flags & IORING_CQE_F_BUFFER);
+            if (ok) {
+                loop.RecycleBuffer(static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+            }
+            __atomic_store_n(loop.ring.cqHead, head + 1, __ATOMIC_RELEASE);
+        }
+    }
+
+    close(pair[0]);
+    close(pair[1]);
+    return ok;
+}
+
+// 释放环相关资源
+void UringEngine::DestroyLoop(Loop& loop) {
+    // 先关闭环，确保内核不再访问缓冲区
+    loop.ring.Destroy();
+    if (loop.bufRing) {
+        munmap(loop.bufRing, loop.bufRingSize);
+        loop.bufRing = nullptr;
+    }
+    if (loop.wakeFd >= 0) {
+        close(loop.wakeFd);
+        loop.wakeFd = -1;
+    }
+    if (options_.reusePort && loop.listenSocket != INVALID_SOCKET) {
+        closesocket(loop.listenSocket);
+    }
+    loop.listenSocket = INVALID_SOCKET;
+}
+
+// 启动I/O线程
+void UringEngine::Start() {
+    if (running_.exchange(true)) return;
+    for (auto& loop : loops_) {
+        Loop* l = loop.get();
+        loop->thread = std::thread([this, l]() { RunLoop(*l); });
+    }
+}
+
+// 事件循环
+void UringEngine::RunLoop(Loop& loop) {
+    currentLoop = &loop;
+    if (options_.reusePort) {
+        PinCurrentThread(loop.index);
+    }
+    ArmAccept(loop);
+    ArmWake(loop);
+
+    while (running_) {
+        // 上一轮产生的响应(以及未能归还的缓冲区)随本次io_uring_enter一起提交
+        if (!loop.deferredBuffers.empty()) loop.ProvideDeferred();
+        FlushPending(loop);
+
+        // 一次系统调用完成批量提交与等待，最多等到下一个定时器到期
+        int ret = loop.ring.Enter(1, loop.timers.NextTimeout());
+        loop.CountSyscall();
+        if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY && errno != ETIME) {
+            std::cerr << "io_uring_enter failed: " << strerror(errno) << std::endl;
+            break;
+        }
+
+        // 先处理到期定时器，使本轮新加入的定时器以当前时刻为起点
+        loop.timers.Expire();
+
+        // 收割所有完成事件
+        unsigned head = *loop.ring.cqHead;
+        unsigned tail = __atomic_load_n(loop.ring.cqTail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const io_uring_cqe& cqe = loop.ring.cqes[head & loop.ring.cqMask];
+            uint64_t userData = cqe.user_data;
+            int res = cqe.res;
+            uint32_t flags = cqe.flags;
+            ++head;
+            __atomic_store_n(loop.ring.cqHead, head, __ATOMIC_RELEASE);
+
+            HandleCompletion(loop, userData, res, flags);
+            if (head == tail) {
+                tail = __atomic_load_n(loop.ring.cqTail, __ATOMIC_ACQUIRE);
+            }
+        }
+    }
+
+    currentLoop = nullptr;
+}
+
+// 分发完成事件
+void UringEngine::HandleCompletion(Loop& loop, uint64_t userData, int res, uint32_t flags) {
+    OpType op = static_cast<OpType>(userData >> OP_SHIFT);
+    ConnectionHandle handle = ConnectionHandle::Unpack(userData);
+    SOCKET socket = handle.socket;
+
+    // 连接的完成事件：代数不符说明连接已移除、fd已被新连接复用，丢弃陈旧事件(只归还缓冲区)
+    if (op == OpType::RECV || op == OpType::SEND || op == OpType::SPLICE_IN || op == OpType::SPLICE_OUT) {
+        if (!loop.connections.Find(handle)) {
+            if (flags & IORING_CQE_F_BUFFER) loop.RecycleBuffer(static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT));
+            return;
+        }
+    }
+
+    switch (op) {
+        case OpType::ACCEPT:
+            HandleAccept(loop, res, flags);
+            break;
+        case OpType::RECV:
+            HandleRecv(loop, socket, res, flags);
+            break;
+        case OpType::SEND:
+            HandleSend(loop, socket, res);
+            break;
+        case OpType::SPLICE_IN:
+        case OpType::SPLICE_OUT:
+            HandleSplice(loop, socket, op == OpType::SPLICE_OUT, res);
+            break;
+        case OpType::WAKE:
+            if (running_) ArmWake(loop);
+            RunPosted(loop);
+            break;
+        case OpType::PROVIDE:
+            if (res < 0) {
+                std::cerr << "IORING_OP_PROVIDE_BUFFERS failed: " << strerror(-res) << std::endl;
+            }
+            break;
+        case OpType::CANCEL:
+            break;  // 被取消的recv与accept会以-ECANCELED单独完成
+    }
+}
+
+// 投递multishot accept
+void UringEngine::ArmAccept(Loop& loop) {
+    io_uring_sqe* sqe = loop.GetSqe();
+    if (!sqe) return;
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = loop.listenSocket;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = MakeUserData(OpType::ACCEPT, loop.listenSocket);
+    loop.acceptArmed = true;
+}
+
+// 取消multishot accept：已完成的accept仍会交付，之后以-ECANCELED结束，新连接留在监听队列中
+void UringEngine::CancelAccept(Loop& loop) {
+    io_uring_sqe* sqe = loop.GetSqe();
+    if (!sqe) return;
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = MakeUserData(OpType::ACCEPT, loop.listenSocket);
+    sqe->user_data = MakeUserData(OpType::CANCEL, loop.listenSocket);
+}
+
+// 投递eventfd读操作
+void UringEngine::ArmWake(Loop& loop) {
+    io_uring_sqe* sqe = loop.GetSqe();
+    if (!sqe) return;
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = loop.wakeFd;
+    sqe->addr = reinterpret_cast<uint64_t>(&loop.wakeValue);
+    sqe->len = sizeof(loop.wakeValue);
+    sqe->user_data = MakeUserData(OpType::WAKE, loop.wakeFd);
+}
+
+// 投递multishot recv，缓冲区由内核从缓冲区组中选择
+void UringEngine::ArmRecv(Loop& loop, SOCKET socket, Connection& conn) {
+    io_uring_sqe* sqe = loop.GetSqe();
+    if (!sqe) {
+        conn.closing = true;
+        return;
+    }
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = socket;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sqe->user_data = MakeUserData(OpType::RECV, loop.connections.Handle(socket));
+    conn.recvArmed = true;
+}
+
+// 取消multishot recv：已在途的数据仍会交付，之后recv以-ECANCELED结束
+void UringEngine::CancelRecv(Loop& loop, SOCKET socket) {
+    io_uring_sqe* sqe = loop.GetSqe();
+    if (!sqe) return;
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = MakeUserData(OpType::RECV, loop.connections.Handle(socket));
+    sqe->user_data = MakeUserData(OpType::CANCEL, loop.connections.Handle(socket));
+}
+
+// 发送队列回落到低水位以下时解除背压并重新投递recv(在OnSend之前调用，处理器据此继续处理请求)；
+// 取消尚未完成时recv仍标记为有效，由其-ECANCELED完成事件重新投递
+void UringEngine::CheckLowWater(Loop& loop, SOCKET socket, Connection& conn) {
+    if (!conn.paused || conn.queued > options_.outputLowWater) return;
+    conn.paused = false;
+    if (!conn.recvArmed && !conn.closing) ArmRecv(loop, socket, conn);
+}
+
+// 为队首数据投递发送：连续的内存数据聚合为一个sendmsg(只有一段时用send)，文件段投递splice
+void UringEngine::SubmitSend(Loop& loop, SOCKET socket, Connection& conn) {
+    OutputSegment& front = conn.output.front();
+    if (front.IsFile() && conn.pipeFds[0] < 0) {
+        loop.CountSyscall();
+        if (pipe2(conn.pipeFds, O_CLOEXEC) < 0) {
+            std::cerr << "pipe2 failed: " << strerror(errno) << std::endl;
+            conn.closing = true;
+            shutdown(socket, SHUT_RDWR);
+            return;
+        }
+    }
+
+    io_uring_sqe* sqe = loop.GetSqe();
+    if (!sqe) {
+        conn.closing = true;
+        shutdown(socket, SHUT_RDWR);
+        return;
+    }
+
+    if (front.IsFile()) {
+        sqe->opcode = IORING_OP_SPLICE;
+        sqe->splice_flags = SPLICE_F_MOVE;
+        if (conn.piped > 0) {
+            // 管道中的数据发往套接字
+            sqe->splice_fd_in = conn.pipeFds[0];
+            sqe->splice_off_in = static_cast<uint64_t>(-1);
+            sqe->fd = socket;
+            sqe->off = static_cast<uint64_t>(-1);
+            sqe->len = static_cast<uint32_t>(conn.piped);
+            sqe->user_data = MakeUserData(OpType::SPLICE_OUT, loop.connections.Handle(socket));
+        } else {
+            // 从页缓存搬运下一块到管道
+            sqe->splice_fd_in = front.file;
+            sqe->splice_off_in = front.offset;
+            sqe->fd = conn.pipeFds[1];
+            sqe->off = static_cast<uint64_t>(-1);
+            sqe->len = static_cast<uint32_t>(std::min<uint64_t>(front.remaining, SPLICE_CHUNK));
+            sqe->user_data = MakeUserData(OpType::SPLICE_IN, loop.connections.Handle(socket));
+        }
+        conn.sendInFlight = true;
+        return;
+    }
+
+    // 只有一段内存数据(最常见的情况)时用IORING_OP_SEND，无需借用sendmsg参数
+    if (conn.output.size() == 1 || conn.output[1].IsFile()) {
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = socket;
+        sqe->addr = reinterpret_cast<uint64_t>(front.Data() + conn.offset);
+        sqe->len = static_cast<uint32_t>(front.Size() - conn.offset);
+        sqe->msg_flags = MSG_NOSIGNAL;
+        sqe->user_data = MakeUserData(OpType::SEND, loop.connections.Handle(socket));
+        conn.sendInFlight = true;
+        return;
+    }
+
+    if (!conn.batch) conn.batch = loop.sendBatches.Acquire();
+    SendBatch& batch = *conn.batch;
+    int count = 0;
+    for (size_t i = 0; i < conn.output.size() && count < MAX_IOVECS; ++i) {
+        const OutputSegment& segment = conn.output[i];
+        if (segment.IsFile()) break;
+        size_t skip = (count == 0) ? conn.offset : 0;
+        batch.iov[count].iov_base = const_cast<char*>(segment.Data()) + skip;
+        batch.iov[count].iov_len = segment.Size() - skip;
+        ++count;
+    }
+    batch.msg = msghdr{};
+    batch.msg.msg_iov = batch.iov;
+    batch.msg.msg_iovlen = count;
+
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = socket;
+    sqe->addr = reinterpret_cast<uint64_t>(&batch.msg);
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = MakeUserData(OpType::SEND, loop.connections.Handle(socket));
+    conn.sendInFlight = true;
+}
+
+// 为本轮有新数据且没有在途发送的连接投递sendmsg
+void UringEngine::FlushPending(Loop& loop) {
+    for (size_t i = 0; i < loop.flushList.size(); ++i) {
+        ConnectionHandle handle = loop.flushList[i];
+        Connection* found = loop.connections.Find(handle);  // 已关闭(或fd已被复用)的连接跳过
+        if (!found) continue;
+        SOCKET socket = handle.socket;
+        Connection& conn = *found;
+        conn.flushQueued = false;
+
+        // 在途发送完成后会继续发送剩余数据
+        if (conn.sendInFlight || conn.closing || conn.output.empty()) continue;
+        SubmitSend(loop, socket, conn);
+    }
+    loop.flushList.clear();
+}
+
+// 处理accept完成
+void UringEngine::HandleAccept(Loop& loop, int res, uint32_t flags) {
+    if (res >= 0) {
+        SOCKET clientSocket = res;
+        Connection& conn = loop.connections.Insert(clientSocket);
+        handler_->OnAccept(loop.index, clientSocket);
+        ArmRecv(loop, clientSocket, conn);
+        MaybeClose(loop, clientSocket);
+    } else if (res != -ECANCELED && res != -EINTR && res != -ECONNABORTED) {
+        std::cerr << "accept failed: " << strerror(-res) << std::endl;
+    }
+
+    // 达到连接上限：取消accept(取消生效前内核已接受的连接照常处理)
+    bool more = (flags & IORING_CQE_F_MORE) != 0;
+    if (!loop.acceptPaused && loop.connections.Size() >= connectionLimit_) {
+        loop.acceptPaused = true;
+        loop.acceptPauses.store(loop.acceptPauses.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (more) CancelAccept(loop);
+    }
+
+    // multishot被内核终止(或被取消)时，未暂停则重新投递
+    if (!more) {
+        loop.acceptArmed = false;
+        if (running_ && !loop.acceptPaused) ArmAccept(loop);
+    }
+}
+
+// 处理recv完成
+void UringEngine::HandleRecv(Loop& loop, SOCKET socket, int res, uint32_t flags) {
+    Connection& conn = *loop.connections.Find(socket);  // HandleCompletion已丢弃陈旧事件
+    bool hasBuffer = (flags & IORING_CQE_F_BUFFER) != 0;
+    uint16_t bid = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+
+    if (res > 0 && hasBuffer) {
+        if (!conn.closing) {
+            const char* data = loop.BufferAt(bid);
+            handler_->OnRecv(loop.index, socket, data, static_cast<size_t>(res));
+        }
+        // 数据已被处理器消费，立即归还缓冲区
+        loop.RecycleBuffer(bid);
+    } else if (hasBuffer) {
+        loop.RecycleBuffer(bid);
+    }
+
+    if (!(flags & IORING_CQE_F_MORE)) {
+        conn.recvArmed = false;
+        if (res > 0 || res == -ENOBUFS || res == -ECANCELED) {
+            // 缓冲区暂时耗尽、内核终止了multishot或因背压被取消：不在背压状态时重新投递
+            if (!conn.closing && !conn.paused) ArmRecv(loop, socket, conn);
+        } else {
+            // 对端关闭或出错
+            conn.closing = true;
+        }
+    }
+
+    MaybeClose(loop, socket);
+}
+
+// 处理send完成
+void UringEngine::HandleSend(Loop& loop, SOCKET socket, int res) {
+    Connection& conn = *loop.connections.Find(socket);  // HandleCompletion已丢弃陈旧事件
+    conn.sendInFlight = false;
+    if (conn.batch) {
+        loop.sendBatches.Release(conn.batch);  // 继续发送时会重新借用(通常是同一个)
+        conn.batch = nullptr;
+    }
+
+    if (res < 0) {
+        // 发送失败，关闭读端以终止multishot recv
+        conn.closing = true;
+        shutdown(socket, SHUT_RDWR);
+        loop.CountSyscall();
+        MaybeClose(loop, socket);
+        return;
+    }
+
+    // 移除已完整发送的缓冲区
+    size_t written = static_cast<size_t>(res);
+    conn.pending += written;
+    conn.queued -= written;
+    while (written > 0) {
+        size_t left = conn.output.front().Size() - conn.offset;
+        if (written < left) {
+            conn.offset += written;
+            break;
+        }
+        written -= left;
+        conn.output.pop_front();
+        conn.offset = 0;
+    }
+
+    // 部分发送或队列中还有数据，继续发送(正在关闭的连接不再发送)；要求写完后关闭的连接在队列清空时关闭
+    if (!conn.output.empty() && !conn.closing) {
+        SubmitSend(loop, socket, conn);
+    } else if (conn.output.empty() && conn.closeAfterSend) {
+        ShutdownDrained(loop, socket, conn);
+    }
+    size_t sent = conn.pending;
+    conn.pending = 0;
+    CheckLowWater(loop, socket, conn);
+    handler_->OnSend(loop.index, socket, sent);
+
+    MaybeClose(loop, socket);
+}
+
+// 处理splice完成(toSocket为false时是文件->管道，否则是管道->套接字)
+void UringEngine::HandleSplice(Loop& loop, SOCKET socket, bool toSocket, int res) {
+    Connection& conn = *loop.connections.Find(socket);  // HandleCompletion已丢弃陈旧事件
+    conn.sendInFlight = false;
+
+    // 出错，或文件在发送期间被截断
+    if (res <= 0) {
+        if (res < 0) std::cerr << "splice failed: " << strerror(-res) << std::endl;
+        conn.closing = true;
+        shutdown(socket, SHUT_RDWR);
+        loop.CountSyscall();
+        MaybeClose(loop, socket);
+        return;
+    }
+
+    OutputSegment& front = conn.output.front();
+    size_t moved = static_cast<size_t>(res);
+    if (!toSocket) {
+        conn.piped = moved;
+        front.offset += moved;
+        front.remaining -= moved;
+    } else {
+        conn.piped -= moved;
+        conn.pending += moved;
+        conn.queued -= moved;
+        if (conn.piped == 0 && front.remaining == 0) conn.output.pop_front();
+    }
+
+    // 管道中还有数据、文件未发完或队列中还有数据，继续发送
+    if (!conn.output.empty() && !conn.closing) {
+        SubmitSend(loop, socket, conn);
+    } else if (conn.output.empty() && conn.closeAfterSend) {
+        ShutdownDrained(loop, socket, conn);
+    }
+    // 数据写入套接字时报告进展(慢速客户端下载期间保持连接活跃)
+    if (conn.pending > 0) {
+        size_t sent = conn.pending;
+        conn.pending = 0;
+        CheckLowWater(loop, socket, conn);
+        handler_->OnSend(loop.index, socket, sent);
+    }
+
+    MaybeClose(loop, socket);
+}
+
+// 要求写完后关闭的连接已写完：发出FIN，recv继续读取直到对端关闭(EOF)，随后由MaybeClose回收
+void UringEngine::ShutdownDrained(Loop& loop, SOCKET socket, Connection& conn) {
+    conn.closeAfterSend = false;
+    shutdown(socket, SHUT_WR);
+    loop.CountSyscall();
+}
+
+// 无未完成操作时关闭连接
+void UringEngine::MaybeClose(Loop& loop, SOCKET socket) {
+    Connection* conn = loop.connections.Find(socket);
+    if (!conn || !conn->closing || conn->recvArmed || conn->sendInFlight) return;
+
+    conn->ClosePipe();
+    loop.connections.Erase(socket);
+    // 先通知上层清理状态，再关闭fd，防止fd被复用后状态错乱
+    handler_->OnClose(loop.index, socket);
+    closesocket(socket);
+    loop.CountSyscall();
+
+    // 腾出名额后恢复accept(取消尚未完成时由其-ECANCELED完成事件重新投递)
+    if (loop.acceptPaused && loop.connections.Size() < connectionLimit_) {
+        loop.acceptPaused = false;
+        if (!loop.acceptArmed && running_) ArmAccept(loop);
+    }
+}
+
+// 放入发送队列，本轮完成事件处理完后提交
+void UringEngine::QueueOutput(Loop& loop, SOCKET socket, OutputSegment segment) {
+    Connection* found = loop.connections.Find(socket);
+    if (!found || found->closing) return;
+
+    Connection& conn = *found;
+    conn.queued += segment.Bytes();
+    if (conn.queued > options_.outputHighWater && !conn.paused) {
+        // 超过高水位：停止接收，直到发送队列回落
+        conn.paused = true;
+        if (conn.recvArmed) CancelRecv(loop, socket);
+    }
+    conn.output.push_back(std::move(segment));
+    if (!conn.flushQueued) {
+        conn.flushQueued = true;
+        loop.flushList.push_back(loop.connections.Handle(socket));
+    }
+}
+
+// 异步发送数据
+void UringEngine::Send(SOCKET socket, std::string data) {
+    Loop* loop = static_cast<Loop*>(currentLoop);
+    if (!loop) {
+        std::cerr << "UringEngine::Send called outside of an I/O thread" << std::endl;
+        return;
+    }
+    if (data.empty()) return;
+    QueueOutput(*loop, socket, OutputSegment(std::move(data)));
+}
+
+// 异步发送共享缓冲区
+void UringEngine::Send(SOCKET socket, SharedBuffer data) {
+    Loop* loop = static_cast<Loop*>(currentLoop);
+    if (!loop) {
+        std::cerr << "UringEngine::Send called outside of an I/O thread" << std::endl;
+        return;
+    }
+    if (!data || data->empty()) return;
+    QueueOutput(*loop, socket, OutputSegment(std::move(data)));
+}
+
+// 异步发送共享缓冲区的一部分
+void UringEngine::Send(SOCKET socket, SharedBuffer data, size_t offset, size_t length) {
+    Loop* loop = static_cast<Loop*>(currentLoop);
+    if (!loop) {
+        std::cerr << "UringEngine::Send called outside of an I/O thread" << std::endl;
+        return;
+    }
+    if (!data || length == 0) return;
+    QueueOutput(*loop, socket, OutputSegment(std::move(data), offset, length));
+}
+
+// 异步发送文件区间
+void UringEngine::SendFile(SOCKET socket, FileHandle file, uint64_t offset, uint64_t length) {
+    OutputSegment segment(file, offset, length);  // 接管文件，出错时自动关闭
+    Loop* loop = static_cast<Loop*>(currentLoop);
+    if (!loop) {
+        std::cerr << "UringEngine::SendFile called outside of an I/O thread" << std::endl;
+        return;
+    }
+    if (length == 0) return;
+    QueueOutput(*loop, socket, std::move(segment));
+}
+
+// 连接是否处于背压状态
+bool UringEngine::Backpressured(SOCKET socket) {
+    Loop* loop = static_cast<Loop*>(currentLoop);
+    if (!loop) return false;
+    Connection* conn = loop->connections.Find(socket);
+    return conn && conn->paused;
+}
+
+// 投递任务到指定事件循环(队列由空变为非空时才唤醒，之后的投递由同一次唤醒处理)
+void UringEngine::Post(size_t loop, std::function<void()> task) {
+    Loop& target = *loops_[loop];
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(target.postMutex);
+        wake = target.posted.empty();
+        target.posted.push_back(std::move(task));
+    }
+    uint64_t one = 1;
+    if (wake && write(target.wakeFd, &one, sizeof(one)) < 0) {
+        std::cerr << "Failed to wake I/O thread: " << strerror(errno) << std::endl;
+    }
+}
+
+// 执行其他线程投递的任务(产生的响应随下一次io_uring_enter提交)
+void UringEngine::RunPosted(Loop& loop) {
+    {
+        std::lock_guard<std::mutex> lock(loop.postMutex);
+        loop.running.swap(loop.posted);
+    }
+    for (auto& task : loop.running) {
+        task();
+    }
+    loop.running.clear();
+}
+
+// 指定事件循环的定时器
+TimerWheel& UringEngine::Timers(size_t loop) {
+    return loops_[loop]->timers;
+}
+
+// 关闭连接(shutdown使multishot recv以EOF结束，由所属线程回收)
+void UringEngine::Close(SOCKET socket) {
+    shutdown(socket, SHUT_RDWR);
+}
+
+// 发送队列写完后关闭连接(队列已空且没有在途发送时立即关闭写端)
+void UringEngine::CloseAfterSend(SOCKET socket) {
+    Loop* loop = static_cast<Loop*>(currentLoop);
+    Connection* conn = loop ? loop->connections.Find(socket) : nullptr;
+    if (!conn) return;
+    conn->closeAfterSend = true;
+    if (conn->output.empty() && !conn->sendInFlight) ShutdownDrained(*loop, socket, *conn);
+}
+
+// 累计系统调用次数
+uint64_t UringEngine::SyscallCount() const {
+    uint64_t total = 0;
+    for (const auto& loop : loops_) {
+        total += loop->syscalls.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+// 累计暂停accept的次数
+uint64_t UringEngine::AcceptPauseCount() const {
+    uint64_t total = 0;
+    for (const auto& loop : loops_) {
+        total += loop->acceptPauses.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+// 停止引擎
+void UringEngine::Stop() {
+    // 唤醒并等待所有I/O线程结束
+    if (running_.exchange(false)) {
+        for (auto& loop : loops_) {
+            uint64_t one = 1;
+            if (write(loop->wakeFd, &one, sizeof(one)) < 0) {
+                std::cerr << "Failed to wake I/O thread: " << strerror(errno) << std::endl;
+            }
+        }
+        for (auto& loop : loops_) {
+            if (loop->thread.joinable()) loop->thread.join();
+        }
+    }
+
+    // 先销毁环(取消所有未完成操作)，再关闭连接
+    for (auto& loop : loops_) {
+        DestroyLoop(*loop);
+        Loop& l = *loop;
+        l.connections.ForEach([this, &l](SOCKET socket, Connection& conn) {
+            conn.ClosePipe();
+            l.connections.Erase(socket);
+            handler_->OnClose(l.index, socket);
+            closesocket(socket);
+        });
+    }
+    loops_.clear();
+
+    // 关闭监听套接字
+    if (listenSocket_ != INVALID_SOCKET) {
+        closesocket(listenSocket_);
+        listenSocket_ = INVALID_SOCKET;
+    }
+}
@@ -0,0 +1,1269 @@
+#include "web_server.hpp"
+#include "response_writer.hpp"
+#include "mime.hpp"
+#include "gzip.hpp"
+#include "content_coding.hpp"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+
+using namespace std::chrono_literals;
+namespace fs = std::filesystem;
+
+namespace {
+// 事件循环延迟的采样间隔，以及定时器轮取整带来的最大误差(两个tick)
+const auto LAG_PROBE_INTERVAL = 50ms;
+const auto LAG_PROBE_SLACK = 20ms;
+// 过载时的503响应体
+const std::string_view OVERLOAD_BODY = "Service Unavailable";
+// 缓存的响应中的长连接头，以及不保持连接时替换它的头
+const std::string_view KEEP_ALIVE_LINE = "Connection: keep-alive\r\n";
+const std::string_view CLOSE_LINE = "Connection: close\r\n";
+
+// 协商结果的缓存键的最大长度(更长的路径不做内容协商)
+const size_t VARIANT_KEY_MAX = 256;
+
+// 协商结果的缓存键："路径 编码集合"(空格不会出现在请求路径中)，写入out，路径过长时返回空
+std::string_view VariantKey(char* out, std::string_view path, uint32_t accepted) {
+    if (path.size() + 2 > VARIANT_KEY_MAX) return std::string_view();
+    memcpy(out, path.data(), path.size());
+    out[path.size()] = ' ';
+    out[path.size() + 1] = static_cast<char>('0' + accepted);
+    return std::string_view(out, path.size() + 2);
+}
+
+// 十六进制数字的值，不是十六进制数字时返回-1
+int HexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// 以'/'结尾的路径(目录)指向的文件
+const std::string_view INDEX_FILE = "index.html";
+
+// 请求目标转换为规范的路径，写入out(容量capacity，不分配内存)：去掉查询串，解码百分号编码
+// (解码后检查，编码的分隔符同样处理)，连续的'/'合并为一个，以'/'结尾时指向目录下的index.html；
+// 不以'/'开头、含有"."或".."段、含有'\'或NUL、编码格式错误或超出容量时返回false
+bool NormalizeTarget(std::string_view target, char* out, size_t capacity, std::string_view& path) {
+    target = target.substr(0, target.find_first_of("?#"));
+    if (target.empty() || target[0] != '/') return false;
+    size_t length = 0;   // 已写入的长度
+    size_t segment = 0;  // 当前段在out中的起点
+    for (size_t i = 0; i <= target.size(); ++i) {
+        bool end = i == target.size();
+        char c = '/';  // 末尾按分隔符处理，以检查最后一段
+        if (!end) {
+            c = target[i];
+            if (c == '%') {
+                int high = i + 2 < target.size() ? HexValue(target[i + 1]) : -1;
+                int low = high >= 0 ? HexValue(target[i + 2]) : -1;
+                if (low < 0) return false;
+                c = static_cast<char>(high * 16 + low);
+                i += 2;
+            }
+            if (c == '\\' || c == '\0') return false;
+        }
+        if (c == '/') {
+            std::string_view last(out + segment, length - segment);
+            if (last == "." || last == "..") return false;
+            if (end || (length > 0 && out[length - 1] == '/')) continue;
+        }
+        if (length == capacity) return false;
+        out[length++] = c;
+        if (c == '/') segment = length;
+    }
+    if (out[length - 1] == '/') {
+        if (capacity - length < INDEX_FILE.size()) return false;
+        memcpy(out + length, INDEX_FILE.data(), INDEX_FILE.size());
+        length += INDEX_FILE.size();
+    }
+    path = std::string_view(out, length);
+    return true;
+}
+
+// path是否在root之下(两者都已规范化，逐段比较，"/www2"不算在"/www"之下)
+bool WithinRoot(const fs::path& root, const fs::path& path) {
+    return std::mismatch(root.begin(), root.end(), path.begin(), path.end()).first == root.end();
+}
+
+// 请求头是否已经结束：在data[from-2, length)中查找空行("\n\n"或"\n\r\n"，可能跨越上次查找的边界)
+bool HeaderEnded(const char* data, size_t length, size_t from) {
+    size_t i = from > 2 ? from - 2 : 0;
+    while (const void* found = memchr(data + i, '\n', length - i)) {
+        i = static_cast<size_t>(static_cast<const char*>(found) - data) + 1;
+        if (i < length && data[i] == '\n') return true;
+        if (i + 1 < length && data[i] == '\r' && data[i + 1] == '\n') return true;
+    }
+    return false;
+}
+
+// 逗号分隔的列表(如Connection头)中是否含有token(不区分大小写)
+bool HasToken(std::string_view list, std::string_view token) {
+    while (!list.empty()) {
+        size_t comma = list.find(',');
+        std::string_view item = list.substr(0, comma);
+        list = comma == std::string_view::npos ? std::string_view() : list.substr(comma + 1);
+        while (!item.empty() && (item.front() == ' ' || item.front() == '\t')) item.remove_prefix(1);
+        while (!item.empty() && (item.back() == ' ' || item.back() == '\t')) item.remove_suffix(1);
+        if (item.size() == token.size() &&
+            std::equal(item.begin(), item.end(), token.begin(), [](char a, char b) {
+                return (a >= 'A' && a <= 'Z' ? a + ('a' - 'A') : a) == b;
+            })) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 请求是否保持连接：Connection头含close时关闭；HTTP/1.1默认保持，HTTP/1.0需要显式的keep-alive
+bool WantsKeepAlive(const HttpRequest& request) {
+    std::string_view connection = request.header(KnownHeader::CONNECTION);
+    if (HasToken(connection, "close")) return false;
+    return request.version == "HTTP/1.1" || HasToken(connection, "keep-alive");
+}
+
+// chunked编码的一块("十六进制大小\r\n数据\r\n")，追加到out
+void AppendChunk(std::string& out, std::string_view data) {
+    char size[16];
+    auto result = std::to_chars(size, size + sizeof(size), data.size(), 16);
+    out.append(size, result.ptr).append("\r\n").append(data).append("\r\n");
+}
+
+// Content-Range的值("bytes 首-末/大小")，写入out(至少64字节)
+std::string_view FormatContentRange(char* out, const ByteRange& range, uint64_t size) {
+    char* p = out;
+    memcpy(p, "bytes ", 6);
+    p += 6;
+    p = std::to_chars(p, out + 64, range.offset).ptr;
+    *p++ = '-';
+    p = std::to_chars(p, out + 64, range.offset + range.length - 1).ptr;
+    *p++ = '/';
+    p = std::to_chars(p, out + 64, size).ptr;
+    return std::string_view(out, static_cast<size_t>(p - out));
+}
+
+// 根据文件头识别图片格式
+std::string_view ImageFormat(std::string_view data) {
+    if (data.compare(0, 8, "\x89PNG\r\n\x1a\n") == 0) return "png";
+    if (data.compare(0, 3, "\xff\xd8\xff") == 0) return "jpeg";
+    if (data.compare(0, 4, "GIF8") == 0) return "gif";
+    if (data.size() >= 12 && data.compare(0, 4, "RIFF") == 0 && data.compare(8, 4, "WEBP") == 0) return "webp";
+    return "unknown";
+}
+}
+
+// 构造函数
+WebServer::WebServer() :
+    running_(false),
+    port_(DEFAULT_PORT),
+    idleTimeout_(DEFAULT_IDLE_TIMEOUT),
+    headerTimeout_(DEFAULT_HEADER_TIMEOUT),
+    bodyTimeout_(DEFAULT_BODY_TIMEOUT),
+    shedQueueDelay_(DEFAULT_SHED_QUEUE_DELAY),
+    shedServiceTime_(DEFAULT_SHED_SERVICE_TIME) {
+    router_.AddPrefix(HttpMethod::UNKNOWN, "/", &WebServer::HandleStatic);
+}
+
+// 内置端点：路径集合在编译期已知，构建完美哈希表，分派只需一次哈希和一次比较
+constinit const StaticMap<WebServer::BuiltinRoute, 2> WebServer::BUILTIN_ROUTES = MakeStaticMap<BuiltinRoute>({
+    {"/upload", {HttpMethod::POST, &WebServer::HandleUpload}},
+    {"/metrics", {HttpMethod::UNKNOWN, &WebServer::HandleMetrics}},
+});
+
+// 析构函数
+WebServer::~WebServer() { Stop(); }
+
+// 初始化服务器
+bool WebServer::Initialize(const ServerConfig& config) {
+    port_ = config.port;
+    documentRoot_ = config.documentRoot;
+    idleTimeout_ = config.idleTimeout;
+    headerTimeout_ = config.headerTimeout;
+    bodyTimeout_ = config.bodyTimeout;
+    maxRequestBody_ = config.maxRequestBody;
+    shedQueueDelay_ = config.shedQueueDelay;
+    shedServiceTime_ = config.shedServiceTime;
+    if (config.cacheCapacity > 0) {
+        cache_ = std::make_unique<AssetCache>(config.cacheCapacity, config.cacheMaxFileSize);
+    }
+
+    // 创建I/O引擎
+    std::string name = config.engine.empty() ? DefaultIoEngineName() : config.engine;
+    engine_ = CreateIoEngine(name);
+    if (!engine_) {
+        std::cerr << "Unsupported I/O engine: " << name << std::endl;
+        return false;
+    }
+
+    // 创建文档根目录
+    if (!fs::exists(documentRoot_)) {
+        if (!fs::create_directory(documentRoot_)) {
+            std::cerr << "Failed to create document root directory" << std::endl;
+            return false;
+        }
+    }
+    std::error_code ec;
+    rootPath_ = fs::canonical(documentRoot_, ec);
+    if (ec) {
+        std::cerr << "Failed to resolve document root: " << ec.message() << std::endl;
+        return false;
+    }
+
+    // 创建监听套接字和I/O线程资源
+    IoEngineOptions options;
+    options.port = config.port;
+    options.threadCount = config.threads > 0 ? config.threads : GetDefaultThreadCount();
+    options.reusePort = config.reusePort;
+    options.lazyRecv = config.lazyRecv;
+    options.maxConnections = config.maxConnections;
+    if (!engine_->Initialize(options, this)) {
+        engine_.reset();
+        return false;
+    }
+
+    // 计算线程池(默认每个CPU核心一个线程；I/O线程只负责收发)
+    if (config.computeThreads >= 0) {
+        size_t threads = config.computeThreads > 0 ? static_cast<size_t>(config.computeThreads)
+                                                   : std::max(1u, std::thread::hardware_concurrency());
+        pool_ = std::make_unique<TaskPool>(threads);
+    }
+
+    // 每个事件循环一个分片(定时器由事件循环自己驱动)
+    for (size_t i = 0; i < engine_->LoopCount(); ++i) {
+        shards_.push_back(std::make_unique<Shard>(shedQueueDelay_, shedServiceTime_));
+        shards_[i]->lagProbe.callback = [this, i]() {
+            Shard& shard = *shards_[i];
+            auto now = std::chrono::steady_clock::now();
+            if (now < shard.lagProbeDue) {
+                // 停顿之后定时器轮逐个追赶落下的tick，期间重新调度的采样会提前执行：顺延到预定时刻
+                auto remaining = std::chrono::ceil<std::chrono::milliseconds>(shard.lagProbeDue - now);
+                engine_->Timers(i).Schedule(shard.lagProbe, remaining);
+                return;
+            }
+            bool was = shard.overload.Overloaded();
+            shard.overload.RecordQueueDelay(now - shard.lagProbeDue - LAG_PROBE_SLACK);
+            shard.CountOverload(was);
+            // 空闲且未过载时停止采样，空闲的事件循环不会被定时唤醒
+            if (shard.active || shard.overload.Overloaded()) ScheduleLagProbe(i);
+        };
+    }
+
+    // 过载时的503响应：与缓存的响应一样预先序列化(发送时插入Date头)，拒绝请求只增加引用计数
+    char header[RESPONSE_HEADER_BUFFER];
+    ResponseWriter writer(header, sizeof(header));
+    writer.StatusLine(503);
+    writer.ContentType("text/plain");
+    writer.ContentLength(OVERLOAD_BODY.size());
+    writer.Header("Retry-After", "1");
+    writer.KeepAlive();
+    writer.End();
+    overloadResponse_ = std::make_shared<const std::string>(std::string(writer.View()).append(OVERLOAD_BODY));
+
+    running_ = true;
+    engine_->Start();  // 开始接受连接
+
+    std::cout << "Server initialized successfully. Listening on port " << config.port << std::endl;
+    return true;
+}
+
+// 处理接受连接
+void WebServer::OnAccept(size_t loop, SOCKET clientSocket) {
+    Shard& shard = *shards_[loop];
+    ClientContext& client = *shard.contexts.Acquire();
+    shard.clients.Insert(clientSocket) = &client;
+    client.socket = clientSocket;
+    client.loop = static_cast<uint32_t>(loop);
+    shard.metrics.accepts.Add();
+
+    // 设置超时定时器(只捕获两个指针，std::function不分配内存)
+    client.timeout.callback = [this, &client]() {
+        shards_[client.loop]->metrics.timeouts.Add();
+        engine_->Close(client.socket);
+    };
+    engine_->Timers(loop).Schedule(client.timeout, idleTimeout_);
+}
+
+// 处理接收数据
+void WebServer::OnRecv(size_t loop, SOCKET clientSocket, const char* data, size_t length) {
+    Shard& shard = *shards_[loop];
+    ClientContext* client = shard.FindClient(clientSocket);
+    if (!client) return;
+    shard.metrics.bytesIn.Add(length);
+    shard.active = true;
+    if (shedQueueDelay_.count() > 0 && !shard.lagProbe.Linked()) ScheduleLagProbe(loop);
+    ConsumeInput(loop, clientSocket, *client, data, length);
+}
+
+// 安排下一次事件循环延迟采样：定时器实际执行比预定时刻晚多少，事件循环就落后了多少
+void WebServer::ScheduleLagProbe(size_t loop) {
+    Shard& shard = *shards_[loop];
+    shard.active = false;
+    shard.lagProbeDue = std::chrono::steady_clock::now() + LAG_PROBE_INTERVAL;
+    engine_->Timers(loop).Schedule(shard.lagProbe, LAG_PROBE_INTERVAL);
+}
+
+// 解析并处理请求：新数据接在未完成的请求之后(length可以为0，用于继续处理积压的请求)
+void WebServer::ConsumeInput(size_t loop, SOCKET clientSocket, ClientContext& client,
+                             const char* data, size_t length) {
+    if (client.closing) return;  // 已回复错误响应，剩余数据不再处理
+    Shard& shard = *shards_[loop];
+    if (!client.parser) client.parser = shard.parsers.Acquire();
+    client.backlogged = false;
+
+    // 没有未完成的请求时直接在引擎的接收缓冲区上解析，只有不完整的尾部才复制
+    bool inPlace = client.partial_request.empty();
+    if (!inPlace) client.partial_request.append(data, length);
+    const char* buffer = inPlace ? data : client.partial_request.data();
+    size_t size = inPlace ? length : client.partial_request.size();
+
+    // 解析器从上次停止处继续，只扫描新到达的字节
+    size_t consumed = 0;
+    size_t headerBytes = 0;  // 未读完的请求头的长度
+    while (consumed < size) {
+        // 前一个请求还在计算线程池中：剩余的流水线请求留到它的响应发出后再处理
+        if (client.busy) break;
+        // 发送队列超过高水位(客户端不读取响应)：剩余的流水线请求留到发送回落后再处理
+        if (engine_->Backpressured(clientSocket)) {
+            client.backlogged = true;
+            break;
+        }
+        // 请求头上次未读完时解析器已归还：先只在新到达的字节中查找请求头结尾的空行，找到后才从头解析，
+        // 缓慢到达的请求头每个字节只查找常数次，不会每次接收都重新解析整个请求头
+        ParseStatus status = ParseStatus::INCOMPLETE;
+        if (client.headerScanned == 0 || HeaderEnded(buffer, size, client.headerScanned)) {
+            status = client.parser->parse(buffer + consumed, size - consumed);
+        }
+        client.headerScanned = 0;
+
+        // 格式错误、不支持的Transfer-Encoding、请求头或请求体超过上限：回复错误后关闭连接(请求的边界已不可信)
+        int rejected = 0;
+        if (status == ParseStatus::FAILED) {
+            shard.metrics.parseFailures.Add();
+            rejected = 400;
+        } else if (status == ParseStatus::UNSUPPORTED) {
+            rejected = 501;
+        } else if ((status == ParseStatus::SUCCESS || client.parser->InBody()) &&
+                   client.parser->contentLength() > maxRequestBody_) {
+            rejected = 413;
+        } else if (status == ParseStatus::INCOMPLETE && !client.parser->InBody()) {
+            headerBytes = size - consumed;
+            if (headerBytes > MAX_REQUEST_HEADER) rejected = 431;
+        }
+        if (rejected) {
+            RejectRequest(loop, clientSocket, client, rejected);
+            client.parser->reset();
+            consumed = size;
+            break;
+        }
+        if (status == ParseStatus::INCOMPLETE) break;
+
+        // 处理请求后跳过已消费的字节，剩余部分是下一个请求的开头
+        auto start = std::chrono::steady_clock::now();
+        bool keepAlive = WantsKeepAlive(client.parser->request());
+        int statusCode = ProcessHttpRequest(loop, clientSocket, client.parser->request(), shard.overload.Overloaded());
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        if (statusCode != 0) shard.metrics.RecordRequest(statusCode, elapsed);
+        bool wasOverloaded = shard.overload.Overloaded();
+        shard.overload.RecordServiceTime(elapsed);
+        shard.CountOverload(wasOverloaded);
+        consumed += client.parser->consumed();
+        client.parser->reset();
+
+        // 客户端要求关闭(Connection: close，或HTTP/1.0没有keep-alive)：响应发出后关闭，丢弃之后的流水线数据；
+        // 交给计算线程池的请求由CompleteOffload在回复后关闭
+        if (!keepAlive) {
+            if (statusCode != 0) {
+                engine_->CloseAfterSend(clientSocket);
+                client.closing = true;
+            } else {
+                client.closeAfterResponse = true;
+            }
+            consumed = size;
+            break;
+        }
+    }
+
+    if (consumed < size) {
+        // 保留未完成请求(解析器的偏移相对于请求开头，两种情况下保持一致)
+        if (inPlace) {
+            client.partial_request.assign(data + consumed, size - consumed);
+        } else {
+            client.partial_request.erase(0, consumed);
+        }
+        // 请求头未读完时也归还解析器，只记下已查找过的长度，下次只在新数据中查找空行；
+        // 只有正在接收请求体的连接才一直持有解析器
+        if (!client.parser->InBody()) {
+            client.parser->reset();
+            shard.ReleaseParser(client);
+            client.headerScanned = static_cast<uint32_t>(headerBytes);
+        }
+    } else {
+        // 请求全部处理完：释放缓冲区并归还解析器，空闲连接不占用它们
+        std::string().swap(client.partial_request);
+        shard.ReleaseParser(client);
+    }
+
+    RefreshTimeout(loop, client);
+}
+
+// 拒绝请求：回复错误响应，发送完后关闭连接(剩余的流水线请求不再处理)
+void WebServer::RejectRequest(size_t loop, SOCKET clientSocket, ClientContext& client, int statusCode) {
+    std::string_view body = statusCode == 413 ? "Payload Too Large" :
+                            statusCode == 431 ? "Request Header Fields Too Large" :
+                            statusCode == 501 ? "Not Implemented" : "Bad Request";
+    char buffer[RESPONSE_HEADER_BUFFER];
+    ResponseWriter writer(buffer, sizeof(buffer));
+    writer.StatusLine(statusCode);
+    writer.Date();
+    writer.ContentType("text/plain");
+    writer.ContentLength(body.size());
+    writer.Header("Connection", "close");
+    writer.End();
+    engine_->Send(clientSocket, std::string(writer.View()).append(body));
+    engine_->CloseAfterSend(clientSocket);
+    client.closing = true;
+    shards_[loop]->metrics.RecordRequest(statusCode, std::chrono::nanoseconds(0));
+}
+
+// 把解析器归还到池(解析器已处于重置状态)
+void WebServer::Shard::ReleaseParser(ClientContext& client) {
+    if (!client.parser) return;
+    parsers.Release(client.parser);
+    client.parser = nullptr;
+}
+
+// 统计过载状态的切换(当前过载的事件循环数 = overloads - recoveries)
+void WebServer::Shard::CountOverload(bool wasOverloaded) {
+    bool overloaded = overload.Overloaded();
+    if (overloaded && !wasOverloaded) metrics.overloads.Add();
+    if (!overloaded && wasOverloaded) metrics.recoveries.Add();
+}
+
+// 按阶段刷新超时：空闲与请求体超时在每次活动时延后(惰性，不移动定时器)，
+// 请求头超时从请求的第一个字节开始计算，期间不再延后；
+// 背压期间等待的是发送进展，计算线程池处理期间等待的是服务器自己，都与发送响应一样使用空闲超时
+void WebServer::RefreshTimeout(size_t loop, ClientContext& client) {
+    TimerWheel& timers = engine_->Timers(loop);
+    if (client.partial_request.empty() || client.backlogged || client.busy) {
+        client.phase = ClientPhase::IDLE;
+        timers.Touch(client.timeout, idleTimeout_);
+    } else if (client.parser && client.parser->InBody()) {
+        client.phase = ClientPhase::BODY;
+        timers.Touch(client.timeout, bodyTimeout_);
+    } else if (client.phase != ClientPhase::HEADER) {
+        client.phase = ClientPhase::HEADER;
+        timers.Touch(client.timeout, headerTimeout_);
+    }
+}
+
+// 处理发送完成
+void WebServer::OnSend(size_t loop, SOCKET clientSocket, size_t bytesSent) {
+    // 发送响应(如大文件下载)期间有进展就延后空闲超时
+    Shard& shard = *shards_[loop];
+    shard.metrics.bytesOut.Add(bytesSent);
+    ClientContext* found = shard.FindClient(clientSocket);
+    if (!found) return;
+    ClientContext& client = *found;
+
+    // 发送队列已回落到低水位以下：继续因背压暂停的流式压缩，或处理背压期间积压的流水线请求
+    if (client.stream && !engine_->Backpressured(clientSocket)) {
+        pool_->Submit([this, stream = std::move(client.stream)]() { CompressNext(stream); });
+    }
+    if (client.backlogged && !client.busy && !engine_->Backpressured(clientSocket)) {
+        ConsumeInput(loop, clientSocket, client, nullptr, 0);
+        return;
+    }
+    if (client.phase == ClientPhase::IDLE) {
+        engine_->Timers(loop).Touch(client.timeout, idleTimeout_);
+    }
+}
+
+// 处理连接关闭
+void WebServer::OnClose(size_t loop, SOCKET socket) {
+    Shard& shard = *shards_[loop];
+    ClientContext* client = shard.FindClient(socket);
+    if (!client) return;
+
+    // 取消定时器，移除客户端，把解析器与上下文归还到池
+    engine_->Timers(loop).Cancel(client->timeout);
+    shard.clients.Erase(socket);
+    shard.metrics.closes.Add();
+    if (client->parser) {
+        client->parser->reset();
+        shard.ReleaseParser(*client);
+    }
+    std::string().swap(client->partial_request);
+    client->phase = ClientPhase::IDLE;
+    client->backlogged = false;
+    client->busy = false;
+    client->closing = false;
+    client->closeAfterResponse = false;
+    client->headerScanned = 0;
+    client->stream.reset();
+    shard.contexts.Release(client);
+}
+
+// 处理HTTP请求：先查内置端点，方法不符或不是内置端点时按路由表分派
+int WebServer::ProcessHttpRequest(size_t loop, SOCKET clientSocket, const HttpRequest& request, bool overloaded) {
+    // 匹配之前规范化(写入栈上的缓冲区，不分配内存)：内置端点、路由与静态文件处理器只看到
+    // 解码后没有空段与"."、".."段的路径
+    char buffer[MAX_REQUEST_HEADER];
+    std::string_view path;
+    if (!NormalizeTarget(request.uri, buffer, sizeof(buffer), path)) {
+        engine_->Send(clientSocket, BuildHttpResponse("Invalid path", "text/plain", 400, true, WantsKeepAlive(request)));
+        return 400;
+    }
+
+    // 过载时以预先构建的503快速拒绝；/metrics按规范化后的路径认出(带查询串或编码时同样)，照常响应，便于观察过载状态
+    const BuiltinRoute* builtin = BUILTIN_ROUTES.Find(path);
+    if (overloaded && !(builtin && builtin->handler == &WebServer::HandleMetrics)) {
+        SendCachedResponse(clientSocket, overloadResponse_, WantsKeepAlive(request));
+        shards_[loop]->metrics.shed.Add();
+        return 503;
+    }
+    if (builtin && (builtin->method == HttpMethod::UNKNOWN || builtin->method == request.method)) {
+        return (this->*builtin->handler)(loop, clientSocket, request, path);
+    }
+    if (const RouteHandler* handler = router_.Match(request.method, path)) {
+        return (this->*(*handler))(loop, clientSocket, request, path);
+    }
+    engine_->Send(clientSocket, BuildHttpResponse("File not found", "text/plain", 404, true, WantsKeepAlive(request)));
+    return 404;
+}
+
+// 图片上传：CPU密集的处理交给计算线程池，I/O线程继续服务其他连接
+int WebServer::HandleUpload(size_t loop, SOCKET clientSocket, const HttpRequest& request, std::string_view) {
+    if (!pool_) {
+        engine_->Send(clientSocket, ProcessImageUpload(request.body, WantsKeepAlive(request)));
+        return 200;
+    }
+    OffloadUpload(loop, clientSocket, request.body, WantsKeepAlive(request));
+    return 0;
+}
+
+// 内置的指标端点(汇总时只读取各分片的计数器，不加锁)；
+// 内容每次都不同，客户端接受gzip时在I/O线程上直接压缩(指标文本只有几KB，以最快的级别压缩)
+int WebServer::HandleMetrics(size_t loop, SOCKET clientSocket, const HttpRequest& request, std::string_view) {
+    const std::string_view contentType = "text/plain; version=0.0.4";
+    std::string body = RenderMetrics();
+    bool keepAlive = WantsKeepAlive(request);
+    if (body.size() < MIN_COMPRESS_SIZE ||
+        !(AcceptedCodings(request.header(KnownHeader::ACCEPT_ENCODING)) & CODING_GZIP)) {
+        engine_->Send(clientSocket, BuildHttpResponse(body, contentType, 200, true, keepAlive));
+        return 200;
+    }
+    std::string compressed = GzipEncoder::Compress(body, 1);
+    CountCompression(body.size(), compressed.size());
+    char buffer[RESPONSE_HEADER_BUFFER];
+    ResponseWriter writer(buffer, sizeof(buffer));
+    writer.StatusLine(200);
+    writer.Date();
+    writer.ContentType(contentType);
+    writer.ContentLength(compressed.size());
+    writer.Header("Content-Encoding", CodingName(CODING_GZIP));
+    writer.Header("Vary", "Accept-Encoding");
+    writer.Connection(keepAlive);
+    writer.End();
+    compressed.insert(0, writer.View());
+    engine_->Send(clientSocket, std::move(compressed));
+    shards_[loop]->metrics.encoded.Add();
+    return 200;
+}
+
+// 静态文件
+int WebServer::HandleStatic(size_t loop, SOCKET clientSocket, const HttpRequest& request, std::string_view path) {
+    bool keepAlive = WantsKeepAlive(request);
+    // path已在分派前规范化；之后的缓存键、文件路径与预压缩文件都由它构建
+
+    // 内容协商只对可压缩的类型；Range请求按原始内容回复(范围总是针对原始字节)
+    std::string_view contentType = MimeType(path);
+    uint32_t accepted = 0;
+    if (request.header(KnownHeader::RANGE).empty() && CompressibleType(contentType)) {
+        accepted = AcceptedCodings(request.header(KnownHeader::ACCEPT_ENCODING));
+    }
+    // 接受压缩的请求按"路径 编码集合"缓存协商的结果(预压缩文件、压缩一次的内容或原始内容)，
+    // 命中时与原始内容一样只需一次查找，不再检查预压缩文件
+    char keyBuffer[VARIANT_KEY_MAX];
+    std::string_view key = accepted ? VariantKey(keyBuffer, path, accepted) : path;
+    if (key.empty()) {
+        accepted = 0;
+        key = path;
+    }
+
+    // 缓存命中：没有条件头与Range头时一次查找加一次发送
+    if (cache_) {
+        Shard& shard = *shards_[loop];
+        AssetCache::FileInfo info;
+        if (auto response = cache_->Find(shard.cacheReader, key, &info)) {
+            shard.metrics.cacheHits.Add();
+            if (!request.header(KnownHeader::IF_NONE_MATCH).empty() ||
+                !request.header(KnownHeader::IF_MODIFIED_SINCE).empty() ||
+                !request.header(KnownHeader::RANGE).empty()) {
+                FileBody body{response, INVALID_FILE, info.size};
+                int status = SendConditional(clientSocket, request,
+                                             MakeValidators(info.size, info.mtime, CodingName(info.coding)),
+                                             contentType, body);
+                if (status != 0) return status;
+            }
+            if (info.coding) shard.metrics.encoded.Add();
+            SendCachedResponse(clientSocket, response, keepAlive);  // 共享缓存的响应，不复制
+            return 200;
+        }
+        shard.metrics.cacheMisses.Add();
+    }
+
+    // 构建文件路径：规范化(解析符号链接)后必须仍在文档根目录之下
+    fs::path filePath;
+    if (!ResolveFile(path, filePath)) {
+        std::string response = BuildHttpResponse("Forbidden", "text/plain", 403, true, keepAlive);
+        engine_->Send(clientSocket, std::move(response));
+        return 403;
+    }
+
+    // 修改时间在读取内容之前获取，读取期间文件被修改时下次校验会发现
+    std::error_code ec;
+    auto mtime = fs::last_write_time(filePath, ec);
+
+    // 打开文件(不存在或不是普通文件时返回404)
+    uint64_t fileSize = 0;
+    FileHandle file = OpenFileForRead(filePath.string(), fileSize);
+    if (file == INVALID_FILE) {
+        std::string response = BuildHttpResponse("File not found", "text/plain", 404, true, keepAlive);
+        engine_->Send(clientSocket, std::move(response));
+        return 404;
+    }
+
+    // 压缩的表示：预压缩的文件(服务器偏好br，其次gzip)，没有时由服务器gzip压缩
+    if (accepted && !ec) {
+        for (uint32_t coding : {CODING_BR, CODING_GZIP}) {
+            if (!(accepted & coding)) continue;
+            int status = SendPrecompressed(loop, clientSocket, request, key, filePath, mtime, coding, contentType);
+            if (status >= 0) {
+                CloseFile(file);
+                return status;
+            }
+        }
+        if ((accepted & CODING_GZIP) && fileSize >= MIN_COMPRESS_SIZE) {
+            int status = SendCompressed(loop, clientSocket, request, key, filePath, file, fileSize, mtime, contentType);
+            if (status >= 0) return status;
+        }
+    }
+
+    // 条件请求与范围请求在读取内容之前处理(304不需要文件内容，206只发送请求的部分)
+    Validators validators = MakeValidators(fileSize, mtime);
+    FileBody body{nullptr, file, fileSize};
+    if (int status = SendConditional(clientSocket, request, validators, contentType, body)) {
+        return status;
+    }
+
+    // 小文件读入内存，序列化为完整响应(不含Date头，发送时插入)后放入缓存；
+    // 协商的结果是原始内容时同一份响应也挂在协商的键上
+    if (cache_ && !ec && cache_->Cacheable(fileSize)) {
+        std::string response = BuildFileHeader(fileSize, contentType, validators, 200, false);
+        if (ReadFileContent(file, fileSize, response)) {
+            CloseFile(file);
+            auto cached = cache_->Insert(path, filePath.string(), std::move(response), fileSize, mtime);
+            if (key != path) cache_->Insert(key, filePath.string(), cached, fileSize, mtime);
+            SendCachedResponse(clientSocket, cached, keepAlive);
+            return 200;
+        }
+    }
+
+    // 响应头从内存发送，文件内容由引擎零拷贝发送(内存占用与文件大小无关)
+    engine_->Send(clientSocket, BuildFileHeader(fileSize, contentType, validators, 200, true, {}, {}, keepAlive));
+    engine_->SendFile(clientSocket, file, 0, fileSize);
+    return 200;
+}
+
+// 请求路径(已解码并检查)对应的文件：规范化后不在文档根目录之下时返回false
+bool WebServer::ResolveFile(std::string_view path, fs::path& filePath) const {
+    std::error_code ec;
+    filePath = fs::weakly_canonical(rootPath_ / fs::path(path.substr(1)), ec);
+    return !ec && WithinRoot(rootPath_, filePath);
+}
+
+// 预压缩的文件("原文件.br"/"原文件.gz")：比原文件旧(原文件修改后未重新生成)时忽略，返回-1
+// (按秒比较：压缩工具复制原文件的修改时间时可能丢掉秒以下的部分)，不在文档根目录之下时同样忽略；
+// 有自己的ETag(大小与修改时间取自预压缩文件)，小文件以协商的键缓存，大文件零拷贝发送
+int WebServer::SendPrecompressed(size_t loop, SOCKET clientSocket, const HttpRequest& request, std::string_view key,
+                                 const fs::path& filePath, fs::file_time_type mtime, uint32_t coding,
+                                 std::string_view contentType) {
+    std::string_view name = CodingName(coding);
+    // filePath已通过文档根目录检查，预压缩文件可能是指向外部的符号链接，规范化后再检查一次
+    fs::path encodedPath = filePath;
+    encodedPath += CodingExtension(coding);
+    std::error_code ec;
+    encodedPath = fs::weakly_canonical(encodedPath, ec);
+    if (ec || !WithinRoot(rootPath_, encodedPath)) return -1;
+    auto encodedTime = fs::last_write_time(encodedPath, ec);
+    if (ec || std::chrono::floor<std::chrono::seconds>(encodedTime) <
+                  std::chrono::floor<std::chrono::seconds>(mtime)) {
+        return -1;
+    }
+    uint64_t size = 0;
+    FileHandle file = OpenFileForRead(encodedPath.string(), size);
+    if (file == INVALID_FILE) return -1;
+
+    Validators validators = MakeValidators(size, encodedTime, name);
+    FileBody body{nullptr, file, size};
+    if (int status = SendConditional(clientSocket, request, validators, contentType, body)) {
+        return status;
+    }
+    shards_[loop]->metrics.encoded.Add();
+    if (cache_ && cache_->Cacheable(size)) {
+        std::string response = BuildFileHeader(size, contentType, validators, 200, false, {}, name);
+        if (ReadFileContent(file, size, response)) {
+            CloseFile(file);
+            // 同时校验原文件：原文件更新后(即使预压缩文件没有重新生成)该项失效，下一次请求重新比较两者的mtime
+            SendCachedResponse(clientSocket,
+                               cache_->Insert(key, encodedPath.string(), std::move(response), size, encodedTime,
+                                              coding, {filePath.string(), mtime}),
+                               WantsKeepAlive(request));
+            return 200;
+        }
+    }
+    engine_->Send(clientSocket, BuildFileHeader(size, contentType, validators, 200, true, {}, name,
+                                                WantsKeepAlive(request)));
+    engine_->SendFile(clientSocket, file, 0, size);
+    return 200;
+}
+
+// 服务器gzip压缩：可缓存的文件只压缩一次(计算线程池上读取并压缩，同一事件循环上并发的未命中等待同一次压缩)，
+// 结果以协商的键缓存，之后的请求直接命中；
+// 不能缓存的文件在计算线程池上流式压缩；没有计算线程池或不是HTTP/1.1请求时大文件按原始内容发送，返回-1
+int WebServer::SendCompressed(size_t loop, SOCKET clientSocket, const HttpRequest& request, std::string_view key,
+                              const fs::path& filePath, FileHandle file, uint64_t fileSize,
+                              fs::file_time_type mtime, std::string_view contentType) {
+    // 流式压缩使用chunked编码，HTTP/1.0客户端无法读取，与没有计算线程池时一样按原始内容零拷贝发送
+    bool cacheable = cache_ && cache_->Cacheable(fileSize);
+    if (!cacheable && (!pool_ || fileSize > MAX_STREAM_COMPRESS_SIZE || request.version != "HTTP/1.1")) return -1;
+
+    // 压缩的表示的ETag由原文件导出，304不需要压缩
+    Validators validators = MakeValidators(fileSize, mtime, CodingName(CODING_GZIP));
+    FileBody body{nullptr, file, fileSize};
+    if (int status = SendConditional(clientSocket, request, validators, contentType, body)) {
+        return status;
+    }
+    bool keepAlive = WantsKeepAlive(request);
+    if (!cacheable) {
+        StreamCompressed(loop, clientSocket, file, fileSize, validators, contentType, keepAlive);
+        return 0;
+    }
+
+    // 没有计算线程池：在I/O线程上读取并压缩
+    if (!pool_) {
+        std::string content;
+        if (!ReadFileContent(file, fileSize, content)) return -1;
+        CloseFile(file);
+        uint32_t coding = 0;
+        auto cached = CompressOnce(std::string(key), filePath.string(), std::move(content), mtime, contentType, coding);
+        if (coding) shards_[loop]->metrics.encoded.Add();
+        SendCachedResponse(clientSocket, cached, keepAlive);
+        return 200;
+    }
+
+    // 本事件循环上同一键已在压缩(并发的未命中)：排在第一个请求后面，压缩完成时一起回复，
+    // 不读取文件也不重复压缩(查找不加锁、不分配内存)
+    Shard& shard = *shards_[loop];
+    auto start = std::chrono::steady_clock::now();
+    auto it = shard.compressing.find(key);
+    if (it != shard.compressing.end()) {
+        CloseFile(file);
+        it->second.push_back({BeginOffload(loop, clientSocket), start, keepAlive});
+        return 0;
+    }
+    shard.compressing.try_emplace(std::string(key)).first->second.push_back(
+        {BeginOffload(loop, clientSocket), start, keepAlive});  // 第一个请求同样等待结果
+
+    // 读取与压缩都在计算线程上进行
+    shard.metrics.offloaded.Add();
+    pool_->Submit([this, loop, contentType, key = std::string(key), path = filePath.string(),
+                   file, fileSize, mtime]() mutable {
+        std::string content;
+        bool read = ReadFileContent(file, fileSize, content);
+        CloseFile(file);
+        uint32_t coding = 0;
+        AssetCache::Response cached;
+        if (read) cached = CompressOnce(key, path, std::move(content), mtime, contentType, coding);
+        engine_->Post(loop, [this, loop, key = std::move(key), cached = std::move(cached), coding]() {
+            FinishCompressing(loop, key, cached, coding);
+        });
+    });
+    return 0;
+}
+
+// 压缩完成(在所属事件循环上)：从正在压缩的键中移除，把结果发给每个等待的请求；读取文件失败时回复500
+void WebServer::FinishCompressing(size_t loop, const std::string& key, const AssetCache::Response& cached,
+                                  uint32_t coding) {
+    Shard& shard = *shards_[loop];
+    auto it = shard.compressing.find(key);
+    std::vector<CompressWaiter> waiters = std::move(it->second);
+    shard.compressing.erase(it);
+    for (const CompressWaiter& waiter : waiters) {
+        CompleteOffload(loop, waiter.handle, waiter.start, [&](SOCKET socket) {
+            if (!cached) {
+                engine_->Send(socket, BuildHttpResponse("Internal Server Error", "text/plain", 500, true,
+                                                        waiter.keepAlive));
+                return 500;
+            }
+            if (coding) shard.metrics.encoded.Add();
+            SendCachedResponse(socket, cached, waiter.keepAlive);
+            return 200;
+        });
+    }
+}
+
+// 压缩一次并放入缓存：缓存项的元数据是原文件的(校验时检查原文件，filePath已通过文档根目录检查)，
+// coding为实际缓存的编码
+AssetCache::Response WebServer::CompressOnce(const std::string& key, const std::string& filePath,
+                                             std::string content, fs::file_time_type mtime,
+                                             std::string_view contentType, uint32_t& coding) {
+    uint64_t fileSize = content.size();
+    std::string compressed = GzipEncoder::Compress(content);
+    CountCompression(fileSize, compressed.size());
+    if (compressed.size() >= fileSize) {
+        coding = 0;
+        std::string response = BuildFileHeader(fileSize, contentType, MakeValidators(fileSize, mtime), 200, false);
+        response.append(content);
+        return cache_->Insert(key, filePath, std::move(response), fileSize, mtime);
+    }
+    std::string_view name = CodingName(CODING_GZIP);
+    std::string response = BuildFileHeader(compressed.size(), contentType, MakeValidators(fileSize, mtime, name),
+                                           200, false, {}, name);
+    response.append(compressed);
+    coding = CODING_GZIP;
+    return cache_->Insert(key, filePath, std::move(response), fileSize, mtime, CODING_GZIP);
+}
+
+// 流式压缩的状态：同一时刻只在一个线程上使用(计算线程压缩一段，事件循环发送)
+struct WebServer::CompressStream {
+    size_t loop = 0;
+    ConnectionHandle handle;                      // 所属连接(关闭后不再继续)
+    std::chrono::steady_clock::time_point start;  // 请求开始时刻
+    FileHandle file = INVALID_FILE;
+    uint64_t fileSize = 0;
+    uint64_t offset = 0;    // 下一段输入的偏移
+    uint64_t bytesOut = 0;  // 已输出的压缩数据
+    GzipEncoder encoder;
+    std::string input;      // 输入缓冲区(各段复用)
+
+    ~CompressStream() {
+        if (file != INVALID_FILE) CloseFile(file);
+    }
+};
+
+// 流式压缩：响应头(chunked，没有Content-Length)立即发送，文件在计算线程上逐段读取并压缩，
+// 每段压缩后作为一个chunk经IoEngine::Post交给连接所属的事件循环发送；
+// 发出一段后才压缩下一段，发送队列超过高水位时暂停，回落后由OnSend继续，
+// 因此每个连接的内存占用不超过高水位加一段，与文件大小无关；连接关闭后不再读取与压缩
+void WebServer::StreamCompressed(size_t loop, SOCKET clientSocket, FileHandle file, uint64_t fileSize,
+                                 const Validators& validators, std::string_view contentType, bool keepAlive) {
+    char buffer[RESPONSE_HEADER_BUFFER];
+    ResponseWriter writer(buffer, sizeof(buffer));
+    writer.StatusLine(200);
+    writer.Date();
+    writer.ContentType(contentType);
+    writer.Header("Transfer-Encoding", "chunked");
+    writer.Header("Content-Encoding", CodingName(CODING_GZIP));
+    writer.Header("Vary", "Accept-Encoding");
+    writer.Header("ETag", validators.ETag());
+    writer.Header("Last-Modified", validators.LastModified());
+    writer.Connection(keepAlive);
+    writer.End();
+    engine_->Send(clientSocket, std::string(writer.View()));
+    shards_[loop]->metrics.encoded.Add();
+
+    auto stream = std::make_shared<CompressStream>();
+    stream->loop = loop;
+    stream->handle = BeginOffload(loop, clientSocket);
+    stream->start = std::chrono::steady_clock::now();
+    stream->file = file;
+    stream->fileSize = fileSize;
+    shards_[loop]->metrics.offloaded.Add();
+    pool_->Submit([this, stream]() { CompressNext(stream); });
+}
+
+// 在计算线程上读取并压缩下一段，最后一段同时结束gzip流
+void WebServer::CompressNext(std::shared_ptr<CompressStream> stream) {
+    CompressStream& s = *stream;
+    uint64_t length = std::min<uint64_t>(COMPRESS_CHUNK_SIZE, s.fileSize - s.offset);
+    s.input.clear();
+    bool ok = ReadFileContent(s.file, length, s.input, s.offset);
+    bool last = false;
+    std::string output;
+    if (ok) {
+        s.offset += length;
+        last = s.offset == s.fileSize;
+        s.encoder.Write(s.input, output);
+        if (last) s.encoder.Finish(output);
+        s.bytesOut += output.size();
+        if (last) CountCompression(s.fileSize, s.bytesOut);
+    }
+    std::string chunk;
+    if (!output.empty()) AppendChunk(chunk, output);
+    if (last) chunk.append("0\r\n\r\n");
+    size_t loop = s.loop;
+    engine_->Post(loop, [this, stream = std::move(stream), chunk = std::move(chunk), ok, last]() mutable {
+        SendStreamChunk(std::move(stream), std::move(chunk), ok, last);
+    });
+}
+
+// 在事件循环上发送一段：读取失败时关闭连接(响应已经开始)，最后一段发出后结束请求；
+// 否则发送队列未超过高水位时立即压缩下一段，超过时挂在连接上，等OnSend在回落后继续
+void WebServer::SendStreamChunk(std::shared_ptr<CompressStream> stream, std::string chunk, bool ok, bool last) {
+    size_t loop = stream->loop;
+    ConnectionHandle handle = stream->handle;
+    if (!ok || last) {
+        auto start = stream->start;
+        stream.reset();  // 关闭文件
+        CompleteOffload(loop, handle, start, [&](SOCKET socket) {
+            if (!ok) {
+                engine_->Close(socket);
+                return 500;
+            }
+            engine_->Send(socket, std::move(chunk));
+            return 200;
+        });
+        return;
+    }
+
+    ClientContext** found = shards_[loop]->clients.Find(handle);
+    if (!found) return;  // 连接已关闭(fd可能已被新连接复用)：丢弃，不再继续压缩
+    engine_->Send(handle.socket, std::move(chunk));
+    if (engine_->Backpressured(handle.socket)) {
+        (*found)->stream = std::move(stream);
+        return;
+    }
+    pool_->Submit([this, stream = std::move(stream)]() { CompressNext(stream); });
+}
+
+// 统计服务器完成的压缩
+void WebServer::CountCompression(uint64_t bytesIn, uint64_t bytesOut) {
+    compressions_.fetch_add(1, std::memory_order_relaxed);
+    compressedIn_.fetch_add(bytesIn, std::memory_order_relaxed);
+    compressedOut_.fetch_add(bytesOut, std::memory_order_relaxed);
+}
+
+// 条件请求(If-None-Match/If-Modified-Since)优先于范围请求；Range只对GET生效，If-Range不匹配时忽略
+int WebServer::SendConditional(SOCKET clientSocket, const HttpRequest& request, const Validators& validators,
+                               std::string_view contentType, FileBody& body) {
+    bool keepAlive = WantsKeepAlive(request);
+    char buffer[RESPONSE_HEADER_BUFFER];
+    ResponseWriter writer(buffer, sizeof(buffer));
+    if (NotModified(request, validators)) {
+        if (body.file != INVALID_FILE) CloseFile(body.file);
+        writer.StatusLine(304);
+        writer.Date();
+        if (CompressibleType(contentType)) writer.Header("Vary", "Accept-Encoding");
+        writer.Header("ETag", validators.ETag());
+        writer.Header("Last-Modified", validators.LastModified());
+        writer.Connection(keepAlive);
+        writer.End();
+        engine_->Send(clientSocket, std::string(writer.View()));
+        return 304;
+    }
+
+    std::string_view rangeHeader = request.header(KnownHeader::RANGE);
+    if (request.method != HttpMethod::GET || rangeHeader.empty() || !IfRangeMatches(request, validators)) {
+        return 0;
+    }
+    RangeSet ranges;
+    switch (ParseRange(rangeHeader, body.size, ranges)) {
+        case RangeStatus::NONE:
+            return 0;
+        case RangeStatus::UNSATISFIABLE: {
+            if (body.file != INVALID_FILE) CloseFile(body.file);
+            char contentRange[32];
+            auto result = std::to_chars(contentRange + 8, contentRange + sizeof(contentRange), body.size);
+            memcpy(contentRange, "bytes */", 8);
+            writer.StatusLine(416);
+            writer.Date();
+            writer.Header("Content-Range", std::string_view(contentRange, result.ptr - contentRange));
+            writer.ContentLength(0);
+            writer.Connection(keepAlive);
+            writer.End();
+            engine_->Send(clientSocket, std::string(writer.View()));
+            return 416;
+        }
+        case RangeStatus::PARTIAL:
+            break;
+    }
+    return SendRanges(clientSocket, ranges, validators, contentType, body, keepAlive);
+}
+
+// 206：内容直接从缓存的响应中切片或由引擎从文件零拷贝发送，不复制整个文件；
+// 多个范围时按multipart/byteranges发送，各段的分隔头拼在一个共享缓冲区中
+int WebServer::SendRanges(SOCKET clientSocket, const RangeSet& ranges, const Validators& validators,
+                          std::string_view contentType, FileBody& body, bool keepAlive) {
+    // 从文件发送时每段需要各自的句柄(数据段析构时关闭)，先全部复制好，失败时退回200
+    FileHandle files[MAX_RANGES];
+    if (body.file != INVALID_FILE) {
+        for (size_t i = 0; i + 1 < ranges.count; ++i) {
+            files[i] = DuplicateFile(body.file);
+            if (files[i] == INVALID_FILE) {
+                for (size_t j = 0; j < i; ++j) CloseFile(files[j]);
+                return 0;
+            }
+        }
+        files[ranges.count - 1] = body.file;
+    }
+    auto sendRange = [&](size_t index) {
+        const ByteRange& range = ranges.ranges[index];
+        if (body.cached) {
+            engine_->Send(clientSocket, body.cached, body.cached->size() - body.size + range.offset, range.length);
+        } else {
+            engine_->SendFile(clientSocket, files[index], range.offset, range.length);
+        }
+    };
+
+    char contentRange[64];
+    if (ranges.count == 1) {
+        engine_->Send(clientSocket, BuildFileHeader(ranges.ranges[0].length, contentType, validators, 206, true,
+                                                    FormatContentRange(contentRange, ranges.ranges[0], body.size),
+                                                    {}, keepAlive));
+        sendRange(0);
+        return 206;
+    }
+
+    // 分隔符由ETag(十六进制数字与'-')导出
+    std::string boundary = "byteranges_";
+    boundary.append(validators.ETag().substr(1, validators.etagSize - 2));
+    std::string parts;
+    size_t partEnds[MAX_RANGES];
+    uint64_t contentLength = 0;
+    for (size_t i = 0; i < ranges.count; ++i) {
+        parts.append("\r\n--").append(boundary).append("\r\nContent-Type: ").append(contentType);
+        parts.append("\r\nContent-Range: ").append(FormatContentRange(contentRange, ranges.ranges[i], body.size));
+        parts.append("\r\n\r\n");
+        partEnds[i] = parts.size();
+        contentLength += ranges.ranges[i].length;
+    }
+    parts.append("\r\n--").append(boundary).append("--\r\n");
+    contentLength += parts.size();
+
+    std::string type = "multipart/byteranges; boundary=" + boundary;
+    engine_->Send(clientSocket, BuildFileHeader(contentLength, type, validators, 206, true, {}, {}, keepAlive,
+                                                contentType));
+    SharedBuffer separators = std::make_shared<const std::string>(std::move(parts));
+    size_t offset = 0;
+    for (size_t i = 0; i < ranges.count; ++i) {
+        engine_->Send(clientSocket, separators, offset, partEnds[i] - offset);
+        sendRange(i);
+        offset = partEnds[i];
+    }
+    engine_->Send(clientSocket, separators, offset, separators->size() - offset);
+    return 206;
+}
+
+// 汇总各分片的指标(与各循环线程并发读取它们的计数器)，附加引擎与缓存的统计
+std::string WebServer::RenderMetrics() const {
+    MetricsSnapshot snapshot;
+    for (const auto& shard : shards_) {
+        snapshot.Add(shard->metrics);
+    }
+
+    std::string out;
+    out.reserve(4096);
+    snapshot.WritePrometheus(out);
+    WriteMetric(out, "web_syscalls_total", "counter", "System calls made by the I/O threads.",
+                engine_->SyscallCount());
+    WriteMetric(out, "web_accept_pauses_total", "counter", "Times accepting stopped at the connection limit.",
+                engine_->AcceptPauseCount());
+    if (pool_) {
+        WriteMetric(out, "web_pool_tasks_total", "counter", "Tasks run by the compute pool.", pool_->Executed());
+        WriteMetric(out, "web_pool_steals_total", "counter", "Compute pool tasks taken from another worker's queue.",
+                    pool_->Stolen());
+        WriteMetric(out, "web_pool_queued", "gauge", "Compute pool tasks waiting to run.", pool_->Pending());
+    }
+    if (cache_) {
+        WriteMetric(out, "web_cache_hits_total", "counter", "Asset cache hits.", snapshot.cacheHits);
+        WriteMetric(out, "web_cache_misses_total", "counter", "Asset cache misses.", snapshot.cacheMisses);
+        WriteMetric(out, "web_cache_evictions_total", "counter", "Asset cache evictions.", cache_->Evictions());
+        WriteMetric(out, "web_cache_entries", "gauge", "Cached assets.", cache_->Size());
+        WriteMetric(out, "web_cache_bytes", "gauge", "Memory used by the asset cache.", cache_->MemoryUsage());
+    }
+    WriteMetric(out, "web_compressions_total", "counter", "Bodies gzip-compressed by the server.",
+                compressions_.load(std::memory_order_relaxed));
+    WriteMetric(out, "web_compression_input_bytes_total", "counter", "Bytes fed to the gzip compressor.",
+                compressedIn_.load(std::memory_order_relaxed));
+    WriteMetric(out, "web_compression_output_bytes_total", "counter", "Bytes produced by the gzip compressor.",
+                compressedOut_.load(std::memory_order_relaxed));
+    return out;
+}
+
+// 处理图片上传：识别格式并计算校验和(只读取参数，可在计算线程上执行)
+std::string WebServer::ProcessImageUpload(std::string_view imageData, bool keepAlive) {
+    char summary[128];
+    std::string_view format = ImageFormat(imageData);
+    int n = snprintf(summary, sizeof(summary), "Image processed successfully: %.*s, %zu bytes, crc32 %08x",
+                     static_cast<int>(format.size()), format.data(), imageData.size(), Crc32(imageData));
+    return BuildHttpResponse(std::string_view(summary, static_cast<size_t>(n)), "text/plain", 200, true, keepAlive);
+}
+
+// 把图片上传交给计算线程池：请求体复制到任务中(接收缓冲区随后会被复用)，
+// 结果经IoEngine::Post回到连接所属的事件循环发送；处理期间该连接的后续请求暂停
+void WebServer::OffloadUpload(size_t loop, SOCKET clientSocket, std::string_view imageData, bool keepAlive) {
+    ConnectionHandle handle = BeginOffload(loop, clientSocket);
+    auto start = std::chrono::steady_clock::now();
+    shards_[loop]->metrics.offloaded.Add();
+    pool_->Submit([this, loop, handle, start, keepAlive, data = std::string(imageData)]() {
+        std::string response = ProcessImageUpload(data, keepAlive);
+        engine_->Post(loop, [this, loop, handle, start, response = std::move(response)]() mutable {
+            CompleteOffload(loop, handle, start, [&](SOCKET socket) {
+                engine_->Send(socket, std::move(response));
+                return 200;
+            });
+        });
+    });
+}
+
+// 标记连接忙碌：处理期间该连接的后续流水线请求暂停(响应须按序发送)；
+// 等待其他请求的结果时同样使用，因此不计入offloaded，由向计算线程池提交任务的调用者统计
+ConnectionHandle WebServer::BeginOffload(size_t loop, SOCKET clientSocket) {
+    Shard& shard = *shards_[loop];
+    shard.FindClient(clientSocket)->busy = true;
+    return shard.clients.Handle(clientSocket);
+}
+
+// 在连接所属的事件循环上发送处理结果并按实际结果记录请求，然后继续处理等待期间收到的请求
+// (请求要求关闭连接时改为发送完后关闭)
+void WebServer::CompleteOffload(size_t loop, ConnectionHandle handle, std::chrono::steady_clock::time_point start,
+                                const std::function<int(SOCKET)>& send) {
+    Shard& shard = *shards_[loop];
+    ClientContext** found = shard.clients.Find(handle);
+    if (!found) return;  // 处理期间连接已关闭(fd可能已被新连接复用)
+    ClientContext& client = **found;
+
+    int statusCode = send(handle.socket);
+    shard.metrics.RecordRequest(statusCode, std::chrono::steady_clock::now() - start);
+    client.busy = false;
+    if (client.closeAfterResponse) {
+        client.closeAfterResponse = false;
+        client.closing = true;
+        engine_->CloseAfterSend(handle.socket);
+        return;
+    }
+    if (!engine_->Backpressured(handle.socket)) {
+        ConsumeInput(loop, handle.socket, client, nullptr, 0);
+    } else {
+        client.backlogged = true;  // 由OnSend在发送回落后继续
+        RefreshTimeout(loop, client);
+    }
+}
+
+// 写入状态行与响应头(Date头紧跟状态行，与发送缓存的响应时插入的位置一致)
+void WebServer::WriteHttpHeader(ResponseWriter& writer, uint64_t contentLength,
+                                std::string_view contentType, int statusCode, bool date, bool keepAlive) {
+    writer.StatusLine(statusCode);
+    if (date) writer.Date();
+    writer.ContentType(contentType);
+    writer.ContentLength(contentLength);
+    writer.Connection(keepAlive);
+    writer.End();
+}
+
+// 静态文件的响应头
+std::string WebServer::BuildFileHeader(uint64_t contentLength, std::string_view contentType,
+                                       const Validators& validators, int statusCode, bool date,
+                                       std::string_view contentRange, std::string_view contentEncoding,
+                                       bool keepAlive, std::string_view fileType) {
+    char buffer[RESPONSE_HEADER_BUFFER];
+    ResponseWriter writer(buffer, sizeof(buffer));
+    writer.StatusLine(statusCode);
+    if (date) writer.Date();
+    writer.ContentType(contentType);
+    writer.ContentLength(contentLength);
+    if (!contentRange.empty()) writer.Header("Content-Range", contentRange);
+    if (!contentEncoding.empty()) writer.Header("Content-Encoding", contentEncoding);
+    if (CompressibleType(fileType.empty() ? contentType : fileType)) writer.Header("Vary", "Accept-Encoding");
+    writer.Header("ETag", validators.ETag());
+    writer.Header("Last-Modified", validators.LastModified());
+    writer.Header("Accept-Ranges", "bytes");
+    writer.Connection(keepAlive);
+    writer.End();
+    return std::string(writer.View());
+}
+
+// 构建HTTP响应头
+std::string WebServer::BuildHttpHeader(uint64_t contentLength, std::string_view contentType,
+                                       int statusCode, bool date, bool keepAlive) {
+    char buffer[RESPONSE_HEADER_BUFFER];
+    ResponseWriter writer(buffer, sizeof(buffer));
+    WriteHttpHeader(writer, contentLength, contentType, statusCode, date, keepAlive);
+    return std::string(writer.View());
+}
+
+// 构建HTTP响应(响应头先写入栈上的缓冲区，再与内容一次拼成精确大小的字符串)
+std::string WebServer::BuildHttpResponse(std::string_view content, std::string_view contentType,
+                                         int statusCode, bool date, bool keepAlive) {
+    char buffer[RESPONSE_HEADER_BUFFER];
+    ResponseWriter writer(buffer, sizeof(buffer));
+    WriteHttpHeader(writer, content.size(), contentType, statusCode, date, keepAlive);
+    std::string response;
+    response.reserve(writer.Size() + content.size());
+    response.append(writer.Data(), writer.Size());
+    response.append(content);
+    return response;
+}
+
+// 发送缓存的响应：在状态行之后插入当前的Date头，三段都是共享缓冲区，不复制也不分配；
+// 不保持连接时再把缓存的响应中的keep-alive头换成close(缓存的响应为所有连接共享，不能修改)
+void WebServer::SendCachedResponse(SOCKET clientSocket, const SharedBuffer& response, bool keepAlive) {
+    size_t statusEnd = response->find('\n') + 1;
+    engine_->Send(clientSocket, response, 0, statusEnd);
+    engine_->Send(clientSocket, DateHeaderLine());
+    size_t connection = keepAlive ? std::string::npos : response->find(KEEP_ALIVE_LINE, statusEnd);
+    if (connection == std::string::npos) {
+        engine_->Send(clientSocket, response, statusEnd, response->size() - statusEnd);
+        return;
+    }
+    size_t rest = connection + KEEP_ALIVE_LINE.size();
+    engine_->Send(clientSocket, response, statusEnd, connection - statusEnd);
+    engine_->Send(clientSocket, std::string(CLOSE_LINE));
+    engine_->Send(clientSocket, response, rest, response->size() - rest);
+}
+
+// 运行服务器
+void WebServer::Run() {
+    std::cout << "Server running on port " << port_ << std::endl;
+    std::cout << "I/O engine: " << engine_->Name() << std::endl;
+    std::cout << "Worker threads: " << engine_->ThreadCount() << std::endl;
+    std::cout << "Event loops: " << engine_->LoopCount() << std::endl;
+    std::cout << "Document root: " << documentRoot_ << std::endl;
+    if (cache_) {
+        std::cout << "Asset cache: " << cache_->Capacity() / (1024 * 1024) << " MB" << std::endl;
+    }
+    if (pool_) {
+        std::cout << "Compute threads: " << pool_->ThreadCount() << std::endl;
+    }
+
+    // 主循环(实际工作由I/O线程完成)
+    while (running_) {
+        std::this_thread::sleep_for(1s);
+    }
+}
+
+// 停止服务器
+void WebServer::Stop() {
+    if (!running_) return;
+
+    // 1. 设置运行标志为false
+    running_ = false;
+
+    // 2. 停止计算线程池(正在执行的任务还可能向事件循环投递结果，因此先于引擎停止)
+    if (pool_) {
+        pool_->Stop();
+    }
+
+    // 3. 停止I/O线程并关闭所有连接(定时器随事件循环一起停止)
+    if (engine_) {
+        engine_->Stop();
+    }
+
+    // 4. 清理分片状态(I/O线程已退出)
+    shards_.clear();
+
+    std::cout << "Server stopped successfully" << std::endl;
+}
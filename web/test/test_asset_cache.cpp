@@ -0,0 +1,174 @@
+#include "asset_cache.hpp"
+#include <cassert>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// 写入测试文件并返回其修改时间
+fs::file_time_type WriteFile(const fs::path& path, const std::string& content) {
+    std::ofstream(path, std::ios::binary) << content;
+    return fs::last_write_time(path);
+}
+
+void TestHitAndMiss(const fs::path& dir) {
+    std::cout << "\n=== Test 1: Hit and Miss ===" << std::endl;
+    AssetCache cache(1024 * 1024, 64 * 1024);
+    AssetCache::Reader reader;
+    fs::path file = dir / "a.html";
+    auto mtime = WriteFile(file, "hello");
+
+    assert(cache.Find(reader, "/a.html") == nullptr);
+    cache.Insert("/a.html", file.string(), "RESPONSE-A", 5, mtime);
+    auto response = cache.Find(reader, "/a.html");
+    assert(response && *response == "RESPONSE-A");
+    assert(cache.Size() == 1 && cache.MemoryUsage() > 0);
+
+    // 命中时可同时取得文件元数据(用于ETag/Last-Modified)
+    AssetCache::FileInfo info;
+    assert(cache.Find(reader, "/a.html", &info) == response && info.size == 5 && info.mtime == mtime && info.coding == 0);
+
+    // 同一份响应可以挂在另一个键上(内容协商的结果)，各自带编码标记
+    assert(cache.Insert("/a.html 1", file.string(), response, 5, mtime, 1) == response);
+    assert(cache.Find(reader, "/a.html 1", &info) == response && info.coding == 1 && cache.Size() == 2);
+
+    cache.Invalidate("/a.html");
+    cache.Invalidate("/a.html 1");
+    assert(cache.Find(reader, "/a.html") == nullptr && cache.Size() == 0 && cache.MemoryUsage() == 0);
+    std::cout << "Test passed!\n";
+}
+
+void TestBudgetAndClockEviction(const fs::path& dir) {
+    std::cout << "\n=== Test 2: Budget and CLOCK Eviction ===" << std::endl;
+    // 预算只够容纳约3个1KB的响应
+    AssetCache cache(3 * 1024 + 3 * 256, 64 * 1024);
+    AssetCache::Reader reader;
+    fs::path file = dir / "b.bin";
+    auto mtime = WriteFile(file, "x");
+    std::string body(1024, 'x');
+
+    cache.Insert("/1", file.string(), body, 1, mtime);
+    cache.Insert("/2", file.string(), body, 1, mtime);
+    cache.Insert("/3", file.string(), body, 1, mtime);
+    assert(cache.Size() == 3);
+
+    // 命中的项获得第二次机会，未引用的/2最先被淘汰
+    assert(cache.Find(reader, "/1") && cache.Find(reader, "/3"));
+    cache.Insert("/4", file.string(), body, 1, mtime);
+    assert(cache.Size() == 3 && cache.Evictions() == 1);
+    assert(cache.MemoryUsage() <= cache.Capacity());
+    assert(cache.Find(reader, "/2") == nullptr);
+    assert(cache.Find(reader, "/1") && cache.Find(reader, "/3") && cache.Find(reader, "/4"));
+
+    // 超出预算的响应只返回不缓存
+    auto large = cache.Insert("/large", file.string(), std::string(8192, 'y'), 1, mtime);
+    assert(large && large->size() == 8192 && cache.Find(reader, "/large") == nullptr);
+    assert(!cache.Cacheable(128 * 1024));
+    std::cout << "Test passed!\n";
+}
+
+void TestInvalidationOnChange(const fs::path& dir) {
+    std::cout << "\n=== Test 3: Invalidation on File Change ===" << std::endl;
+    // 校验间隔为0：每次命中都检查文件
+    AssetCache cache(1024 * 1024, 64 * 1024, 0ms);
+    AssetCache::Reader reader;
+    fs::path file = dir / "c.css";
+    auto mtime = WriteFile(file, "body{}");
+    cache.Insert("/c.css", file.string(), "OLD", 6, mtime);
+    assert(cache.Find(reader, "/c.css"));
+
+    // 修改内容与修改时间后失效
+    WriteFile(file, "body{color:red}");
+    fs::last_write_time(file, mtime + 1s);
+    assert(cache.Find(reader, "/c.css") == nullptr && cache.Size() == 0);
+
+    // 删除文件后失效
+    mtime = fs::last_write_time(file);
+    cache.Insert("/c.css", file.string(), "NEW", fs::file_size(file), mtime);
+    assert(cache.Find(reader, "/c.css"));
+    fs::remove(file);
+    assert(cache.Find(reader, "/c.css") == nullptr);
+    std::cout << "Test passed!\n";
+}
+
+void TestSourceInvalidation(const fs::path& dir) {
+    std::cout << "\n=== Test 4: Invalidation on Source Change ===" << std::endl;
+    AssetCache cache(1024 * 1024, 64 * 1024, 0ms);
+    AssetCache::Reader reader;
+    fs::path source = dir / "d.js";
+    fs::path encoded = dir / "d.js.gz";
+    auto sourceTime = WriteFile(source, "var d = 1;");
+    auto encodedTime = WriteFile(encoded, "GZIP");
+    cache.Insert("/d.js 1", encoded.string(), "GZ", 4, encodedTime, 1, {source.string(), sourceTime});
+    assert(cache.Find(reader, "/d.js 1"));
+
+    // 只修改原文件(预压缩文件不变)：该项失效
+    WriteFile(source, "var d = 2;");
+    fs::last_write_time(source, sourceTime + 1s);
+    assert(cache.Find(reader, "/d.js 1") == nullptr && cache.Size() == 0);
+
+    // 删除原文件后同样失效
+    sourceTime = fs::last_write_time(source);
+    cache.Insert("/d.js 1", encoded.string(), "GZ", 4, encodedTime, 1, {source.string(), sourceTime});
+    assert(cache.Find(reader, "/d.js 1"));
+    fs::remove(source);
+    assert(cache.Find(reader, "/d.js 1") == nullptr);
+    std::cout << "Test passed!\n";
+}
+
+// 多个读者各自持有快照并发查找，同时插入与淘汰：读者总能看到完整的项，版本更新后看到新插入的项
+void TestConcurrentReaders(const fs::path& dir) {
+    std::cout << "\n=== Test 5: Concurrent Readers ===" << std::endl;
+    AssetCache cache(4 * 1024, 64 * 1024);  // 只能容纳一部分键，插入期间不断淘汰
+    fs::path file = dir / "e.txt";
+    auto mtime = WriteFile(file, "e");
+    cache.Insert("/stable", file.string(), "STABLE", 1, mtime);
+
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&]() {
+            AssetCache::Reader reader;
+            while (!done.load()) {
+                for (int i = 0; i < 64; ++i) {
+                    auto response = cache.Find(reader, "/k" + std::to_string(i));
+                    assert(!response || *response == "R" + std::to_string(i));
+                }
+                cache.Find(reader, "/stable");  // 命中置位引用位，淘汰时获得第二次机会
+            }
+        });
+    }
+    for (int round = 0; round < 200; ++round) {
+        for (int i = 0; i < 64; ++i) {
+            cache.Insert("/k" + std::to_string(i), file.string(), "R" + std::to_string(i), 1, mtime);
+        }
+    }
+    done = true;
+    for (auto& reader : readers) reader.join();
+    assert(cache.MemoryUsage() <= cache.Capacity() && cache.Evictions() > 0);
+
+    // 已持有快照的读者在插入之后同样能找到新项
+    AssetCache::Reader reader;
+    assert(cache.Find(reader, "/new") == nullptr);
+    cache.Insert("/new", file.string(), "NEW", 1, mtime);
+    assert(cache.Find(reader, "/new") && *cache.Find(reader, "/new") == "NEW");
+    std::cout << "Test passed!\n";
+}
+
+int main() {
+    std::cout << "=== AssetCache Test Suite ===" << std::endl;
+    fs::path dir = fs::temp_directory_path() / "asset_cache_test";
+    fs::create_directories(dir);
+
+    TestHitAndMiss(dir);
+    TestBudgetAndClockEviction(dir);
+    TestInvalidationOnChange(dir);
+    TestSourceInvalidation(dir);
+    TestConcurrentReaders(dir);
+
+    fs::remove_all(dir);
+    std::cout << "\n=== All tests passed ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,182 @@
+#include "io_engine.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+// 每收到一个字节回应一个64KB的响应；与WebServer一样在背压期间暂停处理，在OnSend中继续
+class EchoHandler : public IoHandler {
+public:
+    explicit EchoHandler(IoEngine& engine)
+        : engine_(engine), response_(std::make_shared<const std::string>(RESPONSE_SIZE, 'r')) {}
+
+    static const size_t RESPONSE_SIZE = 64 * 1024;
+    std::atomic<size_t> issued{0};  // 已放入发送队列的响应数
+
+    void OnAccept(size_t, SOCKET) override {}
+    void OnRecv(size_t, SOCKET socket, const char*, size_t length) override {
+        backlog_ += length;
+        Drain(socket);
+    }
+    void OnSend(size_t, SOCKET socket, size_t) override { Drain(socket); }
+    void OnClose(size_t, SOCKET) override {}
+
+private:
+    void Drain(SOCKET socket) {
+        while (backlog_ > 0 && !engine_.Backpressured(socket)) {
+            engine_.Send(socket, response_);
+            --backlog_;
+            ++issued;
+        }
+    }
+
+    IoEngine& engine_;
+    SharedBuffer response_;
+    size_t backlog_ = 0;  // 尚未回应的请求数(只在I/O线程上访问)
+};
+
+// 收到数据时回应一个大响应后要求写完即关闭(如错误响应)
+class CloseHandler : public IoHandler {
+public:
+    explicit CloseHandler(IoEngine& engine) : engine_(engine) {}
+
+    static const size_t RESPONSE_SIZE = 4 * 1024 * 1024;
+    std::atomic<bool> closed{false};
+
+    void OnAccept(size_t, SOCKET) override {}
+    void OnRecv(size_t, SOCKET socket, const char*, size_t) override {
+        if (replied_) return;  // 关闭前收到的数据不再处理
+        replied_ = true;
+        engine_.Send(socket, std::string(RESPONSE_SIZE, 'c'));
+        engine_.CloseAfterSend(socket);
+    }
+    void OnSend(size_t, SOCKET, size_t) override {}
+    void OnClose(size_t, SOCKET) override { closed = true; }
+
+private:
+    IoEngine& engine_;
+    bool replied_ = false;
+};
+
+// 客户端不读取响应时服务端的发送队列受高水位限制，读取后所有请求都得到回应
+void TestPipelinedClientNotReading(const std::string& name, int port) {
+    std::cout << "\n=== Test: " << name << " backpressure ===" << std::endl;
+    auto engine = CreateIoEngine(name);
+    if (!engine) {
+        std::cout << "Engine not available, skipped\n";
+        return;
+    }
+    EchoHandler handler(*engine);
+    IoEngineOptions options;
+    options.port = port;
+    if (!engine->Initialize(options, &handler)) {
+        std::cout << "Engine failed to initialize, skipped\n";
+        return;
+    }
+    engine->Start();
+
+    SOCKET client = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    assert(connect(client, (sockaddr*)&addr, sizeof(addr)) == 0);
+
+    // 两批请求共2000个(约128MB的响应)，第二批在服务端暂停读取之后才到达
+    const size_t batch = 1000;
+    std::string requests(batch, 'x');
+    assert(send(client, requests.data(), static_cast<int>(batch), 0) == static_cast<int>(batch));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    assert(send(client, requests.data(), static_cast<int>(batch), 0) == static_cast<int>(batch));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    // 排队的响应不超过高水位加上套接字缓冲区能容纳的量
+    size_t stalled = handler.issued.load();
+    std::cout << "Responses queued while client is not reading: " << stalled << "/" << 2 * batch << std::endl;
+    assert(stalled > 0 && stalled < batch / 2);
+
+    // 读完所有响应：背压解除后服务端继续处理积压的请求并恢复读取
+    size_t expected = 2 * batch * EchoHandler::RESPONSE_SIZE;
+    size_t received = 0;
+    char buffer[65536];
+    while (received < expected) {
+        int n = recv(client, buffer, sizeof(buffer), 0);
+        assert(n > 0);
+        for (int i = 0; i < n; ++i) assert(buffer[i] == 'r');
+        received += static_cast<size_t>(n);
+    }
+    assert(handler.issued.load() == 2 * batch);
+    std::cout << "Received " << received << " bytes" << std::endl;
+
+    closesocket(client);
+    engine->Stop();
+    std::cout << "Test passed!\n";
+}
+
+// CloseAfterSend：发送队列中的数据(远超套接字缓冲区)全部写出后才关闭写端，客户端读到完整响应后读到EOF；
+// 期间客户端发来的数据不会使连接被重置
+void TestCloseAfterSend(const std::string& name, int port) {
+    std::cout << "\n=== Test: " << name << " close after send ===" << std::endl;
+    auto engine = CreateIoEngine(name);
+    if (!engine) {
+        std::cout << "Engine not available, skipped\n";
+        return;
+    }
+    CloseHandler handler(*engine);
+    IoEngineOptions options;
+    options.port = port;
+    if (!engine->Initialize(options, &handler)) {
+        std::cout << "Engine failed to initialize, skipped\n";
+        return;
+    }
+    engine->Start();
+
+    SOCKET client = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    assert(connect(client, (sockaddr*)&addr, sizeof(addr)) == 0);
+    assert(send(client, "x", 1, 0) == 1);
+
+    // 客户端暂不读取：响应停留在服务端的发送队列中，连接不能提前关闭
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    assert(!handler.closed.load());
+    assert(send(client, "y", 1, 0) == 1);
+
+    size_t received = 0;
+    char buffer[65536];
+    while (true) {
+        int n = recv(client, buffer, sizeof(buffer), 0);
+        assert(n >= 0);
+        if (n == 0) break;
+        for (int i = 0; i < n; ++i) assert(buffer[i] == 'c');
+        received += static_cast<size_t>(n);
+    }
+    std::cout << "Received " << received << " bytes before EOF" << std::endl;
+    assert(received == CloseHandler::RESPONSE_SIZE);
+
+    // 服务端只关闭了写端：客户端关闭后服务端读到EOF，回收连接
+    closesocket(client);
+    for (int i = 0; i < 100 && !handler.closed.load(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    assert(handler.closed.load());
+    engine->Stop();
+    std::cout << "Test passed!\n";
+}
+
+int main() {
+#ifdef _WIN32
+    TestPipelinedClientNotReading("iocp", 18191);
+    TestCloseAfterSend("iocp", 18193);
+#else
+    TestPipelinedClientNotReading("epoll", 18191);
+    TestPipelinedClientNotReading("uring", 18192);
+    TestCloseAfterSend("epoll", 18193);
+    TestCloseAfterSend("uring", 18194);
+#endif
+    std::cout << "\n=== All tests passed ===" << std::endl;
+    return 0;
+}
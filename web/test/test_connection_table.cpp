@@ -0,0 +1,76 @@
+#include "connection_table.hpp"
+#include <cassert>
+#include <iostream>
+#include <string>
+
+void TestLookup() {
+    std::cout << "\n=== Test 1: Insert, Find, Erase ===" << std::endl;
+    ConnectionTable<std::string> table;
+    assert(table.Empty() && !table.Find(5) && !table.Find(INVALID_SOCKET));
+
+    table.Insert(5) = "five";
+    table.Insert(7) = "seven";
+    assert(table.Size() == 2);
+    assert(*table.Find(5) == "five" && *table.Find(7) == "seven" && !table.Find(6));
+
+    // 移除后值被重置，再次插入得到新值
+    assert(table.Erase(5) && !table.Erase(5));
+    assert(!table.Find(5) && table.Size() == 1);
+    assert(table.Insert(5).empty());
+    std::cout << "Test passed!\n";
+}
+
+void TestGeneration() {
+    std::cout << "\n=== Test 2: Generations ===" << std::endl;
+    ConnectionTable<int> table;
+    table.Insert(3) = 1;
+    ConnectionHandle old = table.Handle(3);
+    assert(old.generation != 0 && table.Find(old));
+
+    // fd关闭后旧句柄失效，被新连接复用后也不匹配
+    table.Erase(3);
+    assert(!table.Find(old) && table.Handle(3).generation == 0);
+    table.Insert(3) = 2;
+    ConnectionHandle current = table.Handle(3);
+    assert(current.generation != old.generation);
+    assert(!table.Find(old) && *table.Find(current) == 2);
+
+    // 打包后的高8位留给调用者
+    uint64_t packed = current.Pack() | (uint64_t(0xab) << 56);
+    ConnectionHandle unpacked = ConnectionHandle::Unpack(packed);
+    assert(unpacked.socket == 3 && unpacked.generation == current.generation);
+    std::cout << "Test passed!\n";
+}
+
+void TestPages() {
+    std::cout << "\n=== Test 3: Pages and Iteration ===" << std::endl;
+    ConnectionTable<int> table;
+    int& first = table.Insert(1);
+    first = 100;
+    // 扩容到更远的页后已有槽位不移动
+    const SOCKET far = static_cast<SOCKET>(5 * ConnectionTable<int>::PAGE_SLOTS + 3);
+    table.Insert(far) = 200;
+    assert(&first == table.Find(1) && first == 100 && *table.Find(far) == 200);
+    assert(!table.Find(static_cast<SOCKET>(3 * ConnectionTable<int>::PAGE_SLOTS)));  // 未分配的页
+
+    // 按fd顺序遍历，遍历中可以移除当前连接
+    table.Insert(2) = 150;
+    int sum = 0;
+    SOCKET last = 0;
+    table.ForEach([&](SOCKET socket, int& value) {
+        assert(socket > last);
+        last = socket;
+        sum += value;
+        table.Erase(socket);
+    });
+    assert(sum == 450 && table.Empty());
+    std::cout << "Test passed!\n";
+}
+
+int main() {
+    TestLookup();
+    TestGeneration();
+    TestPages();
+    std::cout << "\n=== All tests passed ===" << std::endl;
+    return 0;
+}
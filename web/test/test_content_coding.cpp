@@ -0,0 +1,53 @@
+#include "content_coding.hpp"
+#include "mime.hpp"
+#include <cassert>
+#include <iostream>
+
+void TestAcceptEncoding() {
+    std::cout << "\n=== Test 1: Accept-Encoding ===" << std::endl;
+    assert(AcceptedCodings("") == 0);
+    assert(AcceptedCodings("gzip") == CODING_GZIP);
+    assert(AcceptedCodings("gzip, deflate, br") == (CODING_GZIP | CODING_BR));
+    assert(AcceptedCodings("GZIP;q=0.8 , BR ;q=1.0") == (CODING_GZIP | CODING_BR));
+    assert(AcceptedCodings("x-gzip") == CODING_GZIP);
+    assert(AcceptedCodings("identity") == 0);
+    assert(AcceptedCodings("deflate, zstd") == 0);
+    // q=0表示拒绝
+    assert(AcceptedCodings("gzip;q=0") == 0);
+    assert(AcceptedCodings("gzip; q=0.000, br") == CODING_BR);
+    assert(AcceptedCodings("gzip;q=0.001") == CODING_GZIP);
+    assert(AcceptedCodings("br;level=1;q=0") == 0);
+    // "*"匹配未单独列出的编码
+    assert(AcceptedCodings("*") == (CODING_GZIP | CODING_BR));
+    assert(AcceptedCodings("*, br;q=0") == CODING_GZIP);
+    assert(AcceptedCodings("gzip, *;q=0") == CODING_GZIP);
+    assert(AcceptedCodings("*;q=0") == 0);
+    // 格式不规范的列表
+    assert(AcceptedCodings(" ,gzip,, ") == CODING_GZIP);
+    assert(AcceptedCodings("gzipx, bro") == 0);
+    std::cout << "Test passed!\n";
+}
+
+void TestCodingNames() {
+    std::cout << "\n=== Test 2: Coding Names and Compressible Types ===" << std::endl;
+    assert(CodingName(CODING_GZIP) == "gzip" && CodingName(CODING_BR) == "br" && CodingName(0).empty());
+    assert(CodingExtension(CODING_GZIP) == ".gz" && CodingExtension(CODING_BR) == ".br");
+
+    for (const char* path : {"/index.html", "/app.js", "/style.css", "/data.json", "/logo.svg", "/main.wasm",
+                             "/feed.xml", "/notes.txt", "/README"}) {
+        assert(CompressibleType(MimeType(path)));
+    }
+    for (const char* path : {"/a.png", "/a.jpg", "/a.webp", "/a.woff2", "/a.mp4", "/a.zip", "/a.pdf"}) {
+        assert(!CompressibleType(MimeType(path)));
+    }
+    assert(CompressibleType("text/plain; version=0.0.4"));
+    assert(!CompressibleType("multipart/byteranges; boundary=x"));
+    std::cout << "Test passed!\n";
+}
+
+int main() {
+    TestAcceptEncoding();
+    TestCodingNames();
+    std::cout << "\n=== All tests passed ===" << std::endl;
+    return 0;
+}
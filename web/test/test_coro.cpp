@@ -0,0 +1,174 @@
+#include "coro_server.hpp"
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+Task<int> Add(int a, int b) { co_return a + b; }
+
+Task<int> Sum(int n) {
+    int total = 0;
+    for (int i = 0; i < n; ++i) total += co_await Add(i, 1);
+    co_return total;
+}
+
+Task<> Fail() {
+    throw std::runtime_error("boom");
+    co_return;
+}
+
+Task<> Run(int n, int& result, bool& caught) {
+    result = co_await Sum(n);
+    try {
+        co_await Fail();
+    } catch (const std::runtime_error&) {
+        caught = true;
+    }
+}
+
+// 测试用的处理器：回应"URI 请求体长度"；/skip不读取请求体(由下一个ReadRequest跳过)
+Task<> Echo(CoConnection& conn) {
+    while (const HttpRequest* request = co_await conn.ReadRequest()) {
+        std::string uri(request->uri);
+        size_t body = 0;
+        if (uri != "/skip") {
+            for (;;) {
+                std::string_view chunk = co_await conn.ReadBody();
+                if (chunk.empty()) break;
+                body += chunk.size();
+            }
+        }
+        std::string text = uri + " " + std::to_string(body);
+        bool open = co_await conn.Send("HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(text.size()) + "\r\n\r\n" + text);
+        if (!open) break;
+    }
+}
+
+// 阻塞的测试客户端
+class Client {
+public:
+    explicit Client(int port) {
+        fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        assert(connect(fd_, (sockaddr*)&addr, sizeof(addr)) == 0);
+    }
+    ~Client() { close(fd_); }
+
+    void Write(const std::string& data) {
+        assert(send(fd_, data.data(), data.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(data.size()));
+    }
+
+    // 读取一个响应的响应体(连接关闭时返回"<closed>")
+    std::string ReadBody() {
+        size_t end;
+        while ((end = buffer_.find("\r\n\r\n")) == std::string::npos) {
+            if (!Fill()) return "<closed>";
+        }
+        size_t length = std::stoul(buffer_.substr(buffer_.find("Content-Length: ") + 16));
+        while (buffer_.size() < end + 4 + length) {
+            if (!Fill()) return "<closed>";
+        }
+        std::string body = buffer_.substr(end + 4, length);
+        buffer_.erase(0, end + 4 + length);
+        return body;
+    }
+
+private:
+    bool Fill() {
+        char chunk[65536];
+        ssize_t n = recv(fd_, chunk, sizeof(chunk), 0);
+        if (n <= 0) return false;
+        buffer_.append(chunk, static_cast<size_t>(n));
+        return true;
+    }
+
+    int fd_;
+    std::string buffer_;
+};
+
+}
+
+void TestTask() {
+    std::cout << "\n=== Test 1: Task ===" << std::endl;
+    int result = 0;
+    bool caught = false;
+    Task<> task = Run(1000, result, caught);
+    task.Start();
+    assert(task.Done() && !task.Exception());
+    assert(result == 1000 * 1001 / 2 && caught);
+
+    // 协程帧从池中复用：再运行一遍不再从堆分配
+    uint64_t heap = FramePool::HeapAllocations();
+    uint64_t allocations = FramePool::Allocations();
+    Task<> again = Run(1000, result, caught);
+    again.Start();
+    assert(again.Done() && result == 1000 * 1001 / 2);
+    std::cout << "Frames: " << FramePool::Allocations() - allocations << ", from heap: "
+              << FramePool::HeapAllocations() - heap << std::endl;
+    assert(FramePool::Allocations() - allocations > 1000);
+    assert(FramePool::HeapAllocations() - heap <= 1);  // 只有again自己的帧(task的帧尚未释放)
+    std::cout << "Test passed!\n";
+}
+
+void TestServer(const std::string& engine, int port) {
+    std::cout << "\n=== Test: " << engine << " coroutine server ===" << std::endl;
+    if (!CreateIoEngine(engine)) {
+        std::cout << "Engine not available, skipped\n";
+        return;
+    }
+    CoServer server;
+    CoServerConfig config;
+    config.port = port;
+    config.engine = engine;
+    config.threads = 1;
+    if (!server.Initialize(config, Echo)) {
+        std::cout << "Engine failed to initialize, skipped\n";
+        return;
+    }
+
+    // 流水线请求：分段到达的大请求体、未读取的请求体、紧随其后的请求
+    {
+        Client client(port);
+        std::string body(100000, 'b');
+        client.Write("GET /a HTTP/1.1\r\n\r\nPOST /b HTTP/1.1\r\nContent-Length: 100000\r\n\r\n" + body.substr(0, 1000));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        client.Write(body.substr(1000) + "POST /skip HTTP/1.1\r\nContent-Length: 5\r\n\r\nhel");
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        client.Write("loGET /c HTTP/1.1\r\n\r\n");
+        assert(client.ReadBody() == "/a 0");
+        assert(client.ReadBody() == "/b 100000");
+        assert(client.ReadBody() == "/skip 0");
+        assert(client.ReadBody() == "/c 0");
+
+        // 格式错误的请求：连接被关闭
+        client.Write("BAD / HTTP/1.1\r\n\r\n");
+        assert(client.ReadBody() == "<closed>");
+    }
+
+    // 读取请求体期间客户端断开：等待中的ReadBody返回空，处理器结束，服务器照常服务新连接
+    {
+        Client client(port);
+        client.Write("POST /d HTTP/1.1\r\nContent-Length: 1000\r\n\r\n0123456789");
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    {
+        Client client(port);
+        client.Write("GET /e HTTP/1.1\r\n\r\n");
+        assert(client.ReadBody() == "/e 0");
+    }
+
+    server.Stop();
+    std::cout << "Test passed!\n";
+}
+
+int main() {
+    TestTask();
+    TestServer("epoll", 18461);
+    TestServer("uring", 18462);
+    std::cout << "\n=== All tests passed ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,419 @@
+#include "gzip.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+
+// 测试用的DEFLATE解码器(按RFC 1951逐位解码，只用于校验压缩器的输出)
+class Inflater {
+public:
+    explicit Inflater(std::string_view data) : data_(data) {}
+
+    // 解码到最后一块为止，追加到out；partial为true时也可以停在输入末尾的块边界(同步刷新之后)
+    bool Inflate(std::string& out, bool partial = false) {
+        int last = 0;
+        do {
+            if (partial && pos_ == data_.size() && bitCount_ == 0) return true;
+            last = Bits(1);
+            int type = Bits(2);
+            if (error_ || type == 3) return false;
+            blocks[type]++;
+            bool ok = type == 0 ? Stored(out) : type == 1 ? Fixed(out) : Dynamic(out);
+            if (!ok || error_) return false;
+        } while (!last);
+        bitBuffer_ = 0;
+        bitCount_ = 0;
+        return true;
+    }
+    size_t Offset() const { return pos_; }  // 已读取的字节数(最后一块之后按字节对齐)
+
+    int blocks[3] = {};  // 各类型的块数(存储、固定、动态)
+
+private:
+    struct Huffman {
+        short count[16] = {};
+        short symbol[288] = {};
+    };
+
+    int Bits(int need) {
+        while (bitCount_ < need) {
+            if (pos_ >= data_.size()) {
+                error_ = true;
+                return 0;
+            }
+            bitBuffer_ |= static_cast<uint32_t>(static_cast<uint8_t>(data_[pos_++])) << bitCount_;
+            bitCount_ += 8;
+        }
+        int value = static_cast<int>(bitBuffer_ & ((1u << need) - 1));
+        bitBuffer_ >>= need;
+        bitCount_ -= need;
+        return value;
+    }
+
+    bool Stored(std::string& out) {
+        bitBuffer_ = 0;
+        bitCount_ = 0;
+        if (pos_ + 4 > data_.size()) return false;
+        auto byte = [this](size_t i) { return static_cast<unsigned>(static_cast<uint8_t>(data_[pos_ + i])); };
+        unsigned length = byte(0) | (byte(1) << 8);
+        unsigned complement = byte(2) | (byte(3) << 8);
+        pos_ += 4;
+        if (length != (~complement & 0xffff) || pos_ + length > data_.size()) return false;
+        out.append(data_.substr(pos_, length));
+        pos_ += length;
+        return true;
+    }
+
+    // 由码长构建范式哈夫曼表(超额时返回false)
+    static bool Build(Huffman& huffman, const short* lengths, int count) {
+        for (int i = 0; i < count; ++i) huffman.count[lengths[i]]++;
+        int left = 1;
+        for (int length = 1; length < 16; ++length) {
+            left = (left << 1) - huffman.count[length];
+            if (left < 0) return false;
+        }
+        short offsets[16] = {};
+        for (int length = 1; length < 15; ++length) offsets[length + 1] = offsets[length] + huffman.count[length];
+        for (int i = 0; i < count; ++i) {
+            if (lengths[i]) huffman.symbol[offsets[lengths[i]]++] = static_cast<short>(i);
+        }
+        return true;
+    }
+
+    int Decode(const Huffman& huffman) {
+        int code = 0, first = 0, index = 0;
+        for (int length = 1; length < 16; ++length) {
+            code |= Bits(1);
+            if (error_) return -1;
+            int count = huffman.count[length];
+            if (code - count < first) return huffman.symbol[index + (code - first)];
+            index += count;
+            first = (first + count) << 1;
+            code <<= 1;
+        }
+        return -1;
+    }
+
+    bool Codes(std::string& out, const Huffman& literals, const Huffman& distances) {
+        static const short LENGTH_BASE[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                              35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        static const short LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                               3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        static const short DISTANCE_BASE[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                                257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                                8193, 12289, 16385, 24577};
+        static const short DISTANCE_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                                 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+        while (true) {
+            int symbol = Decode(literals);
+            if (symbol < 0) return false;
+            if (symbol < 256) {
+                out.push_back(static_cast<char>(symbol));
+            } else if (symbol == 256) {
+                return true;
+            } else {
+                symbol -= 257;
+                if (symbol >= 29) return false;
+                int length = LENGTH_BASE[symbol] + Bits(LENGTH_EXTRA[symbol]);
+                int code = Decode(distances);
+                if (code < 0 || code >= 30) return false;
+                size_t distance = static_cast<size_t>(DISTANCE_BASE[code] + Bits(DISTANCE_EXTRA[code]));
+                if (error_ || distance > out.size()) return false;
+                for (int i = 0; i < length; ++i) out.push_back(out[out.size() - distance]);
+            }
+        }
+    }
+
+    bool Fixed(std::string& out) {
+        short lengths[288 + 30];
+        for (int i = 0; i < 288; ++i) lengths[i] = i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8;
+        for (int i = 0; i < 30; ++i) lengths[288 + i] = 5;
+        Huffman literals, distances;
+        Build(literals, lengths, 288);
+        Build(distances, lengths + 288, 30);
+        return Codes(out, literals, distances);
+    }
+
+    bool Dynamic(std::string& out) {
+        static const short ORDER[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+        int literalCount = Bits(5) + 257;
+        int distanceCount = Bits(5) + 1;
+        int codeCount = Bits(4) + 4;
+        if (literalCount > 286 || distanceCount > 30) return false;
+        short lengths[286 + 30] = {};
+        for (int i = 0; i < codeCount; ++i) lengths[ORDER[i]] = static_cast<short>(Bits(3));
+        Huffman codeLengths;
+        if (!Build(codeLengths, lengths, 19)) return false;
+
+        int index = 0;
+        while (index < literalCount + distanceCount) {
+            int symbol = Decode(codeLengths);
+            if (symbol < 0) return false;
+            if (symbol < 16) {
+                lengths[index++] = static_cast<short>(symbol);
+                continue;
+            }
+            short length = 0;
+            int repeat = 0;
+            if (symbol == 16) {
+                if (index == 0) return false;
+                length = lengths[index - 1];
+                repeat = 3 + Bits(2);
+            } else {
+                repeat = symbol == 17 ? 3 + Bits(3) : 11 + Bits(7);
+            }
+            if (index + repeat > literalCount + distanceCount) return false;
+            while (repeat--) lengths[index++] = length;
+        }
+        if (lengths[256] == 0) return false;
+        Huffman literals, distances;
+        if (!Build(literals, lengths, literalCount) || !Build(distances, lengths + literalCount, distanceCount)) {
+            return false;
+        }
+        return Codes(out, literals, distances);
+    }
+
+    std::string_view data_;
+    size_t pos_ = 0;
+    uint32_t bitBuffer_ = 0;
+    int bitCount_ = 0;
+    bool error_ = false;
+};
+
+// 解压gzip：检查头部、DEFLATE数据与尾部的CRC-32和长度
+bool Gunzip(std::string_view data, std::string& out, int* blocks = nullptr) {
+    if (data.size() < 18 || data.substr(0, 4) != std::string_view("\x1f\x8b\x08\x00", 4)) return false;
+    Inflater inflater(data.substr(10));
+    out.clear();
+    if (!inflater.Inflate(out)) return false;
+    size_t trailer = 10 + inflater.Offset();
+    if (trailer + 8 != data.size()) return false;
+    auto word = [&](size_t at) {
+        uint32_t value = 0;
+        for (int i = 3; i >= 0; --i) value = (value << 8) | static_cast<uint8_t>(data[at + i]);
+        return value;
+    };
+    if (blocks) std::copy(inflater.blocks, inflater.blocks + 3, blocks);
+    return word(trailer) == Crc32(out) && word(trailer + 4) == static_cast<uint32_t>(out.size());
+}
+
+// 类似源代码的文本(有重复也有变化)
+std::string MakeText(size_t size) {
+    std::mt19937 random(42);
+    const char* words[] = {"server", "request", "response", "header", "cache", "buffer", "socket", "engine",
+                           "return", "const", "std::string", "size_t", "if", "for", "while", "{", "}", ";"};
+    std::string text;
+    while (text.size() < size) {
+        text += words[random() % 18];
+        text += random() % 7 == 0 ? '\n' : ' ';
+        if (random() % 50 == 0) text += std::to_string(random());
+    }
+    text.resize(size);
+    return text;
+}
+
+std::string MakeRandom(size_t size, uint32_t seed) {
+    std::mt19937 random(seed);
+    std::string data(size, '\0');
+    for (auto& c : data) c = static_cast<char>(random());
+    return data;
+}
+
+// 固定的输入与参考输出(三种块各一个)：不依赖本文件的Inflater，双方相同的错误也能发现
+// 存储块：0到255各一个字节(没有重复，不压缩最小)
+std::string GoldenStoredInput() {
+    std::string input;
+    for (int i = 0; i < 256; ++i) input.push_back(static_cast<char>(i));
+    return input;
+}
+const std::string_view GOLDEN_FIXED_INPUT = "hello hello hello";
+const std::string_view GOLDEN_DYNAMIC_INPUT =
+    "GET /index.html HTTP/1.1\r\nHost: example.com\r\nAccept-Encoding: gzip, br\r\n"
+    "Connection: keep-alive\r\nAccept: text/html,application/xhtml+xml\r\n\r\n";
+
+// zlib生成的gzip流(级别0的存储块、Z_FIXED的固定编码块、默认的动态编码块)：校验Inflater本身
+const std::string_view ZLIB_STORED(
+    "\x1f\x8b\x08\x00\x00\x00\x00\x00\x04\x03\x01\x00\x01\xff\xfe\x00\x01\x02\x03\x04\x05\x06\x07\x08"
+    "\x09\x0a\x0b\x0c\x0d\x0e\x0f\x10\x11\x12\x13\x14\x15\x16\x17\x18\x19\x1a\x1b\x1c\x1d\x1e\x1f\x20"
+    "\x21\x22\x23\x24\x25\x26\x27\x28\x29\x2a\x2b\x2c\x2d\x2e\x2f\x30\x31\x32\x33\x34\x35\x36\x37\x38"
+    "\x39\x3a\x3b\x3c\x3d\x3e\x3f\x40\x41\x42\x43\x44\x45\x46\x47\x48\x49\x4a\x4b\x4c\x4d\x4e\x4f\x50"
+    "\x51\x52\x53\x54\x55\x56\x57\x58\x59\x5a\x5b\x5c\x5d\x5e\x5f\x60\x61\x62\x63\x64\x65\x66\x67\x68"
+    "\x69\x6a\x6b\x6c\x6d\x6e\x6f\x70\x71\x72\x73\x74\x75\x76\x77\x78\x79\x7a\x7b\x7c\x7d\x7e\x7f\x80"
+    "\x81\x82\x83\x84\x85\x86\x87\x88\x89\x8a\x8b\x8c\x8d\x8e\x8f\x90\x91\x92\x93\x94\x95\x96\x97\x98"
+    "\x99\x9a\x9b\x9c\x9d\x9e\x9f\xa0\xa1\xa2\xa3\xa4\xa5\xa6\xa7\xa8\xa9\xaa\xab\xac\xad\xae\xaf\xb0"
+    "\xb1\xb2\xb3\xb4\xb5\xb6\xb7\xb8\xb9\xba\xbb\xbc\xbd\xbe\xbf\xc0\xc1\xc2\xc3\xc4\xc5\xc6\xc7\xc8"
+    "\xc9\xca\xcb\xcc\xcd\xce\xcf\xd0\xd1\xd2\xd3\xd4\xd5\xd6\xd7\xd8\xd9\xda\xdb\xdc\xdd\xde\xdf\xe0"
+    "\xe1\xe2\xe3\xe4\xe5\xe6\xe7\xe8\xe9\xea\xeb\xec\xed\xee\xef\xf0\xf1\xf2\xf3\xf4\xf5\xf6\xf7\xf8"
+    "\xf9\xfa\xfb\xfc\xfd\xfe\xff\x73\x8c\x05\x29\x00\x01\x00\x00",
+    279);
+const std::string_view ZLIB_FIXED(
+    "\x1f\x8b\x08\x00\x00\x00\x00\x00\x02\x03\xcb\x48\xcd\xc9\xc9\x57\xc8\x40\x90\x00\x80\x88\xf9\xe5"
+    "\x11\x00\x00\x00",
+    28);
+const std::string_view ZLIB_DYNAMIC(
+    "\x1f\x8b\x08\x00\x00\x00\x00\x00\x02\x03\x35\x8d\x31\x0a\x02\x31\x10\x00\xfb\x40\xfe\xb0\xbd\x77"
+    "\x09\xd7\xa6\x13\x39\xbc\xd2\x22\x1f\x88\x7b\xcb\x19\x4c\x36\x8b\x2e\x12\x7c\xbd\xa4\xb0\x1d\x66"
+    "\x98\xeb\x1a\xc1\x67\xde\xa9\xbb\x87\xd6\x02\x5b\x8c\x37\xbf\xb8\xc5\x9a\xad\xbd\x35\x00\xf5\x54"
+    "\xa5\x90\xc3\x56\xad\x39\x23\x92\xe8\xbc\x32\xb6\x3d\xf3\x11\xe0\xf8\x66\x99\xe0\xfe\xb2\xe6\xd2"
+    "\x98\x09\x35\x37\x0e\xf0\x24\x92\x39\x95\xfc\xa1\x7f\x12\x40\xa9\xab\x1f\x87\x29\x89\x94\x8c\x69"
+    "\xa8\xbe\x0f\x72\xea\xb5\x58\x63\xcd\x0f\x8f\xfd\x95\x98\x8b\x00\x00\x00",
+    138);
+
+// 压缩器(默认级别)的输出，生成时已用系统的gzip -dc解压校验；
+// 压缩器的输出有意改变时须重新用gzip校验后更新
+const std::string_view EXPECTED_STORED(
+    "\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\xff\x01\x00\x01\xff\xfe\x00\x01\x02\x03\x04\x05\x06\x07\x08"
+    "\x09\x0a\x0b\x0c\x0d\x0e\x0f\x10\x11\x12\x13\x14\x15\x16\x17\x18\x19\x1a\x1b\x1c\x1d\x1e\x1f\x20"
+    "\x21\x22\x23\x24\x25\x26\x27\x28\x29\x2a\x2b\x2c\x2d\x2e\x2f\x30\x31\x32\x33\x34\x35\x36\x37\x38"
+    "\x39\x3a\x3b\x3c\x3d\x3e\x3f\x40\x41\x42\x43\x44\x45\x46\x47\x48\x49\x4a\x4b\x4c\x4d\x4e\x4f\x50"
+    "\x51\x52\x53\x54\x55\x56\x57\x58\x59\x5a\x5b\x5c\x5d\x5e\x5f\x60\x61\x62\x63\x64\x65\x66\x67\x68"
+    "\x69\x6a\x6b\x6c\x6d\x6e\x6f\x70\x71\x72\x73\x74\x75\x76\x77\x78\x79\x7a\x7b\x7c\x7d\x7e\x7f\x80"
+    "\x81\x82\x83\x84\x85\x86\x87\x88\x89\x8a\x8b\x8c\x8d\x8e\x8f\x90\x91\x92\x93\x94\x95\x96\x97\x98"
+    "\x99\x9a\x9b\x9c\x9d\x9e\x9f\xa0\xa1\xa2\xa3\xa4\xa5\xa6\xa7\xa8\xa9\xaa\xab\xac\xad\xae\xaf\xb0"
+    "\xb1\xb2\xb3\xb4\xb5\xb6\xb7\xb8\xb9\xba\xbb\xbc\xbd\xbe\xbf\xc0\xc1\xc2\xc3\xc4\xc5\xc6\xc7\xc8"
+    "\xc9\xca\xcb\xcc\xcd\xce\xcf\xd0\xd1\xd2\xd3\xd4\xd5\xd6\xd7\xd8\xd9\xda\xdb\xdc\xdd\xde\xdf\xe0"
+    "\xe1\xe2\xe3\xe4\xe5\xe6\xe7\xe8\xe9\xea\xeb\xec\xed\xee\xef\xf0\xf1\xf2\xf3\xf4\xf5\xf6\xf7\xf8"
+    "\xf9\xfa\xfb\xfc\xfd\xfe\xff\x73\x8c\x05\x29\x00\x01\x00\x00",
+    279);
+const std::string_view EXPECTED_FIXED(
+    "\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\xff\xcb\x48\xcd\xc9\xc9\x57\x40\x22\x01\x80\x88\xf9\xe5\x11"
+    "\x00\x00\x00",
+    27);
+const std::string_view EXPECTED_DYNAMIC(
+    "\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\xff\x35\x8d\x31\x0a\x02\x31\x10\x00\xfb\x40\xfe\xb0\xbd\x77"
+    "\x09\xd7\xa6\x13\x39\xbc\xd2\x22\x1f\x88\xb9\xe5\x5c\x4c\x36\x8b\x2e\x12\x7c\xbd\xa4\xb0\x1d\x66"
+    "\x98\xeb\x1a\xc1\x13\xef\xd8\xdd\x43\x6b\x81\x2d\xc6\x9b\x5f\xdc\x62\xcd\xd6\xde\x1a\x00\x7b\xaa"
+    "\x52\xd0\xe5\x56\xad\x39\xe7\x8c\xa2\xf3\xca\xb9\xed\xc4\x47\x80\xe3\x4b\x32\xc1\xfd\x65\xcd\xa5"
+    "\x31\x63\x56\x6a\x1c\xe0\x89\x28\x73\x2a\xf4\xc1\x7f\x12\x40\xb1\xab\x1f\x87\x29\x89\x14\xca\x69"
+    "\xa8\xbe\x0f\x72\xea\xb5\x58\x63\xcd\x0f\x8f\xfd\x95\x98\x8b\x00\x00\x00",
+    138);
+
+void TestCrc32() {
+    std::cout << "\n=== Test 1: CRC-32 ===" << std::endl;
+    assert(Crc32("") == 0);
+    assert(Crc32("123456789") == 0xcbf43926u);
+    std::string text = MakeText(10000);
+    assert(Crc32(std::string_view(text).substr(3000), Crc32(std::string_view(text).substr(0, 3000))) == Crc32(text));
+    std::cout << "Test passed!\n";
+}
+
+void TestRoundTrip() {
+    std::cout << "\n=== Test 2: Round Trip at Every Level ===" << std::endl;
+    std::string repeated = MakeRandom(30000, 7);
+    repeated += repeated;  // 距离接近窗口大小的匹配
+    const std::string inputs[] = {
+        std::string(), "a", "abcabcabcabcabcabc", MakeText(1000), MakeText(300000),
+        MakeRandom(100000, 1), std::string(200000, '\0'), repeated,
+    };
+    std::string out;
+    for (int level = 1; level <= 9; ++level) {
+        for (const auto& input : inputs) {
+            std::string compressed = GzipEncoder::Compress(input, level);
+            assert(Gunzip(compressed, out) && out == input);
+        }
+    }
+
+    // 文本至少压缩到1/3，随机数据只增加存储块的头部，重复的随机数据约为一半
+    std::string text = MakeText(300000);
+    size_t textSize = GzipEncoder::Compress(text).size();
+    size_t randomSize = GzipEncoder::Compress(inputs[5]).size();
+    size_t repeatedSize = GzipEncoder::Compress(repeated).size();
+    assert(textSize < text.size() / 3);
+    assert(randomSize <= inputs[5].size() + 64);
+    assert(repeatedSize < repeated.size() / 2 + 1024);
+    assert(GzipEncoder::Compress(text, 9).size() <= GzipEncoder::Compress(text, 1).size());
+    std::cout << "text " << text.size() << " -> " << textSize << ", random " << inputs[5].size() << " -> "
+              << randomSize << ", repeated " << repeated.size() << " -> " << repeatedSize << std::endl;
+    std::cout << "Test passed!\n";
+}
+
+void TestBlockTypes() {
+    std::cout << "\n=== Test 3: Block Type Selection ===" << std::endl;
+    // 每块在动态编码、固定编码与存储块之间取最小者
+    std::string out;
+    int blocks[3];
+    assert(Gunzip(GzipEncoder::Compress(MakeRandom(100000, 2)), out, blocks));
+    assert(blocks[0] > 0 && blocks[2] == 0);
+    assert(Gunzip(GzipEncoder::Compress(MakeText(100000)), out, blocks));
+    assert(blocks[2] > 0 && blocks[0] == 0);
+    assert(Gunzip(GzipEncoder::Compress("hello hello hello"), out, blocks));
+    assert(blocks[1] == 1 && blocks[0] == 0 && blocks[2] == 0);
+    std::cout << "Test passed!\n";
+}
+
+void TestStreaming() {
+    std::cout << "\n=== Test 4: Streaming with Sync Flush ===" << std::endl;
+    std::string input = MakeText(200000) + MakeRandom(50000, 3) + MakeText(100000);
+    const size_t chunkSizes[] = {1, 7, 1000, 65536, 70000};
+    for (size_t chunkSize : chunkSizes) {
+        GzipEncoder encoder;
+        std::string compressed;
+        size_t written = 0;
+        int flushes = 0;
+        while (written < input.size()) {
+            size_t n = std::min(chunkSize, input.size() - written);
+            encoder.Write(std::string_view(input).substr(written, n), compressed);
+            written += n;
+            if (written % 50000 < n || written == input.size()) {
+                // 刷新后目前为止的输出可以完整解码出已写入的全部数据
+                encoder.Flush(compressed);
+                std::string partial;
+                Inflater inflater(std::string_view(compressed).substr(10));
+                assert(inflater.Inflate(partial, true) && partial == input.substr(0, written));
+                ++flushes;
+            }
+        }
+        assert(encoder.BytesIn() == input.size());
+        encoder.Finish(compressed);
+        encoder.Finish(compressed);  // 重复结束不输出任何内容
+        std::string out;
+        assert(Gunzip(compressed, out) && out == input);
+        assert(flushes > 1 && compressed.size() < GzipEncoder::Compress(input).size() * 11 / 10);
+    }
+
+    // 没有写入任何数据时也输出完整的gzip流
+    GzipEncoder empty;
+    std::string compressed;
+    empty.Finish(compressed);
+    std::string out = "x";
+    assert(Gunzip(compressed, out) && out.empty());
+    std::cout << "Test passed!\n";
+}
+
+void TestGoldenVectors() {
+    std::cout << "\n=== Test 5: Golden Vectors ===" << std::endl;
+    std::string stored = GoldenStoredInput();
+    struct Vector {
+        std::string_view input;
+        std::string_view reference;  // zlib的输出
+        std::string_view expected;   // 压缩器的输出
+        int type;                    // 块类型
+    };
+    const Vector vectors[] = {
+        {stored, ZLIB_STORED, EXPECTED_STORED, 0},
+        {GOLDEN_FIXED_INPUT, ZLIB_FIXED, EXPECTED_FIXED, 1},
+        {GOLDEN_DYNAMIC_INPUT, ZLIB_DYNAMIC, EXPECTED_DYNAMIC, 2},
+    };
+    for (const Vector& vector : vectors) {
+        // 测试用的Inflater正确解码另一个实现生成的各类块
+        std::string out;
+        int blocks[3];
+        assert(Gunzip(vector.reference, out, blocks) && out == vector.input);
+        assert(blocks[vector.type] == 1 && blocks[0] + blocks[1] + blocks[2] == 1);
+
+        // 压缩器的输出与经过gzip校验的字节完全相同
+        assert(GzipEncoder::Compress(vector.input) == vector.expected);
+        assert(Gunzip(vector.expected, out, blocks) && out == vector.input && blocks[vector.type] == 1);
+    }
+    std::cout << "Test passed!\n";
+}
+
+int main() {
+    TestCrc32();
+    TestRoundTrip();
+    TestBlockTypes();
+    TestStreaming();
+    TestGoldenVectors();
+    std::cout << "\n=== All tests passed ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include "http_conditional.hpp"
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+// 只设置常用头的请求
+HttpRequest MakeRequest(KnownHeader id, std::string_view value) {
+    HttpRequest request;
+    request.method = HttpMethod::GET;
+    request.known[static_cast<size_t>(id)] = value;
+    return request;
+}
+
+void TestValidators() {
+    std::cout << "\n=== Test 1: ETag and Last-Modified ===" << std::endl;
+    auto mtime = fs::file_time_type::clock::now();
+    Validators a = MakeValidators(1234, mtime);
+    Validators b = MakeValidators(1234, mtime);
+    Validators c = MakeValidators(1235, mtime);
+    Validators d = MakeValidators(1234, mtime + std::chrono::nanoseconds(1));
+    assert(a.ETag() == b.ETag() && a.ETag() != c.ETag() && a.ETag() != d.ETag());
+    assert(a.ETag().front() == '"' && a.ETag().back() == '"' && a.ETag().substr(1, 4) == "4d2-");
+    // 压缩的表示有自己的ETag(附加编码名称)，Last-Modified不变
+    Validators gzip = MakeValidators(1234, mtime, "gzip");
+    assert(gzip.ETag().size() == a.ETag().size() + 5 && gzip.ETag().substr(0, a.etagSize - 1) ==
+           a.ETag().substr(0, a.etagSize - 1) && gzip.ETag().substr(a.etagSize - 1) == "-gzip\"");
+    assert(gzip.LastModified() == a.LastModified());
+    Validators longest = MakeValidators(UINT64_MAX, fs::file_time_type::max(), "gzip");
+    assert(longest.etagSize <= ETAG_MAX);
+
+    // Last-Modified与修改时间(秒)一致，并且可以解析回来
+    auto parsed = ParseHttpDate(a.LastModified());
+    assert(parsed && *parsed == a.modified);
+    std::time_t now = std::time(nullptr);
+    assert(a.modified >= now - 5 && a.modified <= now + 5);
+    std::cout << "etag " << a.ETag() << ", last-modified " << a.LastModified() << std::endl;
+    std::cout << "Test passed!\n";
+}
+
+void TestHttpDate() {
+    std::cout << "\n=== Test 2: HTTP Dates ===" << std::endl;
+    assert(ParseHttpDate("Sun, 06 Nov 1994 08:49:37 GMT") == std::time_t(784111777));
+    assert(ParseHttpDate("Thu, 01 Jan 1970 00:00:00 GMT") == std::time_t(0));
+    assert(ParseHttpDate("Tue, 29 Feb 2028 23:59:59 GMT") == std::time_t(1835481599));
+    char text[HTTP_DATE_SIZE];
+    for (std::time_t t : {std::time_t(0), std::time_t(951782400), std::time_t(1700000000), std::time_t(4102444799)}) {
+        FormatHttpDate(t, text);
+        assert(ParseHttpDate(std::string_view(text, sizeof(text))) == t);
+    }
+    // 只接受IMF-fixdate
+    assert(!ParseHttpDate("Sunday, 06-Nov-94 08:49:37 GMT"));
+    assert(!ParseHttpDate("Sun Nov  6 08:49:37 1994"));
+    assert(!ParseHttpDate("Sun, 06 Nox 1994 08:49:37 GMT"));
+    assert(!ParseHttpDate("Sun, 06 Nov 1994 08:49:37 UTC"));
+    assert(!ParseHttpDate("Sun, 0x Nov 1994 08:49:37 GMT"));
+    assert(!ParseHttpDate(""));
+    std::cout << "Test passed!\n";
+}
+
+void TestConditional() {
+    std::cout << "\n=== Test 3: Conditional Requests ===" << std::endl;
+    Validators v = MakeValidators(100, fs::file_time_type::clock::now());
+    std::string etag(v.ETag());
+    std::string weak = "W/" + etag;
+    std::string list = "\"other\", " + weak + " ,\"x\"";
+    std::string lastModified(v.LastModified());
+
+    assert(!NotModified(HttpRequest(), v));
+    assert(NotModified(MakeRequest(KnownHeader::IF_NONE_MATCH, etag), v));
+    assert(NotModified(MakeRequest(KnownHeader::IF_NONE_MATCH, weak), v));  // 弱比较
+    assert(NotModified(MakeRequest(KnownHeader::IF_NONE_MATCH, list), v));
+    assert(NotModified(MakeRequest(KnownHeader::IF_NONE_MATCH, "*"), v));
+    assert(!NotModified(MakeRequest(KnownHeader::IF_NONE_MATCH, "\"other\""), v));
+
+    assert(NotModified(MakeRequest(KnownHeader::IF_MODIFIED_SINCE, lastModified), v));
+    assert(NotModified(MakeRequest(KnownHeader::IF_MODIFIED_SINCE, "Fri, 31 Dec 9999 23:59:59 GMT"), v));
+    assert(!NotModified(MakeRequest(KnownHeader::IF_MODIFIED_SINCE, "Sun, 06 Nov 1994 08:49:37 GMT"), v));
+    assert(!NotModified(MakeRequest(KnownHeader::IF_MODIFIED_SINCE, "yesterday"), v));
+
+    // If-None-Match存在时忽略If-Modified-Since
+    HttpRequest both = MakeRequest(KnownHeader::IF_NONE_MATCH, "\"other\"");
+    both.known[static_cast<size_t>(KnownHeader::IF_MODIFIED_SINCE)] = lastModified;
+    assert(!NotModified(both, v));
+
+    // If-Range：ETag强匹配或日期相同
+    assert(IfRangeMatches(HttpRequest(), v));
+    assert(IfRangeMatches(MakeRequest(KnownHeader::IF_RANGE, etag), v));
+    assert(!IfRangeMatches(MakeRequest(KnownHeader::IF_RANGE, weak), v));
+    assert(!IfRangeMatches(MakeRequest(KnownHeader::IF_RANGE, "\"other\""), v));
+    assert(IfRangeMatches(MakeRequest(KnownHeader::IF_RANGE, lastModified), v));
+    assert(!IfRangeMatches(MakeRequest(KnownHeader::IF_RANGE, "Sun, 06 Nov 1994 08:49:37 GMT"), v));
+    std::cout << "Test passed!\n";
+}
+
+void TestRanges() {
+    std::cout << "\n=== Test 4: Byte Ranges ===" << std::endl;
+    RangeSet r;
+    auto is = [&r](size_t i, uint64_t offset, uint64_t length) {
+        return r.ranges[i].offset == offset && r.ranges[i].length == length;
+    };
+
+    assert(ParseRange("bytes=0-499", 1000, r) == RangeStatus::PARTIAL && r.count == 1 && is(0, 0, 500));
+    assert(ParseRange("bytes=500-", 1000, r) == RangeStatus::PARTIAL && is(0, 500, 500));
+    assert(ParseRange("bytes=-200", 1000, r) == RangeStatus::PARTIAL && is(0, 800, 200));
+    assert(ParseRange("bytes=-5000", 1000, r) == RangeStatus::PARTIAL && is(0, 0, 1000));
+    assert(ParseRange("bytes=900-5000", 1000, r) == RangeStatus::PARTIAL && is(0, 900, 100));  // 截断到文件末尾
+    assert(ParseRange("bytes=0-0, 100-199 ,-1", 1000, r) == RangeStatus::PARTIAL && r.count == 3 &&
+           is(0, 0, 1) && is(1, 100, 100) && is(2, 999, 1));
+    // 相距较远的范围保持请求的顺序；重叠、重复或相近的范围合并(按起点排序)
+    assert(ParseRange("bytes=500-599,0-99", 1000, r) == RangeStatus::PARTIAL && r.count == 2 &&
+           is(0, 500, 100) && is(1, 0, 100));
+    std::string repeated = "bytes=0-";
+    for (size_t i = 1; i < MAX_RANGES; ++i) repeated += ",0-";
+    assert(ParseRange(repeated, 1000, r) == RangeStatus::PARTIAL && r.count == 1 && is(0, 0, 1000));
+    assert(ParseRange("bytes=500-599,0-99,50-149,-1", 1000, r) == RangeStatus::PARTIAL && r.count == 3 &&
+           is(0, 0, 150) && is(1, 500, 100) && is(2, 999, 1));
+    assert(ParseRange("bytes=0-9,20-29", 1000, r) == RangeStatus::PARTIAL && r.count == 1 && is(0, 0, 30));
+    assert(ParseRange("bytes=-1,0-", 1000, r) == RangeStatus::PARTIAL && r.count == 1 && is(0, 0, 1000));
+    assert(ParseRange("bytes=,0-1,,", 1000, r) == RangeStatus::PARTIAL && r.count == 1);
+    // 不可满足的范围被跳过，全部不可满足时416
+    assert(ParseRange("bytes=2000-,0-9", 1000, r) == RangeStatus::PARTIAL && r.count == 1 && is(0, 0, 10));
+    assert(ParseRange("bytes=1000-", 1000, r) == RangeStatus::UNSATISFIABLE);
+    assert(ParseRange("bytes=-0", 1000, r) == RangeStatus::UNSATISFIABLE);
+    assert(ParseRange("bytes=0-", 0, r) == RangeStatus::UNSATISFIABLE);
+    // 格式错误、其他单位或范围过多时忽略
+    assert(ParseRange("", 1000, r) == RangeStatus::NONE);
+    assert(ParseRange("bytes=", 1000, r) == RangeStatus::NONE);
+    assert(ParseRange("items=0-1", 1000, r) == RangeStatus::NONE);
+    assert(ParseRange("bytes=5-1", 1000, r) == RangeStatus::NONE);
+    assert(ParseRange("bytes=abc", 1000, r) == RangeStatus::NONE);
+    assert(ParseRange("bytes=1-2x", 1000, r) == RangeStatus::NONE);
+    assert(ParseRange("bytes=0-1,99999999999999999999-", 1000, r) == RangeStatus::NONE);
+    std::string many = "bytes=0-0";
+    for (size_t i = 1; i <= MAX_RANGES; ++i) many += "," + std::to_string(i) + "-" + std::to_string(i);
+    assert(ParseRange(many, 1000, r) == RangeStatus::NONE);
+    std::cout << "Test passed!\n";
+}
+
+int main() {
+    TestValidators();
+    TestHttpDate();
+    TestConditional();
+    TestRanges();
+    std::cout << "\n=== All tests passed ===" << std::endl;
+    return 0;
+}
@@ -78,6 +78,127 @@ int main() {
         "INVALID REQUEST\r\n", 
         false);
     
+    // 增量解析：逐字节到达，解析器从断点继续
+    {
+        std::string request =
+            "POST /upload HTTP/1.1\r\n"
+            "Content-Length: 5\r\n"
+            "\r\n"
+            "abcde";
+        HttpParser parser;
+        ParseStatus result = ParseStatus::INCOMPLETE;
+        for (size_t n = 1; n <= request.size(); ++n) {
+            result = parser.parse(request.c_str(), n);
+            assert(n == request.size() || result == ParseStatus::INCOMPLETE);
+        }
+        assert(result == ParseStatus::SUCCESS);
+        assert(parser.consumed() == request.size());
+        assert(parser.request().body == "abcde");
+        assert(parser.request().header(KnownHeader::CONTENT_LENGTH) == "5");
+        assert(parser.request().header("content-length") == "5");
+        std::cout << "[PASS] 6. Byte-by-byte resume\n";
+    }
+
+    // 流水线：消费第一个请求后保留剩余字节
+    {
+        std::string first = "GET /a HTTP/1.1\r\nHost: x\r\n\r\n";
+        std::string buffer = first + "GET /b HTTP/1.1\r\n";
+        HttpParser parser;
+        assert(parser.parse(buffer.c_str(), buffer.size()) == ParseStatus::SUCCESS);
+        assert(parser.consumed() == first.size());
+        assert(parser.request().uri == "/a");
+
+        buffer.erase(0, parser.consumed());
+        parser.reset();
+        assert(parser.parse(buffer.c_str(), buffer.size()) == ParseStatus::INCOMPLETE);
+        buffer += "\r\n";
+        assert(parser.parse(buffer.c_str(), buffer.size()) == ParseStatus::SUCCESS);
+        assert(parser.request().uri == "/b");
+        std::cout << "[PASS] 7. Leftover bytes kept for next request\n";
+    }
+
+    // 常用头索引：分段到达且缓冲区在两次解析之间扩容，视图仍指向最终缓冲区
+    {
+        std::string buffer = "GET /img.png HTTP/1.1\r\nHost:  example.com \r\nX-Custom: 1\r\n";
+        HttpParser parser;
+        assert(parser.parse(buffer.c_str(), buffer.size()) == ParseStatus::INCOMPLETE);
+        buffer += "Range: bytes=0-99\r\n\r\n";
+        buffer.reserve(buffer.size() * 4);
+        assert(parser.parse(buffer.c_str(), buffer.size()) == ParseStatus::SUCCESS);
+        const auto& req = parser.request();
+        assert(req.headerCount == 3);
+        assert(req.header(KnownHeader::HOST) == "example.com");
+        assert(req.header(KnownHeader::RANGE) == "bytes=0-99");
+        assert(req.header(KnownHeader::IF_NONE_MATCH).empty());
+        assert(req.header("x-custom") == "1");
+        assert(req.uri.data() == buffer.c_str() + 4);
+        std::cout << "[PASS] 8. Known headers indexed by enum\n";
+    }
+
+    // 只解析请求头：请求体留给调用者读取
+    {
+        std::string buffer = "POST /upload HTTP/1.1\r\nContent-Length: 5\r\n\r\nhel";
+        HttpParser parser;
+        assert(parser.parseHeader(buffer.c_str(), buffer.size()) == ParseStatus::SUCCESS);
+        assert(parser.request().uri == "/upload" && parser.request().body.empty());
+        assert(parser.contentLength() == 5);
+        assert(buffer.compare(parser.consumed(), std::string::npos, "hel") == 0);
+        parser.reset();
+        assert(parser.parse(buffer.c_str(), buffer.size()) == ParseStatus::INCOMPLETE);
+        std::cout << "[PASS] 9. Header-only parsing leaves the body\n";
+    }
+
+    // 重复的Content-Length：值相同时接受，相互矛盾时拒绝(否则可能被用来走私流水线中的请求)
+    run_test("10. Duplicate identical Content-Length",
+        "POST /submit HTTP/1.1\r\n"
+        "Content-Length: 5\r\n"
+        "content-length: 5\r\n"
+        "\r\n"
+        "hello",
+        true);
+    run_test("11. Conflicting Content-Length",
+        "POST /submit HTTP/1.1\r\n"
+        "Content-Length: 5\r\n"
+        "Content-Length: 0\r\n"
+        "\r\n"
+        "hello",
+        false);
+    {
+        // 第一个值为0也算已出现；reset之后重新开始
+        std::string conflicting = "POST /a HTTP/1.1\r\nContent-Length: 0\r\nContent-Length: 3\r\n\r\nabc";
+        HttpParser parser;
+        assert(parser.parse(conflicting.c_str(), conflicting.size()) == ParseStatus::FAILED);
+        parser.reset();
+        std::string single = "POST /a HTTP/1.1\r\nContent-Length: 3\r\n\r\nabc";
+        assert(parser.parse(single.c_str(), single.size()) == ParseStatus::SUCCESS);
+        assert(parser.request().body == "abc");
+        std::cout << "[PASS] 12. Conflicting Content-Length after zero\n";
+    }
+
+    // Transfer-Encoding：请求体的边界不能按Content-Length确定，不能把请求体当作下一个请求解析
+    {
+        std::string chunked = "POST /a.txt HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                              "1c\r\nGET /index.html HTTP/1.1\r\n\r\n\r\n0\r\n\r\n";
+        HttpParser parser;
+        assert(parser.parse(chunked.c_str(), chunked.size()) == ParseStatus::UNSUPPORTED);
+        parser.reset();
+        assert(parser.parseHeader(chunked.c_str(), chunked.size()) == ParseStatus::UNSUPPORTED);
+
+        // 与Content-Length同时出现(不论顺序)：格式错误
+        std::string both = "POST /a HTTP/1.1\r\nContent-Length: 3\r\ntransfer-encoding: chunked\r\n\r\nabc";
+        parser.reset();
+        assert(parser.parse(both.c_str(), both.size()) == ParseStatus::FAILED);
+        both = "POST /a HTTP/1.1\r\nTransfer-Encoding: chunked\r\nContent-Length: 3\r\n\r\nabc";
+        parser.reset();
+        assert(parser.parse(both.c_str(), both.size()) == ParseStatus::FAILED);
+
+        // reset之后不再记得之前的Transfer-Encoding
+        std::string plain = "GET /a HTTP/1.1\r\n\r\n";
+        parser.reset();
+        assert(parser.parse(plain.c_str(), plain.size()) == ParseStatus::SUCCESS);
+        std::cout << "[PASS] 13. Transfer-Encoding rejected\n";
+    }
+
     std::cout << "\nAll tests completed!\n";
     return 0;
 }
\ No newline at end of file
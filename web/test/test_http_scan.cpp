@@ -0,0 +1,91 @@
+#include "http_scan.hpp"
+#include "http_parser.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+
+// 所有实现级别必须与标量实现给出相同结果
+void test_levels_agree() {
+    const ScanLevel levels[] = {ScanLevel::SCALAR, ScanLevel::SSE42, ScanLevel::AVX2};
+    const ScanClass classes[] = {ScanClass::TOKEN, ScanClass::URI, ScanClass::HEADER_VALUE};
+    // 偏向于HTTP中常见字符，同时覆盖所有字节值
+    const std::string common = "abcXYZ019-_.~|:;/ \t\r\n\"{}@";
+    std::mt19937 rng(12345);
+
+    for (int round = 0; round < 2000; ++round) {
+        size_t length = rng() % 100;
+        std::string data(length, 'a');
+        for (auto& c : data) {
+            int pick = rng() % 64;
+            if (pick == 0) c = static_cast<char>(rng() % 256);
+            else if (pick < 8) c = common[rng() % common.size()];
+        }
+
+        for (auto cls : classes) {
+            SetScanLevel(ScanLevel::SCALAR);
+            size_t expected = ScanSpan(data.data(), data.size(), cls);
+            for (auto level : levels) {
+                if (!SetScanLevel(level)) continue;
+                size_t got = ScanSpan(data.data(), data.size(), cls);
+                if (got != expected) {
+                    std::cout << "[FAIL] " << ScanLevelName(level) << " returned " << got
+                              << ", expected " << expected << std::endl;
+                    assert(false);
+                }
+            }
+        }
+    }
+    std::cout << "[PASS] All scan levels agree with scalar" << std::endl;
+}
+
+// 字符类别的边界
+void test_class_boundaries() {
+    SetScanLevel(ScanLevel::SCALAR);
+    std::string name = std::string(40, 'a') + "|~!:";
+    assert(ScanSpan(name.data(), name.size(), ScanClass::TOKEN) == 43);  // |和~是tchar
+    std::string uri = "/path?q=%20&x=\x80\xff HTTP";
+    assert(ScanSpan(uri.data(), uri.size(), ScanClass::URI) == uri.find(' '));
+    std::string value = "gzip,\tdeflate\x01\r\n";
+    assert(ScanSpan(value.data(), value.size(), ScanClass::HEADER_VALUE) == value.find('\x01'));
+    std::cout << "[PASS] Class boundaries" << std::endl;
+}
+
+// 各实现下解析结果相同
+void test_parser_on_each_level() {
+    std::string request =
+        "GET /search?q=simd&lang=zh HTTP/1.1\r\n"
+        "Host: example.com\r\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko)\r\n"
+        "Accept-Encoding: gzip, deflate, br\r\n"
+        "X-Request-Id: 7f9c2ba4-e88f-11ee-a951-0242ac120002\r\n"
+        "\r\n";
+    const ScanLevel levels[] = {ScanLevel::SCALAR, ScanLevel::SSE42, ScanLevel::AVX2};
+    for (auto level : levels) {
+        if (!SetScanLevel(level)) continue;
+        HttpParser parser;
+        assert(parser.parse(request.data(), request.size()) == ParseStatus::SUCCESS);
+        const auto& req = parser.request();
+        assert(req.uri == "/search?q=simd&lang=zh");
+        assert(req.headerCount == 4);
+        assert(req.header(KnownHeader::ACCEPT_ENCODING) == "gzip, deflate, br");
+        assert(req.header("x-request-id") == "7f9c2ba4-e88f-11ee-a951-0242ac120002");
+
+        // 头名称含非法字符
+        std::string bad = "GET / HTTP/1.1\r\nBad Header: x\r\n\r\n";
+        parser.reset();
+        assert(parser.parse(bad.data(), bad.size()) == ParseStatus::FAILED);
+        std::cout << "[PASS] Parser on " << ScanLevelName(level) << std::endl;
+    }
+}
+
+int main() {
+    std::cout << "Starting HTTP scan tests (detected: " << ScanLevelName(GetScanLevel()) << ")\n";
+    ScanLevel detected = GetScanLevel();
+    test_levels_agree();
+    test_class_boundaries();
+    test_parser_on_each_level();
+    SetScanLevel(detected);
+    std::cout << "\nAll tests completed!\n";
+    return 0;
+}
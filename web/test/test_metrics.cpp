@@ -0,0 +1,68 @@
+#include "metrics.hpp"
+#include <cassert>
+#include <iostream>
+
+void TestBuckets() {
+    std::cout << "\n=== Test 1: Histogram Buckets ===" << std::endl;
+    // 小值各占一个桶，之后的桶按顺序首尾相接
+    for (uint64_t v = 0; v < 16; ++v) {
+        assert(LatencyHistogram::BucketOf(v) == v);
+    }
+    for (size_t b = 0; b + 1 < LatencyHistogram::BUCKETS; ++b) {
+        uint64_t upper = LatencyHistogram::BucketUpperBound(b);
+        assert(LatencyHistogram::BucketOf(upper) == b);
+        assert(LatencyHistogram::BucketOf(upper + 1) == b + 1);
+    }
+    assert(LatencyHistogram::BucketOf(UINT64_MAX) == LatencyHistogram::BUCKETS - 1);
+    assert(LatencyHistogram::BucketUpperBound(LatencyHistogram::BUCKETS - 1) == UINT64_MAX);
+
+    // 相对误差不超过1/16
+    for (uint64_t v = 16; v < (uint64_t(1) << 40); v = v * 3 + 7) {
+        uint64_t upper = LatencyHistogram::BucketUpperBound(LatencyHistogram::BucketOf(v));
+        assert(upper >= v && upper - v <= v / 16);
+    }
+    std::cout << "Test passed!\n";
+}
+
+void TestSnapshot() {
+    std::cout << "\n=== Test 2: Snapshot ===" << std::endl;
+    ThreadMetrics a;
+    ThreadMetrics b;
+    for (int i = 1; i <= 990; ++i) a.RecordRequest(200, std::chrono::microseconds(100));
+    for (int i = 1; i <= 10; ++i) b.RecordRequest(404, std::chrono::milliseconds(50));
+    b.RecordRequest(418, std::chrono::microseconds(100));
+    a.accepts.Add(3);
+    b.closes.Add();
+    b.shed.Add(4);
+    a.overloads.Add(2);
+    a.recoveries.Add();
+
+    MetricsSnapshot snapshot;
+    snapshot.Add(a);
+    snapshot.Add(b);
+    assert(snapshot.requests[0] == 990 && snapshot.requests[4] == 10 && snapshot.requests[STATUS_SLOTS - 1] == 1);
+    assert(snapshot.latency.count == 1001);
+
+    uint64_t p50 = snapshot.latency.Percentile(0.5);
+    uint64_t p999 = snapshot.latency.Percentile(0.999);
+    assert(p50 >= 100000 && p50 <= 100000 + 100000 / 16);
+    assert(p999 >= 50000000 && p999 <= 50000000 + 50000000 / 16);
+    assert(snapshot.latency.Max() == p999);
+
+    std::string text;
+    snapshot.WritePrometheus(text);
+    assert(text.find("web_connections_active 2\n") != std::string::npos);
+    assert(text.find("web_requests_shed_total 4\n") != std::string::npos);
+    assert(text.find("web_overloaded_loops 1\n") != std::string::npos);
+    assert(text.find("web_requests_total{status=\"404\"} 10\n") != std::string::npos);
+    assert(text.find("web_request_duration_seconds_bucket{le=\"+Inf\"} 1001\n") != std::string::npos);
+    assert(text.find("web_request_duration_seconds_count 1001\n") != std::string::npos);
+    std::cout << "Test passed!\n";
+}
+
+int main() {
+    TestBuckets();
+    TestSnapshot();
+    std::cout << "\n=== All tests passed ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include "overload.hpp"
+#include <cassert>
+#include <iostream>
+
+using namespace std::chrono_literals;
+
+void TestQueueDelay() {
+    std::cout << "\n=== Test 1: Queue Delay ===" << std::endl;
+    OverloadDetector detector(100ms, 0ms);
+    detector.RecordQueueDelay(80ms);
+    assert(!detector.Overloaded());
+    detector.RecordQueueDelay(150ms);
+    assert(detector.Overloaded());
+
+    // 滞回：回落到阈值以下但未低于一半时保持过载
+    detector.RecordQueueDelay(70ms);
+    assert(detector.Overloaded());
+    detector.RecordQueueDelay(40ms);
+    assert(!detector.Overloaded());
+
+    // 阈值为0时不参与判断
+    detector.RecordServiceTime(10s);
+    assert(!detector.Overloaded());
+    std::cout << "Test passed!\n";
+}
+
+void TestServiceTime() {
+    std::cout << "\n=== Test 2: Service Time ===" << std::endl;
+    OverloadDetector detector(100ms, 10ms);
+    // 单个慢请求只把平均值推高1/8
+    detector.RecordServiceTime(40ms);
+    assert(!detector.Overloaded() && detector.ServiceTime() == 5ms);
+    for (int i = 0; i < 10; ++i) detector.RecordServiceTime(40ms);
+    assert(detector.Overloaded());
+
+    // 快速拒绝的请求使平均值回落，退出过载
+    int fast = 0;
+    while (detector.Overloaded()) {
+        detector.RecordServiceTime(1us);
+        ++fast;
+    }
+    assert(fast > 1 && detector.ServiceTime() < 5ms);
+
+    // 任一信号超过阈值即过载
+    detector.RecordQueueDelay(200ms);
+    assert(detector.Overloaded());
+    std::cout << "Test passed!\n";
+}
+
+int main() {
+    TestQueueDelay();
+    TestServiceTime();
+    std::cout << "\n=== All tests passed ===" << std::endl;
+    return 0;
+}
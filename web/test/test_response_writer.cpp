@@ -0,0 +1,60 @@
+#include "response_writer.hpp"
+#include <cassert>
+#include <iostream>
+
+void TestHttpDate() {
+    std::cout << "\n=== Test 1: HTTP Date ===" << std::endl;
+    char date[HTTP_DATE_SIZE];
+    FormatHttpDate(784111777, date);  // RFC 9110中的示例
+    assert(std::string_view(date, HTTP_DATE_SIZE) == "Sun, 06 Nov 1994 08:49:37 GMT");
+    FormatHttpDate(0, date);
+    assert(std::string_view(date, HTTP_DATE_SIZE) == "Thu, 01 Jan 1970 00:00:00 GMT");
+
+    // 同一秒内返回同一个缓冲区
+    const auto& line = DateHeaderLine();
+    assert(line->size() == DATE_LINE_SIZE);
+    assert(line->compare(0, 6, "Date: ") == 0 && line->compare(DATE_LINE_SIZE - 2, 2, "\r\n") == 0);
+    std::cout << "Test passed!\n";
+}
+
+void TestHeaders() {
+    std::cout << "\n=== Test 2: Headers ===" << std::endl;
+    char buffer[RESPONSE_HEADER_BUFFER];
+    ResponseWriter writer(buffer, sizeof(buffer));
+    writer.StatusLine(404);
+    writer.ContentType("text/plain");
+    writer.ContentLength(18446744073709551615ull);
+    writer.KeepAlive();
+    writer.Header("X-Test", "1");
+    writer.End();
+    assert(writer.Ok());
+    assert(writer.View() ==
+           "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\nContent-Length: 18446744073709551615\r\n"
+           "Connection: keep-alive\r\nX-Test: 1\r\n\r\n");
+
+    // 没有常量片段的状态码只写数字
+    ResponseWriter other(buffer, sizeof(buffer));
+    other.StatusLine(418);
+    assert(other.View() == "HTTP/1.1 418 \r\n");
+    std::cout << "Test passed!\n";
+}
+
+void TestOverflow() {
+    std::cout << "\n=== Test 3: Overflow ===" << std::endl;
+    char buffer[20];
+    ResponseWriter writer(buffer, sizeof(buffer));
+    writer.StatusLine(200);
+    assert(writer.Ok() && writer.Size() == 17);
+    writer.ContentLength(12345);
+    writer.End();  // 溢出后的写入都被忽略
+    assert(!writer.Ok() && writer.Size() == 17);
+    std::cout << "Test passed!\n";
+}
+
+int main() {
+    TestHttpDate();
+    TestHeaders();
+    TestOverflow();
+    std::cout << "\n=== All tests passed ===" << std::endl;
+    return 0;
+}
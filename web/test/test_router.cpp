@@ -0,0 +1,107 @@
+#include "router.hpp"
+#include "static_map.hpp"
+#include "mime.hpp"
+#include <cassert>
+#include <iostream>
+#include <string>
+
+void TestStaticMap() {
+    std::cout << "\n=== Test 1: Static Perfect Hash Map ===" << std::endl;
+    static constexpr auto MAP = MakeStaticMap<int>({
+        {"alpha", 1}, {"beta", 2}, {"gamma", 3}, {"delta", 4}, {"epsilon", 5},
+    });
+    // 构建与查找都可以在编译期完成
+    static_assert(*MAP.Find("gamma") == 3);
+    static_assert(MAP.Find("zeta") == nullptr);
+    static_assert(decltype(MAP)::Slots() == 32);
+
+    const char* keys[] = {"alpha", "beta", "gamma", "delta", "epsilon"};
+    for (int i = 0; i < 5; ++i) {
+        std::string key = keys[i];  // 运行时的键
+        assert(MAP.Find(key) && *MAP.Find(key) == i + 1);
+    }
+    assert(!MAP.Find("") && !MAP.Find("alph") && !MAP.Find("alphaa") && !MAP.Find("Alpha"));
+
+    // 运行时的哈希(整字加载)与编译期的(逐字节)一致：覆盖1到20字节的各种尾部长度
+    static constexpr auto LENGTHS = MakeStaticMap<size_t>({
+        {"a", 1}, {"ab", 2}, {"abc", 3}, {"abcd", 4}, {"abcde", 5}, {"abcdef", 6}, {"abcdefg", 7},
+        {"abcdefgh", 8}, {"abcdefghi", 9}, {"abcdefghij", 10}, {"abcdefghijk", 11}, {"abcdefghijkl", 12},
+        {"abcdefghijklm", 13}, {"abcdefghijklmn", 14}, {"abcdefghijklmno", 15}, {"abcdefghijklmnop", 16},
+        {"abcdefghijklmnopq", 17}, {"abcdefghijklmnopqr", 18}, {"abcdefghijklmnopqrs", 19},
+        {"abcdefghijklmnopqrst", 20},
+    });
+    std::string alphabet = "abcdefghijklmnopqrstuvwxyz";
+    for (size_t length = 1; length <= 20; ++length) {
+        std::string key = alphabet.substr(0, length);
+        assert(LENGTHS.Find(key) && *LENGTHS.Find(key) == length);
+        key.back() = 'Z';
+        assert(!LENGTHS.Find(key));
+    }
+    std::cout << "Test passed!\n";
+}
+
+void TestMimeType() {
+    std::cout << "\n=== Test 2: MIME Types ===" << std::endl;
+    assert(MimeType("/index.html") == "text/html");
+    assert(MimeType("/app.js") == "application/javascript");
+    assert(MimeType("/style.CSS") == "text/css");              // 不区分大小写
+    assert(MimeType("/photos/cat.JPeG") == "image/jpeg");
+    assert(MimeType("/fonts/a.woff2") == "font/woff2");
+    assert(MimeType("/archive.tar.zip") == "application/zip");  // 只看最后一个扩展名
+    assert(MimeType("/README") == "text/plain");                // 没有扩展名
+    assert(MimeType("/v1.2/README") == "text/plain");           // 目录名中的'.'不算
+    assert(MimeType("/file.") == "text/plain");
+    assert(MimeType("/data.unknownext") == "text/plain");
+    assert(MimeType("") == "text/plain");
+    std::cout << "Test passed!\n";
+}
+
+void TestRouter() {
+    std::cout << "\n=== Test 3: Radix Trie Router ===" << std::endl;
+    Router<int> router;
+    router.AddPrefix(HttpMethod::UNKNOWN, "/", 1);
+    router.AddPrefix(HttpMethod::GET, "/static/", 2);
+    router.AddPrefix(HttpMethod::GET, "/static/img/", 3);
+    router.Add(HttpMethod::GET, "/status", 4);
+    router.Add(HttpMethod::POST, "/status", 5);
+    router.Add(HttpMethod::UNKNOWN, "/stats", 6);
+    router.Add(HttpMethod::GET, "/static/", 7);
+
+    auto match = [&router](HttpMethod method, std::string_view path) {
+        const int* handler = router.Match(method, path);
+        return handler ? *handler : 0;
+    };
+    // 精确路由优先，按方法区分
+    assert(match(HttpMethod::GET, "/status") == 4);
+    assert(match(HttpMethod::POST, "/status") == 5);
+    assert(match(HttpMethod::POST, "/stats") == 6);
+    assert(match(HttpMethod::GET, "/static/") == 7);
+    // 最长前缀
+    assert(match(HttpMethod::GET, "/static/app.js") == 2);
+    assert(match(HttpMethod::GET, "/static/img/a.png") == 3);
+    assert(match(HttpMethod::GET, "/statusx") == 1);
+    assert(match(HttpMethod::GET, "/stat") == 1);
+    // 方法不符的前缀路由不匹配，退回到更短的前缀
+    assert(match(HttpMethod::POST, "/static/app.js") == 1);
+    assert(match(HttpMethod::GET, "nothing") == 0);
+
+    // 插入顺序不影响结果(先长后短时拆分边)
+    Router<int> reversed;
+    reversed.Add(HttpMethod::GET, "/abcdef", 1);
+    reversed.Add(HttpMethod::GET, "/abc", 2);
+    reversed.Add(HttpMethod::GET, "/abx", 3);
+    assert(reversed.NodeCount() == 5);  // 根、"/ab"、"c"、"def"、"x"
+    assert(*reversed.Match(HttpMethod::GET, "/abcdef") == 1);
+    assert(*reversed.Match(HttpMethod::GET, "/abc") == 2);
+    assert(*reversed.Match(HttpMethod::GET, "/abx") == 3);
+    assert(!reversed.Match(HttpMethod::GET, "/ab") && !reversed.Match(HttpMethod::GET, "/abcd"));
+    std::cout << "Test passed!\n";
+}
+
+int main() {
+    TestStaticMap();
+    TestMimeType();
+    TestRouter();
+    std::cout << "\n=== All tests passed ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "task_pool.hpp"
+#include <cassert>
+#include <chrono>
+#include <iostream>
+
+using namespace std::chrono_literals;
+
+// 等待条件成立(最多5秒)
+template <typename F>
+bool WaitFor(F done) {
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+void TestRunAll() {
+    std::cout << "\n=== Test 1: Run All Tasks ===" << std::endl;
+    TaskPool pool(4);
+    std::atomic<int> sum{0};
+    for (int i = 1; i <= 1000; ++i) {
+        pool.Submit([&sum, i]() { sum += i; });
+    }
+    assert(WaitFor([&]() { return pool.Executed() == 1000; }));
+    assert(sum == 500500 && pool.Pending() == 0);
+    std::cout << "Test passed!\n";
+}
+
+void TestStealing() {
+    std::cout << "\n=== Test 2: Work Stealing ===" << std::endl;
+    TaskPool pool(4);
+    std::atomic<int> done{0};
+    // 一个任务在自己的队列中产生全部子任务，其他空闲线程把它们窃取过去
+    pool.Submit([&pool, &done]() {
+        for (int i = 0; i < 64; ++i) {
+            pool.Submit([&done]() {
+                std::this_thread::sleep_for(1ms);
+                ++done;
+            });
+        }
+    });
+    assert(WaitFor([&]() { return done == 64; }));
+    assert(pool.Stolen() > 0);
+    std::cout << "Test passed!\n";
+}
+
+void TestStop() {
+    std::cout << "\n=== Test 3: Stop ===" << std::endl;
+    TaskPool pool(1);
+    std::atomic<bool> release{false};
+    std::atomic<int> ran{0};
+    pool.Submit([&]() {
+        while (!release) std::this_thread::yield();
+        ++ran;
+    });
+    for (int i = 0; i < 10; ++i) pool.Submit([&ran]() { ++ran; });
+    assert(WaitFor([&]() { return pool.Pending() == 10; }));
+
+    // 正在执行的任务完成后停止，排队的任务被丢弃，之后的提交被忽略
+    std::thread stopper([&pool]() { pool.Stop(); });
+    std::this_thread::sleep_for(10ms);
+    release = true;
+    stopper.join();
+    pool.Submit([&ran]() { ++ran; });
+    assert(ran == 1 && pool.Pending() == 0 && pool.Executed() == 1);
+    std::cout << "Test passed!\n";
+}
+
+int main() {
+    TestRunAll();
+    TestStealing();
+    TestStop();
+    std::cout << "\n=== All tests passed ===" << std::endl;
+    return 0;
+}
@@ -3,11 +3,23 @@
 #include <atomic>
 #include <chrono>
 #include <cassert>
+#include <thread>
+#include <vector>
+
+// 模拟事件循环：按NextTimeout休眠，醒来后处理到期定时器，持续duration
+void RunFor(TimerWheel& timer, std::chrono::milliseconds duration) {
+    auto deadline = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < deadline) {
+        auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        int wait = timer.NextTimeout();
+        std::this_thread::sleep_for(wait < 0 ? remaining : std::min(remaining, std::chrono::milliseconds(wait)));
+        timer.Expire();
+    }
+}
 
 void TestSingleTimer() {
     std::cout << "\n=== Test 1: Single Timer ===" << std::endl;
-    TimerWheel timer(60, 10ms);
-    timer.Start();
+    TimerWheel timer(10ms);
     
     std::atomic<bool> triggered(false);
     auto start = std::chrono::steady_clock::now();
@@ -22,7 +34,7 @@ void TestSingleTimer() {
     auto wait_time = 450ms;
     while (!triggered && 
           std::chrono::steady_clock::now() - start < wait_time) {
-        std::this_thread::sleep_for(10ms);
+        RunFor(timer, 10ms);
     }
     
     if (!triggered) {
@@ -31,14 +43,12 @@ void TestSingleTimer() {
         assert(false);
     }
     
-    timer.Stop();
     std::cout << "Test passed!\n";
 }
 
 void TestMultipleTimers() {
     std::cout << "\n=== Test 2: Multiple Timers ===" << std::endl;
-    TimerWheel timer(60, 10ms);
-    timer.Start();
+    TimerWheel timer(10ms);
     
     const int test_count = 5;
     std::atomic<int> count(0);
@@ -51,8 +61,7 @@ void TestMultipleTimers() {
         });
     }
     
-    std::this_thread::sleep_for(600ms);
-    timer.Stop();
+    RunFor(timer, 600ms);
     
     if (count != test_count) {
         std::cerr << "ERROR: Only " << count << "/" << test_count 
@@ -64,19 +73,17 @@ void TestMultipleTimers() {
 
 void TestTimerCancellation() {
     std::cout << "\n=== Test 3: Timer Cancellation ===" << std::endl;
-    TimerWheel timer(60, 10ms);
-    timer.Start();
+    TimerWheel timer(10ms);
     
     std::atomic<bool> should_not_trigger(false);
     auto id = timer.AddTimeout(200ms, [&]() {
         should_not_trigger = true;
     });
     
-    std::this_thread::sleep_for(100ms);
+    RunFor(timer, 100ms);
     timer.CancelTimeout(id);
     
-    std::this_thread::sleep_for(200ms);
-    timer.Stop();
+    RunFor(timer, 200ms);
     
     if (should_not_trigger) {
         std::cerr << "ERROR: Cancelled timer was triggered!" << std::endl;
@@ -85,6 +92,119 @@ void TestTimerCancellation() {
     std::cout << "Test passed!\n";
 }
 
+void TestLongTimeouts() {
+    std::cout << "\n=== Test 4: Long Timeouts ===" << std::endl;
+    // 定时器轮没有自己的线程，由调用者用Advance推进tick(与事件循环驱动的方式相同)
+    TimerWheel timer(10ms);
+    std::vector<uint64_t> firedAt;
+    const std::vector<std::chrono::milliseconds> timeouts = {
+        1s, 2560ms, 120s, 1h, 24h, 30 * 24h  // 跨越各层以及超出轮范围的超时
+    };
+    for (auto timeout : timeouts) {
+        timer.AddTimeout(timeout, [&]() { firedAt.push_back(timer.GetCurrentTick()); });
+    }
+
+    // 逐段推进，确认每个定时器恰好在到期tick触发
+    uint64_t elapsed = 0;
+    for (size_t i = 0; i < timeouts.size(); ++i) {
+        uint64_t expires = static_cast<uint64_t>(timeouts[i] / 10ms);
+        timer.Advance(expires - elapsed);
+        if (firedAt.size() != i) {
+            std::cerr << "ERROR: timer " << timeouts[i].count() << "ms fired early" << std::endl;
+            assert(false);
+        }
+        timer.Advance(1);
+        elapsed = expires + 1;
+        assert(firedAt.size() == i + 1);
+    }
+    assert(timer.CountTasks() == 0);
+    std::cout << "Test passed!\n";
+}
+
+void TestIntrusiveReschedule() {
+    std::cout << "\n=== Test 5: Intrusive Reschedule and Cancel ===" << std::endl;
+    TimerWheel timer(10ms);
+    TimerNode node;
+    int fired = 0;
+    node.callback = [&]() { ++fired; };
+
+    // 重新调度会替换原来的到期时间
+    timer.Schedule(node, 100ms);
+    timer.Advance(5);
+    timer.Schedule(node, 100ms);
+    assert(timer.CountTasks() == 1);
+    timer.Advance(10);
+    assert(fired == 0 && node.Linked());
+    timer.Advance(1);
+    assert(fired == 1 && !node.Linked());
+
+    // 取消后不再触发，可以重复取消
+    timer.Schedule(node, 5s);
+    timer.Cancel(node);
+    timer.Cancel(node);
+    timer.Advance(1000);
+    assert(fired == 1 && timer.CountTasks() == 0);
+    std::cout << "Test passed!\n";
+}
+
+void TestNextTimeout() {
+    std::cout << "\n=== Test 6: Next Timeout ===" << std::endl;
+    TimerWheel timer(10ms);
+    auto now = std::chrono::steady_clock::now();
+
+    // 没有定时器时事件循环可以无限期休眠
+    assert(timer.NextTimeout(now) == -1);
+
+    // 等待时长指向最早的定时器
+    TimerNode node;
+    node.callback = []() {};
+    timer.Schedule(node, 500ms);
+    uint64_t id = timer.AddTimeout(50ms, []() {});
+    int wait = timer.NextTimeout(now);
+    assert(wait > 40 && wait <= 70);
+
+    // 取消后指向下一个；超出第0层一圈时最晚在级联时刻醒来
+    timer.CancelTimeout(id);
+    wait = timer.NextTimeout(now);
+    assert(wait > 0 && wait <= 2570);
+    timer.Cancel(node);
+    assert(timer.NextTimeout(now) == -1);
+    std::cout << "Test passed!\n";
+}
+
+void TestLazyTouch() {
+    std::cout << "\n=== Test 7: Lazy Touch ===" << std::endl;
+    TimerWheel timer(10ms);
+    TimerNode node;
+    int fired = 0;
+    node.callback = [&]() { ++fired; };
+
+    // 延后期限只记录新值，原槽位到期时重新放置而不是触发
+    timer.Schedule(node, 100ms);
+    timer.Advance(5);
+    timer.Touch(node, 100ms);
+    timer.Advance(6);
+    assert(fired == 0 && node.Linked() && timer.CountTasks() == 1);
+    timer.Advance(4);
+    assert(fired == 0 && node.Linked());
+    timer.Advance(1);
+    assert(fired == 1 && !node.Linked());
+
+    // 提前期限会立即重新调度
+    timer.Schedule(node, 10s);
+    timer.Touch(node, 50ms);
+    timer.Advance(5);
+    assert(fired == 1);
+    timer.Advance(1);
+    assert(fired == 2 && timer.CountTasks() == 0);
+
+    // 未调度的节点Touch等同于Schedule
+    timer.Touch(node, 10ms);
+    timer.Advance(2);
+    assert(fired == 3);
+    std::cout << "Test passed!\n";
+}
+
 int main() {
     try {
         std::cout << "=== TimerWheel Test Suite ===" << std::endl;
@@ -92,6 +212,10 @@ int main() {
         TestSingleTimer();
         TestMultipleTimers();
         TestTimerCancellation();
+        TestLongTimeouts();
+        TestIntrusiveReschedule();
+        TestNextTimeout();
+        TestLazyTouch();
         
         std::cout << "\n=== All tests passed ===" << std::endl;
         return 0;
@@ -0,0 +1,309 @@
+#include "web_server.hpp"
+#include <cassert>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// 连接服务器，发送原始请求后读取到服务器关闭连接为止
+std::string Exchange(int port, const std::string& request) {
+    SOCKET client = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    assert(connect(client, (sockaddr*)&addr, sizeof(addr)) == 0);
+#ifdef _WIN32
+    DWORD timeout = 5000;
+#else
+    timeval timeout{5, 0};
+#endif
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+    assert(send(client, request.data(), static_cast<int>(request.size()), 0) == static_cast<int>(request.size()));
+
+    std::string response;
+    char buffer[65536];
+    while (true) {
+        int n = recv(client, buffer, sizeof(buffer), 0);
+        assert(n >= 0);  // 超时说明服务器没有关闭连接
+        if (n == 0) break;
+        response.append(buffer, static_cast<size_t>(n));
+    }
+    closesocket(client);
+    return response;
+}
+
+// 统计响应中的状态行数
+size_t CountResponses(const std::string& response) {
+    size_t count = 0;
+    for (size_t pos = 0; (pos = response.find("HTTP/1.1 ", pos)) != std::string::npos; ++pos) ++count;
+    return count;
+}
+
+// 分块编码的请求体不能被当作流水线中的下一个请求(请求走私)：回复501后关闭连接
+void TestChunkedBodyNotServed(int port) {
+    std::cout << "\n=== Test: Transfer-Encoding is not pipelined ===" << std::endl;
+    std::string smuggled = "GET /index.html HTTP/1.1\r\nHost: x\r\n\r\n";
+    char size[16];
+    snprintf(size, sizeof(size), "%zx", smuggled.size());
+    std::string response = Exchange(port,
+        "POST /a.txt HTTP/1.1\r\nHost: x\r\nTransfer-Encoding: chunked\r\n\r\n" +
+        std::string(size) + "\r\n" + smuggled + "\r\n0\r\n\r\n");
+    std::cout << response.substr(0, response.find('\r')) << std::endl;
+    assert(response.compare(0, 29, "HTTP/1.1 501 Not Implemented\r") == 0);
+    assert(CountResponses(response) == 1);
+    assert(response.find("text/html") == std::string::npos);
+
+    // 同时带Content-Length时格式错误
+    response = Exchange(port,
+        "POST /a.txt HTTP/1.1\r\nHost: x\r\nContent-Length: 5\r\nTransfer-Encoding: chunked\r\n\r\n"
+        "0\r\n\r\n" + smuggled);
+    assert(response.compare(0, 24, "HTTP/1.1 400 Bad Request") == 0);
+    assert(CountResponses(response) == 1);
+    std::cout << "Test passed!\n";
+}
+
+// Connection: close与HTTP/1.0：回复Connection: close后关闭连接，之后的流水线请求不再处理
+void TestConnectionClose(int port) {
+    std::cout << "\n=== Test: Connection: close and HTTP/1.0 ===" << std::endl;
+    std::string next = "GET /index.html HTTP/1.1\r\nHost: x\r\n\r\n";
+    // 第二次请求a.txt时命中缓存(共享的缓存响应中的连接头在发送时替换)
+    for (int i = 0; i < 2; ++i) {
+        std::string response = Exchange(port, "GET /a.txt HTTP/1.1\r\nHost: x\r\nConnection: close\r\n\r\n" + next);
+        assert(CountResponses(response) == 1);
+        assert(response.find("Connection: close\r\n") != std::string::npos);
+        assert(response.find("keep-alive") == std::string::npos && response.find("text/html") == std::string::npos);
+
+        response = Exchange(port, "GET /a.txt HTTP/1.0\r\n\r\n" + next);
+        assert(CountResponses(response) == 1);
+        assert(response.find("Connection: close\r\n") != std::string::npos);
+    }
+    std::string response = Exchange(port, "GET /missing HTTP/1.0\r\n\r\n" + next);
+    assert(response.compare(0, 22, "HTTP/1.1 404 Not Found") == 0 && CountResponses(response) == 1);
+    assert(response.find("Connection: close\r\n") != std::string::npos);
+
+    // HTTP/1.0带keep-alive时保持连接，随后的请求要求关闭
+    response = Exchange(port, "GET /a.txt HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n"
+                              "GET /index.html HTTP/1.1\r\nConnection: close\r\n\r\n");
+    assert(CountResponses(response) == 2);
+    size_t second = response.find("HTTP/1.1 ", 1);
+    assert(response.find("Connection: keep-alive\r\n") < second);
+    assert(response.find("Connection: close\r\n", second) != std::string::npos);
+    assert(response.find("text/html", second) != std::string::npos);
+    std::cout << "Test passed!\n";
+}
+
+// 不能缓存的大文件流式压缩使用chunked编码：只对HTTP/1.1请求，HTTP/1.0按原始内容发送
+void TestStreamingNeedsHttp11(int port, size_t bigSize) {
+    std::cout << "\n=== Test: streamed gzip only for HTTP/1.1 ===" << std::endl;
+    std::string response = Exchange(port, "GET /big.js HTTP/1.0\r\nAccept-Encoding: gzip\r\n\r\n");
+    size_t headerEnd = response.find("\r\n\r\n") + 4;
+    std::string header = response.substr(0, headerEnd);
+    assert(header.find("Transfer-Encoding") == std::string::npos);
+    assert(header.find("Content-Encoding") == std::string::npos);
+    assert(header.find("Content-Length: " + std::to_string(bigSize) + "\r\n") != std::string::npos);
+    assert(response.size() - headerEnd == bigSize);
+
+    response = Exchange(port, "GET /big.js HTTP/1.1\r\nAccept-Encoding: gzip\r\nConnection: close\r\n\r\n");
+    header = response.substr(0, response.find("\r\n\r\n"));
+    assert(header.find("Transfer-Encoding: chunked") != std::string::npos);
+    assert(header.find("Content-Encoding: gzip") != std::string::npos);
+    assert(response.size() >= 5 && response.compare(response.size() - 5, 5, "0\r\n\r\n") == 0);
+    std::cout << "Test passed!\n";
+}
+
+// 读取/metrics中的一个计数器
+uint64_t ReadMetric(int port, const std::string& name) {
+    std::string response = Exchange(port, "GET /metrics HTTP/1.1\r\nConnection: close\r\n\r\n");
+    size_t pos = response.find("\n" + name + " ");
+    assert(pos != std::string::npos);
+    return std::stoull(response.substr(pos + name.size() + 2));
+}
+
+// 同一文件的并发未命中在每个事件循环上最多压缩一次：等待结果的请求没有提交任务，不计入offloaded
+void TestOffloadCount(int port, int threads) {
+    std::cout << "\n=== Test: offloaded counts submitted tasks ===" << std::endl;
+    uint64_t offloaded = ReadMetric(port, "web_requests_offloaded_total");
+    uint64_t compressions = ReadMetric(port, "web_compressions_total");
+    std::vector<std::thread> clients;
+    for (int i = 0; i < 16; ++i) {
+        clients.emplace_back([port]() {
+            std::string response = Exchange(port, "GET /mid.js HTTP/1.1\r\nAccept-Encoding: gzip\r\n"
+                                                  "Connection: close\r\n\r\n");
+            assert(response.find("Content-Encoding: gzip") != std::string::npos);
+        });
+    }
+    for (auto& client : clients) client.join();
+    uint64_t submitted = ReadMetric(port, "web_requests_offloaded_total") - offloaded;
+    std::cout << "Offloaded: " << submitted << std::endl;
+    uint64_t compressed = ReadMetric(port, "web_compressions_total") - compressions;
+    assert(compressed >= 1 && compressed <= static_cast<uint64_t>(threads));
+    assert(submitted == compressed);
+    std::cout << "Test passed!\n";
+}
+
+// 静态文件不能逃出文档根目录：绝对路径、编码的".."与指向外部的符号链接
+void TestPathContainment(int port, const fs::path& outside) {
+    std::cout << "\n=== Test: static paths stay under the document root ===" << std::endl;
+    std::string secret = "secret-outside-root";
+    for (const char* target : {"/%2e%2e/", "/%2e%2e/web_server_test_outside/secret.txt", "/a.txt%00",
+                               "/..\\secret.txt"}) {
+        std::string response = Exchange(port, "GET " + std::string(target) + " HTTP/1.1\r\nConnection: close\r\n\r\n");
+        std::cout << target << " -> " << response.substr(0, response.find('\r')) << std::endl;
+        assert(response.compare(0, 12, "HTTP/1.1 400") == 0);
+        assert(response.find("root:") == std::string::npos && response.find(secret) == std::string::npos);
+    }
+    // 重复的'/'被合并，绝对路径仍在文档根目录之下查找
+    for (const char* target : {"//etc/passwd", "/%2F%2Fetc/passwd"}) {
+        std::string response = Exchange(port, "GET " + std::string(target) + " HTTP/1.1\r\nConnection: close\r\n\r\n");
+        std::cout << target << " -> " << response.substr(0, response.find('\r')) << std::endl;
+        assert(response.compare(0, 12, "HTTP/1.1 404") == 0);
+        assert(response.find("root:") == std::string::npos);
+    }
+    // 符号链接(文件与目录)指向根目录之外
+    for (const char* target : {"/escape.txt", "/escape-dir/secret.txt"}) {
+        std::string response = Exchange(port, "GET " + std::string(target) + " HTTP/1.1\r\nConnection: close\r\n\r\n");
+        std::cout << target << " -> " << response.substr(0, response.find('\r')) << std::endl;
+        assert(response.compare(0, 12, "HTTP/1.1 403") == 0);
+        assert(response.find(secret) == std::string::npos);
+    }
+    // 查询串不是路径的一部分，编码的普通字符正常解码
+    std::string response = Exchange(port, "GET /%61.txt?v=1 HTTP/1.1\r\nConnection: close\r\n\r\n");
+    assert(response.compare(0, 15, "HTTP/1.1 200 OK") == 0);
+    assert(fs::exists(outside / "secret.txt"));
+    std::cout << "Test passed!\n";
+}
+
+// 编码的表示同样不能逃出文档根目录：请求的路径与预压缩的兄弟文件("原文件.gz")都要检查
+void TestEncodedContainment(int port) {
+    std::cout << "\n=== Test: encoded variants stay under the document root ===" << std::endl;
+    for (const char* target : {"//etc/passwd", "/%2e%2e/web_server_test_outside/secret.txt", "/escape.txt"}) {
+        std::string response = Exchange(port, "GET " + std::string(target) +
+                                              " HTTP/1.1\r\nAccept-Encoding: gzip, br\r\nConnection: close\r\n\r\n");
+        std::cout << target << " -> " << response.substr(0, response.find('\r')) << std::endl;
+        assert(response.compare(0, 9, "HTTP/1.1 ") == 0 && response.compare(0, 15, "HTTP/1.1 200 OK") != 0);
+        assert(response.find("Content-Encoding") == std::string::npos);
+        assert(response.find("root:") == std::string::npos && response.find("secret") == std::string::npos);
+    }
+    // 根目录中的文件，预压缩的兄弟文件是指向外部的符号链接：忽略它，不发送外部的内容
+    for (int i = 0; i < 2; ++i) {
+        std::string response = Exchange(port, "GET /page.css HTTP/1.1\r\nAccept-Encoding: gzip\r\n"
+                                              "Connection: close\r\n\r\n");
+        std::cout << "/page.css -> " << response.substr(0, response.find('\r')) << std::endl;
+        assert(response.compare(0, 15, "HTTP/1.1 200 OK") == 0);
+        assert(response.find("secret-gz-outside") == std::string::npos);
+    }
+    std::cout << "Test passed!\n";
+}
+
+// 重复或重叠的范围合并后发送：文件不会被发送多次；多个范围的multipart响应同样带Vary
+void TestRangeCoalescing(int port, size_t midSize) {
+    std::cout << "\n=== Test: overlapping ranges are coalesced ===" << std::endl;
+    std::string range = "0-";
+    for (size_t i = 1; i < MAX_RANGES; ++i) range += ",0-";
+    // 第二次请求命中缓存
+    for (int i = 0; i < 2; ++i) {
+        std::string response = Exchange(port, "GET /mid.js HTTP/1.1\r\nRange: bytes=" + range +
+                                              "\r\nConnection: close\r\n\r\n");
+        size_t headerEnd = response.find("\r\n\r\n") + 4;
+        std::cout << response.substr(0, response.find('\r')) << ", body " << response.size() - headerEnd << std::endl;
+        assert(response.compare(0, 28, "HTTP/1.1 206 Partial Content") == 0);
+        assert(response.find("Content-Range: bytes 0-" + std::to_string(midSize - 1) + "/") != std::string::npos);
+        assert(response.size() - headerEnd == midSize);
+    }
+
+    std::string response = Exchange(port, "GET /mid.js HTTP/1.1\r\nRange: bytes=0-9,1000-1009,5-19\r\n"
+                                          "Connection: close\r\n\r\n");
+    std::string header = response.substr(0, response.find("\r\n\r\n"));
+    assert(header.find("multipart/byteranges") != std::string::npos);
+    assert(header.find("Vary: Accept-Encoding\r\n") != std::string::npos);
+    assert(response.find("Content-Range: bytes 0-19/") != std::string::npos);
+    assert(response.find("Content-Range: bytes 1000-1009/") != std::string::npos);
+    assert(response.find("Content-Range: bytes 5-19/") == std::string::npos);
+    std::cout << "Test passed!\n";
+}
+
+// 路由匹配之前规范化："."、".."段被拒绝，重复的'/'合并，以'/'结尾时查找目录下的index.html，查询串不参与匹配
+void TestNormalizedRouting(int port) {
+    std::cout << "\n=== Test: paths are normalized before routing ===" << std::endl;
+    for (const char* target : {"/./a.txt", "/a.txt/.", "/x/../a.txt", "/%2e/a.txt", "a.txt"}) {
+        std::string response = Exchange(port, "GET " + std::string(target) + " HTTP/1.1\r\nConnection: close\r\n\r\n");
+        std::cout << target << " -> " << response.substr(0, response.find('\r')) << std::endl;
+        assert(response.compare(0, 12, "HTTP/1.1 400") == 0);
+    }
+    for (const char* target : {"/?v=1", "/metrics?format=text", "/a..b.txt", "//index.html"}) {
+        std::string response = Exchange(port, "GET " + std::string(target) + " HTTP/1.1\r\nConnection: close\r\n\r\n");
+        std::cout << target << " -> " << response.substr(0, response.find('\r')) << std::endl;
+        assert(response.compare(0, 15, "HTTP/1.1 200 OK") == 0);
+    }
+    // 以'/'结尾：目录下的index.html
+    for (const char* target : {"/sub/", "//sub//?v=1"}) {
+        std::string response = Exchange(port, "GET " + std::string(target) + " HTTP/1.1\r\nConnection: close\r\n\r\n");
+        std::cout << target << " -> " << response.substr(0, response.find('\r')) << std::endl;
+        assert(response.compare(0, 15, "HTTP/1.1 200 OK") == 0);
+        assert(response.find("<html>sub</html>") != std::string::npos);
+    }
+    // 目录本身与文件之下的index.html都不存在
+    for (const char* target : {"/sub", "/a.txt/", "/missing/"}) {
+        std::string response = Exchange(port, "GET " + std::string(target) + " HTTP/1.1\r\nConnection: close\r\n\r\n");
+        std::cout << target << " -> " << response.substr(0, response.find('\r')) << std::endl;
+        assert(response.compare(0, 12, "HTTP/1.1 404") == 0);
+    }
+    std::cout << "Test passed!\n";
+}
+
+int main() {
+    fs::path root = fs::temp_directory_path() / "web_server_test";
+    fs::create_directories(root);
+    std::ofstream(root / "index.html") << "<html>index</html>";
+    std::ofstream(root / "a.txt") << "a";
+    std::ofstream(root / "a..b.txt") << "ab";
+    fs::create_directories(root / "sub");
+    std::ofstream(root / "sub" / "index.html") << "<html>sub</html>";
+    // 超过可缓存大小的可压缩文件
+    std::string big;
+    for (int i = 0; big.size() < MAX_CACHED_FILE_SIZE * 2; ++i) {
+        big += "var v" + std::to_string(i) + " = " + std::to_string(i * 7) + ";\n";
+    }
+    std::ofstream(root / "big.js", std::ios::binary) << big;
+    // 可以缓存的可压缩文件
+    std::ofstream(root / "mid.js", std::ios::binary) << big.substr(0, MAX_CACHED_FILE_SIZE - 1024);
+    // 文档根目录之外的文件，以及根目录中指向它的符号链接
+    fs::path outside = fs::temp_directory_path() / "web_server_test_outside";
+    fs::create_directories(outside);
+    std::ofstream(outside / "secret.txt") << "secret-outside-root";
+    fs::remove(root / "escape.txt");
+    fs::remove(root / "escape-dir");
+    fs::create_symlink(outside / "secret.txt", root / "escape.txt");
+    fs::create_directory_symlink(outside, root / "escape-dir");
+    std::string css;
+    while (css.size() < 4096) css += "body { margin: 0; padding: 0; }\n";
+    std::ofstream(root / "page.css") << css;
+    std::ofstream(outside / "secret.css.gz") << "secret-gz-outside";
+    fs::remove(root / "page.css.gz");
+    fs::create_symlink(outside / "secret.css.gz", root / "page.css.gz");
+
+    ServerConfig config;
+    config.port = 18195;
+    config.threads = 2;
+    config.documentRoot = root.string();
+    WebServer server;
+    assert(server.Initialize(config));
+
+    TestChunkedBodyNotServed(config.port);
+    TestConnectionClose(config.port);
+    TestStreamingNeedsHttp11(config.port, big.size());
+    TestOffloadCount(config.port, config.threads);
+    TestPathContainment(config.port, outside);
+    TestNormalizedRouting(config.port);
+    TestEncodedContainment(config.port);
+    TestRangeCoalescing(config.port, MAX_CACHED_FILE_SIZE - 1024);
+
+    server.Stop();
+    fs::remove_all(root);
+    fs::remove_all(outside);
+    std::cout << "\n=== All tests passed ===" << std::endl;
+    return 0;
+}